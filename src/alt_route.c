@@ -0,0 +1,748 @@
+/**
+ * alt_route.c
+ *
+ * This file contains the internal data-structure and function definitions
+ * for the alt_route type.
+ *
+ * The two searches are Dijkstra's algorithm, run in turns from whichever
+ * side has the cheaper cell to expand, so the cost of each cell they both
+ * expand is exact in both directions. Once they meet, the cost of the
+ * shortest route bounds how far each goes: a cell is only queued if its
+ * cost from its own side plus astar's estimate to the far end is within
+ * the stretch, and a side stops once its cheapest cell is beyond it.
+ *
+ * Each cell of a plateau has its parent in the start tree before it and
+ * its parent in the end tree after it, so the plateaus are found by
+ * walking from every cell both searches expanded whose start tree parent
+ * isn't on a plateau with it. Each cell is on one plateau, so this takes
+ * one pass over the cells.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#include "alt_route.h"
+
+/**
+ * This is the cost of a route that hasn't been found.
+ */
+#define ALT_ROUTE_INFINITY UINT32_MAX
+
+/**
+ * These are the two searches: the one from the start cell, along the
+ * graph's edges, and the one from the end cell, along them backwards.
+ */
+enum alt_route_side { ALT_ROUTE_FORWARD, ALT_ROUTE_BACKWARD };
+
+/**
+ * This is a plateau: a run of moves shared by the two trees of shortest
+ * paths, and the cost of the route through it.
+ */
+struct alt_route_plateau {
+    uint32_t via;       /* The first cell of the plateau. */
+    uint32_t length;    /* The cost of the moves along the plateau. */
+    uint32_t cost;      /* The cost of the route through the plateau. */
+};
+
+/**
+ * This is the internal data-structure of the alt_route type.
+ */
+struct alt_route_data {
+    graph* gp;                  /* The graph routes are found over. */
+    uint32_t stretch;           /* The percentages routes are chosen */
+    uint32_t sharing;           /* with. */
+    uint32_t local;
+    uint32_t* dist[2];          /* The cost of each cell from each side. */
+    uint32_t* parent[2];        /* Each cell's parent in each tree. */
+    uint32_t* visit[2];         /* The search each cell was last reached
+                                 * by from each side. */
+    uint32_t* closed[2];        /* The search each cell was last expanded
+                                 * by from each side. */
+    uint32_t search;            /* The number of the current search. */
+    id_heap open[2];            /* The cells waiting to be expanded on each
+                                 * side. */
+    uint8_t start_x;            /* The coordinates of the start cell. */
+    uint8_t start_y;
+    uint8_t start_z;
+    uint8_t end_x;              /* The coordinates of the end cell. */
+    uint8_t end_y;
+    uint8_t end_z;
+    uint32_t limit;             /* The most a route can cost. */
+    uint32_t* both;             /* The cells expanded by both sides. */
+    uint32_t num_both;          /* The number of them. */
+    struct alt_route_plateau* plateaus;     /* The plateaus found. */
+    uint32_t num_plateaus;      /* The number of them. */
+    uint32_t* on_route;         /* The search each cell was last put on a
+                                 * route by. */
+    uint32_t* mark;             /* The candidate each cell was last put on. */
+    uint32_t candidate;         /* The number of the current candidate. */
+    uint32_t* route;            /* The cells of the current candidate. */
+    uint32_t* route_g;          /* The cost of the candidate to each one. */
+    uint32_t route_size;        /* The number of cells in the candidate. */
+    uint32_t route_local;       /* The cost of the part of it that's a
+                                 * shortest path. */
+    uint32_t* paths;            /* The cells of every route, one after
+                                 * another. */
+    uint32_t paths_capacity;    /* The number of cells there's room for. */
+    uint32_t* first;            /* Where each route starts in the paths,
+                                 * and where the last one ends. */
+    uint32_t* costs;            /* The cost of each route. */
+    uint32_t num_routes;        /* The number of routes found. */
+    uint32_t routes_capacity;   /* The number of routes there's room for. */
+};
+
+/**
+ * This function expands the cell provided to it on the side also provided,
+ * during alt_route_search().
+ */
+void alt_route_expand(alt_route* ap, enum alt_route_side side,
+                      uint32_t current);
+
+/**
+ * This function finds the plateaus of the two trees of shortest paths
+ * grown by alt_route_search(), and puts them in order of how much their
+ * routes cost beyond them.
+ */
+void alt_route_find_plateaus(alt_route* ap);
+
+/**
+ * This function compares the two plateaus provided to it by how much their
+ * routes cost beyond them, and then by how long they are, for qsort().
+ */
+int alt_route_compare_plateaus(const void* a, const void* b);
+
+/**
+ * This function makes the route through the cell provided to it the
+ * current candidate. It returns false if the route goes through a cell
+ * more than once.
+ */
+bool alt_route_build(alt_route* ap, uint32_t via);
+
+/**
+ * This function returns the cost of the moves the current candidate shares
+ * with the routes already found.
+ */
+uint32_t alt_route_get_shared(alt_route a);
+
+/**
+ * This function adds the current candidate to the routes found.
+ */
+void alt_route_add(alt_route* ap);
+
+/**
+ * This function initialises the alt_route provided to it to find routes
+ * over the graph also provided, with the default percentages.
+ */
+void alt_route_init(alt_route* ap, graph* gp)
+{
+    uint32_t count;     /* The number of cell ids. */
+    uint8_t side;       /* The current side. */
+
+    /* Allocate memory to the alt_route. */
+    *ap = (alt_route) malloc(sizeof(struct alt_route_data));
+    count = graph_get_cell_count(*gp);
+
+    /* Initialise the alt_route's internal properties. */
+    (*ap)->gp = gp;
+    (*ap)->stretch = ALT_ROUTE_DEFAULT_STRETCH;
+    (*ap)->sharing = ALT_ROUTE_DEFAULT_SHARING;
+    (*ap)->local = ALT_ROUTE_DEFAULT_LOCAL;
+    for (side = 0; side < 2; side++)
+    {
+        (*ap)->dist[side] = (uint32_t*) malloc(sizeof(uint32_t) * count);
+        (*ap)->parent[side] = (uint32_t*) malloc(sizeof(uint32_t) * count);
+        (*ap)->visit[side] = (uint32_t*) calloc(count, sizeof(uint32_t));
+        (*ap)->closed[side] = (uint32_t*) calloc(count, sizeof(uint32_t));
+        id_heap_init(&(*ap)->open[side], count);
+    }
+    (*ap)->search = 0;
+    (*ap)->start_x = 0;
+    (*ap)->start_y = 0;
+    (*ap)->start_z = 0;
+    (*ap)->end_x = 0;
+    (*ap)->end_y = 0;
+    (*ap)->end_z = 0;
+    (*ap)->limit = ALT_ROUTE_INFINITY;
+    (*ap)->both = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*ap)->num_both = 0;
+    (*ap)->plateaus = (struct alt_route_plateau*) malloc(
+            sizeof(struct alt_route_plateau) * count);
+    (*ap)->num_plateaus = 0;
+    (*ap)->on_route = (uint32_t*) calloc(count, sizeof(uint32_t));
+    (*ap)->mark = (uint32_t*) calloc(count, sizeof(uint32_t));
+    (*ap)->candidate = 0;
+    (*ap)->route = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*ap)->route_g = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*ap)->route_size = 0;
+    (*ap)->route_local = 0;
+    (*ap)->paths = NULL;
+    (*ap)->paths_capacity = 0;
+    (*ap)->first = (uint32_t*) malloc(sizeof(uint32_t));
+    (*ap)->first[0] = 0;
+    (*ap)->costs = NULL;
+    (*ap)->num_routes = 0;
+    (*ap)->routes_capacity = 0;
+}
+
+/**
+ * This function destroys the alt_route provided to it.
+ */
+void alt_route_free(alt_route* ap)
+{
+    uint8_t side;   /* The current side. */
+
+    /* Destroy the alt_route's internal properties. */
+    for (side = 0; side < 2; side++)
+    {
+        free((*ap)->dist[side]);
+        free((*ap)->parent[side]);
+        free((*ap)->visit[side]);
+        free((*ap)->closed[side]);
+        id_heap_free(&(*ap)->open[side]);
+    }
+    free((*ap)->both);
+    free((*ap)->plateaus);
+    free((*ap)->on_route);
+    free((*ap)->mark);
+    free((*ap)->route);
+    free((*ap)->route_g);
+    free((*ap)->paths);
+    free((*ap)->first);
+    free((*ap)->costs);
+
+    /* De-allocate memory from the alt_route. */
+    free(*ap);
+}
+
+/**
+ * This function sets the percentage more than the shortest route an
+ * alternative route found by the alt_route provided to it can cost.
+ */
+void alt_route_set_stretch(alt_route* ap, uint32_t percent)
+{
+    (*ap)->stretch = percent;
+}
+
+/**
+ * This function sets the percentage of the cost of the shortest route an
+ * alternative route found by the alt_route provided to it can share with
+ * the routes found before it.
+ */
+void alt_route_set_sharing(alt_route* ap, uint32_t percent)
+{
+    (*ap)->sharing = percent;
+}
+
+/**
+ * This function sets the percentage of an alternative route's cost that
+ * must be a shortest path, for the alt_route provided to it.
+ */
+void alt_route_set_local(alt_route* ap, uint32_t percent)
+{
+    (*ap)->local = percent;
+}
+
+/**
+ * This function finds the shortest route from the start cell to the end
+ * cell and up to the number of routes provided to it less one alternative
+ * routes, and returns the number of routes found.
+ */
+uint32_t alt_route_search(alt_route* ap, uint32_t start, uint32_t end,
+                          uint32_t num_routes)
+{
+    alt_route a;                /* The alt_route. */
+    uint32_t count;             /* The number of cell ids. */
+    uint32_t current;           /* The cell being expanded. */
+    uint32_t best;              /* The cost of the shortest route. */
+    uint32_t i;                 /* The current plateau. */
+    uint32_t key[2];            /* The cost of each side's cheapest cell. */
+    enum alt_route_side side;   /* The side expanded next. */
+    uint8_t s;                  /* The current side. */
+
+    /* Bring the graph's index up to date and make room for the routes. */
+    graph_update_index((*ap)->gp);
+    a = *ap;
+    count = graph_get_cell_count(*a->gp);
+    if (num_routes > a->routes_capacity)
+    {
+        a->routes_capacity = num_routes;
+        a->first = (uint32_t*) realloc(a->first,
+                sizeof(uint32_t) * (num_routes + 1));
+        a->costs = (uint32_t*) realloc(a->costs,
+                sizeof(uint32_t) * num_routes);
+    }
+
+    /* Move on to the next search number. If the numbers have run out,
+     * forget every cell's search numbers and start counting again. */
+    a->search++;
+    if (a->search == 0)
+    {
+        for (s = 0; s < 2; s++)
+        {
+            memset(a->visit[s], 0, sizeof(uint32_t) * count);
+            memset(a->closed[s], 0, sizeof(uint32_t) * count);
+        }
+        memset(a->on_route, 0, sizeof(uint32_t) * count);
+        a->search = 1;
+    }
+    id_heap_clear(&a->open[ALT_ROUTE_FORWARD]);
+    id_heap_clear(&a->open[ALT_ROUTE_BACKWARD]);
+    a->num_both = 0;
+    a->num_routes = 0;
+    a->first[0] = 0;
+    if (num_routes == 0)
+    {
+        return 0;
+    }
+
+    /* Start each side from its own end. */
+    graph_get_cell_coords(*a->gp, start, &a->start_x, &a->start_y,
+                          &a->start_z);
+    graph_get_cell_coords(*a->gp, end, &a->end_x, &a->end_y, &a->end_z);
+    a->limit = ALT_ROUTE_INFINITY;
+    a->dist[ALT_ROUTE_FORWARD][start] = 0;
+    a->parent[ALT_ROUTE_FORWARD][start] = GRAPH_NO_CELL;
+    a->visit[ALT_ROUTE_FORWARD][start] = a->search;
+    id_heap_push(&a->open[ALT_ROUTE_FORWARD], start, 0);
+    a->dist[ALT_ROUTE_BACKWARD][end] = 0;
+    a->parent[ALT_ROUTE_BACKWARD][end] = GRAPH_NO_CELL;
+    a->visit[ALT_ROUTE_BACKWARD][end] = a->search;
+    id_heap_push(&a->open[ALT_ROUTE_BACKWARD], end, 0);
+    if (start == end)
+    {
+        a->limit = 0;
+    }
+
+    /* Expand the cheaper of the two sides' cheapest cells until neither
+     * side has a cell left within the limit. */
+    while (true)
+    {
+        for (s = 0; s < 2; s++)
+        {
+            key[s] = ALT_ROUTE_INFINITY;
+            if (!id_heap_is_empty(a->open[s]))
+            {
+                key[s] = id_heap_get_key(a->open[s],
+                                         id_heap_peek_min(a->open[s]));
+                if (key[s] > a->limit)
+                {
+                    key[s] = ALT_ROUTE_INFINITY;
+                }
+            }
+        }
+        if (key[ALT_ROUTE_FORWARD] == ALT_ROUTE_INFINITY
+            && key[ALT_ROUTE_BACKWARD] == ALT_ROUTE_INFINITY)
+        {
+            break;
+        }
+        side = key[ALT_ROUTE_FORWARD] <= key[ALT_ROUTE_BACKWARD]
+             ? ALT_ROUTE_FORWARD : ALT_ROUTE_BACKWARD;
+
+        /* Expand the cell, noting it if the other side has too. */
+        current = id_heap_pop_min(&a->open[side]);
+        a->closed[side][current] = a->search;
+        if (a->closed[1 - side][current] == a->search)
+        {
+            a->both[a->num_both++] = current;
+        }
+        alt_route_expand(ap, side, current);
+    }
+
+    /* There are no routes if the two sides never met. */
+    if (a->limit == ALT_ROUTE_INFINITY)
+    {
+        return 0;
+    }
+
+    /* The first route is the shortest, through the cell with the cheapest
+     * route, which both sides expand before they stop. */
+    best = ALT_ROUTE_INFINITY;
+    current = GRAPH_NO_CELL;
+    for (i = 0; i < a->num_both; i++)
+    {
+        if (a->dist[ALT_ROUTE_FORWARD][a->both[i]]
+            + a->dist[ALT_ROUTE_BACKWARD][a->both[i]] < best)
+        {
+            current = a->both[i];
+            best = a->dist[ALT_ROUTE_FORWARD][current]
+                 + a->dist[ALT_ROUTE_BACKWARD][current];
+        }
+    }
+    alt_route_build(ap, current);
+    alt_route_add(ap);
+    if (start == end)
+    {
+        return a->num_routes;
+    }
+
+    /* Take the routes through the plateaus in order, keeping those that
+     * are different enough and can't be cut short. */
+    alt_route_find_plateaus(ap);
+    for (i = 0; i < a->num_plateaus && a->num_routes < num_routes; i++)
+    {
+        if (!alt_route_build(ap, a->plateaus[i].via)
+            || (uint64_t) a->route_local * 100
+               < (uint64_t) a->plateaus[i].cost * a->local)
+        {
+            continue;
+        }
+        if ((uint64_t) alt_route_get_shared(a) * 100
+            > (uint64_t) best * a->sharing)
+        {
+            continue;
+        }
+        alt_route_add(ap);
+    }
+    return a->num_routes;
+}
+
+/**
+ * This function returns the number of routes found by alt_route_search().
+ */
+uint32_t alt_route_get_num_routes(alt_route a)
+{
+    return a->num_routes;
+}
+
+/**
+ * This function returns the ids of the cells that make up the route with
+ * the number provided to it, found by alt_route_search(), from the start
+ * cell to the end cell. Route 0 is the shortest.
+ */
+uint32_t* alt_route_get_path(alt_route a, uint32_t route)
+{
+    return &a->paths[a->first[route]];
+}
+
+/**
+ * This function returns the number of cells in the route with the number
+ * provided to it, found by alt_route_search().
+ */
+uint32_t alt_route_get_path_size(alt_route a, uint32_t route)
+{
+    return a->first[route + 1] - a->first[route];
+}
+
+/**
+ * This function returns the cost of the route with the number provided to
+ * it, found by alt_route_search().
+ */
+uint32_t alt_route_get_cost(alt_route a, uint32_t route)
+{
+    return a->costs[route];
+}
+
+/**
+ * This function expands the cell provided to it on the side also provided,
+ * during alt_route_search().
+ */
+void alt_route_expand(alt_route* ap, enum alt_route_side side,
+                      uint32_t current)
+{
+    alt_route a;        /* The alt_route. */
+    graph g;            /* The graph. */
+    uint32_t e;         /* The current edge. */
+    uint32_t last;      /* The end of the current cell's edges. */
+    uint32_t neighbour; /* The cell the edge leads to. */
+    uint32_t next_g;    /* The cost of the path to it through the cell. */
+    uint32_t total;     /* The cost of the route through it. */
+    uint8_t x, y, z;    /* The coordinates of the neighbour. */
+    uint8_t w;          /* The cost of the edge. */
+
+    /* Assess the edges leaving the cell, or entering it on the backward
+     * side. */
+    a = *ap;
+    g = *a->gp;
+    if (side == ALT_ROUTE_FORWARD)
+    {
+        e = graph_get_first_edge(g, current);
+        last = graph_get_first_edge(g, current + 1);
+    }
+    else
+    {
+        e = graph_get_first_in_edge(g, current);
+        last = graph_get_first_in_edge(g, current + 1);
+    }
+    for (; e < last; e++)
+    {
+        /* Skip moves that aren't possible and cells already expanded. */
+        if (side == ALT_ROUTE_FORWARD)
+        {
+            w = graph_get_edge_w(g, e);
+            neighbour = graph_get_edge_to(g, e);
+        }
+        else
+        {
+            w = graph_get_in_edge_w(g, e);
+            neighbour = graph_get_in_edge_from(g, e);
+        }
+        if (w == 0 || a->closed[side][neighbour] == a->search)
+        {
+            continue;
+        }
+        next_g = a->dist[side][current] + w;
+        if (a->visit[side][neighbour] == a->search
+            && next_g >= a->dist[side][neighbour])
+        {
+            continue;
+        }
+
+        /* Once the sides have met, skip cells that can't be on a route
+         * within the limit. */
+        if (a->limit != ALT_ROUTE_INFINITY)
+        {
+            graph_get_cell_coords(g, neighbour, &x, &y, &z);
+            if (side == ALT_ROUTE_FORWARD)
+            {
+                total = next_g + astar_estimate_coords(graph_get_style(g),
+                        x, y, z, a->end_x, a->end_y, a->end_z);
+            }
+            else
+            {
+                total = next_g + astar_estimate_coords(graph_get_style(g),
+                        x, y, z, a->start_x, a->start_y, a->start_z);
+            }
+            if (total > a->limit)
+            {
+                continue;
+            }
+        }
+
+        /* Record the path to the neighbour and queue it. */
+        a->dist[side][neighbour] = next_g;
+        a->parent[side][neighbour] = current;
+        a->visit[side][neighbour] = a->search;
+        id_heap_push(&a->open[side], neighbour, next_g);
+
+        /* If the other side has reached the neighbour too, there's a route
+         * through it, which may lower the limit. */
+        if (a->visit[1 - side][neighbour] == a->search)
+        {
+            total = next_g + a->dist[1 - side][neighbour];
+            if (a->limit == ALT_ROUTE_INFINITY
+                || total + (uint64_t) total * a->stretch / 100 < a->limit)
+            {
+                a->limit = total + (uint32_t) (
+                        (uint64_t) total * a->stretch / 100);
+            }
+        }
+    }
+}
+
+/**
+ * This function finds the plateaus of the two trees of shortest paths
+ * grown by alt_route_search(), and puts them in order of how much their
+ * routes cost beyond them.
+ */
+void alt_route_find_plateaus(alt_route* ap)
+{
+    alt_route a;        /* The alt_route. */
+    uint32_t via;       /* The first cell of the current plateau. */
+    uint32_t current;   /* The current cell along it. */
+    uint32_t next;      /* The cell after it in the end tree. */
+    uint32_t before;    /* The cell before the first in the start tree. */
+    uint32_t cost;      /* The cost of the route through the plateau. */
+    uint32_t i;         /* The current cell expanded by both sides. */
+
+    a = *ap;
+    a->num_plateaus = 0;
+    for (i = 0; i < a->num_both; i++)
+    {
+        /* Skip cells whose start tree parent is on the same plateau, and
+         * plateaus whose route costs too much. */
+        via = a->both[i];
+        before = a->parent[ALT_ROUTE_FORWARD][via];
+        if (before != GRAPH_NO_CELL
+            && a->closed[ALT_ROUTE_BACKWARD][before] == a->search
+            && a->parent[ALT_ROUTE_BACKWARD][before] == via)
+        {
+            continue;
+        }
+        cost = a->dist[ALT_ROUTE_FORWARD][via]
+             + a->dist[ALT_ROUTE_BACKWARD][via];
+        if (cost > a->limit)
+        {
+            continue;
+        }
+
+        /* Follow the end tree for as long as the start tree agrees. */
+        current = via;
+        next = a->parent[ALT_ROUTE_BACKWARD][current];
+        while (next != GRAPH_NO_CELL
+               && a->closed[ALT_ROUTE_FORWARD][next] == a->search
+               && a->closed[ALT_ROUTE_BACKWARD][next] == a->search
+               && a->parent[ALT_ROUTE_FORWARD][next] == current)
+        {
+            current = next;
+            next = a->parent[ALT_ROUTE_BACKWARD][current];
+        }
+        a->plateaus[a->num_plateaus].via = via;
+        a->plateaus[a->num_plateaus].length
+                = a->dist[ALT_ROUTE_FORWARD][current]
+                - a->dist[ALT_ROUTE_FORWARD][via];
+        a->plateaus[a->num_plateaus].cost = cost;
+        a->num_plateaus++;
+    }
+    qsort(a->plateaus, a->num_plateaus, sizeof(struct alt_route_plateau),
+          alt_route_compare_plateaus);
+}
+
+/**
+ * This function compares the two plateaus provided to it by how much their
+ * routes cost beyond them, and then by how long they are, for qsort().
+ */
+int alt_route_compare_plateaus(const void* a, const void* b)
+{
+    const struct alt_route_plateau* pa;     /* The first plateau. */
+    const struct alt_route_plateau* pb;     /* The second plateau. */
+    uint32_t ka;    /* The first plateau's cost beyond it. */
+    uint32_t kb;    /* The second plateau's cost beyond it. */
+
+    pa = (const struct alt_route_plateau*) a;
+    pb = (const struct alt_route_plateau*) b;
+    ka = pa->cost - pa->length;
+    kb = pb->cost - pb->length;
+    if (ka != kb)
+    {
+        return ka < kb ? -1 : 1;
+    }
+    return pa->length > pb->length ? -1 : pa->length < pb->length ? 1 : 0;
+}
+
+/**
+ * This function makes the route through the cell provided to it the
+ * current candidate, and works out how much of it is a shortest path. It
+ * returns false if the route goes through a cell more than once.
+ */
+bool alt_route_build(alt_route* ap, uint32_t via)
+{
+    alt_route a;        /* The alt_route. */
+    uint32_t count;     /* The number of cell ids. */
+    uint32_t current;   /* The current cell of the route. */
+    uint32_t through;   /* The cost of the route through the cell. */
+    uint32_t low;       /* The cost to the first cell of the shortest
+                         * part. */
+    uint32_t high;      /* The cost to its last cell. */
+    uint32_t i;         /* The current position in the route. */
+
+    /* Move on to the next candidate number. If the numbers have run out,
+     * forget every cell's candidate number and start counting again. */
+    a = *ap;
+    a->candidate++;
+    if (a->candidate == 0)
+    {
+        count = graph_get_cell_count(*a->gp);
+        memset(a->mark, 0, sizeof(uint32_t) * count);
+        a->candidate = 1;
+    }
+
+    /* Follow the start tree back from the cell, then put that part in
+     * order. A cell whose costs from both sides add up to the cost of the
+     * route has a shortest path to the end cell along the route, so the
+     * route is a shortest path from the first such cell on. */
+    through = a->dist[ALT_ROUTE_FORWARD][via]
+            + a->dist[ALT_ROUTE_BACKWARD][via];
+    low = a->dist[ALT_ROUTE_FORWARD][via];
+    a->route_size = 0;
+    for (current = via; current != GRAPH_NO_CELL;
+         current = a->parent[ALT_ROUTE_FORWARD][current])
+    {
+        if (a->closed[ALT_ROUTE_BACKWARD][current] == a->search
+            && a->dist[ALT_ROUTE_FORWARD][current]
+               + a->dist[ALT_ROUTE_BACKWARD][current] == through)
+        {
+            low = a->dist[ALT_ROUTE_FORWARD][current];
+        }
+        a->mark[current] = a->candidate;
+        a->route_g[a->route_size] = a->dist[ALT_ROUTE_FORWARD][current];
+        a->route[a->route_size++] = current;
+    }
+    for (i = 0; i < a->route_size / 2; i++)
+    {
+        current = a->route[i];
+        a->route[i] = a->route[a->route_size - 1 - i];
+        a->route[a->route_size - 1 - i] = current;
+        current = a->route_g[i];
+        a->route_g[i] = a->route_g[a->route_size - 1 - i];
+        a->route_g[a->route_size - 1 - i] = current;
+    }
+
+    /* Follow the end tree on from the cell, giving up if it meets a cell
+     * the route has already been through. The route is a shortest path up
+     * to the last cell whose costs add up the same way. */
+    high = a->dist[ALT_ROUTE_FORWARD][via];
+    for (current = a->parent[ALT_ROUTE_BACKWARD][via];
+         current != GRAPH_NO_CELL;
+         current = a->parent[ALT_ROUTE_BACKWARD][current])
+    {
+        if (a->mark[current] == a->candidate)
+        {
+            return false;
+        }
+        if (a->closed[ALT_ROUTE_FORWARD][current] == a->search
+            && a->dist[ALT_ROUTE_FORWARD][current]
+               + a->dist[ALT_ROUTE_BACKWARD][current] == through)
+        {
+            high = through - a->dist[ALT_ROUTE_BACKWARD][current];
+        }
+        a->mark[current] = a->candidate;
+        a->route_g[a->route_size]
+                = through - a->dist[ALT_ROUTE_BACKWARD][current];
+        a->route[a->route_size++] = current;
+    }
+    a->route_local = high - low;
+    return true;
+}
+
+/**
+ * This function returns the cost of the moves the current candidate shares
+ * with the routes already found.
+ */
+uint32_t alt_route_get_shared(alt_route a)
+{
+    uint32_t shared;    /* The cost of the shared moves. */
+    uint32_t i;         /* The current move. */
+
+    shared = 0;
+    for (i = 1; i < a->route_size; i++)
+    {
+        if (a->on_route[a->route[i - 1]] == a->search
+            && a->on_route[a->route[i]] == a->search)
+        {
+            shared += a->route_g[i] - a->route_g[i - 1];
+        }
+    }
+    return shared;
+}
+
+/**
+ * This function adds the current candidate to the routes found.
+ */
+void alt_route_add(alt_route* ap)
+{
+    alt_route a;        /* The alt_route. */
+    uint32_t size;      /* The number of cells in every route. */
+    uint32_t i;         /* The current cell of the candidate. */
+
+    /* Make room for the candidate's cells. */
+    a = *ap;
+    size = a->first[a->num_routes] + a->route_size;
+    if (size > a->paths_capacity)
+    {
+        a->paths_capacity = size > 2 * a->paths_capacity
+                          ? size : 2 * a->paths_capacity;
+        a->paths = (uint32_t*) realloc(a->paths,
+                sizeof(uint32_t) * a->paths_capacity);
+    }
+
+    /* Copy its cells over and put them on a route. */
+    for (i = 0; i < a->route_size; i++)
+    {
+        a->paths[a->first[a->num_routes] + i] = a->route[i];
+        a->on_route[a->route[i]] = a->search;
+    }
+    a->costs[a->num_routes] = a->route_g[a->route_size - 1];
+    a->num_routes++;
+    a->first[a->num_routes] = size;
+}
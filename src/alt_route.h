@@ -0,0 +1,136 @@
+/**
+ * alt_route.h
+ *
+ * This file contains the data-structure and function prototype declarations
+ * for the alt_route type.
+ *
+ * The alt_route type finds the shortest route between two cells and up to a
+ * number of alternative routes that are different enough from it and from
+ * each other to be worth offering, all from the same pair of searches. It
+ * uses plateaus: one search grows a tree of shortest paths from the start
+ * cell, and another grows a tree of shortest paths to the end cell along
+ * the graph's edges backwards. Where the two trees share a run of moves,
+ * called a plateau, the route that follows the start tree to the plateau,
+ * along it and then the end tree to the end cell is the shortest route
+ * through every cell of the plateau, so the longer the plateau the more of
+ * the route can't be cut short.
+ *
+ * Both searches stop at cells that can't be on a route within the stretch
+ * of the shortest, which astar's estimate tells, so they cover not many
+ * more cells than one search from each end would. Routes are then chosen
+ * by how little they cost beyond their plateau, and kept if
+ *
+ * - they cost no more than the stretch over the shortest route,
+ * - the part of them that's a shortest path, which runs at least from the
+ *   first to the last of their cells whose costs from the two ends add up
+ *   to their cost, plateau included, covers at least the local share of
+ *   their cost, and
+ * - the moves they share with the routes already kept cost no more than
+ *   the sharing share of the shortest route.
+ *
+ * The shares are percentages. The first route is always the shortest.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#ifndef ALT_ROUTE_H
+#define ALT_ROUTE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "graph.h"
+#include "id_heap.h"
+#include "astar.h"
+
+/**
+ * This is the percentage more than the shortest route an alternative route
+ * can cost by default.
+ */
+#define ALT_ROUTE_DEFAULT_STRETCH 25
+
+/**
+ * This is the percentage of the cost of the shortest route an alternative
+ * route can share with the routes already found by default.
+ */
+#define ALT_ROUTE_DEFAULT_SHARING 60
+
+/**
+ * This is the percentage of an alternative route's cost that must be a
+ * shortest path by default.
+ */
+#define ALT_ROUTE_DEFAULT_LOCAL 25
+
+/**
+ * The data-structure of the alt_route type.
+ */
+typedef struct alt_route_data* alt_route;
+
+/**
+ * This function initialises the alt_route provided to it to find routes
+ * over the graph also provided, with the default percentages.
+ */
+void alt_route_init(alt_route* ap, graph* gp);
+
+/**
+ * This function destroys the alt_route provided to it.
+ */
+void alt_route_free(alt_route* ap);
+
+/**
+ * This function sets the percentage more than the shortest route an
+ * alternative route found by the alt_route provided to it can cost.
+ */
+void alt_route_set_stretch(alt_route* ap, uint32_t percent);
+
+/**
+ * This function sets the percentage of the cost of the shortest route an
+ * alternative route found by the alt_route provided to it can share with
+ * the routes found before it.
+ */
+void alt_route_set_sharing(alt_route* ap, uint32_t percent);
+
+/**
+ * This function sets the percentage of an alternative route's cost that
+ * must be a shortest path, for the alt_route provided to it.
+ */
+void alt_route_set_local(alt_route* ap, uint32_t percent);
+
+/**
+ * This function finds the shortest route from the start cell to the end
+ * cell and up to the number of routes provided to it less one alternative
+ * routes, and returns the number of routes found.
+ */
+uint32_t alt_route_search(alt_route* ap, uint32_t start, uint32_t end,
+                          uint32_t num_routes);
+
+/**
+ * This function returns the number of routes found by alt_route_search().
+ */
+uint32_t alt_route_get_num_routes(alt_route a);
+
+/**
+ * This function returns the ids of the cells that make up the route with
+ * the number provided to it, found by alt_route_search(), from the start
+ * cell to the end cell. Route 0 is the shortest.
+ */
+uint32_t* alt_route_get_path(alt_route a, uint32_t route);
+
+/**
+ * This function returns the number of cells in the route with the number
+ * provided to it, found by alt_route_search().
+ */
+uint32_t alt_route_get_path_size(alt_route a, uint32_t route);
+
+/**
+ * This function returns the cost of the route with the number provided to
+ * it, found by alt_route_search().
+ */
+uint32_t alt_route_get_cost(alt_route a, uint32_t route);
+
+#endif // ALT_ROUTE_H
@@ -287,6 +287,14 @@ void* array_pop_data(array* ap, uint64_t index)
                  * target element.*/
                 *ap = next;
 
+                /* The target may have been the only element in the array.
+                 * If so, initialise the array head again, as
+                 * array_pop_front() does. */
+                if (*ap == NULL && elem == 0)
+                {
+                    array_init(ap);
+                }
+
                 /* End the loop. */
                 size = 0;
             }
@@ -14,6 +14,53 @@
 
 #include "astar.h"
 
+#include <string.h>
+
+/**
+ * This is the number of cells astar_search_id() prefetches unless it's told
+ * otherwise. The benchmark shows no gain from prefetching on graphs whose
+ * search state fits in the cache, so it's off.
+ */
+#define ASTAR_DEFAULT_PREFETCH 0
+
+/**
+ * This is the most cells astar_repair_id()'s local search expands unless
+ * it's told otherwise.
+ */
+#define ASTAR_DEFAULT_REPAIR_LIMIT 4096
+
+/**
+ * This is the number of end cells Adaptive A* keeps learned estimates for
+ * at once. The one used least recently makes way for a new one.
+ */
+#define ASTAR_ADAPTIVE_GOALS 4
+
+/**
+ * This asks the processor to start loading the memory at an address. It does
+ * nothing on compilers that can't ask.
+ */
+#if defined(__GNUC__)
+#define ASTAR_PREFETCH(addr) __builtin_prefetch((addr), 1, 3)
+#else
+#define ASTAR_PREFETCH(addr) ((void) (addr))
+#endif
+
+/**
+ * This is the estimates Adaptive A* has learned of the cost from each cell
+ * to one end cell, for one size of agent.
+ */
+struct astar_goal {
+    uint32_t end;           /* The end cell, or GRAPH_NO_CELL if unused. */
+    uint8_t agent_size;     /* The size of the agent. */
+    uint32_t decreases;     /* The graph's number of decreases when the
+                             * estimates were learned. */
+    uint32_t used;          /* The last search that used the estimates. */
+    uint32_t* h;            /* The learned estimate of each cell. */
+    uint32_t* learned;      /* The stamp of the learning each cell's
+                             * estimate is from. */
+    uint32_t stamp;         /* The stamp of the estimates that hold. */
+};
+
 /** 
  * The internal data-structure of the astar type.
  */
@@ -21,6 +68,69 @@ struct astar_data {
     graph* gp;          // The graph.
     min_heap openset;   // The priority queue
     array path;         // The nodes that make up the shortest path
+
+    /* Whether the graph has only one layer on its z axis, in which case
+     * the searches use the two dimensional heuristics. */
+    bool flat;
+
+    /* This is the state of the search over cell ids. Each array has an
+     * element for every cell id. A cell's g and came_from only belong to the
+     * current search if its visit number is the current search's number, so
+     * nothing has to be reset between searches. */
+    id_heap open;           /* The cells waiting to be expanded, by f. */
+    uint32_t* g;            /* The cost of the path from the start. */
+    uint32_t* came_from;    /* The cell before each cell on its path. */
+    uint32_t* visit;        /* The search each cell was last reached by. */
+    uint32_t search;        /* The number of the current search. */
+
+    /* The ids of the cells on the shortest path found over cell ids. */
+    uint32_t* id_path;
+    uint32_t id_path_size;
+
+    /* The number of cells at the top of the priority queue to prefetch. */
+    uint8_t prefetch;
+
+    /* The end cell of the current search over cell ids, and its
+     * coordinates. */
+    uint32_t end;
+    uint8_t end_x;
+    uint8_t end_y;
+    uint8_t end_z;
+
+    /* The wavefront whose distances are used as the heuristic, if any, and
+     * whether they hold for the current search over cell ids. */
+    wavefront wave;
+    bool use_wave;
+
+    /* The deadend whose pruned regions are left out, if any. */
+    deadend dead;
+
+    /* How many cells wide the agent being searched for is. Cells whose
+     * clearance is less than this are treated as obstacles. */
+    uint8_t agent_size;
+
+    /* Whether searches over cell ids learn better estimates from the
+     * searches before them (Adaptive A*), the estimates learned for each
+     * end cell, and the ones used by the current search, if any. */
+    bool adaptive;
+    struct astar_goal goals[ASTAR_ADAPTIVE_GOALS];
+    struct astar_goal* goal;
+
+    /* The extra obstacles and costs searches over cell ids take into
+     * account, if any. */
+    overlay over;
+
+    /* The movement profile the costs of moves are worked out with, if
+     * any. */
+    profile prof;
+
+    /* The cells expanded by the current search, whose estimates are
+     * learned once it reaches its end cell. */
+    uint32_t* expanded;
+    uint32_t num_expanded;
+
+    /* The most cells astar_repair_id()'s local search expands. */
+    uint32_t repair_limit;
 };
 
 /**
@@ -29,17 +139,108 @@ struct astar_data {
  */
 uint32_t astar_h(node node_a, node node_b, enum graph_style style);
 
+/**
+ * This is astar's heuristic function for graphs with only one layer on
+ * their z axis. It returns the same estimates as astar_h() without looking
+ * at the z axis.
+ */
+uint32_t astar_h_2d(node node_a, node node_b, enum graph_style gstyle);
+
 /**
  * This function reconstructs the shortest path going from the starting node
  * to the goal node that the search procedure found.
  */
 void astar_reconstruct_path(astar* asp, node* start, node* current);
 
+/**
+ * This function starts a new search over cell ids, leaving the state of
+ * every previous search behind.
+ */
+void astar_begin_id_search(astar* asp);
+
+/**
+ * This function reconstructs the path over cell ids that ends at the cell
+ * provided to it.
+ */
+void astar_reconstruct_id_path(astar* asp, uint32_t current);
+
+/**
+ * This function runs a search over cell ids from the start cell to the end
+ * cell, expanding at most the number of cells provided to it, or any number
+ * if it's 0. It returns whether the end cell was reached, in which case the
+ * path to it can be followed back through came_from.
+ */
+bool astar_run_id(astar* asp, uint32_t start, uint32_t end, uint32_t limit);
+
+/**
+ * This function assesses every neighbour the cell provided to it can move
+ * to, during a search over cell ids.
+ */
+void astar_expand_id(astar* asp, uint32_t current);
+
+/**
+ * This function records the path to the neighbour provided to it through the
+ * current cell, if it's better than any path the search has found to it
+ * before, and queues the neighbour.
+ */
+void astar_relax_id(astar* asp, uint32_t current, uint32_t neighbour, 
+                    uint32_t w);
+
+/**
+ * This function returns the estimated cost from the cell provided to it to
+ * the end cell of the current search over cell ids. If the astar has a
+ * wavefront that was run to the end cell, the estimate is the wavefront's
+ * distance, which is WAVEFRONT_UNREACHABLE if the cell can't reach the end.
+ */
+uint32_t astar_h_id(astar* asp, uint32_t id);
+
+/**
+ * This function returns the estimated cost from the coordinates of the cell
+ * provided to it to the end cell of the current search over cell ids.
+ */
+uint32_t astar_estimate_id(astar* asp, uint32_t id);
+
+/**
+ * This function returns astar's estimate of the cost between two cells of a
+ * graph with only one layer on its z axis, from their x and y coordinates.
+ */
+uint32_t astar_estimate_2d(enum graph_style gstyle, 
+                           uint8_t ax, uint8_t ay, uint8_t bx, uint8_t by);
+
+/**
+ * This function returns the position of the lowest set bit of the mask
+ * provided to it, which must not be 0.
+ */
+uint8_t astar_lowest_bit(uint32_t mask);
+
+/**
+ * This function finds the learned estimates for the end cell provided to
+ * it, forgetting them if the graph may have become cheaper to move through
+ * since they were learned, or makes way for them if there are none.
+ */
+void astar_find_goal(astar* asp, uint32_t end);
+
+/**
+ * This function learns the estimate of every cell the current search
+ * expanded from the cost of its path to the end cell, which it has just
+ * reached.
+ */
+void astar_learn(astar* asp, uint32_t end);
+
+/**
+ * This function returns whether searches over cell ids by the astar
+ * provided to it move at the graph's own costs, with no overlay or movement
+ * profile.
+ */
+bool astar_uses_graph_costs(astar* asp);
+
 /**
  * This function intialises the astar provided to it.
  */
 void astar_init(astar* asp, graph* gp)
 {
+    uint8_t i;  /* The index of the current goal. */
+
     /* Allocate memory to the astar. */
     *asp = (astar) malloc(sizeof(struct astar_data));
 
@@ -47,6 +248,41 @@ void astar_init(astar* asp, graph* gp)
     (*asp)->gp = gp;
     min_heap_init(&(*asp)->openset);
     array_init(&(*asp)->path);
+
+    /* Initialise the state of the search over cell ids. */
+    id_heap_init(&(*asp)->open, graph_get_cell_count(*gp));
+    (*asp)->g = (uint32_t*) malloc(
+            sizeof(uint32_t) * graph_get_cell_count(*gp));
+    (*asp)->came_from = (uint32_t*) malloc(
+            sizeof(uint32_t) * graph_get_cell_count(*gp));
+    (*asp)->visit = (uint32_t*) calloc(
+            graph_get_cell_count(*gp), sizeof(uint32_t));
+    (*asp)->search = 0;
+    (*asp)->id_path = (uint32_t*) malloc(
+            sizeof(uint32_t) * graph_get_cell_count(*gp));
+    (*asp)->id_path_size = 0;
+    (*asp)->prefetch = ASTAR_DEFAULT_PREFETCH;
+    (*asp)->wave = NULL;
+    (*asp)->use_wave = false;
+    (*asp)->dead = NULL;
+    (*asp)->agent_size = 1;
+    (*asp)->adaptive = false;
+    for (i = 0; i < ASTAR_ADAPTIVE_GOALS; i++)
+    {
+        (*asp)->goals[i].end = GRAPH_NO_CELL;
+        (*asp)->goals[i].used = 0;
+        (*asp)->goals[i].h = NULL;
+        (*asp)->goals[i].learned = NULL;
+    }
+    (*asp)->goal = NULL;
+    (*asp)->over = NULL;
+    (*asp)->prof = NULL;
+    (*asp)->expanded = NULL;
+    (*asp)->num_expanded = 0;
+    (*asp)->repair_limit = ASTAR_DEFAULT_REPAIR_LIMIT;
+
+    /* Use the two dimensional heuristics if the graph is flat. */
+    (*asp)->flat = graph_get_z_size(*gp) == 1;
 }
 
 /**
@@ -54,9 +290,22 @@ void astar_init(astar* asp, graph* gp)
  */ 
 void astar_free(astar* asp)
 {
+    uint8_t i;  /* The index of the current goal. */
+
     /* Destroy the astar's internal properties. */
     min_heap_free(&(*asp)->openset);
     array_free(&(*asp)->path);
+    id_heap_free(&(*asp)->open);
+    free((*asp)->g);
+    free((*asp)->came_from);
+    free((*asp)->visit);
+    free((*asp)->id_path);
+    free((*asp)->expanded);
+    for (i = 0; i < ASTAR_ADAPTIVE_GOALS; i++)
+    {
+        free((*asp)->goals[i].h);
+        free((*asp)->goals[i].learned);
+    }
 
     /* De-allocate memory from the astar. */
     free(*asp);
@@ -163,8 +412,18 @@ void astar_search(astar* asp, node* start, node* end)
 
                     /* Set the estimation for total cost of the path if it
                      * goes through the neighbour. */
-                    node_set_f(neighbour, next_g + astar_h(*neighbour, *end, 
-                                            graph_get_style(*(*asp)->gp)));
+                    if ((*asp)->flat)
+                    {
+                        node_set_f(neighbour, next_g + astar_h_2d(
+                                *neighbour, *end, 
+                                graph_get_style(*(*asp)->gp)));
+                    }
+                    else
+                    {
+                        node_set_f(neighbour, next_g + astar_h(
+                                *neighbour, *end, 
+                                graph_get_style(*(*asp)->gp)));
+                    }
 
                     /* Check if the neighbour is not already in the priority
                      * queue. */
@@ -179,6 +438,804 @@ void astar_search(astar* asp, node* start, node* end)
     }
 }
 
+/**
+ * This is the A* search algorithm working on cell ids instead of nodes. It
+ * searches for the shortest path from the start cell to the end cell using
+ * the graph's index of edges and keeps its own search state, so it doesn't
+ * change the graph's nodes and doesn't need to reset the whole graph.
+ */
+void astar_search_id(astar* asp, uint32_t start, uint32_t end)
+{
+    /* Make sure the graph's index of edges is up to date. */
+    graph_update_index((*asp)->gp);
+
+    /* Search the graph and reconstruct the shortest path if there is one. */
+    if (astar_run_id(asp, start, end, 0))
+    {
+        astar_reconstruct_id_path(asp, end);
+    }
+}
+
+/**
+ * This function repairs the path over cell ids provided to it after the
+ * cells also provided to it have changed. It finds the first and last cells
+ * on the path that changed and searches again only between the cells just
+ * before and just after them, splicing the detour it finds into the rest of
+ * the path, which is kept. The path can be the astar's own id path. The
+ * repaired path can then be got with astar_get_id_path(). It isn't always
+ * the shortest path, as only the detour is searched for. If the local
+ * search can't find a detour within its limit, the whole path is searched
+ * for again.
+ */
+void astar_repair_id(astar* asp, const uint32_t* path, uint32_t path_size,
+                     const uint32_t* changed, uint32_t num_changed)
+{
+    uint32_t start;     /* The start cell of the path. */
+    uint32_t end;       /* The end cell of the path. */
+    uint32_t first;     /* The position of the first changed cell. */
+    uint32_t last;      /* The position of the last changed cell. */
+    uint32_t detour;    /* The number of cells of the detour. */
+    uint32_t size;      /* The number of cells of the repaired path. */
+    uint32_t current;   /* The current cell of the detour. */
+    uint32_t i;         /* The index of the current cell. */
+
+    /* There's nothing to repair on an empty path. */
+    if (path_size == 0)
+    {
+        (*asp)->id_path_size = 0;
+        return;
+    }
+
+    /* Make sure the graph's index of edges is up to date. */
+    graph_update_index((*asp)->gp);
+    start = path[0];
+    end = path[path_size - 1];
+
+    /* Mark the changed cells with a new search number, so each cell of the
+     * path can be checked in constant time. */
+    astar_begin_id_search(asp);
+    for (i = 0; i < num_changed; i++)
+    {
+        (*asp)->visit[changed[i]] = (*asp)->search;
+    }
+
+    /* Find the first and last cells of the path that changed. */
+    first = path_size;
+    last = 0;
+    for (i = 0; i < path_size; i++)
+    {
+        if ((*asp)->visit[path[i]] == (*asp)->search)
+        {
+            if (first == path_size)
+            {
+                first = i;
+            }
+            last = i;
+        }
+    }
+
+    /* Keep the path as it is if none of it changed. */
+    if (first == path_size)
+    {
+        if (path != (*asp)->id_path)
+        {
+            memcpy((*asp)->id_path, path, sizeof(uint32_t) * path_size);
+        }
+        (*asp)->id_path_size = path_size;
+        return;
+    }
+
+    /* Search between the cells either side of the changed ones. */
+    first = first > 0 ? first - 1 : 0;
+    last = last < path_size - 1 ? last + 1 : path_size - 1;
+    if (!astar_run_id(asp, path[first], path[last], (*asp)->repair_limit))
+    {
+        astar_search_id(asp, start, end);
+        return;
+    }
+
+    /* Measure the detour, and search the whole path again if the repaired
+     * path wouldn't fit. */
+    detour = 0;
+    for (current = path[last]; current != GRAPH_NO_CELL;
+         current = (*asp)->came_from[current])
+    {
+        detour++;
+    }
+    size = first + detour + (path_size - last - 1);
+    if (size > graph_get_cell_count(*(*asp)->gp))
+    {
+        astar_search_id(asp, start, end);
+        return;
+    }
+
+    /* Put the unchanged start and end of the path in place, moving the end
+     * first in case the path is the astar's own. Then fill the detour in
+     * between from its end back. */
+    if (path != (*asp)->id_path)
+    {
+        memcpy((*asp)->id_path, path, sizeof(uint32_t) * first);
+    }
+    memmove(&(*asp)->id_path[first + detour], &path[last + 1],
+            sizeof(uint32_t) * (path_size - last - 1));
+    i = first + detour;
+    for (current = path[last]; current != GRAPH_NO_CELL;
+         current = (*asp)->came_from[current])
+    {
+        i--;
+        (*asp)->id_path[i] = current;
+    }
+    (*asp)->id_path_size = size;
+}
+
+/**
+ * This function sets the most cells astar_repair_id()'s local search
+ * expands before it gives up and searches for the whole path again. 0 lets
+ * it expand any number.
+ */
+void astar_set_repair_limit(astar* asp, uint32_t limit)
+{
+    (*asp)->repair_limit = limit;
+}
+
+/**
+ * This function runs a search over cell ids from the start cell to the end
+ * cell, expanding at most the number of cells provided to it, or any number
+ * if it's 0. It returns whether the end cell was reached, in which case the
+ * path to it can be followed back through came_from.
+ */
+bool astar_run_id(astar* asp, uint32_t start, uint32_t end, uint32_t limit)
+{
+    graph g;            /* The graph. */
+    uint32_t current;   /* The current cell on the path. */
+    uint32_t next;      /* A cell that's likely to be expanded soon. */
+    uint32_t i;         /* The position of that cell in the queue. */
+    uint32_t expanded;  /* The number of cells expanded. */
+
+    /* Start a new search towards the end cell. */
+    g = *(*asp)->gp;
+    astar_begin_id_search(asp);
+    (*asp)->end = end;
+    graph_get_cell_coords(g, end, &(*asp)->end_x, &(*asp)->end_y, 
+                                  &(*asp)->end_z);
+    expanded = 0;
+
+    /* The wavefront only read the types of the cells, so its distances only
+     * hold if every edge is a grid move and nothing has made the graph
+     * cheaper to move through since it was run. */
+    (*asp)->use_wave = (*asp)->wave != NULL 
+                    && wavefront_get_goal((*asp)->wave) == end
+                    && graph_is_unit_grid(g) 
+                    && wavefront_is_current((*asp)->wave);
+    if ((*asp)->dead != NULL && (*asp)->agent_size == 1 
+        && astar_uses_graph_costs(asp))
+    {
+        deadend_begin_search(&(*asp)->dead, start, end);
+    }
+    (*asp)->goal = NULL;
+    if ((*asp)->adaptive)
+    {
+        astar_find_goal(asp, end);
+    }
+
+    /* There's no path if the agent doesn't fit on the start cell, just as
+     * neighbours it doesn't fit on are skipped. */
+    if ((*asp)->agent_size > 1 
+        && graph_get_clearance(g, start) < (*asp)->agent_size)
+    {
+        return false;
+    }
+
+    /* Add the start cell to the priority queue. */
+    (*asp)->visit[start] = (*asp)->search;
+    (*asp)->g[start] = 0;
+    (*asp)->came_from[start] = GRAPH_NO_CELL;
+    id_heap_push(&(*asp)->open, start, astar_estimate(g, start, end));
+
+    /* Search the graph. */
+    while (!id_heap_is_empty((*asp)->open))
+    {
+        /* Get the cell with the lowest estimated total cost. */
+        current = id_heap_pop_min(&(*asp)->open);
+
+        /* Start loading the passability masks or edges and the search state
+         * of the cells that are likely to be expanded next, while this one
+         * is expanded. */
+        for (i = 0; i < (*asp)->prefetch 
+                    && i < id_heap_size((*asp)->open); i++)
+        {
+            next = id_heap_get_at((*asp)->open, i);
+            graph_prefetch_cell(g, next);
+            ASTAR_PREFETCH(&(*asp)->visit[next]);
+            ASTAR_PREFETCH(&(*asp)->g[next]);
+        }
+
+        /* Check if the path has reached the end cell, and learn from the
+         * search if it's adaptive. */
+        if (current == end)
+        {
+            if ((*asp)->goal != NULL && astar_uses_graph_costs(asp))
+            {
+                astar_learn(asp, end);
+            }
+            return true;
+        }
+
+        /* Give up once the search has expanded as many cells as it may. */
+        expanded++;
+        if (limit != 0 && expanded > limit)
+        {
+            return false;
+        }
+
+        /* Note the cell as expanded if the search learns from it. A cell
+         * is only expanded again if a learned estimate was too low to be
+         * consistent, so the list can't run out unless that happens. */
+        if ((*asp)->goal != NULL && astar_uses_graph_costs(asp)
+            && (*asp)->num_expanded < graph_get_cell_count(g))
+        {
+            (*asp)->expanded[(*asp)->num_expanded] = current;
+            (*asp)->num_expanded++;
+        }
+
+        /* Assess the neighbours of the current cell. */
+        astar_expand_id(asp, current);
+    }
+    return false;
+}
+
+/**
+ * This function assesses every neighbour the cell provided to it can move
+ * to, during a search over cell ids.
+ */
+void astar_expand_id(astar* asp, uint32_t current)
+{
+    graph g;            /* The graph. */
+    uint32_t mask;      /* The directions of the passable neighbours. */
+    uint32_t e;         /* The edge leading to the neighbour. */
+    uint32_t last;      /* The end of the current cell's edges. */
+    uint8_t dir;        /* The direction of the neighbour. */
+    uint8_t w;          /* The cost of moving to the neighbour. */
+
+    /* Get the graph. */
+    g = *(*asp)->gp;
+
+    /* Check if the passability mask describes all of the cell's edges. */
+    if (graph_is_unit_grid(g))
+    {
+        /* Visit the neighbour in each direction whose bit is set. Every one
+         * of them costs 1 to move to. */
+        mask = graph_get_pass_mask(g, current);
+        while (mask != 0)
+        {
+            dir = astar_lowest_bit(mask);
+            mask &= mask - 1;
+            astar_relax_id(asp, current, 
+                           graph_get_neighbour_id(g, current, dir), 1);
+        }
+    }
+    else
+    {
+        /* Assess the edges leaving the current cell. */
+        last = graph_get_first_edge(g, current + 1);
+        for (e = graph_get_first_edge(g, current); e < last; e++)
+        {
+            /* Skip moves that aren't possible. */
+            w = graph_get_edge_w(g, e);
+            if (w != 0)
+            {
+                astar_relax_id(asp, current, graph_get_edge_to(g, e), w);
+            }
+        }
+    }
+}
+
+/**
+ * This function records the path to the neighbour provided to it through the
+ * current cell, if it's better than any path the search has found to it
+ * before, and queues the neighbour.
+ */
+void astar_relax_id(astar* asp, uint32_t current, uint32_t neighbour, 
+                    uint32_t w)
+{
+    uint32_t next_g;    /* Cost from start to neighbour through the current cell. */
+    uint32_t h;         /* The estimated cost from the neighbour to the end. */
+
+    /* Work out the cost of the move for the agent's movement profile. */
+    if ((*asp)->prof != NULL)
+    {
+        w = profile_get_cost((*asp)->prof, *(*asp)->gp, current, neighbour,
+                             w);
+        if (w == 0)
+        {
+            return;
+        }
+    }
+
+    /* Take the overlay's obstacles and extra costs into account. */
+    if ((*asp)->over != NULL)
+    {
+        w = overlay_get_cost((*asp)->over, neighbour, w);
+        if (w == 0)
+        {
+            return;
+        }
+    }
+
+    /* Measure the cost of the path to the neighbour. */
+    next_g = (*asp)->g[current] + w;
+
+    /* Check if the path to the neighbour is better than any previous path
+     * this search found. */
+    if ((*asp)->visit[neighbour] != (*asp)->search 
+        || next_g < (*asp)->g[neighbour])
+    {
+        /* Skip the neighbour if the agent doesn't fit there. Clearance
+         * comes from the cells' types, so an agent one cell wide goes by
+         * the edges' weights alone, which can disagree with the types. */
+        if ((*asp)->agent_size > 1 
+            && graph_get_clearance(*(*asp)->gp, neighbour) 
+               < (*asp)->agent_size)
+        {
+            return;
+        }
+
+        /* Skip the neighbour if it's in a region no shortest path has to
+         * go through. The regions were only tested for agents one cell
+         * wide on the graph as it is. */
+        if ((*asp)->dead != NULL && (*asp)->agent_size == 1
+            && astar_uses_graph_costs(asp)
+            && deadend_is_skipped((*asp)->dead, neighbour))
+        {
+            return;
+        }
+
+        /* Skip the neighbour if it's known that it can't reach the end. */
+        h = astar_h_id(asp, neighbour);
+        if (h == WAVEFRONT_UNREACHABLE)
+        {
+            return;
+        }
+
+        /* Record the better path to the neighbour. */
+        (*asp)->visit[neighbour] = (*asp)->search;
+        (*asp)->g[neighbour] = next_g;
+        (*asp)->came_from[neighbour] = current;
+
+        /* Queue the neighbour by the estimated total cost of a path through
+         * it. */
+        id_heap_push(&(*asp)->open, neighbour, next_g + h);
+    }
+}
+
+/**
+ * This function returns the estimated cost from the cell provided to it to
+ * the end cell of the current search over cell ids. If the astar has a
+ * wavefront that was run to the end cell, the estimate is the wavefront's
+ * distance, which is WAVEFRONT_UNREACHABLE if the cell can't reach the end.
+ */
+uint32_t astar_h_id(astar* asp, uint32_t id)
+{
+    uint32_t h;         /* The estimate. */
+
+    /* Use the wavefront's distance if it measured distances to the end and
+     * they still hold, or otherwise estimate the cost from the
+     * coordinates. */
+    if ((*asp)->use_wave)
+    {
+        h = wavefront_get_distance((*asp)->wave, id);
+        if (h == WAVEFRONT_UNREACHABLE)
+        {
+            return h;
+        }
+    }
+    else
+    {
+        h = astar_estimate_id(asp, id);
+    }
+
+    /* Scale the estimate by the movement profile's cheapest move. */
+    if ((*asp)->prof != NULL)
+    {
+        h *= profile_get_min_multiplier((*asp)->prof);
+    }
+
+    /* Use the estimate learned by an earlier search instead if it's
+     * higher. */
+    if ((*asp)->goal != NULL 
+        && (*asp)->goal->learned[id] == (*asp)->goal->stamp
+        && (*asp)->goal->h[id] > h)
+    {
+        h = (*asp)->goal->h[id];
+    }
+    return h;
+}
+
+/**
+ * This function returns the estimated cost from the coordinates of the cell
+ * provided to it to the end cell of the current search over cell ids.
+ */
+uint32_t astar_estimate_id(astar* asp, uint32_t id)
+{
+    uint8_t x, y, z;    /* The cell's coordinates. */
+
+    /* Only the x and y axes are needed on a flat graph. */
+    if ((*asp)->flat)
+    {
+        graph_get_cell_coords_2d(*(*asp)->gp, id, &x, &y);
+        return astar_estimate_2d(graph_get_style(*(*asp)->gp), x, y,
+                                 (*asp)->end_x, (*asp)->end_y);
+    }
+    graph_get_cell_coords(*(*asp)->gp, id, &x, &y, &z);
+    return astar_estimate_coords(graph_get_style(*(*asp)->gp), x, y, z, 
+                                 (*asp)->end_x, (*asp)->end_y, 
+                                 (*asp)->end_z);
+}
+
+/**
+ * This function returns the position of the lowest set bit of the mask
+ * provided to it, which must not be 0.
+ */
+uint8_t astar_lowest_bit(uint32_t mask)
+{
+#if defined(__GNUC__)
+    return (uint8_t) __builtin_ctz(mask);
+#else
+    uint8_t bit;    /* The position of the current bit. */
+
+    /* Find the first set bit. */
+    for (bit = 0; !(mask & 1); bit++)
+    {
+        mask >>= 1;
+    }
+    return bit;
+#endif
+}
+
+/**
+ * This function returns the ids of the cells that make up the shortest path
+ * found by astar_search_id(), from the start cell to the end cell.
+ */
+uint32_t* astar_get_id_path(astar as)
+{
+    return as->id_path;
+}
+
+/**
+ * This function returns the number of cells in the path found by
+ * astar_search_id(). It is 0 if no path was found.
+ */
+uint32_t astar_get_id_path_size(astar as)
+{
+    return as->id_path_size;
+}
+
+/**
+ * This function sets how many of the cells at the top of the priority queue
+ * astar_search_id() prefetches while it expands the current cell. The
+ * prefetched cells are the ones most likely to be expanded next, so their
+ * edges and search state are already in the cache when they are. 0 turns
+ * prefetching off.
+ *
+ * Prefetching is experimental. It has only shown a gain, of under 10%
+ * at a distance of 1, on graphs of millions of cells with weighted edges,
+ * whose search state is far bigger than the cache, and it's slower at
+ * longer distances or on graphs that fit in the cache.
+ */
+void astar_set_prefetch(astar* asp, uint8_t distance)
+{
+    (*asp)->prefetch = distance;
+}
+
+/**
+ * This function gives the astar provided to it a wavefront whose distances
+ * astar_search_id() uses as its heuristic when the search's end cell is the
+ * wavefront's goal. The distances are exact on a grid whose moves all cost
+ * 1, so the search only expands cells on shortest paths. They're only
+ * used while graph_is_unit_grid() holds and wavefront_is_current() says
+ * nothing has made the graph cheaper since the wavefront was run, as the
+ * wavefront doesn't see added edges. NULL stops the astar using a
+ * wavefront.
+ */
+void astar_set_wavefront(astar* asp, wavefront w)
+{
+    (*asp)->wave = w;
+}
+
+/**
+ * This function gives the astar provided to it a deadend whose pruned
+ * regions astar_search_id() leaves out, apart from the ones it has to go
+ * through because its start or end cell is in them. The paths it finds are
+ * just as short. NULL stops the astar using a deadend.
+ */
+void astar_set_deadend(astar* asp, deadend d)
+{
+    (*asp)->dead = d;
+}
+
+/**
+ * This function sets how many cells wide the agent astar_search_id() and
+ * astar_repair_id() search for is. The agent fills a cube of cells that
+ * size with its lowest corner on the cell it's at, so cells whose clearance
+ * is less than the size are treated as obstacles, there's no path from a
+ * start cell the agent doesn't fit on, and one graph serves agents of
+ * every size. Agents one cell wide, which is the size the astar
+ * starts with, go by the weights of the edges alone, as clearance comes
+ * from the cells' types. A deadend is only used for them.
+ */
+void astar_set_agent_size(astar* asp, uint8_t size)
+{
+    (*asp)->agent_size = size;
+}
+
+/**
+ * This function turns Adaptive A* on or off for the astar provided to it.
+ * Once a search over cell ids reaches its end cell, every cell it expanded
+ * learns the cost of the path found less the cost of its own path from the
+ * start as its estimate of the cost to that end. Later searches to the same
+ * end, from anywhere, use the learned estimates where they're higher, so
+ * they expand fewer cells while still finding shortest paths. Estimates are
+ * kept for a few end cells and each size of agent at once, and are
+ * forgotten once the graph may have become cheaper to move through, as
+ * counted by graph_get_num_decreases(). Making moves dearer keeps them.
+ */
+void astar_set_adaptive(astar* asp, bool adaptive)
+{
+    (*asp)->adaptive = adaptive;
+}
+
+/**
+ * This function gives the astar provided to it an overlay of extra
+ * obstacles and costs that astar_search_id() and astar_repair_id() take
+ * into account as they expand each cell, without the graph being changed.
+ * Searches only read the graph and the overlay, so each thread can search
+ * the same graph with its own astar and overlay. A deadend isn't used
+ * while there's an overlay, and Adaptive A* uses what it has learned but
+ * doesn't learn from searches with one. NULL stops the astar using an
+ * overlay.
+ */
+void astar_set_overlay(astar* asp, overlay o)
+{
+    (*asp)->over = o;
+}
+
+/**
+ * This function gives the astar provided to it a movement profile that
+ * astar_search_id() and astar_repair_id() work out the cost of each move
+ * with, from the terrain class of the cell it goes into, as they expand
+ * each cell. The estimates are scaled by the profile's lowest multiplier,
+ * so the paths are still the shortest for the profile. As with an overlay,
+ * a deadend isn't used and Adaptive A* doesn't learn from the searches.
+ * NULL stops the astar using a profile.
+ */
+void astar_set_profile(astar* asp, profile p)
+{
+    (*asp)->prof = p;
+}
+
+/**
+ * This function returns whether searches over cell ids by the astar
+ * provided to it move at the graph's own costs, with no overlay or movement
+ * profile.
+ */
+bool astar_uses_graph_costs(astar* asp)
+{
+    return (*asp)->over == NULL && (*asp)->prof == NULL;
+}
+
+/**
+ * This function finds the learned estimates for the end cell provided to
+ * it, forgetting them if the graph may have become cheaper to move through
+ * since they were learned, or makes way for them if there are none.
+ */
+void astar_find_goal(astar* asp, uint32_t end)
+{
+    struct astar_goal* goal;    /* The current goal. */
+    uint32_t count;             /* The number of cell ids. */
+    uint8_t i;                  /* The index of the current goal. */
+
+    /* Look for the estimates of the end cell for this size of agent, noting
+     * the ones used least recently in case there aren't any. */
+    (*asp)->goal = &(*asp)->goals[0];
+    for (i = 0; i < ASTAR_ADAPTIVE_GOALS; i++)
+    {
+        goal = &(*asp)->goals[i];
+        if (goal->end == end && goal->agent_size == (*asp)->agent_size)
+        {
+            (*asp)->goal = goal;
+            break;
+        }
+        if (goal->used < (*asp)->goal->used)
+        {
+            (*asp)->goal = goal;
+        }
+    }
+    goal = (*asp)->goal;
+
+    /* Allocate memory to the estimates the first time they're used. */
+    count = graph_get_cell_count(*(*asp)->gp);
+    if (goal->h == NULL)
+    {
+        goal->h = (uint32_t*) malloc(sizeof(uint32_t) * count);
+        goal->learned = (uint32_t*) calloc(count, sizeof(uint32_t));
+        goal->stamp = 0;
+    }
+    if ((*asp)->expanded == NULL)
+    {
+        (*asp)->expanded = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    }
+
+    /* Forget every estimate if they're for another end cell or the graph
+     * may have become cheaper since they were learned, by moving on to a
+     * new stamp. */
+    if (goal->end != end || goal->agent_size != (*asp)->agent_size
+        || goal->decreases != graph_get_num_decreases(*(*asp)->gp))
+    {
+        goal->end = end;
+        goal->agent_size = (*asp)->agent_size;
+        goal->decreases = graph_get_num_decreases(*(*asp)->gp);
+        goal->stamp++;
+        if (goal->stamp == 0)
+        {
+            memset(goal->learned, 0, sizeof(uint32_t) * count);
+            goal->stamp = 1;
+        }
+    }
+    goal->used = (*asp)->search;
+    (*asp)->num_expanded = 0;
+}
+
+/**
+ * This function learns the estimate of every cell the current search
+ * expanded from the cost of its path to the end cell, which it has just
+ * reached.
+ */
+void astar_learn(astar* asp, uint32_t end)
+{
+    struct astar_goal* goal;    /* The goal being learned. */
+    uint32_t cell;              /* The current expanded cell. */
+    uint32_t i;                 /* The index of the current cell. */
+
+    /* The cost from an expanded cell to the end is at least the cost of the
+     * path to the end less the cost of the cell's own path. */
+    goal = (*asp)->goal;
+    for (i = 0; i < (*asp)->num_expanded; i++)
+    {
+        cell = (*asp)->expanded[i];
+        if ((*asp)->g[cell] <= (*asp)->g[end])
+        {
+            goal->h[cell] = (*asp)->g[end] - (*asp)->g[cell];
+            goal->learned[cell] = goal->stamp;
+        }
+    }
+    (*asp)->num_expanded = 0;
+}
+
+/**
+ * This function returns astar's estimate of the cost of the cheapest path
+ * between the cells with the ids provided to it in the graph also provided
+ * to the function. It never overestimates on the graph's own grid, so other
+ * searches over cell ids can use it as well.
+ */
+uint32_t astar_estimate(graph g, uint32_t a, uint32_t b)
+{
+    uint8_t ax, ay, az; /* The first cell's coordinates. */
+    uint8_t bx, by, bz; /* The second cell's coordinates. */
+
+    /* Only the x and y axes are needed on a flat graph. */
+    if (graph_get_z_size(g) == 1)
+    {
+        graph_get_cell_coords_2d(g, a, &ax, &ay);
+        graph_get_cell_coords_2d(g, b, &bx, &by);
+        return astar_estimate_2d(graph_get_style(g), ax, ay, bx, by);
+    }
+
+    /* Get the coordinates of both cells and estimate from them. */
+    graph_get_cell_coords(g, a, &ax, &ay, &az);
+    graph_get_cell_coords(g, b, &bx, &by, &bz);
+    return astar_estimate_coords(graph_get_style(g), 
+                                 ax, ay, az, bx, by, bz);
+}
+
+/**
+ * This function returns astar's estimate of the cost between two cells from
+ * their coordinates.
+ */
+uint32_t astar_estimate_coords(enum graph_style gstyle,
+                               uint8_t ax, uint8_t ay, uint8_t az,
+                               uint8_t bx, uint8_t by, uint8_t bz)
+{
+    uint32_t dx;    /* The absolute difference of the x axes. */
+    uint32_t dy;    /* The absolute difference of the y axes. */
+    uint32_t dz;    /* The absolute difference of the z axes. */
+    uint32_t max;   /* The maximum absolute difference of the axes. */
+
+    /* Calculate the absolute differences of each axis. */
+    dx = ax > bx ? ax - bx : bx - ax;
+    dy = ay > by ? ay - by : by - ay;
+    dz = az > bz ? az - bz : bz - az;
+
+    /* Calculate the estimated cost the same way astar_h() does. */
+    if (gstyle == MANHATTAN)
+    {
+        return dx + dy + dz;
+    }
+    max = dx > dy ? dx : dy;
+    return max > dz ? max : dz;
+}
+
+/**
+ * This function returns astar's estimate of the cost between two cells of a
+ * graph with only one layer on its z axis, from their x and y coordinates.
+ */
+uint32_t astar_estimate_2d(enum graph_style gstyle, 
+                           uint8_t ax, uint8_t ay, uint8_t bx, uint8_t by)
+{
+    uint32_t dx;    /* The absolute difference of the x axes. */
+    uint32_t dy;    /* The absolute difference of the y axes. */
+
+    /* Calculate the absolute differences of the x and y axes. */
+    dx = ax > bx ? ax - bx : bx - ax;
+    dy = ay > by ? ay - by : by - ay;
+
+    /* Calculate the estimated cost the same way astar_h_2d() does. */
+    if (gstyle == MANHATTAN)
+    {
+        return dx + dy;
+    }
+    return dx > dy ? dx : dy;
+}
+
+/**
+ * This function starts a new search over cell ids, leaving the state of
+ * every previous search behind.
+ */
+void astar_begin_id_search(astar* asp)
+{
+    /* Move on to the next search number. If the numbers have run out, forget
+     * every cell's visit number and start counting again. */
+    (*asp)->search++;
+    if ((*asp)->search == 0)
+    {
+        memset((*asp)->visit, 0, 
+               sizeof(uint32_t) * graph_get_cell_count(*(*asp)->gp));
+        (*asp)->search = 1;
+    }
+
+    /* Empty the priority queue and the path. */
+    id_heap_clear(&(*asp)->open);
+    (*asp)->id_path_size = 0;
+}
+
+/**
+ * This function reconstructs the path over cell ids that ends at the cell
+ * provided to it.
+ */
+void astar_reconstruct_id_path(astar* asp, uint32_t current)
+{
+    uint32_t size;  /* The number of cells on the path. */
+    uint32_t i;     /* The index of the current cell on the path. */
+    uint32_t temp;  /* A cell being swapped. */
+
+    /* Follow the path back from its end to its start. */
+    size = 0;
+    while (current != GRAPH_NO_CELL)
+    {
+        (*asp)->id_path[size] = current;
+        size++;
+        current = (*asp)->came_from[current];
+    }
+
+    /* Put the path in order from its start to its end. */
+    for (i = 0; i < size / 2; i++)
+    {
+        temp = (*asp)->id_path[i];
+        (*asp)->id_path[i] = (*asp)->id_path[size - 1 - i];
+        (*asp)->id_path[size - 1 - i] = temp;
+    }
+    (*asp)->id_path_size = size;
+}
+
 /**
  * This is astar's heuristic function. This function returns an estimate of
  * the distance between two graph-nodes.
@@ -189,7 +1246,7 @@ uint32_t astar_h(node node_a, node node_b, enum graph_style gstyle)
     uint8_t dx;     /* The absolute difference of the x axes. */
     uint8_t dy;     /* The absolute difference of the y axes. */
     uint8_t dz;     /* The absolute difference of the z axes. */
-    uint8_t min;    /* The minimum absolute difference out of all the axes. */
+    uint8_t max;    /* The maximum absolute difference out of all the axes. */
 	
     /* Calculate the absolute differences of each axis of the two nodes. */
     dx = abs(node_get_x(node_a) - node_get_x(node_b));
@@ -201,16 +1258,40 @@ uint32_t astar_h(node node_a, node node_b, enum graph_style gstyle)
     {
         cost = (uint64_t) (dx + dy + dz); 
     } 
-    else if (gstyle == DIAGONAL)
+    else
     {
-        min = dx < dy ? dx : dy;
-        min = min < dz ? min : dz;
-        cost = (dx + dy + dz) + (1 - 3) * min;
+        /* Every move, diagonal or not, costs the same, so the cost is the
+         * number of moves along the longest axis. */
+        max = dx > dy ? dx : dy;
+        max = max > dz ? max : dz;
+        cost = (uint64_t) max;
     }
 
     /* Return the estimated cost. */
     return cost;
 }
+
+/**
+ * This is astar's heuristic function for graphs with only one layer on
+ * their z axis. It returns the same estimates as astar_h() without looking
+ * at the z axis.
+ */
+uint32_t astar_h_2d(node node_a, node node_b, enum graph_style gstyle)
+{
+    uint8_t dx;     /* The absolute difference of the x axes. */
+    uint8_t dy;     /* The absolute difference of the y axes. */
+
+    /* Calculate the absolute differences of the x and y axes. */
+    dx = abs(node_get_x(node_a) - node_get_x(node_b));
+    dy = abs(node_get_y(node_a) - node_get_y(node_b));
+
+    /* Return the estimated cost with consideration towards the graph type. */
+    if (gstyle == MANHATTAN)
+    {
+        return (uint32_t) dx + dy;
+    }
+    return dx > dy ? dx : dy;
+}
 /**
  * This function reconstructs the shortest path going from the starting node
  * to the goal node that was found by the search function.
@@ -24,6 +24,11 @@
 #include "node.h"
 #include "graph.h"
 #include "min_heap.h"
+#include "id_heap.h"
+#include "wavefront.h"
+#include "deadend.h"
+#include "overlay.h"
+#include "profile.h"
 
 /**
  * The data-structure of the astar type.
@@ -59,4 +64,144 @@ void astar_reset(astar* asp);
  */
 void astar_search(astar* asp, node* start, node* end);
 
+/**
+ * This is the A* search algorithm working on cell ids instead of nodes. It
+ * searches for the shortest path from the start cell to the end cell using
+ * the graph's index of edges and keeps its own search state, so it doesn't
+ * change the graph's nodes and doesn't need to reset the whole graph.
+ * That state takes 24 bytes for every cell id, for each astar.
+ */
+void astar_search_id(astar* asp, uint32_t start, uint32_t end);
+
+/**
+ * This function repairs the path over cell ids provided to it after the
+ * cells also provided to it have changed. It finds the first and last cells
+ * on the path that changed and searches again only between the cells just
+ * before and just after them, splicing the detour it finds into the rest of
+ * the path, which is kept. The path can be the astar's own id path. The
+ * repaired path can then be got with astar_get_id_path(). It isn't always
+ * the shortest path, as only the detour is searched for. If the local
+ * search can't find a detour within its limit, the whole path is searched
+ * for again.
+ */
+void astar_repair_id(astar* asp, const uint32_t* path, uint32_t path_size,
+                     const uint32_t* changed, uint32_t num_changed);
+
+/**
+ * This function sets the most cells astar_repair_id()'s local search
+ * expands before it gives up and searches for the whole path again. 0 lets
+ * it expand any number.
+ */
+void astar_set_repair_limit(astar* asp, uint32_t limit);
+
+/**
+ * This function returns the ids of the cells that make up the shortest path
+ * found by astar_search_id(), from the start cell to the end cell.
+ */
+uint32_t* astar_get_id_path(astar as);
+
+/**
+ * This function returns the number of cells in the path found by
+ * astar_search_id(). It is 0 if no path was found.
+ */
+uint32_t astar_get_id_path_size(astar as);
+
+/**
+ * This function sets how many of the cells at the top of the priority queue
+ * astar_search_id() prefetches while it expands the current cell. The
+ * prefetched cells are the ones most likely to be expanded next, so their
+ * edges and search state are already in the cache when they are. 0 turns
+ * prefetching off, which is how the astar starts.
+ *
+ * Prefetching is experimental. It has only shown a gain, of under 10%
+ * at a distance of 1, on graphs of millions of cells with weighted edges,
+ * whose search state is far bigger than the cache, and it's slower at
+ * longer distances or on graphs that fit in the cache.
+ */
+void astar_set_prefetch(astar* asp, uint8_t distance);
+
+/**
+ * This function gives the astar provided to it a wavefront whose distances
+ * astar_search_id() uses as its heuristic when the search's end cell is the
+ * wavefront's goal. The distances are exact on a grid whose moves all cost
+ * 1, so the search only expands cells on shortest paths. They're only
+ * used while graph_is_unit_grid() holds and wavefront_is_current() says
+ * nothing has made the graph cheaper since the wavefront was run, as the
+ * wavefront doesn't see added edges. NULL stops the astar using a
+ * wavefront.
+ */
+void astar_set_wavefront(astar* asp, wavefront w);
+
+/**
+ * This function gives the astar provided to it a deadend whose pruned
+ * regions astar_search_id() leaves out, apart from the ones it has to go
+ * through because its start or end cell is in them. The paths it finds are
+ * just as short. NULL stops the astar using a deadend.
+ */
+void astar_set_deadend(astar* asp, deadend d);
+
+/**
+ * This function sets how many cells wide the agent astar_search_id() and
+ * astar_repair_id() search for is. The agent fills a cube of cells that
+ * size with its lowest corner on the cell it's at, so cells whose clearance
+ * is less than the size are treated as obstacles, there's no path from a
+ * start cell the agent doesn't fit on, and one graph serves agents of
+ * every size. Agents one cell wide, which is the size the astar
+ * starts with, go by the weights of the edges alone, as clearance comes
+ * from the cells' types. A deadend is only used for them.
+ */
+void astar_set_agent_size(astar* asp, uint8_t size);
+
+/**
+ * This function turns Adaptive A* on or off for the astar provided to it.
+ * Once a search over cell ids reaches its end cell, every cell it expanded
+ * learns the cost of the path found less the cost of its own path from the
+ * start as its estimate of the cost to that end. Later searches to the same
+ * end, from anywhere, use the learned estimates where they're higher, so
+ * they expand fewer cells while still finding shortest paths. Estimates are
+ * kept for a few end cells and each size of agent at once, and are
+ * forgotten once the graph may have become cheaper to move through, as
+ * counted by graph_get_num_decreases(). Making moves dearer keeps them.
+ */
+void astar_set_adaptive(astar* asp, bool adaptive);
+
+/**
+ * This function gives the astar provided to it an overlay of extra
+ * obstacles and costs that astar_search_id() and astar_repair_id() take
+ * into account as they expand each cell, without the graph being changed.
+ * Searches only read the graph and the overlay, so each thread can search
+ * the same graph with its own astar and overlay. A deadend isn't used
+ * while there's an overlay, and Adaptive A* uses what it has learned but
+ * doesn't learn from searches with one. NULL stops the astar using an
+ * overlay.
+ */
+void astar_set_overlay(astar* asp, overlay o);
+
+/**
+ * This function gives the astar provided to it a movement profile that
+ * astar_search_id() and astar_repair_id() work out the cost of each move
+ * with, from the terrain class of the cell it goes into, as they expand
+ * each cell. The estimates are scaled by the profile's lowest multiplier,
+ * so the paths are still the shortest for the profile. As with an overlay,
+ * a deadend isn't used and Adaptive A* doesn't learn from the searches.
+ * NULL stops the astar using a profile.
+ */
+void astar_set_profile(astar* asp, profile p);
+
+/**
+ * This function returns astar's estimate of the cost of the cheapest path
+ * between the cells with the ids provided to it in the graph also provided
+ * to the function. It never overestimates on the graph's own grid, so other
+ * searches over cell ids can use it as well.
+ */
+uint32_t astar_estimate(graph g, uint32_t a, uint32_t b);
+
+/**
+ * This function returns astar's estimate of the cost between two cells from
+ * their coordinates.
+ */
+uint32_t astar_estimate_coords(enum graph_style gstyle,
+                               uint8_t ax, uint8_t ay, uint8_t az,
+                               uint8_t bx, uint8_t by, uint8_t bz);
+
 #endif // ASTAR_H
@@ -0,0 +1,202 @@
+/**
+ * bench.c
+ *
+ * This file measures how long the astar type takes to search large graphs.
+ *
+ * Astar version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "graph.h"
+#include "astar.h"
+#include "hda.h"
+
+/**
+ * These are the sizes of the graph's axes.
+ */
+#define BENCH_X_SIZE 128
+#define BENCH_Y_SIZE 128
+#define BENCH_Z_SIZE 16
+
+/**
+ * This is the number of searches each measurement is made over.
+ */
+#define BENCH_NUM_SEARCHES 200
+
+/**
+ * This is the number of long searches each parallel measurement is made
+ * over, and the largest number of threads measured.
+ */
+#define BENCH_NUM_LONG_SEARCHES 10
+#define BENCH_MAX_THREADS 8
+
+/**
+ * This function returns the current time in seconds.
+ */
+double bench_now(void)
+{
+    struct timespec ts; /* The current time. */
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+/**
+ * This function fills the arrays provided to it with the start and end cells
+ * of the searches to measure. The same seed always gives the same cells.
+ */
+void bench_make_queries(graph g, uint32_t* starts, uint32_t* ends)
+{
+    uint32_t i; /* The index of the current search. */
+
+    srand(1);
+    for (i = 0; i < BENCH_NUM_SEARCHES; i++)
+    {
+        starts[i] = graph_get_cell_id(g, rand() % BENCH_X_SIZE,
+                                         rand() % BENCH_Y_SIZE,
+                                         rand() % BENCH_Z_SIZE);
+        ends[i] = graph_get_cell_id(g, rand() % BENCH_X_SIZE,
+                                       rand() % BENCH_Y_SIZE,
+                                       rand() % BENCH_Z_SIZE);
+    }
+}
+
+/**
+ * This function returns how many seconds the astar provided to it takes to
+ * make every search.
+ */
+double bench_searches(astar* asp, uint32_t* starts, uint32_t* ends)
+{
+    double start_time;  /* The time the searches started. */
+    uint32_t i;         /* The index of the current search. */
+
+    start_time = bench_now();
+    for (i = 0; i < BENCH_NUM_SEARCHES; i++)
+    {
+        astar_search_id(asp, starts[i], ends[i]);
+    }
+    return bench_now() - start_time;
+}
+
+/**
+ * This function measures searches over a graph with the layout provided to
+ * it, with prefetching off and at a few distances.
+ */
+void bench_prefetch(enum graph_layout layout, const char* name)
+{
+    graph g;                /* The graph. */
+    astar as;               /* The astar. */
+    uint32_t* starts;       /* The start cell of each search. */
+    uint32_t* ends;         /* The end cell of each search. */
+    uint8_t distances[] = { 0, 1, 2, 4 }; /* The prefetch distances. */
+    uint32_t i;             /* The index of the current distance. */
+
+    /* Initialise the graph, the astar and the searches. */
+    graph_init_layout(&g, BENCH_X_SIZE, BENCH_Y_SIZE, BENCH_Z_SIZE,
+                      MANHATTAN, layout);
+    astar_init(&as, &g);
+    starts = (uint32_t*) malloc(sizeof(uint32_t) * BENCH_NUM_SEARCHES);
+    ends = (uint32_t*) malloc(sizeof(uint32_t) * BENCH_NUM_SEARCHES);
+    bench_make_queries(g, starts, ends);
+
+    /* Warm up, then measure each prefetch distance. */
+    bench_searches(&as, starts, ends);
+    for (i = 0; i < sizeof(distances); i++)
+    {
+        astar_set_prefetch(&as, distances[i]);
+        printf("%-8s prefetch %u: %8.2f ms\n", name, distances[i],
+               bench_searches(&as, starts, ends) * 1000.0);
+    }
+
+    /* Destroy structures. */
+    free(starts);
+    free(ends);
+    astar_free(&as);
+    graph_free(&g);
+}
+
+/**
+ * This function measures single searches spread over more and more threads
+ * by the hda type, against the serial search over cell ids. The searches
+ * run between opposite corners of the graph, so each one is long.
+ */
+void bench_hda(void)
+{
+    graph g;                /* The graph. */
+    astar as;               /* The serial astar. */
+    hda h;                  /* The parallel search. */
+    uint32_t starts[BENCH_NUM_LONG_SEARCHES]; /* The start cells. */
+    uint32_t ends[BENCH_NUM_LONG_SEARCHES];   /* The end cells. */
+    double start_time;      /* The time the searches started. */
+    double serial;          /* The time the serial searches took. */
+    double one;             /* The time the searches took on one thread. */
+    double t;               /* The time the searches took. */
+    uint32_t i;             /* The index of the current search. */
+    uint8_t threads;        /* The current number of threads. */
+
+    /* Initialise the graph and pick searches between opposite corners. */
+    graph_init(&g, BENCH_X_SIZE, BENCH_Y_SIZE, BENCH_Z_SIZE, MANHATTAN);
+    for (i = 0; i < BENCH_NUM_LONG_SEARCHES; i++)
+    {
+        starts[i] = graph_get_cell_id(g, i, 0, i % BENCH_Z_SIZE);
+        ends[i] = graph_get_cell_id(g, BENCH_X_SIZE - 1 - i,
+                                       BENCH_Y_SIZE - 1,
+                                       BENCH_Z_SIZE - 1 - i % BENCH_Z_SIZE);
+    }
+
+    /* Measure the serial search. */
+    astar_init(&as, &g);
+    start_time = bench_now();
+    for (i = 0; i < BENCH_NUM_LONG_SEARCHES; i++)
+    {
+        astar_search_id(&as, starts[i], ends[i]);
+    }
+    serial = bench_now() - start_time;
+    astar_free(&as);
+    printf("%d long searches:\n", BENCH_NUM_LONG_SEARCHES);
+    printf("serial        : %8.2f ms\n", serial * 1000.0);
+
+    /* Measure the parallel search with each number of threads. */
+    one = 0.0;
+    for (threads = 1; threads <= BENCH_MAX_THREADS; threads *= 2)
+    {
+        hda_init(&h, &g, threads);
+        start_time = bench_now();
+        for (i = 0; i < BENCH_NUM_LONG_SEARCHES; i++)
+        {
+            hda_search(&h, starts[i], ends[i]);
+        }
+        t = bench_now() - start_time;
+        hda_free(&h);
+        if (threads == 1)
+        {
+            one = t;
+        }
+        printf("hda %u threads: %8.2f ms, speedup %5.2fx\n", threads,
+               t * 1000.0, one / t);
+    }
+
+    /* Destroy structures. */
+    graph_free(&g);
+}
+
+int main(int argc, char* argv[])
+{
+    /* Measure prefetching on both layouts. */
+    printf("%d searches over a %dx%dx%d graph:\n", BENCH_NUM_SEARCHES,
+           BENCH_X_SIZE, BENCH_Y_SIZE, BENCH_Z_SIZE);
+    bench_prefetch(LINEAR, "LINEAR");
+    bench_prefetch(MORTON, "MORTON");
+
+    /* Measure parallel single searches. */
+    bench_hda();
+
+    /* Exit the program */
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,1374 @@
+/**
+ * ch.c
+ *
+ * This file contains the internal data-structure and function definitions
+ * for the ch type.
+ *
+ * While the hierarchy is being built, each cell has a list of the edges
+ * leaving it and a list of the edges entering it, which the shortcuts are
+ * added to. Each round, every cell that's less important than all of its
+ * neighbours that are left is chosen, so no two chosen cells are
+ * neighbours. The threads then find the shortcuts each chosen cell needs,
+ * only reading the lists, and the shortcuts are added once they're all
+ * done. The witness searches that check if a shortcut is needed never go
+ * through a chosen cell, so two cells contracted at the same time can't
+ * each rely on a path through the other. Lastly the threads work out the
+ * importance of the neighbours of the contracted cells again.
+ *
+ * The cells are ranked in the order they're contracted. Once they all are,
+ * the edges are split into the ones leading up the hierarchy from each
+ * cell, which the search from the start cell uses, and the ones entering
+ * each cell from higher up, which the search from the end cell uses. Each
+ * edge has the cell it shortcuts through, if it's a shortcut, which is
+ * lower in the hierarchy than both of its ends.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#include "ch.h"
+
+/**
+ * This is the most cells a witness search settles before it gives up and
+ * the shortcut is added.
+ */
+#define CH_WITNESS_LIMIT 500
+
+/**
+ * This is the number at the start of a file a hierarchy is saved to.
+ */
+#define CH_MAGIC 0x31304843
+
+/**
+ * These are the states a cell can be in while the hierarchy is built.
+ */
+#define CH_REMAINING 0
+#define CH_CHOSEN 1
+#define CH_CONTRACTED 2
+
+/**
+ * These are the jobs the threads can be given while the hierarchy is built.
+ */
+#define CH_PHASE_PRIORITY 0
+#define CH_PHASE_CONTRACT 1
+
+/**
+ * This is an edge while the hierarchy is built, to or from the cell whose
+ * list it's in.
+ */
+struct ch_arc {
+    uint32_t id;            /* The cell at the other end. */
+    uint32_t w;             /* The cost of the edge. */
+    uint32_t mid;           /* The cell it shortcuts through, if any. */
+};
+
+/**
+ * This is a growable list of edges.
+ */
+struct ch_arc_list {
+    struct ch_arc* arcs;    /* The edges. */
+    uint32_t size;          /* The number of edges in the list. */
+    uint32_t capacity;      /* The number of edges the list can hold. */
+};
+
+/**
+ * This is a shortcut found by one of the threads.
+ */
+struct ch_shortcut {
+    uint32_t from;          /* The cell the shortcut leaves. */
+    uint32_t to;            /* The cell the shortcut enters. */
+    uint32_t w;             /* The cost of the shortcut. */
+    uint32_t mid;           /* The cell it shortcuts through. */
+};
+
+/**
+ * This is the state of one of the threads building the hierarchy.
+ */
+struct ch_worker {
+    struct ch_builder* bp;          /* The hierarchy being built. */
+    uint32_t index;                 /* The number of the thread. */
+    id_heap open;                   /* The cells a witness search has left. */
+    uint32_t* dist;                 /* The distance to each cell. */
+    uint32_t* visit;                /* The search each cell was reached by. */
+    uint32_t search;                /* The number of the witness search. */
+    struct ch_shortcut* shortcuts;  /* The shortcuts the thread found. */
+    uint32_t num_shortcuts;         /* The number of shortcuts found. */
+    uint32_t shortcuts_capacity;    /* The number of shortcuts it can hold. */
+    pthread_t thread;               /* The thread. */
+};
+
+/**
+ * This is the state of the hierarchy while it's built.
+ */
+struct ch_builder {
+    uint32_t num_cells;         /* The number of cells. */
+    struct ch_arc_list* out;    /* The edges leaving each cell. */
+    struct ch_arc_list* in;     /* The edges entering each cell. */
+    uint8_t* state;             /* The state of each cell. */
+    int32_t* priority;          /* How important each cell is. */
+    uint32_t* deleted;          /* The number of contracted neighbours. */
+    uint32_t* seen;             /* The cell that last counted each cell. */
+    uint32_t* mark;             /* The round each cell was last updated. */
+    uint32_t* set;              /* The cells the threads work on. */
+    uint32_t set_size;          /* The number of cells they work on. */
+    uint8_t phase;              /* The job the threads have been given. */
+    struct ch_worker* workers;  /* The threads. */
+    uint8_t num_threads;        /* The number of threads. */
+};
+
+/**
+ * This is the internal data-structure of the ch type.
+ */
+struct ch_data {
+    graph* gp;              /* The graph the hierarchy was built from. */
+    uint32_t num_cells;     /* The number of cells. */
+    uint32_t* rank;         /* The place of each cell in the hierarchy. */
+    uint32_t* up_first;     /* The first upward edge of each cell. */
+    uint32_t* up_to;        /* The cell each upward edge enters. */
+    uint32_t* up_w;         /* The cost of each upward edge. */
+    uint32_t* up_mid;       /* The cell each upward edge shortcuts. */
+    uint32_t* down_first;   /* The first edge into each cell from above. */
+    uint32_t* down_from;    /* The cell each of those edges leaves. */
+    uint32_t* down_w;       /* The cost of each of those edges. */
+    uint32_t* down_mid;     /* The cell each of those edges shortcuts. */
+    uint32_t num_shortcuts; /* The number of shortcuts. */
+    id_heap forward;        /* The cells left to search from the start. */
+    id_heap backward;       /* The cells left to search from the end. */
+    uint32_t* dist_f;       /* The distance to each cell from the start. */
+    uint32_t* dist_b;       /* The distance from each cell to the end. */
+    uint32_t* pred_f;       /* The cell before each cell from the start. */
+    uint32_t* pred_b;       /* The cell after each cell towards the end. */
+    uint32_t* visit_f;      /* The search each cell was reached from start. */
+    uint32_t* visit_b;      /* The search each cell was reached from end. */
+    uint32_t search;        /* The number of the current search. */
+    uint32_t* chain;        /* The path through the hierarchy. */
+    uint32_t* path;         /* The path that was found. */
+    uint32_t path_size;     /* The number of cells in the path. */
+    uint32_t path_capacity; /* The number of cells the path can hold. */
+    uint32_t cost;          /* The cost of the path. */
+};
+
+/**
+ * This function builds the contraction hierarchy of the ch provided to it
+ * with the number of threads also provided.
+ */
+void ch_build(ch* cp, uint8_t num_threads);
+
+/**
+ * This function has every thread of the builder provided to it do the job
+ * also provided for each cell of the builder's set.
+ */
+void ch_run(struct ch_builder* bp, uint8_t phase);
+
+/**
+ * This function is run by each thread building the hierarchy.
+ */
+void* ch_work(void* arg);
+
+/**
+ * This function returns true if the cell provided to it is less important
+ * than every neighbour that hasn't been contracted.
+ */
+bool ch_is_chosen(struct ch_builder* bp, uint32_t v);
+
+/**
+ * This function works out how important the cell provided to it is.
+ */
+void ch_update_priority(struct ch_worker* wp, uint32_t v);
+
+/**
+ * This function returns the number of shortcuts contracting the cell
+ * provided to it would add, recording them with the worker also provided
+ * if asked to.
+ */
+uint32_t ch_find_shortcuts(struct ch_worker* wp, uint32_t v, bool record);
+
+/**
+ * This function finds the distances from the source cell provided to it to
+ * the cells around it, without going through the cell to skip, up to the
+ * limit also provided.
+ */
+void ch_witness_search(struct ch_worker* wp, uint32_t source, uint32_t skip,
+                       uint32_t limit);
+
+/**
+ * This function adds the edge provided to it to the list also provided, or
+ * lowers the cost of the edge the list already has to the same cell.
+ */
+void ch_arc_list_add(struct ch_arc_list* lp, uint32_t id, uint32_t w,
+                     uint32_t mid);
+
+/**
+ * This function drops the edges to contracted cells from the list provided
+ * to it.
+ */
+void ch_arc_list_compact(struct ch_builder* bp, struct ch_arc_list* lp);
+
+/**
+ * This function splits the edges of the builder provided to it into the
+ * upward and downward edges of the ch also provided.
+ */
+void ch_build_index(ch* cp, struct ch_builder* bp);
+
+/**
+ * This function allocates memory to the search state of the ch provided to
+ * it.
+ */
+void ch_init_search(ch* cp);
+
+/**
+ * This function settles the cell provided to it in the search from the
+ * start if forward is true, or the search from the end if not.
+ */
+void ch_settle(ch* cp, bool forward, uint32_t current, uint32_t* bestp,
+               uint32_t* meetp);
+
+/**
+ * This function reconstructs the path that goes through the cell provided
+ * to it, where the two searches met.
+ */
+void ch_reconstruct_path(ch* cp, uint32_t meet);
+
+/**
+ * This function adds the cells of the edge provided to it to the path,
+ * after the cell it leaves, unpacking it if it's a shortcut.
+ */
+void ch_unpack(ch* cp, uint32_t from, uint32_t to);
+
+/**
+ * This function returns the cell the edge provided to it shortcuts
+ * through, or GRAPH_NO_CELL if it isn't a shortcut.
+ */
+uint32_t ch_find_mid(ch c, uint32_t from, uint32_t to);
+
+/**
+ * This function writes the data provided to it to the file also provided.
+ */
+void ch_write(FILE* fp, const void* data, size_t size, size_t count);
+
+/**
+ * This function reads the data provided to it from the file also provided.
+ */
+void ch_read(FILE* fp, void* data, size_t size, size_t count);
+
+/**
+ * This function initialises the ch provided to it by building a contraction
+ * hierarchy of the graph also provided to the function, with the number of
+ * threads also provided.
+ */
+void ch_init(ch* cp, graph* gp, uint8_t num_threads)
+{
+    /* Check there's a thread to build the hierarchy with. */
+    if (num_threads == 0)
+    {
+        fprintf(stdout,
+                "\nERROR: In function ch_init(): a ch needs at least one "
+                "thread!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Make sure the graph's index of edges is up to date. */
+    graph_update_index(gp);
+
+    /* Allocate memory to the ch. */
+    *cp = (ch) malloc(sizeof(struct ch_data));
+    (*cp)->gp = gp;
+    (*cp)->num_cells = graph_get_cell_count(*gp);
+
+    /* Build the hierarchy and get ready to search it. */
+    ch_build(cp, num_threads);
+    ch_init_search(cp);
+}
+
+/**
+ * This function initialises the ch provided to it with the contraction
+ * hierarchy saved to the file with the name also provided. The hierarchy
+ * must have been built from the graph also provided to the function.
+ */
+void ch_load(ch* cp, graph* gp, const char* filename)
+{
+    FILE* fp;               /* The file. */
+    uint32_t header[5];     /* The magic number and the sizes. */
+    uint32_t n;             /* The number of cells. */
+
+    /* Open the file and check it holds a hierarchy of the graph. */
+    fp = fopen(filename, "rb");
+    if (fp == NULL)
+    {
+        fprintf(stdout,
+                "\nERROR: In function ch_load(): could not open %s!\n",
+                filename);
+        exit(EXIT_FAILURE);
+    }
+    ch_read(fp, header, sizeof(uint32_t), 5);
+    if (header[0] != CH_MAGIC || header[1] != graph_get_cell_count(*gp))
+    {
+        fprintf(stdout,
+                "\nERROR: In function ch_load(): %s does not hold a "
+                "hierarchy of this graph!\n", filename);
+        exit(EXIT_FAILURE);
+    }
+
+    /* Allocate memory to the ch. */
+    *cp = (ch) malloc(sizeof(struct ch_data));
+    (*cp)->gp = gp;
+    (*cp)->num_cells = header[1];
+    (*cp)->num_shortcuts = header[4];
+    n = (*cp)->num_cells;
+    (*cp)->rank = (uint32_t*) malloc(sizeof(uint32_t) * n);
+    (*cp)->up_first = (uint32_t*) malloc(sizeof(uint32_t) * (n + 1));
+    (*cp)->up_to = (uint32_t*) malloc(sizeof(uint32_t) * header[2]);
+    (*cp)->up_w = (uint32_t*) malloc(sizeof(uint32_t) * header[2]);
+    (*cp)->up_mid = (uint32_t*) malloc(sizeof(uint32_t) * header[2]);
+    (*cp)->down_first = (uint32_t*) malloc(sizeof(uint32_t) * (n + 1));
+    (*cp)->down_from = (uint32_t*) malloc(sizeof(uint32_t) * header[3]);
+    (*cp)->down_w = (uint32_t*) malloc(sizeof(uint32_t) * header[3]);
+    (*cp)->down_mid = (uint32_t*) malloc(sizeof(uint32_t) * header[3]);
+
+    /* Read the hierarchy in the order it was saved in. */
+    ch_read(fp, (*cp)->rank, sizeof(uint32_t), n);
+    ch_read(fp, (*cp)->up_first, sizeof(uint32_t), n + 1);
+    ch_read(fp, (*cp)->up_to, sizeof(uint32_t), header[2]);
+    ch_read(fp, (*cp)->up_w, sizeof(uint32_t), header[2]);
+    ch_read(fp, (*cp)->up_mid, sizeof(uint32_t), header[2]);
+    ch_read(fp, (*cp)->down_first, sizeof(uint32_t), n + 1);
+    ch_read(fp, (*cp)->down_from, sizeof(uint32_t), header[3]);
+    ch_read(fp, (*cp)->down_w, sizeof(uint32_t), header[3]);
+    ch_read(fp, (*cp)->down_mid, sizeof(uint32_t), header[3]);
+    fclose(fp);
+
+    /* Get ready to search the hierarchy. */
+    ch_init_search(cp);
+}
+
+/**
+ * This function saves the contraction hierarchy of the ch provided to it to
+ * the file with the name also provided.
+ */
+void ch_save(ch c, const char* filename)
+{
+    FILE* fp;               /* The file. */
+    uint32_t header[5];     /* The magic number and the sizes. */
+    uint32_t n;             /* The number of cells. */
+
+    /* Open the file. */
+    fp = fopen(filename, "wb");
+    if (fp == NULL)
+    {
+        fprintf(stdout,
+                "\nERROR: In function ch_save(): could not open %s!\n",
+                filename);
+        exit(EXIT_FAILURE);
+    }
+
+    /* Write the sizes of the arrays first, so they can be allocated before
+     * they're read. */
+    n = c->num_cells;
+    header[0] = CH_MAGIC;
+    header[1] = n;
+    header[2] = c->up_first[n];
+    header[3] = c->down_first[n];
+    header[4] = c->num_shortcuts;
+    ch_write(fp, header, sizeof(uint32_t), 5);
+
+    /* Write the hierarchy. */
+    ch_write(fp, c->rank, sizeof(uint32_t), n);
+    ch_write(fp, c->up_first, sizeof(uint32_t), n + 1);
+    ch_write(fp, c->up_to, sizeof(uint32_t), header[2]);
+    ch_write(fp, c->up_w, sizeof(uint32_t), header[2]);
+    ch_write(fp, c->up_mid, sizeof(uint32_t), header[2]);
+    ch_write(fp, c->down_first, sizeof(uint32_t), n + 1);
+    ch_write(fp, c->down_from, sizeof(uint32_t), header[3]);
+    ch_write(fp, c->down_w, sizeof(uint32_t), header[3]);
+    ch_write(fp, c->down_mid, sizeof(uint32_t), header[3]);
+    if (fclose(fp) != 0)
+    {
+        fprintf(stdout,
+                "\nERROR: In function ch_save(): could not write %s!\n",
+                filename);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * This function destroys the ch provided to it.
+ */
+void ch_free(ch* cp)
+{
+    /* De-allocate memory from the hierarchy. */
+    free((*cp)->rank);
+    free((*cp)->up_first);
+    free((*cp)->up_to);
+    free((*cp)->up_w);
+    free((*cp)->up_mid);
+    free((*cp)->down_first);
+    free((*cp)->down_from);
+    free((*cp)->down_w);
+    free((*cp)->down_mid);
+
+    /* De-allocate memory from the search state. */
+    id_heap_free(&(*cp)->forward);
+    id_heap_free(&(*cp)->backward);
+    free((*cp)->dist_f);
+    free((*cp)->dist_b);
+    free((*cp)->pred_f);
+    free((*cp)->pred_b);
+    free((*cp)->visit_f);
+    free((*cp)->visit_b);
+    free((*cp)->chain);
+    free((*cp)->path);
+
+    /* De-allocate memory from the ch. */
+    free(*cp);
+}
+
+/**
+ * This function searches for the shortest path from the start cell to the
+ * end cell.
+ */
+void ch_search(ch* cp, uint32_t start, uint32_t end)
+{
+    uint32_t best;      /* The cost of the cheapest path so far. */
+    uint32_t meet;      /* The cell the cheapest path goes through. */
+    bool forward;       /* Whether the search from the start goes on. */
+    bool backward;      /* Whether the search from the end goes on. */
+    uint32_t current;   /* The cell being settled. */
+
+    /* Start a new search. If the search number wraps around, the old
+     * numbers have to be cleared so they can't be mistaken for new ones. */
+    (*cp)->search++;
+    if ((*cp)->search == 0)
+    {
+        memset((*cp)->visit_f, 0, sizeof(uint32_t) * (*cp)->num_cells);
+        memset((*cp)->visit_b, 0, sizeof(uint32_t) * (*cp)->num_cells);
+        (*cp)->search = 1;
+    }
+    id_heap_clear(&(*cp)->forward);
+    id_heap_clear(&(*cp)->backward);
+    (*cp)->path_size = 0;
+    (*cp)->cost = UINT32_MAX;
+    best = UINT32_MAX;
+    meet = GRAPH_NO_CELL;
+
+    /* Start a search up the hierarchy from each end. */
+    (*cp)->visit_f[start] = (*cp)->search;
+    (*cp)->dist_f[start] = 0;
+    (*cp)->pred_f[start] = GRAPH_NO_CELL;
+    id_heap_push(&(*cp)->forward, start, 0);
+    (*cp)->visit_b[end] = (*cp)->search;
+    (*cp)->dist_b[end] = 0;
+    (*cp)->pred_b[end] = GRAPH_NO_CELL;
+    id_heap_push(&(*cp)->backward, end, 0);
+
+    /* Take turns settling a cell from each end. A search is done when the
+     * closest cell it has left is no closer than the cheapest path. */
+    while (true)
+    {
+        forward = !id_heap_is_empty((*cp)->forward)
+                  && id_heap_get_key((*cp)->forward,
+                             id_heap_peek_min((*cp)->forward)) < best;
+        backward = !id_heap_is_empty((*cp)->backward)
+                   && id_heap_get_key((*cp)->backward,
+                              id_heap_peek_min((*cp)->backward)) < best;
+        if (!forward && !backward)
+        {
+            break;
+        }
+        if (forward)
+        {
+            current = id_heap_pop_min(&(*cp)->forward);
+            ch_settle(cp, true, current, &best, &meet);
+        }
+        if (backward)
+        {
+            current = id_heap_pop_min(&(*cp)->backward);
+            ch_settle(cp, false, current, &best, &meet);
+        }
+    }
+
+    /* Unpack the path if one was found. */
+    if (meet != GRAPH_NO_CELL)
+    {
+        (*cp)->cost = best;
+        ch_reconstruct_path(cp, meet);
+    }
+}
+
+/**
+ * This function returns the ids of the cells that make up the shortest path
+ * found by ch_search(), from the start cell to the end cell.
+ */
+uint32_t* ch_get_path(ch c)
+{
+    return c->path;
+}
+
+/**
+ * This function returns the number of cells in the path found by
+ * ch_search(). It is 0 if no path was found.
+ */
+uint32_t ch_get_path_size(ch c)
+{
+    return c->path_size;
+}
+
+/**
+ * This function returns the cost of the path found by ch_search(), or
+ * UINT32_MAX if no path was found.
+ */
+uint32_t ch_get_cost(ch c)
+{
+    return c->cost;
+}
+
+/**
+ * This function returns the number of shortcuts in the contraction
+ * hierarchy of the ch provided to it.
+ */
+uint32_t ch_get_num_shortcuts(ch c)
+{
+    return c->num_shortcuts;
+}
+
+/**
+ * This function builds the contraction hierarchy of the ch provided to it
+ * with the number of threads also provided.
+ */
+void ch_build(ch* cp, uint8_t num_threads)
+{
+    struct ch_builder b;    /* The hierarchy being built. */
+    struct ch_worker* wp;   /* The current thread. */
+    struct ch_shortcut* sp; /* The current shortcut. */
+    struct ch_arc_list* lists[2]; /* The current cell's lists of edges. */
+    graph g;                /* The graph. */
+    uint32_t* remaining;    /* The cells that are left. */
+    uint32_t* update;       /* The neighbours of the contracted cells. */
+    uint32_t num_remaining; /* The number of cells that are left. */
+    uint32_t next_rank;     /* The rank of the next cell contracted. */
+    uint32_t round;         /* The number of the current round. */
+    uint32_t num_chosen;    /* The number of cells chosen this round. */
+    uint32_t v;             /* The current cell. */
+    uint32_t u;             /* The current neighbour. */
+    uint32_t e;             /* The current edge. */
+    uint32_t i, j, k;       /* Loop counters. */
+
+    /* Give every cell its edges from the graph. Moves that are impossible
+     * aren't edges. */
+    g = *(*cp)->gp;
+    b.num_cells = (*cp)->num_cells;
+    b.out = (struct ch_arc_list*) calloc(b.num_cells,
+                                         sizeof(struct ch_arc_list));
+    b.in = (struct ch_arc_list*) calloc(b.num_cells,
+                                        sizeof(struct ch_arc_list));
+    for (v = 0; v < b.num_cells; v++)
+    {
+        for (e = graph_get_first_edge(g, v);
+             e < graph_get_first_edge(g, v + 1); e++)
+        {
+            u = graph_get_edge_to(g, e);
+            if (graph_get_edge_w(g, e) != 0 && u != v)
+            {
+                ch_arc_list_add(&b.out[v], u, graph_get_edge_w(g, e),
+                                GRAPH_NO_CELL);
+                ch_arc_list_add(&b.in[u], v, graph_get_edge_w(g, e),
+                                GRAPH_NO_CELL);
+            }
+        }
+    }
+
+    /* Initialise the rest of the builder's state. */
+    b.state = (uint8_t*) calloc(b.num_cells, sizeof(uint8_t));
+    b.priority = (int32_t*) malloc(sizeof(int32_t) * b.num_cells);
+    b.deleted = (uint32_t*) calloc(b.num_cells, sizeof(uint32_t));
+    b.seen = (uint32_t*) malloc(sizeof(uint32_t) * b.num_cells);
+    b.mark = (uint32_t*) calloc(b.num_cells, sizeof(uint32_t));
+    b.set = (uint32_t*) malloc(sizeof(uint32_t) * b.num_cells);
+    remaining = (uint32_t*) malloc(sizeof(uint32_t) * b.num_cells);
+    update = (uint32_t*) malloc(sizeof(uint32_t) * b.num_cells);
+    for (v = 0; v < b.num_cells; v++)
+    {
+        b.seen[v] = GRAPH_NO_CELL;
+        b.set[v] = v;
+        remaining[v] = v;
+    }
+    b.set_size = b.num_cells;
+    num_remaining = b.num_cells;
+
+    /* Initialise the threads. */
+    b.num_threads = num_threads;
+    b.workers = (struct ch_worker*) malloc(
+            sizeof(struct ch_worker) * num_threads);
+    for (i = 0; i < num_threads; i++)
+    {
+        wp = &b.workers[i];
+        wp->bp = &b;
+        wp->index = i;
+        id_heap_init(&wp->open, b.num_cells);
+        wp->dist = (uint32_t*) malloc(sizeof(uint32_t) * b.num_cells);
+        wp->visit = (uint32_t*) calloc(b.num_cells, sizeof(uint32_t));
+        wp->search = 0;
+        wp->shortcuts = NULL;
+        wp->num_shortcuts = 0;
+        wp->shortcuts_capacity = 0;
+    }
+
+    /* Work out how important every cell is to start with. */
+    ch_run(&b, CH_PHASE_PRIORITY);
+
+    /* Contract the cells a round at a time. */
+    (*cp)->rank = (uint32_t*) malloc(sizeof(uint32_t) * b.num_cells);
+    next_rank = 0;
+    round = 0;
+    while (num_remaining > 0)
+    {
+        round++;
+
+        /* Choose the cells that are less important than their neighbours.
+         * The least important cell left is always chosen. */
+        num_chosen = 0;
+        for (i = 0; i < num_remaining; i++)
+        {
+            if (ch_is_chosen(&b, remaining[i]))
+            {
+                b.set[num_chosen] = remaining[i];
+                num_chosen++;
+            }
+        }
+        for (i = 0; i < num_chosen; i++)
+        {
+            b.state[b.set[i]] = CH_CHOSEN;
+        }
+        b.set_size = num_chosen;
+
+        /* Find the shortcuts the chosen cells need. */
+        for (i = 0; i < num_threads; i++)
+        {
+            b.workers[i].num_shortcuts = 0;
+        }
+        ch_run(&b, CH_PHASE_CONTRACT);
+
+        /* Contract the chosen cells. Their neighbours have to have their
+         * importance worked out again, so they're collected as they're
+         * counted. */
+        k = 0;
+        for (i = 0; i < num_chosen; i++)
+        {
+            v = b.set[i];
+            b.state[v] = CH_CONTRACTED;
+            (*cp)->rank[v] = next_rank;
+            next_rank++;
+        }
+        for (i = 0; i < num_chosen; i++)
+        {
+            v = b.set[i];
+            lists[0] = &b.out[v];
+            lists[1] = &b.in[v];
+            for (j = 0; j < 2; j++)
+            {
+                for (e = 0; e < lists[j]->size; e++)
+                {
+                    u = lists[j]->arcs[e].id;
+                    if (b.state[u] != CH_REMAINING || b.seen[u] == v)
+                    {
+                        continue;
+                    }
+                    b.seen[u] = v;
+                    b.deleted[u]++;
+                    if (b.mark[u] != round)
+                    {
+                        b.mark[u] = round;
+                        update[k] = u;
+                        k++;
+                    }
+                }
+            }
+        }
+
+        /* Add the shortcuts the threads found. */
+        for (i = 0; i < num_threads; i++)
+        {
+            for (j = 0; j < b.workers[i].num_shortcuts; j++)
+            {
+                sp = &b.workers[i].shortcuts[j];
+                ch_arc_list_add(&b.out[sp->from], sp->to, sp->w, sp->mid);
+                ch_arc_list_add(&b.in[sp->to], sp->from, sp->w, sp->mid);
+            }
+        }
+
+        /* Work out how important the neighbours are now. Their edges to
+         * contracted cells are dropped first, as those are kept by the
+         * contracted cells and only slow the witness searches down. */
+        for (i = 0; i < k; i++)
+        {
+            b.set[i] = update[i];
+            ch_arc_list_compact(&b, &b.out[update[i]]);
+            ch_arc_list_compact(&b, &b.in[update[i]]);
+        }
+        b.set_size = k;
+        ch_run(&b, CH_PHASE_PRIORITY);
+
+        /* Take the contracted cells out of the cells that are left. */
+        j = 0;
+        for (i = 0; i < num_remaining; i++)
+        {
+            if (b.state[remaining[i]] == CH_REMAINING)
+            {
+                remaining[j] = remaining[i];
+                j++;
+            }
+        }
+        num_remaining = j;
+    }
+
+    /* Split the edges up by the hierarchy. */
+    ch_build_index(cp, &b);
+
+    /* Destroy the builder. */
+    for (i = 0; i < num_threads; i++)
+    {
+        id_heap_free(&b.workers[i].open);
+        free(b.workers[i].dist);
+        free(b.workers[i].visit);
+        free(b.workers[i].shortcuts);
+    }
+    for (v = 0; v < b.num_cells; v++)
+    {
+        free(b.out[v].arcs);
+        free(b.in[v].arcs);
+    }
+    free(b.workers);
+    free(b.out);
+    free(b.in);
+    free(b.state);
+    free(b.priority);
+    free(b.deleted);
+    free(b.seen);
+    free(b.mark);
+    free(b.set);
+    free(remaining);
+    free(update);
+}
+
+/**
+ * This function has every thread of the builder provided to it do the job
+ * also provided for each cell of the builder's set.
+ */
+void ch_run(struct ch_builder* bp, uint8_t phase)
+{
+    uint8_t i;  /* The current thread. */
+
+    /* Run the threads and wait for them to finish. */
+    bp->phase = phase;
+    for (i = 1; i < bp->num_threads; i++)
+    {
+        pthread_create(&bp->workers[i].thread, NULL, ch_work,
+                       &bp->workers[i]);
+    }
+    ch_work(&bp->workers[0]);
+    for (i = 1; i < bp->num_threads; i++)
+    {
+        pthread_join(bp->workers[i].thread, NULL);
+    }
+}
+
+/**
+ * This function is run by each thread building the hierarchy.
+ */
+void* ch_work(void* arg)
+{
+    struct ch_worker* wp;   /* The thread's state. */
+    struct ch_builder* bp;  /* The hierarchy being built. */
+    uint32_t i;             /* The index of the current cell in the set. */
+
+    /* The cells of the set are dealt out to the threads in turn. */
+    wp = (struct ch_worker*) arg;
+    bp = wp->bp;
+    for (i = wp->index; i < bp->set_size; i += bp->num_threads)
+    {
+        if (bp->phase == CH_PHASE_PRIORITY)
+        {
+            ch_update_priority(wp, bp->set[i]);
+        }
+        else
+        {
+            ch_find_shortcuts(wp, bp->set[i], true);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * This function returns true if the cell provided to it is less important
+ * than every neighbour that hasn't been contracted.
+ */
+bool ch_is_chosen(struct ch_builder* bp, uint32_t v)
+{
+    struct ch_arc_list* lists[2];   /* The cell's lists of edges. */
+    uint32_t u;                     /* The current neighbour. */
+    uint32_t e;                     /* The current edge. */
+    uint8_t j;                      /* The current list. */
+
+    /* Ties are broken by the cell ids. */
+    lists[0] = &bp->out[v];
+    lists[1] = &bp->in[v];
+    for (j = 0; j < 2; j++)
+    {
+        for (e = 0; e < lists[j]->size; e++)
+        {
+            u = lists[j]->arcs[e].id;
+            if (bp->state[u] != CH_CONTRACTED
+                && (bp->priority[u] < bp->priority[v]
+                    || (bp->priority[u] == bp->priority[v] && u < v)))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * This function works out how important the cell provided to it is.
+ */
+void ch_update_priority(struct ch_worker* wp, uint32_t v)
+{
+    struct ch_builder* bp;  /* The hierarchy being built. */
+    int32_t degree;         /* The number of edges the cell has left. */
+    uint32_t e;             /* The current edge. */
+
+    /* Count the edges contracting the cell would remove. */
+    bp = wp->bp;
+    degree = 0;
+    for (e = 0; e < bp->out[v].size; e++)
+    {
+        if (bp->state[bp->out[v].arcs[e].id] == CH_REMAINING)
+        {
+            degree++;
+        }
+    }
+    for (e = 0; e < bp->in[v].size; e++)
+    {
+        if (bp->state[bp->in[v].arcs[e].id] == CH_REMAINING)
+        {
+            degree++;
+        }
+    }
+
+    /* The edge difference, plus the contracted neighbours so the cells
+     * that are contracted are spread out. */
+    bp->priority[v] = (int32_t) ch_find_shortcuts(wp, v, false) - degree
+                    + (int32_t) bp->deleted[v];
+}
+
+/**
+ * This function returns the number of shortcuts contracting the cell
+ * provided to it would add, recording them with the worker also provided
+ * if asked to.
+ */
+uint32_t ch_find_shortcuts(struct ch_worker* wp, uint32_t v, bool record)
+{
+    struct ch_builder* bp;  /* The hierarchy being built. */
+    struct ch_arc* in;      /* The current edge entering the cell. */
+    struct ch_arc* out;     /* The current edge leaving the cell. */
+    uint32_t max_out;       /* The cost of the dearest edge leaving it. */
+    uint32_t count;         /* The number of shortcuts needed. */
+    uint32_t i, j;          /* Loop counters. */
+
+    /* Find the dearest edge leaving the cell, which bounds how far the
+     * witness searches have to go. */
+    bp = wp->bp;
+    max_out = 0;
+    for (j = 0; j < bp->out[v].size; j++)
+    {
+        out = &bp->out[v].arcs[j];
+        if (bp->state[out->id] == CH_REMAINING && out->w > max_out)
+        {
+            max_out = out->w;
+        }
+    }
+
+    /* A path into the cell and out again needs a shortcut if there's no
+     * path around the cell that's as cheap. */
+    count = 0;
+    for (i = 0; i < bp->in[v].size; i++)
+    {
+        in = &bp->in[v].arcs[i];
+        if (bp->state[in->id] != CH_REMAINING || in->id == v)
+        {
+            continue;
+        }
+        ch_witness_search(wp, in->id, v, in->w + max_out);
+        for (j = 0; j < bp->out[v].size; j++)
+        {
+            out = &bp->out[v].arcs[j];
+            if (bp->state[out->id] != CH_REMAINING || out->id == in->id
+                || out->id == v)
+            {
+                continue;
+            }
+            if (wp->visit[out->id] == wp->search
+                && wp->dist[out->id] <= in->w + out->w)
+            {
+                continue;
+            }
+
+            /* Record the shortcut, making room for it if there isn't any. */
+            count++;
+            if (record)
+            {
+                if (wp->num_shortcuts == wp->shortcuts_capacity)
+                {
+                    wp->shortcuts_capacity = wp->shortcuts_capacity == 0
+                                           ? 64
+                                           : wp->shortcuts_capacity * 2;
+                    wp->shortcuts = (struct ch_shortcut*) realloc(
+                            wp->shortcuts, sizeof(struct ch_shortcut)
+                                           * wp->shortcuts_capacity);
+                }
+                wp->shortcuts[wp->num_shortcuts].from = in->id;
+                wp->shortcuts[wp->num_shortcuts].to = out->id;
+                wp->shortcuts[wp->num_shortcuts].w = in->w + out->w;
+                wp->shortcuts[wp->num_shortcuts].mid = v;
+                wp->num_shortcuts++;
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * This function finds the distances from the source cell provided to it to
+ * the cells around it, without going through the cell to skip, up to the
+ * limit also provided.
+ */
+void ch_witness_search(struct ch_worker* wp, uint32_t source, uint32_t skip,
+                       uint32_t limit)
+{
+    struct ch_builder* bp;  /* The hierarchy being built. */
+    struct ch_arc* arc;     /* The current edge. */
+    uint32_t current;       /* The cell being settled. */
+    uint32_t settled;       /* The number of cells settled. */
+    uint32_t d;             /* The distance through the current cell. */
+    uint32_t e;             /* The index of the current edge. */
+
+    /* Start a new search. If the search number wraps around, the old
+     * numbers have to be cleared so they can't be mistaken for new ones. */
+    bp = wp->bp;
+    wp->search++;
+    if (wp->search == 0)
+    {
+        memset(wp->visit, 0, sizeof(uint32_t) * bp->num_cells);
+        wp->search = 1;
+    }
+    id_heap_clear(&wp->open);
+    wp->visit[source] = wp->search;
+    wp->dist[source] = 0;
+    id_heap_push(&wp->open, source, 0);
+
+    /* Settle cells until they're beyond the limit or there have been too
+     * many. Only cells that are left are gone through. */
+    settled = 0;
+    while (!id_heap_is_empty(wp->open) && settled < CH_WITNESS_LIMIT)
+    {
+        current = id_heap_pop_min(&wp->open);
+        if (wp->dist[current] > limit)
+        {
+            break;
+        }
+        settled++;
+        for (e = 0; e < bp->out[current].size; e++)
+        {
+            arc = &bp->out[current].arcs[e];
+            if (arc->id == skip || bp->state[arc->id] != CH_REMAINING)
+            {
+                continue;
+            }
+            d = wp->dist[current] + arc->w;
+            if (wp->visit[arc->id] != wp->search || d < wp->dist[arc->id])
+            {
+                wp->visit[arc->id] = wp->search;
+                wp->dist[arc->id] = d;
+                id_heap_push(&wp->open, arc->id, d);
+            }
+        }
+    }
+}
+
+/**
+ * This function adds the edge provided to it to the list also provided, or
+ * lowers the cost of the edge the list already has to the same cell.
+ */
+void ch_arc_list_add(struct ch_arc_list* lp, uint32_t id, uint32_t w,
+                     uint32_t mid)
+{
+    uint32_t i;     /* The index of the current edge. */
+
+    /* Keep only the cheapest edge to each cell. */
+    for (i = 0; i < lp->size; i++)
+    {
+        if (lp->arcs[i].id == id)
+        {
+            if (w < lp->arcs[i].w)
+            {
+                lp->arcs[i].w = w;
+                lp->arcs[i].mid = mid;
+            }
+            return;
+        }
+    }
+
+    /* Double the list's capacity if it's full. */
+    if (lp->size == lp->capacity)
+    {
+        lp->capacity = lp->capacity == 0 ? 4 : lp->capacity * 2;
+        lp->arcs = (struct ch_arc*) realloc(
+                lp->arcs, sizeof(struct ch_arc) * lp->capacity);
+    }
+    lp->arcs[lp->size].id = id;
+    lp->arcs[lp->size].w = w;
+    lp->arcs[lp->size].mid = mid;
+    lp->size++;
+}
+
+/**
+ * This function drops the edges to contracted cells from the list provided
+ * to it.
+ */
+void ch_arc_list_compact(struct ch_builder* bp, struct ch_arc_list* lp)
+{
+    uint32_t i;     /* The index of the current edge. */
+    uint32_t j;     /* The index the next edge kept goes at. */
+
+    /* Move the edges that are kept down over the ones that aren't. */
+    j = 0;
+    for (i = 0; i < lp->size; i++)
+    {
+        if (bp->state[lp->arcs[i].id] != CH_CONTRACTED)
+        {
+            lp->arcs[j] = lp->arcs[i];
+            j++;
+        }
+    }
+    lp->size = j;
+}
+
+/**
+ * This function splits the edges of the builder provided to it into the
+ * upward and downward edges of the ch also provided.
+ */
+void ch_build_index(ch* cp, struct ch_builder* bp)
+{
+    struct ch_arc* arc;     /* The current edge. */
+    uint32_t* rank;         /* The rank of each cell. */
+    uint32_t n;             /* The number of cells. */
+    uint32_t v;             /* The current cell. */
+    uint32_t e;             /* The index of the current edge. */
+    uint32_t up;            /* The index of the next upward edge. */
+    uint32_t down;          /* The index of the next downward edge. */
+
+    /* Count each cell's edges that lead up the hierarchy. */
+    rank = (*cp)->rank;
+    n = bp->num_cells;
+    (*cp)->up_first = (uint32_t*) malloc(sizeof(uint32_t) * (n + 1));
+    (*cp)->down_first = (uint32_t*) malloc(sizeof(uint32_t) * (n + 1));
+    up = 0;
+    down = 0;
+    for (v = 0; v < n; v++)
+    {
+        (*cp)->up_first[v] = up;
+        (*cp)->down_first[v] = down;
+        for (e = 0; e < bp->out[v].size; e++)
+        {
+            if (rank[bp->out[v].arcs[e].id] > rank[v])
+            {
+                up++;
+            }
+        }
+        for (e = 0; e < bp->in[v].size; e++)
+        {
+            if (rank[bp->in[v].arcs[e].id] > rank[v])
+            {
+                down++;
+            }
+        }
+    }
+    (*cp)->up_first[n] = up;
+    (*cp)->down_first[n] = down;
+
+    /* Fill the edges in. Every edge is in one of the two arrays, so the
+     * shortcuts are counted as they go in. */
+    (*cp)->up_to = (uint32_t*) malloc(sizeof(uint32_t) * up);
+    (*cp)->up_w = (uint32_t*) malloc(sizeof(uint32_t) * up);
+    (*cp)->up_mid = (uint32_t*) malloc(sizeof(uint32_t) * up);
+    (*cp)->down_from = (uint32_t*) malloc(sizeof(uint32_t) * down);
+    (*cp)->down_w = (uint32_t*) malloc(sizeof(uint32_t) * down);
+    (*cp)->down_mid = (uint32_t*) malloc(sizeof(uint32_t) * down);
+    (*cp)->num_shortcuts = 0;
+    up = 0;
+    down = 0;
+    for (v = 0; v < n; v++)
+    {
+        for (e = 0; e < bp->out[v].size; e++)
+        {
+            arc = &bp->out[v].arcs[e];
+            if (rank[arc->id] > rank[v])
+            {
+                (*cp)->up_to[up] = arc->id;
+                (*cp)->up_w[up] = arc->w;
+                (*cp)->up_mid[up] = arc->mid;
+                up++;
+                if (arc->mid != GRAPH_NO_CELL)
+                {
+                    (*cp)->num_shortcuts++;
+                }
+            }
+        }
+        for (e = 0; e < bp->in[v].size; e++)
+        {
+            arc = &bp->in[v].arcs[e];
+            if (rank[arc->id] > rank[v])
+            {
+                (*cp)->down_from[down] = arc->id;
+                (*cp)->down_w[down] = arc->w;
+                (*cp)->down_mid[down] = arc->mid;
+                down++;
+                if (arc->mid != GRAPH_NO_CELL)
+                {
+                    (*cp)->num_shortcuts++;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * This function allocates memory to the search state of the ch provided to
+ * it.
+ */
+void ch_init_search(ch* cp)
+{
+    uint32_t n;     /* The number of cells. */
+
+    /* Initialise the state of each cell for each search. */
+    n = (*cp)->num_cells;
+    id_heap_init(&(*cp)->forward, n);
+    id_heap_init(&(*cp)->backward, n);
+    (*cp)->dist_f = (uint32_t*) malloc(sizeof(uint32_t) * n);
+    (*cp)->dist_b = (uint32_t*) malloc(sizeof(uint32_t) * n);
+    (*cp)->pred_f = (uint32_t*) malloc(sizeof(uint32_t) * n);
+    (*cp)->pred_b = (uint32_t*) malloc(sizeof(uint32_t) * n);
+    (*cp)->visit_f = (uint32_t*) calloc(n, sizeof(uint32_t));
+    (*cp)->visit_b = (uint32_t*) calloc(n, sizeof(uint32_t));
+    (*cp)->search = 0;
+
+    /* The path grows as it's needed. */
+    (*cp)->chain = (uint32_t*) malloc(sizeof(uint32_t) * n);
+    (*cp)->path = NULL;
+    (*cp)->path_size = 0;
+    (*cp)->path_capacity = 0;
+    (*cp)->cost = UINT32_MAX;
+}
+
+/**
+ * This function settles the cell provided to it in the search from the
+ * start if forward is true, or the search from the end if not.
+ */
+void ch_settle(ch* cp, bool forward, uint32_t current, uint32_t* bestp,
+               uint32_t* meetp)
+{
+    uint32_t* first;    /* The first edge of each cell in this direction. */
+    uint32_t* ids;      /* The cell at the other end of each edge. */
+    uint32_t* ws;       /* The cost of each edge. */
+    uint32_t* dist;     /* The distance of each cell in this direction. */
+    uint32_t* pred;     /* The cell each cell was reached from. */
+    uint32_t* visit;    /* The search each cell was reached by. */
+    uint32_t* other_dist;  /* The distances in the other direction. */
+    uint32_t* other_visit; /* The visits in the other direction. */
+    id_heap* hp;        /* The heap of this direction. */
+    uint32_t d;         /* The distance through the current cell. */
+    uint32_t id;        /* The cell at the other end of the edge. */
+    uint32_t e;         /* The current edge. */
+
+    /* Pick out the arrays of the direction being searched. */
+    if (forward)
+    {
+        first = (*cp)->up_first;
+        ids = (*cp)->up_to;
+        ws = (*cp)->up_w;
+        dist = (*cp)->dist_f;
+        pred = (*cp)->pred_f;
+        visit = (*cp)->visit_f;
+        other_dist = (*cp)->dist_b;
+        other_visit = (*cp)->visit_b;
+        hp = &(*cp)->forward;
+    }
+    else
+    {
+        first = (*cp)->down_first;
+        ids = (*cp)->down_from;
+        ws = (*cp)->down_w;
+        dist = (*cp)->dist_b;
+        pred = (*cp)->pred_b;
+        visit = (*cp)->visit_b;
+        other_dist = (*cp)->dist_f;
+        other_visit = (*cp)->visit_f;
+        hp = &(*cp)->backward;
+    }
+
+    /* Check if the searches have met at a cheaper path. */
+    if (other_visit[current] == (*cp)->search
+        && dist[current] + other_dist[current] < *bestp)
+    {
+        *bestp = dist[current] + other_dist[current];
+        *meetp = current;
+    }
+
+    /* Relax the edges of the cell that lead up the hierarchy. */
+    for (e = first[current]; e < first[current + 1]; e++)
+    {
+        id = ids[e];
+        d = dist[current] + ws[e];
+        if (visit[id] != (*cp)->search || d < dist[id])
+        {
+            visit[id] = (*cp)->search;
+            dist[id] = d;
+            pred[id] = current;
+            id_heap_push(hp, id, d);
+        }
+    }
+}
+
+/**
+ * This function reconstructs the path that goes through the cell provided
+ * to it, where the two searches met.
+ */
+void ch_reconstruct_path(ch* cp, uint32_t meet)
+{
+    uint32_t size;      /* The number of cells in the chain. */
+    uint32_t cell;      /* The current cell. */
+    uint32_t i;         /* The index of the current cell. */
+
+    /* Put together the path through the hierarchy, from the start cell up
+     * to where the searches met and down to the end cell. */
+    size = 0;
+    for (cell = meet; cell != GRAPH_NO_CELL; cell = (*cp)->pred_f[cell])
+    {
+        size++;
+    }
+    i = size;
+    for (cell = meet; cell != GRAPH_NO_CELL; cell = (*cp)->pred_f[cell])
+    {
+        i--;
+        (*cp)->chain[i] = cell;
+    }
+    for (cell = (*cp)->pred_b[meet]; cell != GRAPH_NO_CELL;
+         cell = (*cp)->pred_b[cell])
+    {
+        (*cp)->chain[size] = cell;
+        size++;
+    }
+
+    /* Unpack each edge of it into the edges of the graph. */
+    (*cp)->path_size = 0;
+    if ((*cp)->path_capacity == 0)
+    {
+        (*cp)->path_capacity = 64;
+        (*cp)->path = (uint32_t*) malloc(
+                sizeof(uint32_t) * (*cp)->path_capacity);
+    }
+    (*cp)->path[0] = (*cp)->chain[0];
+    (*cp)->path_size = 1;
+    for (i = 1; i < size; i++)
+    {
+        ch_unpack(cp, (*cp)->chain[i - 1], (*cp)->chain[i]);
+    }
+}
+
+/**
+ * This function adds the cells of the edge provided to it to the path,
+ * after the cell it leaves, unpacking it if it's a shortcut.
+ */
+void ch_unpack(ch* cp, uint32_t from, uint32_t to)
+{
+    uint32_t mid;   /* The cell the edge shortcuts through. */
+
+    /* A shortcut is the two edges it was made from. */
+    mid = ch_find_mid(*cp, from, to);
+    if (mid != GRAPH_NO_CELL)
+    {
+        ch_unpack(cp, from, mid);
+        ch_unpack(cp, mid, to);
+        return;
+    }
+
+    /* Double the path's capacity if it's full. */
+    if ((*cp)->path_size == (*cp)->path_capacity)
+    {
+        (*cp)->path_capacity *= 2;
+        (*cp)->path = (uint32_t*) realloc(
+                (*cp)->path, sizeof(uint32_t) * (*cp)->path_capacity);
+    }
+    (*cp)->path[(*cp)->path_size] = to;
+    (*cp)->path_size++;
+}
+
+/**
+ * This function returns the cell the edge provided to it shortcuts
+ * through, or GRAPH_NO_CELL if it isn't a shortcut.
+ */
+uint32_t ch_find_mid(ch c, uint32_t from, uint32_t to)
+{
+    uint32_t e;     /* The current edge. */
+
+    /* The edge is kept with whichever of its cells is lower down. */
+    if (c->rank[from] < c->rank[to])
+    {
+        for (e = c->up_first[from]; e < c->up_first[from + 1]; e++)
+        {
+            if (c->up_to[e] == to)
+            {
+                return c->up_mid[e];
+            }
+        }
+    }
+    else
+    {
+        for (e = c->down_first[to]; e < c->down_first[to + 1]; e++)
+        {
+            if (c->down_from[e] == from)
+            {
+                return c->down_mid[e];
+            }
+        }
+    }
+    return GRAPH_NO_CELL;
+}
+
+/**
+ * This function writes the data provided to it to the file also provided.
+ */
+void ch_write(FILE* fp, const void* data, size_t size, size_t count)
+{
+    if (fwrite(data, size, count, fp) != count)
+    {
+        fprintf(stdout,
+                "\nERROR: In function ch_write(): could not write the "
+                "hierarchy!\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * This function reads the data provided to it from the file also provided.
+ */
+void ch_read(FILE* fp, void* data, size_t size, size_t count)
+{
+    if (fread(data, size, count, fp) != count)
+    {
+        fprintf(stdout,
+                "\nERROR: In function ch_read(): could not read the "
+                "hierarchy!\n");
+        exit(EXIT_FAILURE);
+    }
+}
@@ -0,0 +1,102 @@
+/**
+ * ch.h
+ *
+ * This file contains the data-structure and function prototype declarations
+ * for the ch type.
+ *
+ * The ch type is a contraction hierarchy. It's built once from the edges of
+ * a graph, including the ones added with graph_add_edge(), by contracting
+ * the cells one by one, least important first, and adding shortcut edges
+ * between the neighbours of each contracted cell where the path through it
+ * is the only shortest one. A cell's importance is its edge difference: the
+ * number of shortcuts contracting it would add, less the number of edges it
+ * has, plus the number of its neighbours already contracted. Cells that
+ * aren't neighbours are contracted at the same time by several threads.
+ *
+ * A search then only ever moves up the hierarchy, from both ends at once,
+ * and the shortcuts on the path it finds are unpacked into the edges of the
+ * graph. The hierarchy can be saved to a file and loaded again, so it only
+ * has to be built once.
+ *
+ * The hierarchy is built from the graph as it is when ch_init() is called.
+ * Changes made to the graph after that aren't seen by it.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#ifndef CH_H
+#define CH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "graph.h"
+#include "id_heap.h"
+
+/**
+ * The data-structure of the ch type.
+ */
+typedef struct ch_data* ch;
+
+/**
+ * This function initialises the ch provided to it by building a contraction
+ * hierarchy of the graph also provided to the function, with the number of
+ * threads also provided.
+ */
+void ch_init(ch* cp, graph* gp, uint8_t num_threads);
+
+/**
+ * This function initialises the ch provided to it with the contraction
+ * hierarchy saved to the file with the name also provided. The hierarchy
+ * must have been built from the graph also provided to the function.
+ */
+void ch_load(ch* cp, graph* gp, const char* filename);
+
+/**
+ * This function saves the contraction hierarchy of the ch provided to it to
+ * the file with the name also provided.
+ */
+void ch_save(ch c, const char* filename);
+
+/**
+ * This function destroys the ch provided to it.
+ */
+void ch_free(ch* cp);
+
+/**
+ * This function searches for the shortest path from the start cell to the
+ * end cell.
+ */
+void ch_search(ch* cp, uint32_t start, uint32_t end);
+
+/**
+ * This function returns the ids of the cells that make up the shortest path
+ * found by ch_search(), from the start cell to the end cell.
+ */
+uint32_t* ch_get_path(ch c);
+
+/**
+ * This function returns the number of cells in the path found by
+ * ch_search(). It is 0 if no path was found.
+ */
+uint32_t ch_get_path_size(ch c);
+
+/**
+ * This function returns the cost of the path found by ch_search(), or
+ * UINT32_MAX if no path was found.
+ */
+uint32_t ch_get_cost(ch c);
+
+/**
+ * This function returns the number of shortcuts in the contraction
+ * hierarchy of the ch provided to it.
+ */
+uint32_t ch_get_num_shortcuts(ch c);
+
+#endif // CH_H
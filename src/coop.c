@@ -0,0 +1,654 @@
+/**
+ * coop.c
+ *
+ * This file contains the internal data-structure and function definitions
+ * for the coop type.
+ *
+ * The reservation table and the states a unit's search has reached are
+ * both kept in hash_maps, keyed by a cell id in the top 32 bits and a
+ * timestep in the bottom 32 bits, as only a few of the pairs are ever used.
+ * The table holds the unit that reserved each pair, and the states hold the
+ * index of each pair's node in the search's pool of nodes.
+ *
+ * The search's open list is a binary heap of 64-bit keys, each the node's
+ * estimated total cost in the top 32 bits and its index in the bottom 32
+ * bits. A node whose cost is lowered is added again, and the old key is
+ * skipped when it comes up because the node is closed by then.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#include "coop.h"
+
+/**
+ * This is the parent of a search's first node.
+ */
+#define COOP_NO_NODE UINT32_MAX
+
+/**
+ * This is the internal data-structure of the coop type.
+ */
+struct coop_data {
+    graph* gp;              /* The graph to plan paths on. */
+    uint32_t window;        /* The number of timesteps planned at once. */
+    uint32_t batch_size;    /* The number of units estimated at once. */
+    uint32_t num_units;     /* The number of units. */
+    uint32_t units_capacity; /* The number of units there's room for. */
+    uint32_t* position;     /* The cell each unit is in. */
+    uint32_t* goal;         /* The goal cell of each unit. */
+    uint32_t* plans;        /* The cells of each unit's plan. */
+    uint32_t first;         /* The unit that picks first next time. */
+    uint32_t num_failed;    /* The units that couldn't find a plan. */
+    hash_map reserved;      /* The unit that reserved each cell and time. */
+    sssp s;                 /* The searches for the estimates. */
+    uint32_t* sources;      /* The goals of the current batch. */
+    uint32_t** dists;       /* The cost to each goal of the batch. */
+    hash_map states;        /* The node of each cell and time reached. */
+    uint32_t* node_cell;    /* The cell of each node. */
+    uint32_t* node_t;       /* The timestep of each node. */
+    uint32_t* node_g;       /* The cost of the path to each node. */
+    uint32_t* node_parent;  /* The node each node's path came from. */
+    bool* node_closed;      /* Whether each node has been expanded. */
+    uint32_t num_nodes;     /* The number of nodes. */
+    uint32_t nodes_capacity; /* The number of nodes there's room for. */
+    uint64_t* heap;         /* The open list. */
+    uint32_t heap_size;     /* The number of keys in the open list. */
+    uint32_t heap_capacity; /* The number of keys there's room for. */
+};
+
+/**
+ * This function plans the window for the unit provided to it, with the
+ * costs to its goal also provided. It returns false if there's no plan.
+ */
+bool coop_plan_unit(coop* cp, uint32_t unit, uint32_t* dist);
+
+/**
+ * This function assesses the move from the node provided to it to the cell
+ * also provided, with the cost also provided, for the unit also provided.
+ */
+void coop_relax(coop* cp, uint32_t unit, uint32_t parent, uint32_t to,
+                uint32_t w, uint32_t* dist);
+
+/**
+ * This function reserves the cell provided to it at the timestep also
+ * provided for the unit also provided, unless it's already reserved.
+ */
+void coop_reserve(coop* cp, uint32_t cell, uint32_t t, uint32_t unit);
+
+/**
+ * This function returns the unit that reserved the cell provided to it at
+ * the timestep also provided, or HASH_MAP_ABSENT if no unit has.
+ */
+uint32_t coop_get_owner(coop c, uint32_t cell, uint32_t t);
+
+/**
+ * This function adds a node to the search's pool and returns its index.
+ */
+uint32_t coop_add_node(coop* cp, uint32_t cell, uint32_t t, uint32_t g,
+                       uint32_t parent);
+
+/**
+ * This function adds the key provided to it to the open list.
+ */
+void coop_heap_push(coop* cp, uint64_t key);
+
+/**
+ * This function takes the lowest key off the open list and returns it.
+ */
+uint64_t coop_heap_pop(coop* cp);
+
+/**
+ * This function initialises the coop provided to it to plan paths on the
+ * graph also provided, the number of timesteps of the window also provided
+ * ahead, finding the estimates for the batch size of units also provided at
+ * a time with the number of threads also provided.
+ */
+void coop_init(coop* cp, graph* gp, uint32_t window, uint32_t batch_size,
+               uint8_t num_threads)
+{
+    uint32_t i;     /* The index of the current unit of a batch. */
+
+    /* Check the window and the batches aren't empty. */
+    if (window == 0 || batch_size == 0)
+    {
+        fprintf(stdout,
+                "\nERROR: In function coop_init(): the window and the "
+                "batch size must be at least 1!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Allocate memory to the coop. */
+    *cp = (coop) malloc(sizeof(struct coop_data));
+
+    /* There are no units yet. */
+    (*cp)->gp = gp;
+    (*cp)->window = window;
+    (*cp)->batch_size = batch_size;
+    (*cp)->num_units = 0;
+    (*cp)->units_capacity = 0;
+    (*cp)->position = NULL;
+    (*cp)->goal = NULL;
+    (*cp)->plans = NULL;
+    (*cp)->first = 0;
+    (*cp)->num_failed = 0;
+    hash_map_init(&(*cp)->reserved, 1024);
+
+    /* Allocate memory to the estimates of a batch. */
+    sssp_init(&(*cp)->s, gp, num_threads);
+    (*cp)->sources = (uint32_t*) malloc(sizeof(uint32_t) * batch_size);
+    (*cp)->dists = (uint32_t**) malloc(sizeof(uint32_t*) * batch_size);
+    for (i = 0; i < batch_size; i++)
+    {
+        (*cp)->dists[i] = (uint32_t*) malloc(
+                sizeof(uint32_t) * graph_get_cell_count(*gp));
+    }
+
+    /* The searches' nodes and open list grow as they're needed. */
+    hash_map_init(&(*cp)->states, 1024);
+    (*cp)->node_cell = NULL;
+    (*cp)->node_t = NULL;
+    (*cp)->node_g = NULL;
+    (*cp)->node_parent = NULL;
+    (*cp)->node_closed = NULL;
+    (*cp)->num_nodes = 0;
+    (*cp)->nodes_capacity = 0;
+    (*cp)->heap = NULL;
+    (*cp)->heap_size = 0;
+    (*cp)->heap_capacity = 0;
+}
+
+/**
+ * This function destroys the coop provided to it.
+ */
+void coop_free(coop* cp)
+{
+    uint32_t i;     /* The index of the current unit of a batch. */
+
+    /* De-allocate memory from the units. */
+    free((*cp)->position);
+    free((*cp)->goal);
+    free((*cp)->plans);
+    hash_map_free(&(*cp)->reserved);
+
+    /* De-allocate memory from the estimates. */
+    sssp_free(&(*cp)->s);
+    for (i = 0; i < (*cp)->batch_size; i++)
+    {
+        free((*cp)->dists[i]);
+    }
+    free((*cp)->dists);
+    free((*cp)->sources);
+
+    /* De-allocate memory from the searches. */
+    hash_map_free(&(*cp)->states);
+    free((*cp)->node_cell);
+    free((*cp)->node_t);
+    free((*cp)->node_g);
+    free((*cp)->node_parent);
+    free((*cp)->node_closed);
+    free((*cp)->heap);
+
+    /* De-allocate memory from the coop. */
+    free(*cp);
+}
+
+/**
+ * This function adds a unit at the start cell provided to it, heading for
+ * the goal cell also provided, to the coop also provided. It returns the
+ * number of the unit.
+ */
+uint32_t coop_add_unit(coop* cp, uint32_t start, uint32_t goal)
+{
+    uint32_t unit;  /* The number of the new unit. */
+    uint32_t t;     /* The current timestep. */
+
+    /* Double the room for units if it's full. */
+    if ((*cp)->num_units == (*cp)->units_capacity)
+    {
+        (*cp)->units_capacity = (*cp)->units_capacity == 0
+                              ? 16 : (*cp)->units_capacity * 2;
+        (*cp)->position = (uint32_t*) realloc((*cp)->position,
+                sizeof(uint32_t) * (*cp)->units_capacity);
+        (*cp)->goal = (uint32_t*) realloc((*cp)->goal,
+                sizeof(uint32_t) * (*cp)->units_capacity);
+        (*cp)->plans = (uint32_t*) realloc((*cp)->plans,
+                sizeof(uint32_t) * (*cp)->units_capacity
+                                 * ((*cp)->window + 1));
+    }
+
+    /* The unit waits where it is until it's planned for. */
+    unit = (*cp)->num_units;
+    (*cp)->position[unit] = start;
+    (*cp)->goal[unit] = goal;
+    for (t = 0; t <= (*cp)->window; t++)
+    {
+        (*cp)->plans[unit * ((*cp)->window + 1) + t] = start;
+    }
+    (*cp)->num_units++;
+    return unit;
+}
+
+/**
+ * This function gives the unit provided to it a new goal cell.
+ */
+void coop_set_goal(coop* cp, uint32_t unit, uint32_t goal)
+{
+    (*cp)->goal[unit] = goal;
+}
+
+/**
+ * This function plans the next window of timesteps for every unit.
+ */
+void coop_plan(coop* cp)
+{
+    uint32_t* plan;     /* The plan of the current unit. */
+    uint32_t done;      /* The number of units planned. */
+    uint32_t count;     /* The number of units in the current batch. */
+    uint32_t unit;      /* The current unit. */
+    uint32_t i;         /* The index of the unit in the batch. */
+    uint32_t t;         /* The current timestep. */
+
+    /* Make sure the graph's index of edges is up to date. */
+    graph_update_index((*cp)->gp);
+
+    /* Start a new reservation table. A unit that hasn't been planned for
+     * yet is taken to wait where it is, so those cells are reserved for the
+     * whole window first. That way a unit can always wait when its turn
+     * comes, and no plan ever runs into another. */
+    hash_map_clear(&(*cp)->reserved);
+    for (unit = 0; unit < (*cp)->num_units; unit++)
+    {
+        for (t = 0; t <= (*cp)->window; t++)
+        {
+            coop_reserve(cp, (*cp)->position[unit], t, unit);
+        }
+    }
+    (*cp)->num_failed = 0;
+
+    /* Plan the units a batch at a time, in turn from the one that picks
+     * first. */
+    for (done = 0; done < (*cp)->num_units; done += count)
+    {
+        /* Find the cost to every goal of the batch at once. */
+        count = (*cp)->num_units - done;
+        if (count > (*cp)->batch_size)
+        {
+            count = (*cp)->batch_size;
+        }
+        for (i = 0; i < count; i++)
+        {
+            unit = ((*cp)->first + done + i) % (*cp)->num_units;
+            (*cp)->sources[i] = (*cp)->goal[unit];
+        }
+        sssp_run_many(&(*cp)->s, (*cp)->sources, count, (*cp)->dists, true);
+
+        /* Plan each unit of the batch in place of its waiting and reserve
+         * its cells. A unit with no plan waits where it is. */
+        for (i = 0; i < count; i++)
+        {
+            unit = ((*cp)->first + done + i) % (*cp)->num_units;
+            plan = &(*cp)->plans[unit * ((*cp)->window + 1)];
+            for (t = 1; t <= (*cp)->window; t++)
+            {
+                hash_map_remove(&(*cp)->reserved,
+                                ((uint64_t) (*cp)->position[unit] << 32) | t);
+            }
+            if (!coop_plan_unit(cp, unit, (*cp)->dists[i]))
+            {
+                for (t = 0; t <= (*cp)->window; t++)
+                {
+                    plan[t] = (*cp)->position[unit];
+                }
+                (*cp)->num_failed++;
+            }
+            for (t = 1; t <= (*cp)->window; t++)
+            {
+                coop_reserve(cp, plan[t], t, unit);
+            }
+        }
+    }
+
+    /* Let the next unit pick first next time. */
+    if ((*cp)->num_units > 0)
+    {
+        (*cp)->first = ((*cp)->first + 1) % (*cp)->num_units;
+    }
+}
+
+/**
+ * This function moves every unit the number of timesteps provided to it
+ * along its plan. It can't move them further than the window.
+ */
+void coop_advance(coop* cp, uint32_t steps)
+{
+    uint32_t unit;  /* The current unit. */
+
+    if (steps > (*cp)->window)
+    {
+        steps = (*cp)->window;
+    }
+    for (unit = 0; unit < (*cp)->num_units; unit++)
+    {
+        (*cp)->position[unit] =
+                (*cp)->plans[unit * ((*cp)->window + 1) + steps];
+    }
+}
+
+/**
+ * This function returns the number of units in the coop provided to it.
+ */
+uint32_t coop_get_num_units(coop c)
+{
+    return c->num_units;
+}
+
+/**
+ * This function returns the cell the unit provided to it is in.
+ */
+uint32_t coop_get_position(coop c, uint32_t unit)
+{
+    return c->position[unit];
+}
+
+/**
+ * This function returns the goal cell of the unit provided to it.
+ */
+uint32_t coop_get_goal(coop c, uint32_t unit)
+{
+    return c->goal[unit];
+}
+
+/**
+ * This function returns the cells the unit provided to it plans to be in at
+ * each timestep of the window, starting with the cell it's in now. There
+ * are one more of them than the number of timesteps in the window.
+ */
+uint32_t* coop_get_plan(coop c, uint32_t unit)
+{
+    return &c->plans[unit * (c->window + 1)];
+}
+
+/**
+ * This function returns the number of timesteps of the window of the coop
+ * provided to it.
+ */
+uint32_t coop_get_window(coop c)
+{
+    return c->window;
+}
+
+/**
+ * This function returns the number of units that couldn't find a plan the
+ * last time the coop provided to it planned, and were left waiting where
+ * they were.
+ */
+uint32_t coop_get_num_failed(coop c)
+{
+    return c->num_failed;
+}
+
+/**
+ * This function plans the window for the unit provided to it, with the
+ * costs to its goal also provided. It returns false if there's no plan.
+ */
+bool coop_plan_unit(coop* cp, uint32_t unit, uint32_t* dist)
+{
+    graph g;            /* The graph. */
+    uint32_t* plan;     /* The unit's plan. */
+    uint32_t start;     /* The cell the unit is in. */
+    uint32_t current;   /* The node being expanded. */
+    uint32_t cell;      /* The cell of the node. */
+    uint32_t e;         /* The edge leading to the neighbour. */
+    uint32_t last;      /* The end of the cell's edges. */
+    uint8_t w;          /* The cost of moving to the neighbour. */
+
+    /* A unit that can't reach its goal has nothing to plan. */
+    g = *(*cp)->gp;
+    start = (*cp)->position[unit];
+    if (dist[start] == SSSP_UNREACHABLE)
+    {
+        return false;
+    }
+
+    /* Start a new search from the unit's cell now. */
+    hash_map_clear(&(*cp)->states);
+    (*cp)->num_nodes = 0;
+    (*cp)->heap_size = 0;
+    current = coop_add_node(cp, start, 0, 0, COOP_NO_NODE);
+    hash_map_put(&(*cp)->states, (uint64_t) start << 32, current);
+    coop_heap_push(cp, ((uint64_t) dist[start] << 32) | current);
+
+    /* Expand the most promising node until one at the end of the window
+     * comes up. The estimate takes care of the rest of the way. */
+    while ((*cp)->heap_size > 0)
+    {
+        current = (uint32_t) coop_heap_pop(cp);
+        if ((*cp)->node_closed[current])
+        {
+            continue;
+        }
+        (*cp)->node_closed[current] = true;
+
+        /* Write the plan out once the window is filled. */
+        if ((*cp)->node_t[current] == (*cp)->window)
+        {
+            plan = &(*cp)->plans[unit * ((*cp)->window + 1)];
+            for (; current != COOP_NO_NODE;
+                 current = (*cp)->node_parent[current])
+            {
+                plan[(*cp)->node_t[current]] = (*cp)->node_cell[current];
+            }
+            return true;
+        }
+
+        /* Waiting costs a timestep, except at the goal. */
+        cell = (*cp)->node_cell[current];
+        coop_relax(cp, unit, current, cell,
+                   cell == (*cp)->goal[unit] ? 0 : 1, dist);
+
+        /* Assess the moves to the cell's neighbours. */
+        last = graph_get_first_edge(g, cell + 1);
+        for (e = graph_get_first_edge(g, cell); e < last; e++)
+        {
+            w = graph_get_edge_w(g, e);
+            if (w != 0)
+            {
+                coop_relax(cp, unit, current, graph_get_edge_to(g, e), w,
+                           dist);
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * This function assesses the move from the node provided to it to the cell
+ * also provided, with the cost also provided, for the unit also provided.
+ */
+void coop_relax(coop* cp, uint32_t unit, uint32_t parent, uint32_t to,
+                uint32_t w, uint32_t* dist)
+{
+    uint32_t from;      /* The cell the move is from. */
+    uint32_t t;         /* The timestep the move is made at. */
+    uint32_t owner;     /* The unit that reserved the cell next. */
+    uint32_t g;         /* The cost of the path through the move. */
+    uint32_t node;      /* The node the move leads to. */
+    uint64_t key;       /* The cell and timestep the move leads to. */
+
+    /* Moves to cells the goal can't be reached from lead nowhere. */
+    if (dist[to] == SSSP_UNREACHABLE)
+    {
+        return;
+    }
+
+    /* The cell can't be reserved by another unit for the next timestep. */
+    from = (*cp)->node_cell[parent];
+    t = (*cp)->node_t[parent];
+    owner = coop_get_owner(*cp, to, t + 1);
+    if (owner != HASH_MAP_ABSENT && owner != unit)
+    {
+        return;
+    }
+
+    /* Nor can the unit swap cells with another unit. */
+    if (to != from)
+    {
+        owner = coop_get_owner(*cp, to, t);
+        if (owner != HASH_MAP_ABSENT && owner != unit
+            && coop_get_owner(*cp, from, t + 1) == owner)
+        {
+            return;
+        }
+    }
+
+    /* Keep the cheapest path to each cell and timestep. */
+    g = (*cp)->node_g[parent] + w;
+    key = ((uint64_t) to << 32) | (t + 1);
+    node = hash_map_get((*cp)->states, key);
+    if (node == HASH_MAP_ABSENT)
+    {
+        node = coop_add_node(cp, to, t + 1, g, parent);
+        hash_map_put(&(*cp)->states, key, node);
+    }
+    else if ((*cp)->node_closed[node] || g >= (*cp)->node_g[node])
+    {
+        return;
+    }
+    else
+    {
+        (*cp)->node_g[node] = g;
+        (*cp)->node_parent[node] = parent;
+    }
+    coop_heap_push(cp, ((uint64_t) (g + dist[to]) << 32) | node);
+}
+
+/**
+ * This function reserves the cell provided to it at the timestep also
+ * provided for the unit also provided, unless it's already reserved.
+ */
+void coop_reserve(coop* cp, uint32_t cell, uint32_t t, uint32_t unit)
+{
+    if (coop_get_owner(*cp, cell, t) == HASH_MAP_ABSENT)
+    {
+        hash_map_put(&(*cp)->reserved, ((uint64_t) cell << 32) | t, unit);
+    }
+}
+
+/**
+ * This function returns the unit that reserved the cell provided to it at
+ * the timestep also provided, or HASH_MAP_ABSENT if no unit has.
+ */
+uint32_t coop_get_owner(coop c, uint32_t cell, uint32_t t)
+{
+    return hash_map_get(c->reserved, ((uint64_t) cell << 32) | t);
+}
+
+/**
+ * This function adds a node to the search's pool and returns its index.
+ */
+uint32_t coop_add_node(coop* cp, uint32_t cell, uint32_t t, uint32_t g,
+                       uint32_t parent)
+{
+    uint32_t node;  /* The index of the new node. */
+
+    /* Double the pool's capacity if it's full. */
+    if ((*cp)->num_nodes == (*cp)->nodes_capacity)
+    {
+        (*cp)->nodes_capacity = (*cp)->nodes_capacity == 0
+                              ? 1024 : (*cp)->nodes_capacity * 2;
+        (*cp)->node_cell = (uint32_t*) realloc((*cp)->node_cell,
+                sizeof(uint32_t) * (*cp)->nodes_capacity);
+        (*cp)->node_t = (uint32_t*) realloc((*cp)->node_t,
+                sizeof(uint32_t) * (*cp)->nodes_capacity);
+        (*cp)->node_g = (uint32_t*) realloc((*cp)->node_g,
+                sizeof(uint32_t) * (*cp)->nodes_capacity);
+        (*cp)->node_parent = (uint32_t*) realloc((*cp)->node_parent,
+                sizeof(uint32_t) * (*cp)->nodes_capacity);
+        (*cp)->node_closed = (bool*) realloc((*cp)->node_closed,
+                sizeof(bool) * (*cp)->nodes_capacity);
+    }
+
+    /* Fill the node in. */
+    node = (*cp)->num_nodes;
+    (*cp)->node_cell[node] = cell;
+    (*cp)->node_t[node] = t;
+    (*cp)->node_g[node] = g;
+    (*cp)->node_parent[node] = parent;
+    (*cp)->node_closed[node] = false;
+    (*cp)->num_nodes++;
+    return node;
+}
+
+/**
+ * This function adds the key provided to it to the open list.
+ */
+void coop_heap_push(coop* cp, uint64_t key)
+{
+    uint64_t* heap;     /* The open list. */
+    uint32_t i;         /* The position of the new key. */
+    uint32_t parent;    /* The position of its parent. */
+
+    /* Double the open list's capacity if it's full. */
+    if ((*cp)->heap_size == (*cp)->heap_capacity)
+    {
+        (*cp)->heap_capacity = (*cp)->heap_capacity == 0
+                             ? 1024 : (*cp)->heap_capacity * 2;
+        (*cp)->heap = (uint64_t*) realloc((*cp)->heap,
+                sizeof(uint64_t) * (*cp)->heap_capacity);
+    }
+
+    /* Move the key up past every parent with a higher key. */
+    heap = (*cp)->heap;
+    i = (*cp)->heap_size;
+    (*cp)->heap_size++;
+    while (i > 0)
+    {
+        parent = (i - 1) / 2;
+        if (heap[parent] <= key)
+        {
+            break;
+        }
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = key;
+}
+
+/**
+ * This function takes the lowest key off the open list and returns it.
+ */
+uint64_t coop_heap_pop(coop* cp)
+{
+    uint64_t* heap;     /* The open list. */
+    uint64_t top;       /* The lowest key. */
+    uint64_t key;       /* The key being moved down. */
+    uint32_t size;      /* The number of keys left. */
+    uint32_t i;         /* The position of the key being moved down. */
+    uint32_t child;     /* The position of its lower child. */
+
+    /* Move the last key down from the top past every lower child. */
+    heap = (*cp)->heap;
+    top = heap[0];
+    (*cp)->heap_size--;
+    size = (*cp)->heap_size;
+    key = heap[size];
+    i = 0;
+    while (2 * i + 1 < size)
+    {
+        child = 2 * i + 1;
+        if (child + 1 < size && heap[child + 1] < heap[child])
+        {
+            child++;
+        }
+        if (key <= heap[child])
+        {
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = key;
+    return top;
+}
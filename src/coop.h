@@ -0,0 +1,120 @@
+/**
+ * coop.h
+ *
+ * This file contains the data-structure and function prototype declarations
+ * for the coop type.
+ *
+ * The coop type plans paths for many units at once so they don't collide,
+ * using Windowed Hierarchical Cooperative A* (WHCA*). Each unit searches
+ * over pairs of a cell and a timestep, a set number of timesteps ahead, and
+ * can move to a neighbouring cell or wait each timestep. The cells the
+ * units already planned will be in at each timestep are kept in a shared
+ * reservation table, and a unit can't plan to be in a cell someone else has
+ * reserved, or to swap cells with another unit. The estimate of the rest of
+ * the way is the true cost of the cheapest path from a cell to the unit's
+ * goal, ignoring the other units, which is found for a batch of units at a
+ * time with one thread per unit.
+ *
+ * A unit that hasn't been planned for yet is taken to wait where it is, so
+ * a unit can always at least wait and the plans never run into each other.
+ *
+ * Only a window of timesteps is planned at once. The units are moved part
+ * of the way along their plans with coop_advance() and planned again,
+ * starting with a different unit each time so no unit is always the last
+ * to pick.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#ifndef COOP_H
+#define COOP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "graph.h"
+#include "hash_map.h"
+#include "sssp.h"
+
+/**
+ * The data-structure of the coop type.
+ */
+typedef struct coop_data* coop;
+
+/**
+ * This function initialises the coop provided to it to plan paths on the
+ * graph also provided, the number of timesteps of the window also provided
+ * ahead, finding the estimates for the batch size of units also provided at
+ * a time with the number of threads also provided.
+ */
+void coop_init(coop* cp, graph* gp, uint32_t window, uint32_t batch_size,
+               uint8_t num_threads);
+
+/**
+ * This function destroys the coop provided to it.
+ */
+void coop_free(coop* cp);
+
+/**
+ * This function adds a unit at the start cell provided to it, heading for
+ * the goal cell also provided, to the coop also provided. It returns the
+ * number of the unit.
+ */
+uint32_t coop_add_unit(coop* cp, uint32_t start, uint32_t goal);
+
+/**
+ * This function gives the unit provided to it a new goal cell.
+ */
+void coop_set_goal(coop* cp, uint32_t unit, uint32_t goal);
+
+/**
+ * This function plans the next window of timesteps for every unit.
+ */
+void coop_plan(coop* cp);
+
+/**
+ * This function moves every unit the number of timesteps provided to it
+ * along its plan. It can't move them further than the window.
+ */
+void coop_advance(coop* cp, uint32_t steps);
+
+/**
+ * This function returns the number of units in the coop provided to it.
+ */
+uint32_t coop_get_num_units(coop c);
+
+/**
+ * This function returns the cell the unit provided to it is in.
+ */
+uint32_t coop_get_position(coop c, uint32_t unit);
+
+/**
+ * This function returns the goal cell of the unit provided to it.
+ */
+uint32_t coop_get_goal(coop c, uint32_t unit);
+
+/**
+ * This function returns the cells the unit provided to it plans to be in at
+ * each timestep of the window, starting with the cell it's in now. There
+ * are one more of them than the number of timesteps in the window.
+ */
+uint32_t* coop_get_plan(coop c, uint32_t unit);
+
+/**
+ * This function returns the number of timesteps of the window of the coop
+ * provided to it.
+ */
+uint32_t coop_get_window(coop c);
+
+/**
+ * This function returns the number of units that couldn't find a plan the
+ * last time the coop provided to it planned, and were left waiting where
+ * they were.
+ */
+uint32_t coop_get_num_failed(coop c);
+
+#endif // COOP_H
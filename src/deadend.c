@@ -0,0 +1,1125 @@
+/**
+ * deadend.c
+ *
+ * This file contains the internal data-structure and function definitions
+ * for the deadend type.
+ *
+ * Each cell has the id of the region it's in, and each region the sector
+ * it's in, the box around its cells and the order it was pruned in, which
+ * is 0 while it isn't pruned. The ids of regions whose sectors have been
+ * split again are kept in a list and reused.
+ *
+ * The doorway of a region is the unpruned passable cells outside it that
+ * one of its cells has an edge to or from. To test a region, a scan from
+ * each cell of its doorway only moves to cells whose cost from the cell is
+ * the estimate, staying out of the region and the pruned regions and within
+ * a cell of the region's box. The region is pruned if every scan reaches
+ * every other cell of the doorway.
+ *
+ * When a pruned region isn't pruned any more, the pruned regions next to it
+ * that were pruned after it were tested without its cells in their doorway,
+ * so they aren't pruned any more either, and are tested again.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#include "deadend.h"
+
+/**
+ * This is the region of a cell that isn't in one.
+ */
+#define DEADEND_NONE UINT32_MAX
+
+/**
+ * This is the internal data-structure of the deadend type.
+ */
+struct deadend_data {
+    graph* gp;              /* The graph the regions split up. */
+    uint8_t size[3];        /* The width of the graph along each axis. */
+    uint8_t num_sectors[3]; /* The number of sectors along each axis. */
+
+    /* The regions. */
+    uint32_t* region_of;    /* The region each cell is in. */
+    uint32_t* sector;       /* The sector of each region. */
+    uint32_t* order;        /* The order each region was pruned in. */
+    uint8_t* lo;            /* The lowest coordinates of each region. */
+    uint8_t* hi;            /* The highest coordinates of each region. */
+    uint32_t num_ids;       /* The number of region ids used. */
+    uint32_t capacity;      /* The number of regions there's room for. */
+    uint32_t* spare;        /* The ids of regions that can be reused. */
+    uint32_t num_spare;     /* The number of ids that can be reused. */
+    uint32_t num_pruned;    /* The number of pruned regions. */
+    uint32_t next_order;    /* The order the next region is pruned in. */
+
+    /* The regions waiting to be tested. */
+    uint32_t* work;         /* The regions to test. */
+    uint32_t num_work;      /* The number of regions to test. */
+    bool* queued;           /* Whether each region is waiting. */
+    uint32_t* stack;        /* The regions to stop pruning. */
+    uint32_t* stack_order;  /* The order they were pruned in. */
+
+    /* The regions next to a region. */
+    uint32_t* neighbours;   /* The regions found. */
+    uint32_t num_neighbours; /* The number of regions found. */
+    uint32_t* region_visit; /* The time each region was last found. */
+    uint32_t region_stamp;  /* The number of the current time. */
+
+    /* The cells of a sector, and of a region's doorway. */
+    uint32_t* sector_cells; /* The cells of the sector. */
+    uint32_t num_sector_cells; /* The number of cells in the sector. */
+    uint32_t* sector_regions; /* The regions of the sector. */
+    uint32_t num_sector_regions; /* The number of regions in the sector. */
+    uint32_t doorway[DEADEND_MAX_DOORWAY]; /* The cells of the doorway. */
+    uint32_t num_doorway;   /* The number of cells in the doorway. */
+
+    /* The state of the scans over cells. */
+    uint32_t* cell_visit;   /* The scan each cell was last reached by. */
+    uint32_t cell_stamp;    /* The number of the current scan. */
+    uint32_t* cell_g;       /* The cost of each cell from the scan's cell. */
+    uint32_t* queue;        /* The cells waiting to be scanned from. */
+
+    /* The state of the current search, which lets in the pruned regions
+     * with its number. */
+    uint32_t* allowed;      /* The search each region was last let in by. */
+    uint32_t search;        /* The number of the current search. */
+    bool skip;              /* Whether the search leaves out any regions. */
+};
+
+/**
+ * This function returns whether the cell with the id provided to it is in
+ * the graph and passable.
+ */
+bool deadend_is_open(deadend d, uint32_t id);
+
+/**
+ * This function returns the sector of the cell with the id provided to it.
+ */
+uint32_t deadend_sector_of(deadend d, uint32_t id);
+
+/**
+ * This function gathers the cells of the sector provided to it.
+ */
+void deadend_gather_sector(deadend* dp, uint32_t s);
+
+/**
+ * This function gathers the regions of the sector provided to it.
+ */
+void deadend_gather_regions(deadend* dp, uint32_t s);
+
+/**
+ * This function returns an unused region id, making room for more regions
+ * if there isn't one.
+ */
+uint32_t deadend_new_region(deadend* dp);
+
+/**
+ * This function splits the passable cells of the sector provided to it into
+ * regions of connected cells, and queues them to be tested.
+ */
+void deadend_split_sector(deadend* dp, uint32_t s);
+
+/**
+ * This function stops pruning every region of the sector provided to it and
+ * hands their ids back.
+ */
+void deadend_clear_sector(deadend* dp, uint32_t s);
+
+/**
+ * This function finds the regions with an edge to or from the region
+ * provided to it.
+ */
+void deadend_find_neighbours(deadend* dp, uint32_t r);
+
+/**
+ * This function finds the doorway of the region provided to it. It returns
+ * false if the doorway has more than DEADEND_MAX_DOORWAY cells.
+ */
+bool deadend_find_doorway(deadend* dp, uint32_t r);
+
+/**
+ * This function returns whether every pair of cells in the doorway of the
+ * region provided to it is joined by a path around it that costs no more
+ * than the estimate.
+ */
+bool deadend_is_bypassed(deadend* dp, uint32_t r);
+
+/**
+ * This function scans the cells reachable from the cell provided to it for
+ * their estimated cost, around the region also provided.
+ */
+void deadend_scan(deadend* dp, uint32_t r, uint32_t from);
+
+/**
+ * This function returns the estimated cost between the two cells provided
+ * to it, the same as astar's.
+ */
+uint32_t deadend_estimate(deadend d, uint32_t a, uint32_t b);
+
+/**
+ * This function queues the region provided to it to be tested, if it isn't
+ * already waiting.
+ */
+void deadend_queue(deadend* dp, uint32_t r);
+
+/**
+ * This function tests the queued regions, pruning the ones that pass, until
+ * none are left.
+ */
+void deadend_prune(deadend* dp);
+
+/**
+ * This function stops pruning the region provided to it, and the pruned
+ * regions next to it that were pruned after it, and queues them to be
+ * tested again.
+ */
+void deadend_unprune(deadend* dp, uint32_t r);
+
+/**
+ * This function initialises the deadend provided to it by splitting the
+ * graph also provided into regions and pruning every region it can.
+ */
+void deadend_init(deadend* dp, graph* gp)
+{
+    uint32_t count;     /* The number of cells in the graph. */
+    uint32_t s;         /* The current sector. */
+    uint8_t axis;       /* The current axis. */
+
+    /* Allocate memory to the deadend. */
+    *dp = (deadend) malloc(sizeof(struct deadend_data));
+    (*dp)->gp = gp;
+    graph_update_index(gp);
+    count = graph_get_cell_count(*gp);
+    (*dp)->size[0] = graph_get_x_size(*gp);
+    (*dp)->size[1] = graph_get_y_size(*gp);
+    (*dp)->size[2] = graph_get_z_size(*gp);
+    for (axis = 0; axis < 3; axis++)
+    {
+        (*dp)->num_sectors[axis] = (uint8_t) (((*dp)->size[axis]
+                + DEADEND_SECTOR_SIZE - 1) / DEADEND_SECTOR_SIZE);
+    }
+
+    /* Initialise the regions, with room for one in every sector to start
+     * with. */
+    (*dp)->region_of = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*dp)->capacity = (uint32_t) (*dp)->num_sectors[0]
+                    * (*dp)->num_sectors[1] * (*dp)->num_sectors[2];
+    (*dp)->sector = (uint32_t*) malloc(sizeof(uint32_t) * (*dp)->capacity);
+    (*dp)->order = (uint32_t*) malloc(sizeof(uint32_t) * (*dp)->capacity);
+    (*dp)->lo = (uint8_t*) malloc(sizeof(uint8_t) * 3 * (*dp)->capacity);
+    (*dp)->hi = (uint8_t*) malloc(sizeof(uint8_t) * 3 * (*dp)->capacity);
+    (*dp)->spare = (uint32_t*) malloc(sizeof(uint32_t) * (*dp)->capacity);
+    (*dp)->work = (uint32_t*) malloc(sizeof(uint32_t) * (*dp)->capacity);
+    (*dp)->queued = (bool*) malloc(sizeof(bool) * (*dp)->capacity);
+    (*dp)->stack = (uint32_t*) malloc(sizeof(uint32_t) * (*dp)->capacity);
+    (*dp)->stack_order = (uint32_t*) malloc(
+            sizeof(uint32_t) * (*dp)->capacity);
+    (*dp)->neighbours = (uint32_t*) malloc(
+            sizeof(uint32_t) * (*dp)->capacity);
+    (*dp)->region_visit = (uint32_t*) calloc((*dp)->capacity,
+                                             sizeof(uint32_t));
+    (*dp)->num_ids = 0;
+    (*dp)->num_spare = 0;
+    (*dp)->num_pruned = 0;
+    (*dp)->next_order = 1;
+    (*dp)->num_work = 0;
+    (*dp)->num_neighbours = 0;
+    (*dp)->region_stamp = 0;
+
+    /* Initialise the state of the scans. */
+    (*dp)->sector_cells = (uint32_t*) malloc(sizeof(uint32_t)
+            * DEADEND_SECTOR_SIZE * DEADEND_SECTOR_SIZE * DEADEND_SECTOR_SIZE);
+    (*dp)->num_sector_cells = 0;
+    (*dp)->sector_regions = (uint32_t*) malloc(sizeof(uint32_t)
+            * DEADEND_SECTOR_SIZE * DEADEND_SECTOR_SIZE * DEADEND_SECTOR_SIZE);
+    (*dp)->num_sector_regions = 0;
+    (*dp)->num_doorway = 0;
+    (*dp)->cell_visit = (uint32_t*) calloc(count, sizeof(uint32_t));
+    (*dp)->cell_stamp = 0;
+    (*dp)->cell_g = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*dp)->queue = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*dp)->allowed = (uint32_t*) calloc((*dp)->capacity, sizeof(uint32_t));
+    (*dp)->search = 0;
+    (*dp)->skip = false;
+
+    /* Split every sector into regions and prune all that can be. */
+    for (s = 0; s < (*dp)->capacity; s++)
+    {
+        deadend_split_sector(dp, s);
+    }
+    deadend_prune(dp);
+}
+
+/**
+ * This function destroys the deadend provided to it.
+ */
+void deadend_free(deadend* dp)
+{
+    /* De-allocate memory from the regions. */
+    free((*dp)->region_of);
+    free((*dp)->sector);
+    free((*dp)->order);
+    free((*dp)->lo);
+    free((*dp)->hi);
+    free((*dp)->spare);
+    free((*dp)->work);
+    free((*dp)->queued);
+    free((*dp)->stack);
+    free((*dp)->stack_order);
+    free((*dp)->neighbours);
+    free((*dp)->region_visit);
+    free((*dp)->allowed);
+
+    /* De-allocate memory from the scans. */
+    free((*dp)->sector_cells);
+    free((*dp)->sector_regions);
+    free((*dp)->cell_visit);
+    free((*dp)->cell_g);
+    free((*dp)->queue);
+
+    /* De-allocate memory from the deadend. */
+    free(*dp);
+}
+
+/**
+ * This function brings the regions of the deadend provided to it up to date
+ * with the type of the cell with the id also provided, after it has been
+ * changed.
+ */
+void deadend_update(deadend* dp, uint32_t id)
+{
+    graph g;            /* The graph. */
+    uint8_t c[3];       /* The cell's coordinates. */
+    int32_t s[3];       /* The coordinates of the current sector. */
+    int32_t cs[3];      /* The coordinates of the cell's sector. */
+    uint32_t r;         /* The current region. */
+    uint32_t e;         /* The current edge. */
+    uint32_t i;         /* The index of the current region. */
+    uint8_t axis;       /* The current axis. */
+    bool near;          /* Whether the cell is near the region's box. */
+    bool in;            /* Whether the edges being followed come in. */
+
+    /* Stop pruning the regions whose test looked at the cell, which are
+     * the ones it's within a cell of. They can only be in the cell's
+     * sector or the sectors next to it. */
+    g = *(*dp)->gp;
+    graph_get_cell_coords(g, id, &c[0], &c[1], &c[2]);
+    for (axis = 0; axis < 3; axis++)
+    {
+        cs[axis] = c[axis] / DEADEND_SECTOR_SIZE;
+    }
+    for (s[2] = cs[2] - 1; s[2] <= cs[2] + 1; s[2]++)
+    {
+        for (s[1] = cs[1] - 1; s[1] <= cs[1] + 1; s[1]++)
+        {
+            for (s[0] = cs[0] - 1; s[0] <= cs[0] + 1; s[0]++)
+            {
+                if (s[0] < 0 || s[1] < 0 || s[2] < 0
+                    || s[0] >= (*dp)->num_sectors[0]
+                    || s[1] >= (*dp)->num_sectors[1]
+                    || s[2] >= (*dp)->num_sectors[2])
+                {
+                    continue;
+                }
+                deadend_gather_regions(dp, (uint32_t) ((s[2]
+                        * (*dp)->num_sectors[1] + s[1])
+                        * (*dp)->num_sectors[0] + s[0]));
+                for (i = 0; i < (*dp)->num_sector_regions; i++)
+                {
+                    r = (*dp)->sector_regions[i];
+                    near = true;
+                    for (axis = 0; axis < 3; axis++)
+                    {
+                        near = near && c[axis] + 1 >= (*dp)->lo[3 * r + axis]
+                                    && c[axis] <= (*dp)->hi[3 * r + axis] + 1;
+                    }
+                    if (near)
+                    {
+                        deadend_unprune(dp, r);
+                    }
+                }
+            }
+        }
+    }
+
+    /* So are the regions with edges to or from the cell from further
+     * away, as it's in their doorways. */
+    for (in = false; ; in = true)
+    {
+        for (e = in ? graph_get_first_in_edge(g, id)
+                    : graph_get_first_edge(g, id);
+             e < (in ? graph_get_first_in_edge(g, id + 1)
+                     : graph_get_first_edge(g, id + 1)); e++)
+        {
+            r = (*dp)->region_of[in ? graph_get_in_edge_from(g, e)
+                                    : graph_get_edge_to(g, e)];
+            if (r != DEADEND_NONE)
+            {
+                deadend_unprune(dp, r);
+            }
+        }
+        if (in)
+        {
+            break;
+        }
+    }
+
+    /* Split the cell's sector into regions again. */
+    r = (uint32_t) ((cs[2] * (*dp)->num_sectors[1] + cs[1])
+                    * (*dp)->num_sectors[0] + cs[0]);
+    deadend_clear_sector(dp, r);
+    deadend_split_sector(dp, r);
+
+    /* The regions next to the new ones may be prunable now as well. */
+    deadend_gather_regions(dp, r);
+    for (i = 0; i < (*dp)->num_sector_regions; i++)
+    {
+        deadend_find_neighbours(dp, (*dp)->sector_regions[i]);
+        while ((*dp)->num_neighbours > 0)
+        {
+            (*dp)->num_neighbours--;
+            r = (*dp)->neighbours[(*dp)->num_neighbours];
+            if ((*dp)->order[r] == 0)
+            {
+                deadend_queue(dp, r);
+            }
+        }
+    }
+    deadend_prune(dp);
+}
+
+/**
+ * This function readies the deadend provided to it for a search from the
+ * start cell to the end cell, after which deadend_is_skipped() says which
+ * cells the search can leave out.
+ */
+void deadend_begin_search(deadend* dp, uint32_t start, uint32_t end)
+{
+    uint32_t ends[2];   /* The start and end cells. */
+    uint32_t min_order; /* The earliest order of their regions. */
+    uint32_t num_stack; /* The number of regions on the stack. */
+    uint32_t r;         /* The current region. */
+    uint32_t n;         /* The current neighbour. */
+    uint32_t i;         /* The index of the current neighbour. */
+
+    /* Start a new search. */
+    (*dp)->search++;
+    if ((*dp)->search == 0)
+    {
+        memset((*dp)->allowed, 0, sizeof(uint32_t) * (*dp)->capacity);
+        (*dp)->search = 1;
+    }
+
+    /* A cell that isn't in a region wasn't in any region's doorway, so a
+     * search from or to it can't leave anything out. */
+    ends[0] = start;
+    ends[1] = end;
+    (*dp)->skip = (*dp)->region_of[start] != DEADEND_NONE
+                  && (*dp)->region_of[end] != DEADEND_NONE;
+    if (!(*dp)->skip)
+    {
+        return;
+    }
+
+    /* The graph without the regions pruned before the start and end cells'
+     * regions has paths as short. In it, a path only has to go through the
+     * pruned regions joined to theirs, so those are let in. */
+    min_order = UINT32_MAX;
+    num_stack = 0;
+    for (i = 0; i < 2; i++)
+    {
+        r = (*dp)->region_of[ends[i]];
+        if ((*dp)->order[r] != 0 && (*dp)->allowed[r] != (*dp)->search)
+        {
+            (*dp)->allowed[r] = (*dp)->search;
+            (*dp)->stack[num_stack] = r;
+            num_stack++;
+            if ((*dp)->order[r] < min_order)
+            {
+                min_order = (*dp)->order[r];
+            }
+        }
+    }
+    while (num_stack > 0)
+    {
+        num_stack--;
+        deadend_find_neighbours(dp, (*dp)->stack[num_stack]);
+        for (i = 0; i < (*dp)->num_neighbours; i++)
+        {
+            n = (*dp)->neighbours[i];
+            if ((*dp)->order[n] >= min_order
+                && (*dp)->allowed[n] != (*dp)->search)
+            {
+                (*dp)->allowed[n] = (*dp)->search;
+                (*dp)->stack[num_stack] = n;
+                num_stack++;
+            }
+        }
+    }
+}
+
+/**
+ * This function returns whether the search readied by
+ * deadend_begin_search() can leave out the cell with the id provided to it.
+ */
+bool deadend_is_skipped(deadend d, uint32_t id)
+{
+    uint32_t r;     /* The cell's region. */
+
+    r = d->region_of[id];
+    return d->skip && r != DEADEND_NONE && d->order[r] != 0
+           && d->allowed[r] != d->search;
+}
+
+/**
+ * This function returns whether the cell with the id provided to it is in a
+ * pruned region.
+ */
+bool deadend_is_pruned(deadend d, uint32_t id)
+{
+    return d->region_of[id] != DEADEND_NONE
+           && d->order[d->region_of[id]] != 0;
+}
+
+/**
+ * This function returns the number of regions the deadend provided to it
+ * has split the graph's passable cells into.
+ */
+uint32_t deadend_get_num_regions(deadend d)
+{
+    return d->num_ids - d->num_spare;
+}
+
+/**
+ * This function returns the number of regions the deadend provided to it
+ * has pruned.
+ */
+uint32_t deadend_get_num_pruned(deadend d)
+{
+    return d->num_pruned;
+}
+
+/**
+ * This function returns whether the cell with the id provided to it is in
+ * the graph and passable.
+ */
+bool deadend_is_open(deadend d, uint32_t id)
+{
+    return graph_cell_exists(*d->gp, id)
+           && node_get_type(*graph_get_cell_node(*d->gp, id)) == PASSABLE;
+}
+
+/**
+ * This function returns the sector of the cell with the id provided to it.
+ */
+uint32_t deadend_sector_of(deadend d, uint32_t id)
+{
+    uint8_t x, y, z;    /* The cell's coordinates. */
+
+    graph_get_cell_coords(*d->gp, id, &x, &y, &z);
+    return ((uint32_t) (z / DEADEND_SECTOR_SIZE) * d->num_sectors[1]
+            + y / DEADEND_SECTOR_SIZE) * d->num_sectors[0]
+           + x / DEADEND_SECTOR_SIZE;
+}
+
+/**
+ * This function gathers the cells of the sector provided to it.
+ */
+void deadend_gather_sector(deadend* dp, uint32_t s)
+{
+    uint32_t lo[3];     /* The lowest coordinates of the sector. */
+    uint32_t hi[3];     /* The coordinates just past the sector. */
+    uint32_t x, y, z;   /* The coordinates of the current cell. */
+    uint8_t axis;       /* The current axis. */
+
+    /* Work out the sector's corners. */
+    lo[0] = s % (*dp)->num_sectors[0];
+    lo[1] = s / (*dp)->num_sectors[0] % (*dp)->num_sectors[1];
+    lo[2] = s / (*dp)->num_sectors[0] / (*dp)->num_sectors[1];
+    for (axis = 0; axis < 3; axis++)
+    {
+        lo[axis] *= DEADEND_SECTOR_SIZE;
+        hi[axis] = lo[axis] + DEADEND_SECTOR_SIZE;
+        if (hi[axis] > (*dp)->size[axis])
+        {
+            hi[axis] = (*dp)->size[axis];
+        }
+    }
+
+    /* Gather the cells between them. */
+    (*dp)->num_sector_cells = 0;
+    for (z = lo[2]; z < hi[2]; z++)
+    {
+        for (y = lo[1]; y < hi[1]; y++)
+        {
+            for (x = lo[0]; x < hi[0]; x++)
+            {
+                (*dp)->sector_cells[(*dp)->num_sector_cells] =
+                        graph_get_cell_id(*(*dp)->gp, (uint8_t) x,
+                                          (uint8_t) y, (uint8_t) z);
+                (*dp)->num_sector_cells++;
+            }
+        }
+    }
+}
+
+/**
+ * This function gathers the regions of the sector provided to it.
+ */
+void deadend_gather_regions(deadend* dp, uint32_t s)
+{
+    uint32_t i;     /* The index of the current cell of the sector. */
+    uint32_t r;     /* The region of the current cell. */
+
+    deadend_gather_sector(dp, s);
+    (*dp)->region_stamp++;
+    (*dp)->num_sector_regions = 0;
+    for (i = 0; i < (*dp)->num_sector_cells; i++)
+    {
+        r = (*dp)->region_of[(*dp)->sector_cells[i]];
+        if (r != DEADEND_NONE
+            && (*dp)->region_visit[r] != (*dp)->region_stamp)
+        {
+            (*dp)->region_visit[r] = (*dp)->region_stamp;
+            (*dp)->sector_regions[(*dp)->num_sector_regions] = r;
+            (*dp)->num_sector_regions++;
+        }
+    }
+}
+
+/**
+ * This function returns an unused region id, making room for more regions
+ * if there isn't one.
+ */
+uint32_t deadend_new_region(deadend* dp)
+{
+    uint32_t r;     /* The new region. */
+
+    /* Reuse an id if one is spare. */
+    if ((*dp)->num_spare > 0)
+    {
+        (*dp)->num_spare--;
+        return (*dp)->spare[(*dp)->num_spare];
+    }
+
+    /* Otherwise make room for more regions if there isn't any. */
+    if ((*dp)->num_ids == (*dp)->capacity)
+    {
+        (*dp)->capacity *= 2;
+        (*dp)->sector = (uint32_t*) realloc((*dp)->sector,
+                sizeof(uint32_t) * (*dp)->capacity);
+        (*dp)->order = (uint32_t*) realloc((*dp)->order,
+                sizeof(uint32_t) * (*dp)->capacity);
+        (*dp)->lo = (uint8_t*) realloc((*dp)->lo,
+                sizeof(uint8_t) * 3 * (*dp)->capacity);
+        (*dp)->hi = (uint8_t*) realloc((*dp)->hi,
+                sizeof(uint8_t) * 3 * (*dp)->capacity);
+        (*dp)->spare = (uint32_t*) realloc((*dp)->spare,
+                sizeof(uint32_t) * (*dp)->capacity);
+        (*dp)->work = (uint32_t*) realloc((*dp)->work,
+                sizeof(uint32_t) * (*dp)->capacity);
+        (*dp)->queued = (bool*) realloc((*dp)->queued,
+                sizeof(bool) * (*dp)->capacity);
+        (*dp)->stack = (uint32_t*) realloc((*dp)->stack,
+                sizeof(uint32_t) * (*dp)->capacity);
+        (*dp)->stack_order = (uint32_t*) realloc((*dp)->stack_order,
+                sizeof(uint32_t) * (*dp)->capacity);
+        (*dp)->neighbours = (uint32_t*) realloc((*dp)->neighbours,
+                sizeof(uint32_t) * (*dp)->capacity);
+        (*dp)->region_visit = (uint32_t*) realloc((*dp)->region_visit,
+                sizeof(uint32_t) * (*dp)->capacity);
+        memset(&(*dp)->region_visit[(*dp)->num_ids], 0, sizeof(uint32_t)
+               * ((*dp)->capacity - (*dp)->num_ids));
+        (*dp)->allowed = (uint32_t*) realloc((*dp)->allowed,
+                sizeof(uint32_t) * (*dp)->capacity);
+        memset(&(*dp)->allowed[(*dp)->num_ids], 0, sizeof(uint32_t)
+               * ((*dp)->capacity - (*dp)->num_ids));
+    }
+    r = (*dp)->num_ids;
+    (*dp)->num_ids++;
+    (*dp)->queued[r] = false;
+    return r;
+}
+
+/**
+ * This function splits the passable cells of the sector provided to it into
+ * regions of connected cells, and queues them to be tested.
+ */
+void deadend_split_sector(deadend* dp, uint32_t s)
+{
+    graph g;            /* The graph. */
+    uint32_t i;         /* The index of the current cell of the sector. */
+    uint32_t head;      /* The next cell in the queue. */
+    uint32_t tail;      /* The end of the queue. */
+    uint32_t current;   /* The cell being grown from. */
+    uint32_t n;         /* The neighbour. */
+    uint32_t e;         /* The current edge. */
+    uint32_t r;         /* The new region. */
+    uint8_t c[3];       /* The coordinates of the current cell. */
+    uint8_t axis;       /* The current axis. */
+    bool in;            /* Whether the edges being followed come in. */
+
+    /* Take the sector's cells out of their regions. */
+    g = *(*dp)->gp;
+    deadend_gather_sector(dp, s);
+    for (i = 0; i < (*dp)->num_sector_cells; i++)
+    {
+        (*dp)->region_of[(*dp)->sector_cells[i]] = DEADEND_NONE;
+    }
+
+    /* Grow a region from each passable cell that isn't in one yet, along
+     * edges either way between passable cells of the sector. */
+    for (i = 0; i < (*dp)->num_sector_cells; i++)
+    {
+        current = (*dp)->sector_cells[i];
+        if ((*dp)->region_of[current] != DEADEND_NONE
+            || !deadend_is_open(*dp, current))
+        {
+            continue;
+        }
+        r = deadend_new_region(dp);
+        (*dp)->sector[r] = s;
+        (*dp)->order[r] = 0;
+        graph_get_cell_coords(g, current, &c[0], &c[1], &c[2]);
+        memcpy(&(*dp)->lo[3 * r], c, 3);
+        memcpy(&(*dp)->hi[3 * r], c, 3);
+        (*dp)->region_of[current] = r;
+        (*dp)->queue[0] = current;
+        head = 0;
+        tail = 1;
+        while (head < tail)
+        {
+            current = (*dp)->queue[head];
+            head++;
+            graph_get_cell_coords(g, current, &c[0], &c[1], &c[2]);
+            for (axis = 0; axis < 3; axis++)
+            {
+                if (c[axis] < (*dp)->lo[3 * r + axis])
+                {
+                    (*dp)->lo[3 * r + axis] = c[axis];
+                }
+                if (c[axis] > (*dp)->hi[3 * r + axis])
+                {
+                    (*dp)->hi[3 * r + axis] = c[axis];
+                }
+            }
+            for (in = false; ; in = true)
+            {
+                for (e = in ? graph_get_first_in_edge(g, current)
+                            : graph_get_first_edge(g, current);
+                     e < (in ? graph_get_first_in_edge(g, current + 1)
+                             : graph_get_first_edge(g, current + 1)); e++)
+                {
+                    n = in ? graph_get_in_edge_from(g, e)
+                           : graph_get_edge_to(g, e);
+                    if ((in ? graph_get_in_edge_w(g, e)
+                            : graph_get_edge_w(g, e)) == 0
+                        || (*dp)->region_of[n] != DEADEND_NONE
+                        || deadend_sector_of(*dp, n) != s
+                        || !deadend_is_open(*dp, n))
+                    {
+                        continue;
+                    }
+                    (*dp)->region_of[n] = r;
+                    (*dp)->queue[tail] = n;
+                    tail++;
+                }
+                if (in)
+                {
+                    break;
+                }
+            }
+        }
+        deadend_queue(dp, r);
+    }
+}
+
+/**
+ * This function stops pruning every region of the sector provided to it and
+ * hands their ids back.
+ */
+void deadend_clear_sector(deadend* dp, uint32_t s)
+{
+    uint32_t i;         /* The index of the current region or cell. */
+    uint32_t r;         /* The current region. */
+
+    /* Stop pruning the regions and hand back their ids, marking them as
+     * gone so they're skipped if they're still queued. */
+    deadend_gather_regions(dp, s);
+    for (i = 0; i < (*dp)->num_sector_regions; i++)
+    {
+        r = (*dp)->sector_regions[i];
+        deadend_unprune(dp, r);
+        (*dp)->sector[r] = DEADEND_NONE;
+        (*dp)->spare[(*dp)->num_spare] = r;
+        (*dp)->num_spare++;
+    }
+
+    /* Take the cells out of them. */
+    deadend_gather_sector(dp, s);
+    for (i = 0; i < (*dp)->num_sector_cells; i++)
+    {
+        (*dp)->region_of[(*dp)->sector_cells[i]] = DEADEND_NONE;
+    }
+}
+
+/**
+ * This function finds the regions with an edge to or from the region
+ * provided to it.
+ */
+void deadend_find_neighbours(deadend* dp, uint32_t r)
+{
+    graph g;            /* The graph. */
+    uint32_t i;         /* The index of the current cell of the sector. */
+    uint32_t current;   /* The current cell of the region. */
+    uint32_t n;         /* The region of the neighbour. */
+    uint32_t e;         /* The current edge. */
+    bool in;            /* Whether the edges being followed come in. */
+
+    /* Look along the edges of each of the region's cells. */
+    g = *(*dp)->gp;
+    (*dp)->region_stamp++;
+    (*dp)->region_visit[r] = (*dp)->region_stamp;
+    (*dp)->num_neighbours = 0;
+    deadend_gather_sector(dp, (*dp)->sector[r]);
+    for (i = 0; i < (*dp)->num_sector_cells; i++)
+    {
+        current = (*dp)->sector_cells[i];
+        if ((*dp)->region_of[current] != r)
+        {
+            continue;
+        }
+        for (in = false; ; in = true)
+        {
+            for (e = in ? graph_get_first_in_edge(g, current)
+                        : graph_get_first_edge(g, current);
+                 e < (in ? graph_get_first_in_edge(g, current + 1)
+                         : graph_get_first_edge(g, current + 1)); e++)
+            {
+                n = (*dp)->region_of[in ? graph_get_in_edge_from(g, e)
+                                        : graph_get_edge_to(g, e)];
+                if ((in ? graph_get_in_edge_w(g, e)
+                        : graph_get_edge_w(g, e)) == 0
+                    || n == DEADEND_NONE
+                    || (*dp)->region_visit[n] == (*dp)->region_stamp)
+                {
+                    continue;
+                }
+                (*dp)->region_visit[n] = (*dp)->region_stamp;
+                (*dp)->neighbours[(*dp)->num_neighbours] = n;
+                (*dp)->num_neighbours++;
+            }
+            if (in)
+            {
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * This function finds the doorway of the region provided to it. It returns
+ * false if the doorway has more than DEADEND_MAX_DOORWAY cells.
+ */
+bool deadend_find_doorway(deadend* dp, uint32_t r)
+{
+    graph g;            /* The graph. */
+    uint32_t i;         /* The index of the current cell of the sector. */
+    uint32_t current;   /* The current cell of the region. */
+    uint32_t n;         /* The neighbour. */
+    uint32_t e;         /* The current edge. */
+    bool in;            /* Whether the edges being followed come in. */
+
+    /* Look along the edges of each of the region's cells for unpruned
+     * passable cells outside it. */
+    g = *(*dp)->gp;
+    (*dp)->cell_stamp++;
+    if ((*dp)->cell_stamp == 0)
+    {
+        memset((*dp)->cell_visit, 0,
+               sizeof(uint32_t) * graph_get_cell_count(g));
+        (*dp)->cell_stamp = 1;
+    }
+    (*dp)->num_doorway = 0;
+    deadend_gather_sector(dp, (*dp)->sector[r]);
+    for (i = 0; i < (*dp)->num_sector_cells; i++)
+    {
+        current = (*dp)->sector_cells[i];
+        if ((*dp)->region_of[current] != r)
+        {
+            continue;
+        }
+        for (in = false; ; in = true)
+        {
+            for (e = in ? graph_get_first_in_edge(g, current)
+                        : graph_get_first_edge(g, current);
+                 e < (in ? graph_get_first_in_edge(g, current + 1)
+                         : graph_get_first_edge(g, current + 1)); e++)
+            {
+                n = in ? graph_get_in_edge_from(g, e)
+                       : graph_get_edge_to(g, e);
+                if ((in ? graph_get_in_edge_w(g, e)
+                        : graph_get_edge_w(g, e)) == 0
+                    || (*dp)->region_of[n] == DEADEND_NONE
+                    || (*dp)->region_of[n] == r
+                    || (*dp)->order[(*dp)->region_of[n]] != 0
+                    || (*dp)->cell_visit[n] == (*dp)->cell_stamp)
+                {
+                    continue;
+                }
+                if ((*dp)->num_doorway == DEADEND_MAX_DOORWAY)
+                {
+                    return false;
+                }
+                (*dp)->cell_visit[n] = (*dp)->cell_stamp;
+                (*dp)->doorway[(*dp)->num_doorway] = n;
+                (*dp)->num_doorway++;
+            }
+            if (in)
+            {
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * This function returns whether every pair of cells in the doorway of the
+ * region provided to it is joined by a path around it that costs no more
+ * than the estimate.
+ */
+bool deadend_is_bypassed(deadend* dp, uint32_t r)
+{
+    uint32_t i;         /* The index of the cell scanned from. */
+    uint32_t j;         /* The index of the cell that has to be reached. */
+
+    /* Regions with wide doorways are left alone. */
+    if (!deadend_find_doorway(dp, r))
+    {
+        return false;
+    }
+
+    /* Check every cell of the doorway reaches every other one. */
+    for (i = 0; i < (*dp)->num_doorway; i++)
+    {
+        deadend_scan(dp, r, (*dp)->doorway[i]);
+        for (j = 0; j < (*dp)->num_doorway; j++)
+        {
+            if ((*dp)->cell_visit[(*dp)->doorway[j]] != (*dp)->cell_stamp)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * This function scans the cells reachable from the cell provided to it for
+ * their estimated cost, around the region also provided.
+ */
+void deadend_scan(deadend* dp, uint32_t r, uint32_t from)
+{
+    graph g;            /* The graph. */
+    uint32_t head;      /* The next cell in the queue. */
+    uint32_t tail;      /* The end of the queue. */
+    uint32_t current;   /* The cell being scanned from. */
+    uint32_t n;         /* The neighbour. */
+    uint32_t e;         /* The current edge. */
+    uint32_t next_g;    /* The cost of the neighbour through the cell. */
+    uint8_t c[3];       /* The coordinates of the neighbour. */
+    uint8_t axis;       /* The current axis. */
+    uint8_t w;          /* The cost of the move. */
+    bool near;          /* Whether the neighbour is near the region. */
+
+    /* Start a new scan. */
+    g = *(*dp)->gp;
+    (*dp)->cell_stamp++;
+    if ((*dp)->cell_stamp == 0)
+    {
+        memset((*dp)->cell_visit, 0,
+               sizeof(uint32_t) * graph_get_cell_count(g));
+        (*dp)->cell_stamp = 1;
+    }
+    (*dp)->cell_visit[from] = (*dp)->cell_stamp;
+    (*dp)->cell_g[from] = 0;
+    (*dp)->queue[0] = from;
+    head = 0;
+    tail = 1;
+
+    /* Each cell is reached at its estimated cost or not at all, so the
+     * order the cells are scanned in doesn't matter. */
+    while (head < tail)
+    {
+        current = (*dp)->queue[head];
+        head++;
+        for (e = graph_get_first_edge(g, current);
+             e < graph_get_first_edge(g, current + 1); e++)
+        {
+            /* Only move to unpruned passable cells outside the region. */
+            w = graph_get_edge_w(g, e);
+            n = graph_get_edge_to(g, e);
+            if (w == 0 || (*dp)->cell_visit[n] == (*dp)->cell_stamp
+                || (*dp)->region_of[n] == DEADEND_NONE
+                || (*dp)->region_of[n] == r
+                || (*dp)->order[(*dp)->region_of[n]] != 0)
+            {
+                continue;
+            }
+
+            /* Keep within a cell of the region's box. */
+            graph_get_cell_coords(g, n, &c[0], &c[1], &c[2]);
+            near = true;
+            for (axis = 0; axis < 3; axis++)
+            {
+                near = near && c[axis] + 1 >= (*dp)->lo[3 * r + axis]
+                            && c[axis] <= (*dp)->hi[3 * r + axis] + 1;
+            }
+            next_g = (*dp)->cell_g[current] + w;
+            if (!near || deadend_estimate(*dp, from, n) != next_g)
+            {
+                continue;
+            }
+            (*dp)->cell_visit[n] = (*dp)->cell_stamp;
+            (*dp)->cell_g[n] = next_g;
+            (*dp)->queue[tail] = n;
+            tail++;
+        }
+    }
+}
+
+/**
+ * This function returns the estimated cost between the two cells provided
+ * to it, the same as astar's.
+ */
+uint32_t deadend_estimate(deadend d, uint32_t a, uint32_t b)
+{
+    uint8_t ac[3];      /* The first cell's coordinates. */
+    uint8_t bc[3];      /* The second cell's coordinates. */
+    uint32_t sum;       /* The sum of the distances along each axis. */
+    uint32_t max;       /* The largest distance along an axis. */
+    uint32_t dist;      /* The distance along the current axis. */
+    uint8_t axis;       /* The current axis. */
+
+    /* A MANHATTAN graph moves along one axis at a time, and a DIAGONAL one
+     * along all of them at once. */
+    graph_get_cell_coords(*d->gp, a, &ac[0], &ac[1], &ac[2]);
+    graph_get_cell_coords(*d->gp, b, &bc[0], &bc[1], &bc[2]);
+    sum = 0;
+    max = 0;
+    for (axis = 0; axis < 3; axis++)
+    {
+        dist = ac[axis] > bc[axis] ? ac[axis] - bc[axis]
+                                   : bc[axis] - ac[axis];
+        sum += dist;
+        if (dist > max)
+        {
+            max = dist;
+        }
+    }
+    return graph_get_style(*d->gp) == MANHATTAN ? sum : max;
+}
+
+/**
+ * This function queues the region provided to it to be tested, if it isn't
+ * already waiting.
+ */
+void deadend_queue(deadend* dp, uint32_t r)
+{
+    if (!(*dp)->queued[r])
+    {
+        (*dp)->queued[r] = true;
+        (*dp)->work[(*dp)->num_work] = r;
+        (*dp)->num_work++;
+    }
+}
+
+/**
+ * This function tests the queued regions, pruning the ones that pass, until
+ * none are left.
+ */
+void deadend_prune(deadend* dp)
+{
+    uint32_t r;     /* The region being tested. */
+
+    while ((*dp)->num_work > 0)
+    {
+        /* Take the next region, skipping ones that have gone or are
+         * already pruned. */
+        (*dp)->num_work--;
+        r = (*dp)->work[(*dp)->num_work];
+        (*dp)->queued[r] = false;
+        if ((*dp)->sector[r] == DEADEND_NONE || (*dp)->order[r] != 0
+            || !deadend_is_bypassed(dp, r))
+        {
+            continue;
+        }
+
+        /* Prune it, and test its unpruned neighbours again, as it's no
+         * longer in their doorways. */
+        (*dp)->order[r] = (*dp)->next_order;
+        (*dp)->next_order++;
+        (*dp)->num_pruned++;
+        deadend_find_neighbours(dp, r);
+        while ((*dp)->num_neighbours > 0)
+        {
+            (*dp)->num_neighbours--;
+            r = (*dp)->neighbours[(*dp)->num_neighbours];
+            if ((*dp)->order[r] == 0)
+            {
+                deadend_queue(dp, r);
+            }
+        }
+    }
+}
+
+/**
+ * This function stops pruning the region provided to it, and the pruned
+ * regions next to it that were pruned after it, and queues them to be
+ * tested again.
+ */
+void deadend_unprune(deadend* dp, uint32_t r)
+{
+    uint32_t num_stack;     /* The number of regions on the stack. */
+    uint32_t order;         /* The order the current region was pruned in. */
+    uint32_t n;             /* The current neighbour. */
+    uint32_t i;             /* The index of the current neighbour. */
+
+    /* Regions are taken out of the pruned ones as they're put on the stack,
+     * with the order they were pruned in kept alongside, so none is put on
+     * it twice. */
+    if ((*dp)->order[r] == 0)
+    {
+        return;
+    }
+    (*dp)->stack[0] = r;
+    (*dp)->stack_order[0] = (*dp)->order[r];
+    (*dp)->order[r] = 0;
+    (*dp)->num_pruned--;
+    deadend_queue(dp, r);
+    num_stack = 1;
+    while (num_stack > 0)
+    {
+        num_stack--;
+        r = (*dp)->stack[num_stack];
+        order = (*dp)->stack_order[num_stack];
+
+        /* Stop pruning the neighbours pruned after the region. */
+        deadend_find_neighbours(dp, r);
+        for (i = 0; i < (*dp)->num_neighbours; i++)
+        {
+            n = (*dp)->neighbours[i];
+            if ((*dp)->order[n] > order)
+            {
+                (*dp)->stack[num_stack] = n;
+                (*dp)->stack_order[num_stack] = (*dp)->order[n];
+                num_stack++;
+                (*dp)->order[n] = 0;
+                (*dp)->num_pruned--;
+                deadend_queue(dp, n);
+            }
+        }
+    }
+}
@@ -0,0 +1,109 @@
+/**
+ * deadend.h
+ *
+ * This file contains the data-structure and function prototype declarations
+ * for the deadend type.
+ *
+ * The deadend type finds the parts of a graph that shortest paths never
+ * have to pass through, such as rooms off a corridor, so that searches can
+ * leave them out. The passable cells are split into regions, the connected
+ * cells of each DEADEND_SECTOR_SIZE cube of the graph. A region is pruned
+ * if every pair of cells outside it that it joins, its doorway, is also
+ * joined by a path around it that costs no more than astar's estimate. A
+ * dead-end, whose doorway is a single opening, always passes, as does a
+ * swamp, which a path around costs no more to take than one through it.
+ *
+ * The regions are pruned one at a time, each tested on the graph without
+ * the regions pruned before it, so every pruned region can be left out at
+ * once. A search whose start or end cell is in a pruned region lets in that
+ * region and the pruned regions joined to it that were pruned after it.
+ *
+ * A region's test only looks at the cells in and around it, so when a
+ * cell's type changes, deadend_update() only tests again the regions around
+ * it, and the regions pruned after them next to them.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#ifndef DEADEND_H
+#define DEADEND_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "node.h"
+#include "graph.h"
+
+/**
+ * This is how many cells wide the cubes the regions are made in are.
+ */
+#define DEADEND_SECTOR_SIZE 8
+
+/**
+ * This is the most cells a region's doorway can have for it to be pruned.
+ * Regions with wider doorways are too open for a path around them to be as
+ * short as one through them, and testing them takes a scan from every cell
+ * of the doorway.
+ */
+#define DEADEND_MAX_DOORWAY 32
+
+/**
+ * The data-structure of the deadend type.
+ */
+typedef struct deadend_data* deadend;
+
+/**
+ * This function initialises the deadend provided to it by splitting the
+ * graph also provided into regions and pruning every region it can.
+ */
+void deadend_init(deadend* dp, graph* gp);
+
+/**
+ * This function destroys the deadend provided to it.
+ */
+void deadend_free(deadend* dp);
+
+/**
+ * This function brings the regions of the deadend provided to it up to date
+ * with the type of the cell with the id also provided, after it has been
+ * changed.
+ */
+void deadend_update(deadend* dp, uint32_t id);
+
+/**
+ * This function readies the deadend provided to it for a search from the
+ * start cell to the end cell, after which deadend_is_skipped() says which
+ * cells the search can leave out.
+ */
+void deadend_begin_search(deadend* dp, uint32_t start, uint32_t end);
+
+/**
+ * This function returns whether the search readied by
+ * deadend_begin_search() can leave out the cell with the id provided to it.
+ */
+bool deadend_is_skipped(deadend d, uint32_t id);
+
+/**
+ * This function returns whether the cell with the id provided to it is in a
+ * pruned region.
+ */
+bool deadend_is_pruned(deadend d, uint32_t id);
+
+/**
+ * This function returns the number of regions the deadend provided to it
+ * has split the graph's passable cells into.
+ */
+uint32_t deadend_get_num_regions(deadend d);
+
+/**
+ * This function returns the number of regions the deadend provided to it
+ * has pruned.
+ */
+uint32_t deadend_get_num_pruned(deadend d);
+
+#endif // DEADEND_H
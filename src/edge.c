@@ -68,6 +68,15 @@ uint8_t edge_get_w(edge e)
     return e->w;
 }
 
+/**
+ * This function sets the weight of the edge provided to it.
+ */
+void edge_set_w(edge* ep, uint8_t w)
+{
+    /* Set the weight of the edge. */
+    (*ep)->w = w;
+}
+
 /**
  * This function prints information about the edge provided to it.
  */
@@ -45,6 +45,11 @@ void* edge_get_neighbourp(edge* ep);
  */
 uint8_t edge_get_w(edge e);
 
+/**
+ * This function sets the weight of the edge provided to it.
+ */
+void edge_set_w(edge* ep, uint8_t w);
+
 /**
  * This function prints information about the edge provided to it.
  */
@@ -0,0 +1,301 @@
+/**
+ * fringe.c
+ *
+ * This file contains the internal data-structure and function definitions
+ * for the fringe type.
+ *
+ * The lists for now and later are plain arrays of cell ids. The list for
+ * now is used as a stack, so the children of a cell are expanded straight
+ * after it, as they would be if they were put after it in Fringe Search's
+ * linked list, and both lists are read and written from one end in order.
+ * A cell can be in the lists more than once; when a copy comes up, it's
+ * judged by the cost of the best path found to it so far.
+ *
+ * Each cell only needs the cost of its path, the cell its path came from
+ * and the number of the search that last reached it.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#include "fringe.h"
+
+/**
+ * This is a growable list of cell ids.
+ */
+struct fringe_list {
+    uint32_t* ids;          /* The cell ids. */
+    uint32_t size;          /* The number of cell ids in the list. */
+    uint32_t capacity;      /* The number of cell ids the list can hold. */
+};
+
+/**
+ * This is the internal data-structure of the fringe type.
+ */
+struct fringe_data {
+    graph* gp;                  /* The graph to search. */
+    uint32_t* g;                /* The cost of the path to each cell. */
+    uint32_t* came_from;        /* The cell each cell's path came from. */
+    uint32_t* visit;            /* The search each cell was last reached by. */
+    uint32_t search;            /* The number of the current search. */
+    struct fringe_list now;     /* The cells to expand now. */
+    struct fringe_list later;   /* The cells to expand later. */
+    uint32_t peak_size;         /* The most cells the lists have held. */
+    uint32_t* path;             /* The path that was found. */
+    uint32_t path_size;         /* The number of cells in the path. */
+};
+
+/**
+ * This function adds the cell id provided to it to the list also provided.
+ */
+void fringe_list_push(struct fringe_list* lp, uint32_t id);
+
+/**
+ * This function reconstructs the path that ends at the cell provided to it.
+ */
+void fringe_reconstruct_path(fringe* fp, uint32_t current);
+
+/**
+ * This function initialises the fringe provided to it to search the graph
+ * also provided to the function.
+ */
+void fringe_init(fringe* fp, graph* gp)
+{
+    /* Allocate memory to the fringe. */
+    *fp = (fringe) malloc(sizeof(struct fringe_data));
+
+    /* Initialise the state of each cell. */
+    (*fp)->gp = gp;
+    (*fp)->g = (uint32_t*) malloc(
+            sizeof(uint32_t) * graph_get_cell_count(*gp));
+    (*fp)->came_from = (uint32_t*) malloc(
+            sizeof(uint32_t) * graph_get_cell_count(*gp));
+    (*fp)->visit = (uint32_t*) calloc(graph_get_cell_count(*gp),
+                                      sizeof(uint32_t));
+    (*fp)->search = 0;
+
+    /* The lists grow as they're needed. */
+    (*fp)->now.ids = NULL;
+    (*fp)->now.size = 0;
+    (*fp)->now.capacity = 0;
+    (*fp)->later.ids = NULL;
+    (*fp)->later.size = 0;
+    (*fp)->later.capacity = 0;
+    (*fp)->peak_size = 0;
+
+    /* No path has been found yet. */
+    (*fp)->path = NULL;
+    (*fp)->path_size = 0;
+}
+
+/**
+ * This function destroys the fringe provided to it.
+ */
+void fringe_free(fringe* fp)
+{
+    /* De-allocate memory from the fringe's internal properties. */
+    free((*fp)->g);
+    free((*fp)->came_from);
+    free((*fp)->visit);
+    free((*fp)->now.ids);
+    free((*fp)->later.ids);
+    free((*fp)->path);
+
+    /* De-allocate memory from the fringe. */
+    free(*fp);
+}
+
+/**
+ * This function searches for the shortest path from the start cell to the
+ * end cell.
+ */
+void fringe_search(fringe* fp, uint32_t start, uint32_t end)
+{
+    graph g;                    /* The graph. */
+    struct fringe_list swap;    /* The list for now, while it's swapped. */
+    enum graph_style gstyle;    /* The moves the graph allows. */
+    uint32_t current;           /* The cell being expanded. */
+    uint32_t neighbour;         /* The neighbour being assessed. */
+    uint32_t next_g;            /* The cost of the path to the neighbour. */
+    uint32_t f;                 /* The current cell's estimated total cost. */
+    uint32_t threshold;         /* The highest estimate expanded for now. */
+    uint32_t next_threshold;    /* The lowest estimate left for later. */
+    uint32_t e;                 /* The edge leading to the neighbour. */
+    uint32_t last;              /* The end of the current cell's edges. */
+    uint8_t x, y, z;            /* The current cell's coordinates. */
+    uint8_t ex, ey, ez;         /* The end cell's coordinates. */
+    uint8_t w;                  /* The cost of moving to the neighbour. */
+    bool path_found;            /* Whether a path has been found. */
+
+    /* Make sure the graph's index of edges is up to date. */
+    graph_update_index((*fp)->gp);
+    g = *(*fp)->gp;
+    gstyle = graph_get_style(g);
+    graph_get_cell_coords(g, end, &ex, &ey, &ez);
+
+    /* Start a new search. If the search number wraps around, the old
+     * numbers have to be cleared so they can't be mistaken for new ones. */
+    (*fp)->search++;
+    if ((*fp)->search == 0)
+    {
+        memset((*fp)->visit, 0, sizeof(uint32_t) * graph_get_cell_count(g));
+        (*fp)->search = 1;
+    }
+    (*fp)->now.size = 0;
+    (*fp)->later.size = 0;
+    (*fp)->peak_size = 1;
+    (*fp)->path_size = 0;
+    path_found = false;
+
+    /* Start with only the start cell, and a threshold of its estimate. */
+    (*fp)->visit[start] = (*fp)->search;
+    (*fp)->g[start] = 0;
+    (*fp)->came_from[start] = GRAPH_NO_CELL;
+    fringe_list_push(&(*fp)->now, start);
+    threshold = astar_estimate(g, start, end);
+
+    /* Search until the path is found or no cells are left. */
+    while ((*fp)->now.size > 0 && !path_found)
+    {
+        /* Expand the cells within the threshold, leaving the rest for
+         * later. */
+        next_threshold = UINT32_MAX;
+        while ((*fp)->now.size > 0 && !path_found)
+        {
+            /* Take the cell off the list for now. */
+            (*fp)->now.size--;
+            current = (*fp)->now.ids[(*fp)->now.size];
+
+            /* Leave the cell for later if it's beyond the threshold. */
+            graph_get_cell_coords(g, current, &x, &y, &z);
+            f = (*fp)->g[current]
+              + astar_estimate_coords(gstyle, x, y, z, ex, ey, ez);
+            if (f > threshold)
+            {
+                if (f < next_threshold)
+                {
+                    next_threshold = f;
+                }
+                fringe_list_push(&(*fp)->later, current);
+                continue;
+            }
+
+            /* Check if the path has reached the end cell. */
+            if (current == end)
+            {
+                fringe_reconstruct_path(fp, current);
+                path_found = true;
+                continue;
+            }
+
+            /* Put the neighbours the cell gives a cheaper path to on the
+             * list for now, to be expanded next. */
+            last = graph_get_first_edge(g, current + 1);
+            for (e = graph_get_first_edge(g, current); e < last; e++)
+            {
+                w = graph_get_edge_w(g, e);
+                if (w == 0)
+                {
+                    continue;
+                }
+                neighbour = graph_get_edge_to(g, e);
+                next_g = (*fp)->g[current] + w;
+                if ((*fp)->visit[neighbour] != (*fp)->search
+                    || next_g < (*fp)->g[neighbour])
+                {
+                    (*fp)->visit[neighbour] = (*fp)->search;
+                    (*fp)->g[neighbour] = next_g;
+                    (*fp)->came_from[neighbour] = current;
+                    fringe_list_push(&(*fp)->now, neighbour);
+                }
+            }
+
+            /* Keep track of the most cells the lists have held. */
+            if ((*fp)->now.size + (*fp)->later.size > (*fp)->peak_size)
+            {
+                (*fp)->peak_size = (*fp)->now.size + (*fp)->later.size;
+            }
+        }
+
+        /* Raise the threshold and make the cells left for later the cells
+         * to expand now. */
+        threshold = next_threshold;
+        swap = (*fp)->now;
+        (*fp)->now = (*fp)->later;
+        (*fp)->later = swap;
+        (*fp)->later.size = 0;
+    }
+}
+
+/**
+ * This function returns the ids of the cells that make up the shortest path
+ * found by fringe_search(), from the start cell to the end cell.
+ */
+uint32_t* fringe_get_path(fringe f)
+{
+    return f->path;
+}
+
+/**
+ * This function returns the number of cells in the path found by
+ * fringe_search(). It is 0 if no path was found.
+ */
+uint32_t fringe_get_path_size(fringe f)
+{
+    return f->path_size;
+}
+
+/**
+ * This function returns the most cells the lists of the fringe provided to
+ * it have held at once during its last search.
+ */
+uint32_t fringe_get_peak_size(fringe f)
+{
+    return f->peak_size;
+}
+
+/**
+ * This function adds the cell id provided to it to the list also provided.
+ */
+void fringe_list_push(struct fringe_list* lp, uint32_t id)
+{
+    /* Double the list's capacity if it's full. */
+    if (lp->size == lp->capacity)
+    {
+        lp->capacity = lp->capacity == 0 ? 64 : lp->capacity * 2;
+        lp->ids = (uint32_t*) realloc(lp->ids, sizeof(uint32_t) * lp->capacity);
+    }
+    lp->ids[lp->size] = id;
+    lp->size++;
+}
+
+/**
+ * This function reconstructs the path that ends at the cell provided to it.
+ */
+void fringe_reconstruct_path(fringe* fp, uint32_t current)
+{
+    uint32_t cell;      /* The current cell on the path. */
+    uint32_t size;      /* The number of cells in the path. */
+    uint32_t i;         /* The index of the current cell. */
+
+    /* Count the cells in the path, so only enough memory for them is
+     * needed. */
+    size = 0;
+    for (cell = current; cell != GRAPH_NO_CELL;
+         cell = (*fp)->came_from[cell])
+    {
+        size++;
+    }
+
+    /* Fill the path in from the end cell back to the start cell. */
+    (*fp)->path = (uint32_t*) realloc((*fp)->path, sizeof(uint32_t) * size);
+    i = size;
+    for (cell = current; cell != GRAPH_NO_CELL;
+         cell = (*fp)->came_from[cell])
+    {
+        i--;
+        (*fp)->path[i] = cell;
+    }
+    (*fp)->path_size = size;
+}
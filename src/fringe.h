@@ -0,0 +1,73 @@
+/**
+ * fringe.h
+ *
+ * This file contains the data-structure and function prototype declarations
+ * for the fringe type.
+ *
+ * The fringe type is an implementation of Fringe Search. Like A* it finds
+ * the shortest path between two cells of a graph, but it has no priority
+ * queue. It keeps a list of the cells to expand now and a list of the cells
+ * to expand later, and only expands cells whose estimated total cost is
+ * within a threshold. When the list for now runs out, the threshold is
+ * raised to the lowest estimate of the cells left for later and those cells
+ * become the list for now. Some cells are expanded more than once, but the
+ * search keeps less state for each cell than A* and no heap.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#ifndef FRINGE_H
+#define FRINGE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "graph.h"
+#include "astar.h"
+
+/**
+ * The data-structure of the fringe type.
+ */
+typedef struct fringe_data* fringe;
+
+/**
+ * This function initialises the fringe provided to it to search the graph
+ * also provided to the function.
+ */
+void fringe_init(fringe* fp, graph* gp);
+
+/**
+ * This function destroys the fringe provided to it.
+ */
+void fringe_free(fringe* fp);
+
+/**
+ * This function searches for the shortest path from the start cell to the
+ * end cell.
+ */
+void fringe_search(fringe* fp, uint32_t start, uint32_t end);
+
+/**
+ * This function returns the ids of the cells that make up the shortest path
+ * found by fringe_search(), from the start cell to the end cell.
+ */
+uint32_t* fringe_get_path(fringe f);
+
+/**
+ * This function returns the number of cells in the path found by
+ * fringe_search(). It is 0 if no path was found.
+ */
+uint32_t fringe_get_path_size(fringe f);
+
+/**
+ * This function returns the most cells the lists of the fringe provided to
+ * it have held at once during its last search.
+ */
+uint32_t fringe_get_peak_size(fringe f);
+
+#endif // FRINGE_H
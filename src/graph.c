@@ -15,15 +15,56 @@
 
 #include "graph.h"
 
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * This asks the processor to start loading the memory at an address. It does
+ * nothing on compilers that can't ask.
+ */
+#if defined(__GNUC__)
+#define GRAPH_PREFETCH(addr) __builtin_prefetch((addr), 0, 3)
+#else
+#define GRAPH_PREFETCH(addr) ((void) (addr))
+#endif
+
+/**
+ * This is the number of steps it takes to spread or gather the bits of a
+ * coordinate without BMI2, one for each power of two up to 32 bits.
+ */
+#define GRAPH_MORTON_STEPS 5
+
 /**
  * This is the internal data-structure of the graph type.
  */
 struct graph_data {
     
-    /* This is the three-dimensional array of the nodes that make up the
-     * graph. */
-    node*** nodes;
-    
+    /* This is the array of the nodes that make up the graph, in the order
+     * given by the graph's layout. The index of a node is its cell id. */
+    node* cells;
+
+    /* This is the block of memory the nodes' data is kept in, in the same
+     * order as the array of nodes. Padding ids have no place in it. */
+    void* cell_data;
+
+    /* This is the number of cell ids. With a MORTON layout, some of them
+     * are padding and their place in the array of nodes is NULL. */
+    uint32_t num_cells;
+
+    /* These are the bits of a cell id that hold each of the cell's
+     * coordinates when the graph has a MORTON layout. */
+    uint32_t xmask;
+    uint32_t ymask;
+    uint32_t zmask;
+
+    /* These are the masks of the bits that move at each step when a
+     * coordinate is spread into or gathered out of a cell id without BMI2.
+     * Step i moves bits by 1 << i places. */
+    uint32_t xmoves[GRAPH_MORTON_STEPS];
+    uint32_t ymoves[GRAPH_MORTON_STEPS];
+    uint32_t zmoves[GRAPH_MORTON_STEPS];
+
     /* These are the sizes of each of the axes/dimensions of the graph. */ 
     uint8_t xsize;
     uint8_t ysize;
@@ -32,6 +73,53 @@ struct graph_data {
     /* This stores the way in which a graph-node will be considered a neighbour
      * of another graph-node. */
     enum graph_style gstyle;
+
+    /* This stores the order the graph's cells are stored in. */
+    enum graph_layout layout;
+
+    /* This is the index of the graph's edges, grouped by the cell they
+     * leave. The edges leaving cell id are first_edge[id] up to
+     * first_edge[id + 1], edge_to holds the cell each edge leads to and
+     * edge_w holds the cost of moving along it. */
+    uint32_t* first_edge;
+    uint32_t* edge_to;
+    uint8_t* edge_w;
+    uint32_t num_edges;
+
+    /* This is the same index grouped by the cell each edge leads into, for
+     * searches that run backwards from their goal. The edges leading into
+     * cell id are first_in_edge[id] up to first_in_edge[id + 1] and
+     * in_edge_from holds the cell each edge leaves. */
+    uint32_t* first_in_edge;
+    uint32_t* in_edge_from;
+    uint8_t* in_edge_w;
+
+    /* This stores whether edges were added or removed since the index of
+     * edges was last built. */
+    bool index_dirty;
+
+    /* This is the passability mask of each cell. Bit d is set if the cell
+     * has an edge with a non-zero cost to its neighbour in direction d. */
+    uint32_t* pass_masks;
+
+    /* This is how far apart the ids of neighbouring cells are in each
+     * direction when the graph has a LINEAR layout. */
+    int32_t dir_deltas[GRAPH_NUM_DIRECTIONS];
+
+    /* This stores whether every edge is a grid move costing 0 or 1. */
+    bool unit_grid;
+
+    /* This is the clearance of each cell: how many cells wide the largest
+     * cube of passable cells with the cell at its lowest corner is. */
+    uint8_t* clearance;
+
+    /* This is the number of changes to the graph that may have made moving
+     * between some of its cells cheaper. */
+    uint32_t num_decreases;
+
+    /* This is the terrain class of each cell, which movement profiles use
+     * to work out what moving into the cell costs each kind of agent. */
+    uint8_t* terrain;
 };
 
 /**
@@ -46,6 +134,59 @@ bool graph_valid_coord(graph g, int16_t x, int16_t y, int16_t z);
  */
 void graph_init_nodes(graph* gp);
 
+/**
+ * This function initialises the masks that say which bits of a cell id hold
+ * which coordinate when the graph has a MORTON layout.
+ */
+void graph_init_morton(graph* gp);
+
+/**
+ * This function fills the array provided to it with the masks of the bits
+ * that move at each step when bits are spread into or gathered out of the
+ * mask also provided to the function.
+ */
+void graph_init_moves(uint32_t mask, uint32_t* moves);
+
+/**
+ * This function adds the offset provided to it, which is -1, 0 or 1, to the
+ * coordinate held in the bits of the id that are set in the mask, leaving
+ * the id's other bits as they are.
+ */
+uint32_t graph_step_bits(uint32_t id, uint32_t mask, int8_t off);
+
+/**
+ * This function builds the graph's index of edges from its nodes' edges.
+ */
+void graph_build_index(graph* gp);
+
+/**
+ * This function returns the direction of the move between the two cells
+ * with the ids provided to it, or GRAPH_NUM_DIRECTIONS if they aren't
+ * neighbours on the grid.
+ */
+uint8_t graph_get_move_dir(graph g, uint32_t from, uint32_t to);
+
+/**
+ * This function works out the clearance of every cell of the graph provided
+ * to it in one pass from its highest corner to its lowest.
+ */
+void graph_build_clearance(graph* gp);
+
+/**
+ * This function brings the clearance of the cells up to date after the type
+ * of the cell with the id provided to it has changed. Only cells at lower
+ * coordinates can change, so it works outwards from the cell a layer at a
+ * time and stops at the first layer that didn't change.
+ */
+void graph_update_clearance(graph* gp, uint32_t id);
+
+/**
+ * This function returns what the clearance of the cell at the coordinates
+ * provided to it should be, from the clearance of its neighbours at higher
+ * coordinates.
+ */
+uint8_t graph_cell_clearance(graph g, int16_t x, int16_t y, int16_t z);
+
 /**
  * This function initialises the graph provided to it.
  */
@@ -53,6 +194,23 @@ void graph_init(graph* gp,
                 uint8_t xsize, uint8_t ysize, uint8_t zsize, 
                 enum graph_style gstyle)
 {
+    /* Initialise the graph with its cells in the linear order. */
+    graph_init_layout(gp, xsize, ysize, zsize, gstyle, LINEAR);
+}
+
+/**
+ * This function initialises the graph provided to it, storing its cells in
+ * the order given by the layout also provided to the function.
+ */
+void graph_init_layout(graph* gp,
+                       uint8_t xsize, uint8_t ysize, uint8_t zsize, 
+                       enum graph_style gstyle, enum graph_layout layout)
+{
+    uint8_t dir;    /* The current direction. */
+    int8_t xoff;    /* The x offset of the direction. */
+    int8_t yoff;    /* The y offset of the direction. */
+    int8_t zoff;    /* The z offset of the direction. */
+
     /* Allocate memory for the graph. */
     *gp = (graph) malloc(sizeof(struct graph_data));
 
@@ -61,9 +219,52 @@ void graph_init(graph* gp,
     (*gp)->ysize = ysize;
     (*gp)->zsize = zsize;
     (*gp)->gstyle = gstyle;
+    (*gp)->layout = layout;
+
+    /* Work out how many cell ids the layout needs. */
+    if (layout == MORTON)
+    {
+        /* The ids cover each axis rounded up to a power of two. */
+        graph_init_morton(gp);
+        (*gp)->num_cells = (*gp)->xmask | (*gp)->ymask | (*gp)->zmask;
+        (*gp)->num_cells++;
+    }
+    else
+    {
+        /* There is exactly one id for each cell. */
+        (*gp)->xmask = 0;
+        (*gp)->ymask = 0;
+        (*gp)->zmask = 0;
+        (*gp)->num_cells = (uint32_t) xsize * ysize * zsize;
+    }
     
     /* Initialise the graph's nodes. */
     graph_init_nodes(gp);
+
+    /* Work out how far apart neighbours' ids are with a LINEAR layout. */
+    for (dir = 0; dir < GRAPH_NUM_DIRECTIONS; dir++)
+    {
+        graph_get_dir_offset(dir, &xoff, &yoff, &zoff);
+        (*gp)->dir_deltas[dir] = ((int32_t) xoff * ysize + yoff) * zsize 
+                               + zoff;
+    }
+
+    /* Build the index of the graph's edges. */
+    (*gp)->first_edge = NULL;
+    (*gp)->edge_to = NULL;
+    (*gp)->edge_w = NULL;
+    (*gp)->first_in_edge = NULL;
+    (*gp)->in_edge_from = NULL;
+    (*gp)->in_edge_w = NULL;
+    (*gp)->pass_masks = NULL;
+    (*gp)->num_decreases = 0;
+    (*gp)->terrain = (uint8_t*) calloc((*gp)->num_cells, sizeof(uint8_t));
+    graph_build_index(gp);
+
+    /* Work out the clearance of the cells from their nodes' types. Only
+     * graph_set_cell_type() changes it after this, as adding and removing
+     * edges doesn't change the types. */
+    graph_build_clearance(gp);
 }
 
 /**
@@ -71,36 +272,33 @@ void graph_init(graph* gp,
  */
 void graph_free(graph* gp)
 {
-    uint8_t x;      /* The current x coordinate. */
-    uint8_t y;      /* The current y coordinate. */
-    uint8_t z;      /* The current z coordinate. */
-    uint8_t xsize;  /* The size of the graph's x axis. */
-    uint8_t ysize;  /* The size of the graph's y axis. */
-    uint8_t zsize;  /* The size of the graph's z axis. */
+    uint32_t id;    /* The current cell id. */
 
-    /* Get the size of the graph's axes/dimensions. */
-    xsize = (*gp)->xsize;
-    ysize = (*gp)->ysize;
-    zsize = (*gp)->zsize;
-
-    /* De-allocate memory from the graph's nodes. */
-    for (x = 0; x < xsize; x++)
+    /* Destroy the graph's nodes. */
+    for (id = 0; id < (*gp)->num_cells; id++)
     {
-        for (y = 0; y < ysize; y++)
+        /* Check that the id isn't padding. */
+        if ((*gp)->cells[id] != NULL)
         {
-            for (z = 0; z < zsize; z++)
-            {
-                /* Destroy the node. */
-                node_free(&(*gp)->nodes[x][y][z]);
-            }
-            /* De-allocate memory from the z axis. */
-            free((*gp)->nodes[x][y]);
+            /* Destroy the node. */
+            node_free(&(*gp)->cells[id]);
         }
-        /* De-allocate memory from the y axis. */
-        free((*gp)->nodes[x]);
     }
-    /* De-allocate memory from the x axis. */
-    free((*gp)->nodes);
+
+    /* De-allocate memory from the nodes. */
+    free((*gp)->cell_data);
+    free((*gp)->cells);
+
+    /* De-allocate memory from the index of edges. */
+    free((*gp)->first_edge);
+    free((*gp)->edge_to);
+    free((*gp)->edge_w);
+    free((*gp)->first_in_edge);
+    free((*gp)->in_edge_from);
+    free((*gp)->in_edge_w);
+    free((*gp)->pass_masks);
+    free((*gp)->clearance);
+    free((*gp)->terrain);
 
     /* De-allocate memory from the graph. */
     free(*gp);
@@ -110,39 +308,573 @@ void graph_free(graph* gp)
  * This function returns the node in the graph provided to it located at the
  * coordinates also provided to the function.
  */
-node* graph_get_node(graph g, uint8_t x, uint8_t y, uint8_t z)
+node* graph_get_node(graph g, uint8_t x, uint8_t y, uint8_t z)
+{
+    node* n;    /* The node at the coordinates. */
+
+    /* Check if the coordinates are within the bounds of the graph. */
+    if (graph_valid_coord(g, (int16_t) x, (int16_t) y, (int16_t) z))
+    {
+        /* The provided coordinates is within the bounds of the graph so
+         * get the node at those coordinates. */
+        n = &(g->cells[graph_get_cell_id(g, x, y, z)]);
+    }
+    else
+    {
+        /* The provided coordinates are not within the bounds of the graph
+         * so print an error message and exit the program. */
+        fprintf(stdout,
+                "\nERROR: In function graph_get_node(): "
+                "Invalid node coordinates: { %d, %d, %d }!\n", x, y, z);
+        exit(EXIT_FAILURE);
+    }
+
+    /* Returning the node at the coordinates. */
+    return n;
+}
+
+/* This function returns the way in which a graph-node will be considered a
+ * neighbour of another graph-node.
+ */
+enum graph_style graph_get_style(graph g)
+{
+    /* Return the way in which graph-nodes are considered neighbours of each
+     * other. */
+    return g->gstyle;
+}
+
+/**
+ * This function returns the order the cells of the graph provided to it are
+ * stored in.
+ */
+enum graph_layout graph_get_layout(graph g)
+{
+    /* Return the graph's layout. */
+    return g->layout;
+}
+
+/**
+ * This function returns the number of cell ids of the graph provided to it.
+ * With a MORTON layout some ids are padding and don't belong to a cell.
+ */
+uint32_t graph_get_cell_count(graph g)
+{
+    /* Return the number of cell ids. */
+    return g->num_cells;
+}
+
+/**
+ * This function scatters the low bits of the value provided to it into the
+ * bits that are set in the mask also provided to it. The moves are the
+ * mask's masks from graph_init_moves().
+ */
+uint32_t graph_deposit_bits(uint32_t val, uint32_t mask, 
+                            const uint32_t* moves)
+{
+#if defined(__BMI2__)
+    /* Let the processor scatter the bits. */
+    return _pdep_u32(val, mask);
+#else
+    uint32_t t;     /* The bits that move at the current step. */
+    int8_t i;       /* The current step. */
+
+    /* Undo the steps that would gather the bits, largest first. Each step
+     * moves the bits that have to travel that far left. */
+    for (i = GRAPH_MORTON_STEPS - 1; i >= 0; i--)
+    {
+        t = val << (1 << i);
+        val = (val & ~moves[i]) | (t & moves[i]);
+    }
+
+    /* Return the scattered bits. */
+    return val & mask;
+#endif
+}
+
+/**
+ * This function gathers the bits of the value provided to it that are set in
+ * the mask also provided to it into the low bits of the result. The moves
+ * are the mask's masks from graph_init_moves().
+ */
+uint32_t graph_extract_bits(uint32_t val, uint32_t mask, 
+                            const uint32_t* moves)
+{
+#if defined(__BMI2__)
+    /* Let the processor gather the bits. */
+    return _pext_u32(val, mask);
+#else
+    uint32_t t;     /* The bits that move at the current step. */
+    uint8_t i;      /* The current step. */
+
+    /* Gather the bits in steps of 1, 2, 4, 8 and 16 places, moving each
+     * bit right by the parts of its distance to travel at each step. */
+    val &= mask;
+    for (i = 0; i < GRAPH_MORTON_STEPS; i++)
+    {
+        t = val & moves[i];
+        val = (val ^ t) | (t >> (1 << i));
+    }
+
+    /* Return the gathered bits. */
+    return val;
+#endif
+}
+
+/**
+ * This function returns the id of the cell in the graph provided to it
+ * located at the coordinates also provided to the function. The coordinates
+ * must be within the bounds of the graph.
+ */
+uint32_t graph_get_cell_id(graph g, uint8_t x, uint8_t y, uint8_t z)
+{
+    /* Check which order the cells are stored in. */
+    if (g->layout == MORTON)
+    {
+        /* Interleave the bits of the coordinates. */
+        return graph_deposit_bits(x, g->xmask, g->xmoves) 
+             | graph_deposit_bits(y, g->ymask, g->ymoves) 
+             | graph_deposit_bits(z, g->zmask, g->zmoves);
+    }
+
+    /* The cells are stored x axis first, then y, then z. */
+    return ((uint32_t) x * g->ysize + y) * g->zsize + z;
+}
+
+/**
+ * This function gets the coordinates of the cell with the id provided to it
+ * in the graph also provided to the function.
+ */
+void graph_get_cell_coords(graph g, uint32_t id, 
+                           uint8_t* xp, uint8_t* yp, uint8_t* zp)
+{
+    /* Check which order the cells are stored in. */
+    if (g->layout == MORTON)
+    {
+        /* De-interleave the bits of the id. */
+        *xp = (uint8_t) graph_extract_bits(id, g->xmask, g->xmoves);
+        *yp = (uint8_t) graph_extract_bits(id, g->ymask, g->ymoves);
+        *zp = (uint8_t) graph_extract_bits(id, g->zmask, g->zmoves);
+    }
+    else
+    {
+        /* The cells are stored x axis first, then y, then z. */
+        *zp = (uint8_t) (id % g->zsize);
+        *yp = (uint8_t) ((id / g->zsize) % g->ysize);
+        *xp = (uint8_t) (id / g->zsize / g->ysize);
+    }
+}
+
+/**
+ * This function gets the x and y coordinates of the cell with the id
+ * provided to it in a graph with only one layer on its z axis, without
+ * working out the z coordinate.
+ */
+void graph_get_cell_coords_2d(graph g, uint32_t id, uint8_t* xp, uint8_t* yp)
+{
+    /* Check which order the cells are stored in. */
+    if (g->layout == MORTON)
+    {
+        /* De-interleave the bits of the id. The z mask is empty. */
+        *xp = (uint8_t) graph_extract_bits(id, g->xmask, g->xmoves);
+        *yp = (uint8_t) graph_extract_bits(id, g->ymask, g->ymoves);
+    }
+    else
+    {
+        /* The cells are stored x axis first, then y. */
+        *yp = (uint8_t) (id % g->ysize);
+        *xp = (uint8_t) (id / g->ysize);
+    }
+}
+
+/**
+ * This function returns true if the id provided to it belongs to a cell of
+ * the graph also provided to the function.
+ */
+bool graph_cell_exists(graph g, uint32_t id)
+{
+    /* Return whether there's a node at that id. */
+    return id < g->num_cells && g->cells[id] != NULL;
+}
+
+/**
+ * This function returns the id of the cell that the node provided to it is
+ * at in the graph also provided to the function.
+ */
+uint32_t graph_get_node_id(graph g, node* np)
+{
+    /* The node is a place in the graph's array of nodes. */
+    return (uint32_t) (np - g->cells);
+}
+
+/**
+ * This function returns the node at the cell with the id provided to it in
+ * the graph also provided to the function.
+ */
+node* graph_get_cell_node(graph g, uint32_t id)
+{
+    /* Check there's a node at that id. */
+    if (!graph_cell_exists(g, id))
+    {
+        fprintf(stdout,
+                "\nERROR: In function graph_get_cell_node(): "
+                "Invalid cell id: %u!\n", id);
+        exit(EXIT_FAILURE);
+    }
+
+    /* Return the node. */
+    return &(g->cells[id]);
+}
+
+/**
+ * This function brings the graph's index of edges up to date with any edges
+ * that have been added or removed since it was last built. Searches that use
+ * cell ids call it before they start.
+ */
+void graph_update_index(graph* gp)
+{
+    /* Rebuild the index if edges have changed. */
+    if ((*gp)->index_dirty)
+    {
+        graph_build_index(gp);
+    }
+}
+
+/**
+ * This function returns the number of edges in the index of the graph
+ * provided to it.
+ */
+uint32_t graph_get_edge_count(graph g)
+{
+    return g->num_edges;
+}
+
+/**
+ * This function returns the id of the first edge leaving the cell with the
+ * id provided to it. The edges leaving the cell run up to, but not
+ * including, the first edge of the next cell id.
+ */
+uint32_t graph_get_first_edge(graph g, uint32_t id)
+{
+    return g->first_edge[id];
+}
+
+/**
+ * This function returns the id of the cell that the edge with the id
+ * provided to it leads to.
+ */
+uint32_t graph_get_edge_to(graph g, uint32_t e)
+{
+    return g->edge_to[e];
+}
+
+/**
+ * This function returns the cost of moving along the edge with the id
+ * provided to it. A cost of 0 means the move isn't possible.
+ */
+uint8_t graph_get_edge_w(graph g, uint32_t e)
+{
+    return g->edge_w[e];
+}
+
+/**
+ * This function returns the id of the first edge leading into the cell with
+ * the id provided to it. The edges leading into the cell run up to, but not
+ * including, the first edge leading into the next cell id.
+ */
+uint32_t graph_get_first_in_edge(graph g, uint32_t id)
+{
+    return g->first_in_edge[id];
+}
+
+/**
+ * This function returns the id of the cell that the edge leading in with the
+ * id provided to it leaves.
+ */
+uint32_t graph_get_in_edge_from(graph g, uint32_t e)
+{
+    return g->in_edge_from[e];
+}
+
+/**
+ * This function returns the cost of moving along the edge leading in with
+ * the id provided to it. A cost of 0 means the move isn't possible.
+ */
+uint8_t graph_get_in_edge_w(graph g, uint32_t e)
+{
+    return g->in_edge_w[e];
+}
+
+/**
+ * This function returns true if every edge of the graph provided to it is a
+ * move to a neighbouring cell on the grid with a cost of 0 or 1, as they are
+ * when the graph is initialised. The passability masks then describe all of
+ * the graph's edges.
+ */
+bool graph_is_unit_grid(graph g)
+{
+    return g->unit_grid;
+}
+
+/**
+ * This function returns the passability mask of the cell with the id
+ * provided to it. Bit d of the mask is set if the cell has an edge with a
+ * non-zero cost to its neighbour in direction d.
+ */
+uint32_t graph_get_pass_mask(graph g, uint32_t id)
+{
+    return g->pass_masks[id];
+}
+
+/**
+ * This function returns the clearance of the cell with the id provided to
+ * it: how many cells wide the largest cube of passable cells with the cell
+ * at its lowest corner is. It's 0 for an obstacle. Along an axis that's only
+ * one cell long the cube is flat, so on a flat graph it's a square. An agent
+ * that fills a cube of cells can stand with its lowest corner on any cell
+ * whose clearance is at least its size. The clearance is worked out when
+ * the graph is initialised and kept up to date by graph_set_cell_type().
+ */
+uint8_t graph_get_clearance(graph g, uint32_t id)
+{
+    return g->clearance[id];
+}
+
+/**
+ * This function returns the id of the neighbour in the direction provided to
+ * it of the cell with the id also provided to the function. The neighbour
+ * must be within the bounds of the graph.
+ */
+uint32_t graph_get_neighbour_id(graph g, uint32_t id, uint8_t dir)
+{
+    int8_t xoff;        /* The x offset of the direction. */
+    int8_t yoff;        /* The y offset of the direction. */
+    int8_t zoff;        /* The z offset of the direction. */
+
+    /* With a LINEAR layout the neighbour is a fixed distance away. */
+    if (g->layout == LINEAR)
+    {
+        return (uint32_t) ((int32_t) id + g->dir_deltas[dir]);
+    }
+
+    /* Otherwise step each coordinate where it lies in the id. */
+    graph_get_dir_offset(dir, &xoff, &yoff, &zoff);
+    id = graph_step_bits(id, g->xmask, xoff);
+    id = graph_step_bits(id, g->ymask, yoff);
+    return graph_step_bits(id, g->zmask, zoff);
+}
+
+/**
+ * This function adds the offset provided to it, which is -1, 0 or 1, to the
+ * coordinate held in the bits of the id that are set in the mask, leaving
+ * the id's other bits as they are. Filling the gaps between the mask's bits
+ * with ones lets a carry run straight through them when adding, and
+ * clearing them lets a borrow do the same when subtracting.
+ */
+uint32_t graph_step_bits(uint32_t id, uint32_t mask, int8_t off)
+{
+    if (off > 0)
+    {
+        return (id & ~mask) | (((id | ~mask) + 1) & mask);
+    }
+    if (off < 0)
+    {
+        return (id & ~mask) | (((id & mask) - 1) & mask);
+    }
+    return id;
+}
+
+/**
+ * This function gets the coordinate offsets of the direction provided to
+ * it. Directions are numbered in the order of their x, then y, then z
+ * offsets, each going from -1 to 1.
+ */
+void graph_get_dir_offset(uint8_t dir, int8_t* xp, int8_t* yp, int8_t* zp)
+{
+    /* Skip over the offset that stays put, which would be number 13. */
+    if (dir >= 13)
+    {
+        dir++;
+    }
+
+    /* Split the number into its offsets. */
+    *xp = (int8_t) (dir / 9) - 1;
+    *yp = (int8_t) ((dir / 3) % 3) - 1;
+    *zp = (int8_t) (dir % 3) - 1;
+}
+
+/**
+ * This function returns the direction of the move between the two cells
+ * with the ids provided to it, or GRAPH_NUM_DIRECTIONS if they aren't
+ * neighbours on the grid.
+ */
+uint8_t graph_get_move_dir(graph g, uint32_t from, uint32_t to)
+{
+    uint8_t fx, fy, fz; /* The coordinates of the cell moved from. */
+    uint8_t tx, ty, tz; /* The coordinates of the cell moved to. */
+    int16_t xoff;       /* The x offset of the move. */
+    int16_t yoff;       /* The y offset of the move. */
+    int16_t zoff;       /* The z offset of the move. */
+    uint8_t dir;        /* The direction of the move. */
+
+    /* Get the offsets of the move. */
+    graph_get_cell_coords(g, from, &fx, &fy, &fz);
+    graph_get_cell_coords(g, to, &tx, &ty, &tz);
+    xoff = (int16_t) tx - fx;
+    yoff = (int16_t) ty - fy;
+    zoff = (int16_t) tz - fz;
+
+    /* Check the cells are neighbours on the grid. */
+    if (xoff < -1 || xoff > 1 || yoff < -1 || yoff > 1 
+        || zoff < -1 || zoff > 1 || (xoff == 0 && yoff == 0 && zoff == 0))
+    {
+        return GRAPH_NUM_DIRECTIONS;
+    }
+
+    /* Number the direction, skipping over the offset that stays put. */
+    dir = (uint8_t) ((xoff + 1) * 9 + (yoff + 1) * 3 + (zoff + 1));
+    return dir > 13 ? dir - 1 : dir;
+}
+
+/**
+ * This function changes the node-type of the cell with the id provided to
+ * it. Moving into the cell then costs 1 if it's PASSABLE and isn't possible
+ * if it's IMPASSABLE. The graph's index of edges, the passability masks
+ * of the cell's neighbours and the clearance of the cells are updated to
+ * match.
+ */
+void graph_set_cell_type(graph* gp, uint32_t id, enum node_type type)
+{
+    node* np;           /* The cell's node. */
+    array edges;        /* The edges leading into the cell. */
+    edge* e;            /* The current edge into the cell. */
+    uint32_t from;      /* The cell the current edge leaves. */
+    uint32_t ie;        /* The index entry of the current edge. */
+    uint32_t last;      /* The end of the edges leaving that cell. */
+    uint64_t size;      /* The number of edges into the cell. */
+    uint64_t i;         /* The index of the current edge. */
+    uint8_t w;          /* The new cost of moving into the cell. */
+    uint8_t dir;        /* The direction of the current edge. */
+
+    /* Set the node's type and work out the new cost of moving into it. */
+    np = graph_get_cell_node(*gp, id);
+    if (type == PASSABLE && node_get_type(*np) != PASSABLE)
+    {
+        (*gp)->num_decreases++;
+    }
+    node_set_type(np, type);
+    w = type == PASSABLE ? 1 : 0;
+
+    /* Update every edge leading into the cell. */
+    edges = node_get_edges(*np);
+    size = array_size(edges);
+    for (i = 0; i < size; i++)
+    {
+        /* Set the weight of the node's edge. */
+        e = (edge*) array_get_data(edges, i);
+        edge_set_w(e, w);
+
+        /* The index will be rebuilt from the nodes anyway if it's out of
+         * date, so only update it if it isn't. The edges leading into the
+         * cell are in the same order as the node's edges. */
+        if (!(*gp)->index_dirty)
+        {
+            (*gp)->in_edge_w[(*gp)->first_in_edge[id] + i] = w;
+
+            /* Find the edge in the index and set its weight. */
+            from = graph_get_node_id(*gp, (node*) edge_get_neighbourp(e));
+            last = (*gp)->first_edge[from + 1];
+            for (ie = (*gp)->first_edge[from]; ie < last; ie++)
+            {
+                if ((*gp)->edge_to[ie] == id)
+                {
+                    (*gp)->edge_w[ie] = w;
+                }
+            }
+
+            /* Update the passability mask of the cell the edge leaves. */
+            dir = graph_get_move_dir(*gp, from, id);
+            if (dir < GRAPH_NUM_DIRECTIONS)
+            {
+                if (w != 0)
+                {
+                    (*gp)->pass_masks[from] |= (uint32_t) 1 << dir;
+                }
+                else
+                {
+                    (*gp)->pass_masks[from] &= ~((uint32_t) 1 << dir);
+                }
+            }
+        }
+    }
+
+    /* Bring the clearance of the cells up to date. */
+    graph_update_clearance(gp, id);
+}
+
+/**
+ * This function returns the number of changes to the graph provided to it
+ * that may have made moving between some of its cells cheaper: cells made
+ * PASSABLE by graph_set_cell_type(), edges added and terrain classes set.
+ * Searches that keep what they've learned about the graph from one search
+ * to the next can check it to know when what they learned may no longer
+ * hold. Changes that only make moves dearer don't count.
+ */
+uint32_t graph_get_num_decreases(graph g)
+{
+    return g->num_decreases;
+}
+
+/**
+ * This function sets the terrain class of the cell with the id provided to
+ * it, which must be less than GRAPH_NUM_TERRAINS. The graph's own costs
+ * don't change, only the costs movement profiles give moves into the cell.
+ */
+void graph_set_cell_terrain(graph* gp, uint32_t id, uint8_t terrain)
 {
-    node* n;    /* The node at the coordinates. */
-
-    /* Check if the coordinates are within the bounds of the graph. */
-    if (graph_valid_coord(g, (int16_t) x, (int16_t) y, (int16_t) z))
-    {
-        /* The provided coordinates is within the bounds of the graph so
-         * get the node at those coordinates. */
-        n = &(g->nodes[x][y][z]);
-    }
-    else
+    /* Check the terrain class is one profiles have costs for. */
+    if (terrain >= GRAPH_NUM_TERRAINS)
     {
-        /* The provided coordinates are not within the bounds of the graph
-         * so print an error message and exit the program. */
         fprintf(stdout,
-                "\nERROR: In function graph_get_node(): "
-                "Invalid node coordinates: { %d, %d, %d }!\n", x, y, z);
+                "\nERROR: In function graph_set_cell_terrain(): Terrain "
+                "class %u is beyond the %u classes!\n", 
+                (unsigned) terrain, (unsigned) GRAPH_NUM_TERRAINS);
         exit(EXIT_FAILURE);
     }
 
-    /* Returning the node at the coordinates. */
-    return n;
+    /* Set the cell's terrain class. The new class may be cheaper for some
+     * agents to move into. */
+    (*gp)->terrain[id] = terrain;
+    (*gp)->num_decreases++;
 }
 
-/* This function returns the way in which a graph-node will be considered a
- * neighbour of another graph-node.
+/**
+ * This function returns the terrain class of the cell with the id provided
+ * to it. Every cell's terrain class is 0 when the graph is initialised.
  */
-enum graph_style graph_get_style(graph g)
+uint8_t graph_get_cell_terrain(graph g, uint32_t id)
 {
-    /* Return the way in which graph-nodes are considered neighbours of each
-     * other. */
-    return g->gstyle;
+    return g->terrain[id];
+}
+
+/**
+ * This function asks the processor to start loading what a search reads to
+ * expand the cell with the id provided to it, so it's in the cache by the
+ * time the cell is expanded: the cell's passability mask on a unit grid,
+ * or otherwise its entry in the edge index.
+ */
+void graph_prefetch_cell(graph g, uint32_t id)
+{
+    /* Searches expand unit grids from the passability masks alone. */
+    if (g->unit_grid)
+    {
+        GRAPH_PREFETCH(&g->pass_masks[id]);
+        return;
+    }
+
+    /* Where the cell's edges start isn't known until its index entry is
+     * loaded, and reading it here would stall on the very miss this is
+     * meant to hide, so only the entry is prefetched. */
+    GRAPH_PREFETCH(&g->first_edge[id]);
 }
 
 /**
@@ -180,8 +912,20 @@ uint8_t graph_get_z_size(graph g)
  */
 void  graph_add_edge(node* fromp, node* top, uint8_t weight)
 {
+    graph owner;
+
     /* Add an edge. */
     node_add_edge(fromp, top, weight);
+
+    /* The graph's index of edges is now out of date, and the new edge may
+     * be a cheaper way between the nodes. Nodes that weren't created by a
+     * graph have no index to update. */
+    owner = (graph) node_get_owner(*fromp);
+    if (owner != NULL)
+    {
+        owner->index_dirty = true;
+        owner->num_decreases++;
+    }
 }
 
 /**
@@ -193,8 +937,37 @@ void  graph_add_edge(node* fromp, node* top, uint8_t weight)
  */
 void graph_remove_edge(node* fromp, node* top) 
 {
+    graph owner;
+
     /* Remove an edge. */
     node_remove_edge(fromp, top);
+
+    /* The graph's index of edges is now out of date, if there is one. */
+    owner = (graph) node_get_owner(*fromp);
+    if (owner != NULL)
+    {
+        owner->index_dirty = true;
+    }
+}
+
+/**
+ * This function does the same as graph_add_edge() for the cells with the ids
+ * provided to it.
+ */
+void graph_add_edge_id(graph* gp, uint32_t from, uint32_t to, uint8_t weight)
+{
+    graph_add_edge(graph_get_cell_node(*gp, from), 
+                   graph_get_cell_node(*gp, to), weight);
+}
+
+/**
+ * This function does the same as graph_remove_edge() for the cells with the
+ * ids provided to it.
+ */
+void graph_remove_edge_id(graph* gp, uint32_t from, uint32_t to)
+{
+    graph_remove_edge(graph_get_cell_node(*gp, from), 
+                      graph_get_cell_node(*gp, to));
 }
 
 /**
@@ -203,27 +976,14 @@ void graph_remove_edge(node* fromp, node* top)
  */
 void graph_reset(graph* gp)
 {
-    uint8_t x;      /* The current x coordinate. */
-    uint8_t y;      /* The current y coordinate. */
-    uint8_t z;      /* The current z coordinate. */
-    uint8_t xsize;  /* The size of the graph's x axis. */
-    uint8_t ysize;  /* The size of the graph's y axis. */
-    uint8_t zsize;  /* The size of the graph's z axis. */
-
-    /* Get the size of the graph's axes/dimensions. */
-    xsize = (*gp)->xsize;
-    ysize = (*gp)->ysize;
-    zsize = (*gp)->zsize;
+    uint32_t id;    /* The current cell id. */
    
-    /* Reset the graph's nodes. */
-    for (x = 0; x < xsize; x++)
+    /* Reset the graph's nodes in the order they're stored in. */
+    for (id = 0; id < (*gp)->num_cells; id++)
     {
-        for (y = 0; y < ysize; y++)
+        if ((*gp)->cells[id] != NULL)
         {
-            for (z = 0; z < zsize; z++)
-            {
-	            node_reset(&(*gp)->nodes[x][y][z]);
-            }
+	        node_reset(&(*gp)->cells[id]);
         }
     }
 }
@@ -292,6 +1052,69 @@ bool diagonal_relationship(int8_t xoff, int8_t yoff, int8_t zoff)
             );
 }
 
+/**
+ * These are the coordinate offsets of a cell's neighbours on a graph with
+ * only one layer on its z axis. They are in the same order the three
+ * dimensional collection finds them in, so both give the same neighbours in
+ * the same order.
+ */
+const int8_t graph_manhattan_offsets_2d[4][2] = {
+    { -1,  0 }, {  0, -1 }, {  0,  1 }, {  1,  0 }
+};
+const int8_t graph_diagonal_offsets_2d[8][2] = {
+    { -1, -1 }, { -1,  0 }, { -1,  1 }, {  0, -1 },
+    {  0,  1 }, {  1, -1 }, {  1,  0 }, {  1,  1 }
+};
+
+/**
+ * This function populates the array of neighbours of the node provided to
+ * this function when the graph only has one layer on its z axis. It only
+ * visits the 4 or 8 neighbours the graph's style allows and never looks at
+ * the z axis.
+ */
+void graph_collect_neighbours_2d(graph* gp, node* np)
+{
+    const int8_t (*offsets)[2]; /* The offsets of the neighbours. */
+    uint8_t num_offsets;        /* The number of offsets. */
+    uint8_t xsize;              /* The size of the graph's x axis. */
+    uint8_t ysize;              /* The size of the graph's y axis. */
+    int16_t x;                  /* The neighbour's x coordinate. */
+    int16_t y;                  /* The neighbour's y coordinate. */
+    uint8_t i;                  /* The index of the current offset. */
+
+    /* Get the offsets of the neighbours for the graph's style. */
+    if ((*gp)->gstyle == MANHATTAN)
+    {
+        offsets = graph_manhattan_offsets_2d;
+        num_offsets = 4;
+    }
+    else
+    {
+        offsets = graph_diagonal_offsets_2d;
+        num_offsets = 8;
+    }
+
+    /* Get the size of the graph's axes. */
+    xsize = (*gp)->xsize;
+    ysize = (*gp)->ysize;
+
+    /* Collect the neighbours of the provided node. */
+    for (i = 0; i < num_offsets; i++)
+    {
+        /* Calculate the coordinates of the neighbour. */
+        x = (int16_t) node_get_x(*np) + offsets[i][0];
+        y = (int16_t) node_get_y(*np) + offsets[i][1];
+
+        /* Check the coordinates are within the bounds of the graph. */
+        if (x >= 0 && x < xsize && y >= 0 && y < ysize)
+        {
+            /* Add the neighbour to the node's array of neighbours. */
+            node_add_neighbour(np, &(*gp)->cells[
+                    graph_get_cell_id(*gp, (uint8_t) x, (uint8_t) y, 0)]);
+        }
+    }
+}
+
 /**
  * This function populates the array of neighbours of the node provided to 
  * this function.
@@ -387,58 +1210,514 @@ void graph_init_edges(graph* gp, node* np)
     free(&(weights[0]));
 }
 
+/**
+ * This function initialises the masks that say which bits of a cell id hold
+ * which coordinate when the graph has a MORTON layout.
+ */
+void graph_init_morton(graph* gp)
+{
+    uint32_t bit;   /* The next bit of the id to hand out. */
+    uint32_t level; /* The bit of the coordinates being handed out. */
+
+    /* Hand out the bits of the id to the axes in turn, for as long as each
+     * axis still needs more bits to hold its largest coordinate. */
+    (*gp)->xmask = 0;
+    (*gp)->ymask = 0;
+    (*gp)->zmask = 0;
+    bit = 1;
+    for (level = 0; level < 8; level++)
+    {
+        if (((*gp)->xsize - 1) >> level)
+        {
+            (*gp)->xmask |= bit;
+            bit <<= 1;
+        }
+        if (((*gp)->ysize - 1) >> level)
+        {
+            (*gp)->ymask |= bit;
+            bit <<= 1;
+        }
+        if (((*gp)->zsize - 1) >> level)
+        {
+            (*gp)->zmask |= bit;
+            bit <<= 1;
+        }
+    }
+
+    /* Work out which bits move at each step for each of the masks. */
+    graph_init_moves((*gp)->xmask, (*gp)->xmoves);
+    graph_init_moves((*gp)->ymask, (*gp)->ymoves);
+    graph_init_moves((*gp)->zmask, (*gp)->zmoves);
+}
+
+/**
+ * This function fills the array provided to it with the masks of the bits
+ * that move at each step when bits are spread into or gathered out of the
+ * mask also provided to the function. Gathering moves each bit right by
+ * the number of clear bits below it in the mask, and step i moves the bits
+ * whose count has bit i set (Hacker's Delight, section 7-4).
+ */
+void graph_init_moves(uint32_t mask, uint32_t* moves)
+{
+    uint32_t mk;    /* The clear bits of the mask, one place to the left. */
+    uint32_t mp;    /* Which bits have an odd count of clear bits below. */
+    uint32_t mv;    /* The bits that move at the current step. */
+    uint8_t i;      /* The current step. */
+
+    mk = ~mask << 1;
+    for (i = 0; i < GRAPH_MORTON_STEPS; i++)
+    {
+        /* Count the clear bits below each bit, keeping only the lowest bit
+         * of the count that's left. */
+        mp = mk ^ (mk << 1);
+        mp ^= mp << 2;
+        mp ^= mp << 4;
+        mp ^= mp << 8;
+        mp ^= mp << 16;
+
+        /* The bits of the mask with that bit of the count set move at this
+         * step, and the mask's bits are moved with them. */
+        mv = mp & mask;
+        moves[i] = mv;
+        mask = (mask ^ mv) | (mv >> (1 << i));
+        mk &= ~mp;
+    }
+}
+
 /**
  * This function initialises the nodes of the graph provided to it. 
  */
 void graph_init_nodes(graph* gp)
 {
-    uint8_t x;      /* The current x coordinate. */
-    uint8_t y;      /* The current y coordinate. */
-    uint8_t z;      /* The current z coordinate. */
-    uint8_t xsize;  /* The size of the graph's x axis. */
-    uint8_t ysize;  /* The size of the graph's y axis. */
-    uint8_t zsize;  /* The size of the graph's z axis. */
+    uint32_t id;        /* The current cell id. */
+    uint8_t x;          /* The current x coordinate. */
+    uint8_t y;          /* The current y coordinate. */
+    uint8_t z;          /* The current z coordinate. */
+    size_t data_size;   /* The size of a node's data. */
+    uint32_t slot;      /* The place of the next node's data. */
 
-    /* Get the size of the graph's axes. */
-    xsize = (*gp)->xsize;
-    ysize = (*gp)->ysize;
-    zsize = (*gp)->zsize;
+    /* Allocate memory to the nodes, and to the data of the nodes of real
+     * cells only. The MORTON layout has ids that are padding, and they
+     * can outnumber the cells several times over. */
+    data_size = node_get_data_size();
+    (*gp)->cells = (node*) malloc(sizeof(node) * (*gp)->num_cells);
+    (*gp)->cell_data = malloc(data_size * (uint32_t) (*gp)->xsize 
+                              * (*gp)->ysize * (*gp)->zsize);
 
-    /* Allocate memory to the x axis. */
-    (*gp)->nodes = (node***) malloc(sizeof(node**) * xsize);
-    for (x = 0; x < xsize; x++)
+    /* Initialise the nodes in the order they're stored in, so that their data
+     * is laid out in memory the same way. */
+    slot = 0;
+    for (id = 0; id < (*gp)->num_cells; id++)
     {
-        /* Allocate memory to the y axis. */
-        (*gp)->nodes[x] = (node**) malloc(sizeof(node*) * ysize);
-        for (y = 0; y < ysize; y++)
+        /* Get the coordinates of the cell. */
+        graph_get_cell_coords(*gp, id, &x, &y, &z);
+
+        /* Check that the id belongs to a cell rather than padding. */
+        if (graph_valid_coord(*gp, (int16_t) x, (int16_t) y, (int16_t) z))
         {
-            /* Allocate memory to the z axis. */
-            (*gp)->nodes[x][y] = (node*) malloc(sizeof(node) * zsize);
-            for (z = 0; z < zsize; z++)
-            {
-                /* Initialise the node. */
-                node_init(&(*gp)->nodes[x][y][z], x, y, z, PASSABLE);
-            }
+            /* Initialise the node. */
+            node_init_in(&(*gp)->cells[id], 
+                         (char*) (*gp)->cell_data + data_size * slot++, 
+                         x, y, z, PASSABLE);
+            node_set_owner(&(*gp)->cells[id], *gp);
+        }
+        else
+        {
+            /* There is no cell with this id. */
+            (*gp)->cells[id] = NULL;
         }
     }
 
     /* Create the array of neighbouring nodes and their edges. */
-    for (x = 0; x < xsize; x++)
+    for (id = 0; id < (*gp)->num_cells; id++)
     {
-        for (y = 0; y < ysize; y++)
+        if ((*gp)->cells[id] != NULL)
         {
-            for (z = 0; z < zsize; z++)
+            /* Populate the node's array of neighbours, using the two
+             * dimensional collection if the graph is flat. */
+            if ((*gp)->zsize == 1)
+            {
+                graph_collect_neighbours_2d(gp, &(*gp)->cells[id]);
+            }
+            else
             {
-                /* Populate the node's array of neighbours. */
-                graph_collect_neighbours(gp, &(*gp)->nodes[x][y][z]);
+                graph_collect_neighbours(gp, &(*gp)->cells[id]);
+            }
                 
-                /* Create the edges of this node's array of neighbours. */
-                graph_init_edges(gp, &(*gp)->nodes[x][y][z]);
+            /* Create the edges of this node's array of neighbours. */
+            graph_init_edges(gp, &(*gp)->cells[id]);
+        }
+    }
+}
+
+/**
+ * This function builds the graph's index of edges from its nodes' edges.
+ */
+void graph_build_index(graph* gp)
+{
+    array edges;        /* The edges of the current node. */
+    edge* e;            /* The current edge. */
+    uint32_t* from;     /* The cell each collected edge leaves. */
+    uint32_t* to;       /* The cell each collected edge leads to. */
+    uint8_t* w;         /* The cost of each collected edge. */
+    uint32_t num_edges; /* The number of edges collected. */
+    uint32_t id;        /* The current cell id. */
+    uint32_t i;         /* The index of the current edge. */
+    uint64_t size;      /* The number of edges the current node has. */
+    uint8_t dir;        /* The direction of the current edge. */
+
+    /* Count the graph's edges. */
+    num_edges = 0;
+    for (id = 0; id < (*gp)->num_cells; id++)
+    {
+        if ((*gp)->cells[id] != NULL)
+        {
+            num_edges += array_size(node_get_edges((*gp)->cells[id]));
+        }
+    }
+
+    /* Collect the edges. A node's edges lead into it, from the neighbour
+     * each edge stores, so the edges are collected grouped by the cell they
+     * lead into and are kept as the index of edges leading in. */
+    free((*gp)->first_in_edge);
+    free((*gp)->in_edge_from);
+    free((*gp)->in_edge_w);
+    (*gp)->first_in_edge = (uint32_t*) malloc(
+            sizeof(uint32_t) * ((*gp)->num_cells + 1));
+    from = (uint32_t*) malloc(sizeof(uint32_t) * num_edges);
+    to = (uint32_t*) malloc(sizeof(uint32_t) * num_edges);
+    w = (uint8_t*) malloc(sizeof(uint8_t) * num_edges);
+    num_edges = 0;
+    for (id = 0; id < (*gp)->num_cells; id++)
+    {
+        (*gp)->first_in_edge[id] = num_edges;
+        if ((*gp)->cells[id] != NULL)
+        {
+            edges = node_get_edges((*gp)->cells[id]);
+            size = array_size(edges);
+            for (i = 0; i < size; i++)
+            {
+                e = (edge*) array_get_data(edges, i);
+                from[num_edges] = graph_get_node_id(*gp, 
+                                        (node*) edge_get_neighbourp(e));
+                to[num_edges] = id;
+                w[num_edges] = edge_get_w(*e);
+                num_edges++;
+            }
+        }
+    }
+    (*gp)->first_in_edge[(*gp)->num_cells] = num_edges;
+    (*gp)->in_edge_from = from;
+    (*gp)->in_edge_w = w;
+
+    /* Allocate memory to the index. */
+    free((*gp)->first_edge);
+    free((*gp)->edge_to);
+    free((*gp)->edge_w);
+    (*gp)->first_edge = (uint32_t*) calloc((*gp)->num_cells + 1, 
+                                           sizeof(uint32_t));
+    (*gp)->edge_to = (uint32_t*) malloc(sizeof(uint32_t) * num_edges);
+    (*gp)->edge_w = (uint8_t*) malloc(sizeof(uint8_t) * num_edges);
+    (*gp)->num_edges = num_edges;
+
+    /* Count the edges leaving each cell, then turn the counts into the
+     * position of each cell's first edge. */
+    for (i = 0; i < num_edges; i++)
+    {
+        (*gp)->first_edge[from[i] + 1]++;
+    }
+    for (id = 0; id < (*gp)->num_cells; id++)
+    {
+        (*gp)->first_edge[id + 1] += (*gp)->first_edge[id];
+    }
+
+    /* Place each edge with the other edges leaving the same cell, using the
+     * first edge positions as insertion points for now. */
+    for (i = 0; i < num_edges; i++)
+    {
+        (*gp)->edge_to[(*gp)->first_edge[from[i]]] = to[i];
+        (*gp)->edge_w[(*gp)->first_edge[from[i]]] = w[i];
+        (*gp)->first_edge[from[i]]++;
+    }
+
+    /* Each insertion point is now the next cell's first edge, so move them
+     * back up by one cell. */
+    for (id = (*gp)->num_cells; id > 0; id--)
+    {
+        (*gp)->first_edge[id] = (*gp)->first_edge[id - 1];
+    }
+    (*gp)->first_edge[0] = 0;
+
+    /* Build the passability masks from the index, noting whether every
+     * edge is a grid move costing 0 or 1. */
+    free((*gp)->pass_masks);
+    (*gp)->pass_masks = (uint32_t*) calloc((*gp)->num_cells, 
+                                           sizeof(uint32_t));
+    (*gp)->unit_grid = true;
+    for (id = 0; id < (*gp)->num_cells; id++)
+    {
+        for (i = (*gp)->first_edge[id]; i < (*gp)->first_edge[id + 1]; i++)
+        {
+            dir = graph_get_move_dir(*gp, id, (*gp)->edge_to[i]);
+            if (dir == GRAPH_NUM_DIRECTIONS || (*gp)->edge_w[i] > 1)
+            {
+                (*gp)->unit_grid = false;
+            }
+            else if ((*gp)->edge_w[i] != 0)
+            {
+                (*gp)->pass_masks[id] |= (uint32_t) 1 << dir;
+            }
+        }
+    }
+
+    /* De-allocate memory from the collected edges that aren't kept. */
+    free(to);
+
+    /* The index is now up to date. */
+    (*gp)->index_dirty = false;
+}
+
+/**
+ * This function works out the clearance of every cell of the graph provided
+ * to it in one pass from its highest corner to its lowest.
+ */
+void graph_build_clearance(graph* gp)
+{
+    uint8_t* next;      /* The clearance of the plane at the next x. */
+    uint8_t* cur;       /* The clearance of the plane at the current x. */
+    uint8_t* low;       /* The least clearance of each cell's neighbours in
+                         * the next plane. */
+    uint8_t* tmp;       /* A plane being swapped. */
+    size_t width;       /* The length of a row of a plane, with padding. */
+    size_t size;        /* The number of cells in a plane, with padding. */
+    size_t row;         /* The position of the current row in the plane. */
+    size_t i;           /* The current position in the plane. */
+    uint32_t id;        /* The id of the current cell. */
+    int16_t x;          /* The current x coordinate. */
+    int16_t y;          /* The current y coordinate. */
+    int16_t z;          /* The current z coordinate. */
+    uint8_t xpad;       /* The clearance of the cells past the x axis. */
+    uint8_t ypad;       /* The clearance of the cells past the y axis. */
+    uint8_t zpad;       /* The clearance of the cells past the z axis. */
+    uint8_t m;          /* The least clearance of the current cell's
+                         * neighbours. */
+
+    /* Allocate memory to the clearance. */
+    (*gp)->clearance = (uint8_t*) calloc((*gp)->num_cells, sizeof(uint8_t));
+
+    /* The planes have an extra row and column of padding past the end of
+     * the y and z axes, and one more cell so the padding's neighbours can
+     * be read too. */
+    width = (size_t) (*gp)->zsize + 1;
+    size = ((size_t) (*gp)->ysize + 1) * width;
+    next = (uint8_t*) malloc(sizeof(uint8_t) * (size + 1));
+    cur = (uint8_t*) malloc(sizeof(uint8_t) * (size + 1));
+    low = (uint8_t*) malloc(sizeof(uint8_t) * (size + 1));
+
+    /* The cells past the end of an axis are obstacles, unless the axis is
+     * only one cell long, in which case the cubes are flat along it and
+     * nothing past it limits them. */
+    xpad = (*gp)->xsize == 1 ? UINT8_MAX : 0;
+    ypad = (*gp)->ysize == 1 ? UINT8_MAX : 0;
+    zpad = (*gp)->zsize == 1 ? UINT8_MAX : 0;
+
+    /* The plane past the end of the x axis is all padding. */
+    for (y = 0; y <= (int16_t) (*gp)->ysize; y++)
+    {
+        for (z = 0; z <= (int16_t) (*gp)->zsize; z++)
+        {
+            m = xpad;
+            if (y == (int16_t) (*gp)->ysize && ypad < m)
+            {
+                m = ypad;
+            }
+            if (z == (int16_t) (*gp)->zsize && zpad < m)
+            {
+                m = zpad;
+            }
+            next[y * width + z] = m;
+        }
+    }
+    next[size] = 0;
+
+    /* Work through the planes from the end of the x axis to its start. */
+    for (x = (int16_t) (*gp)->xsize - 1; x >= 0; x--)
+    {
+        /* Set the padding of the current plane. */
+        for (z = 0; z <= (int16_t) (*gp)->zsize; z++)
+        {
+            cur[(*gp)->ysize * width + z] = ypad;
+        }
+        for (y = 0; y < (int16_t) (*gp)->ysize; y++)
+        {
+            cur[y * width + (*gp)->zsize] = zpad;
+        }
+        cur[size - 1] = ypad < zpad ? ypad : zpad;
+        cur[size] = 0;
+
+        /* Find the least clearance of the four neighbours each cell has in
+         * the next plane. Every cell is worked out the same way, so this
+         * loop is vectorised by the compiler. */
+        for (i = 0; i < size - width; i++)
+        {
+            m = next[i] < next[i + 1] ? next[i] : next[i + 1];
+            m = next[i + width] < m ? next[i + width] : m;
+            m = next[i + width + 1] < m ? next[i + width + 1] : m;
+            low[i] = m;
+        }
+
+        /* Work through the rows of the plane from the end of the y axis. */
+        for (y = (int16_t) (*gp)->ysize - 1; y >= 0; y--)
+        {
+            /* Add the two neighbours each cell has in the next row, which
+             * is also vectorised. */
+            row = (size_t) y * width;
+            for (i = row; i < row + width - 1; i++)
+            {
+                m = cur[i + width] < cur[i + width + 1] 
+                  ? cur[i + width] : cur[i + width + 1];
+                low[i] = m < low[i] ? m : low[i];
+            }
+
+            /* Work along the row from the end of the z axis, adding the
+             * last neighbour, the next cell in the row. */
+            for (z = (int16_t) (*gp)->zsize - 1; z >= 0; z--)
+            {
+                i = row + (size_t) z;
+                id = graph_get_cell_id(*gp, (uint8_t) x, (uint8_t) y, 
+                                       (uint8_t) z);
+                if (node_get_type((*gp)->cells[id]) == PASSABLE)
+                {
+                    m = cur[i + 1] < low[i] ? cur[i + 1] : low[i];
+                    cur[i] = m < UINT8_MAX ? m + 1 : UINT8_MAX;
+                }
+                else
+                {
+                    cur[i] = 0;
+                }
+                (*gp)->clearance[id] = cur[i];
+            }
+        }
+
+        /* The current plane is the next plane of the one before it. */
+        tmp = next;
+        next = cur;
+        cur = tmp;
+    }
+
+    /* De-allocate memory from the planes. */
+    free(next);
+    free(cur);
+    free(low);
+}
+
+/**
+ * This function brings the clearance of the cells up to date after the type
+ * of the cell with the id provided to it has changed. Only cells at lower
+ * coordinates can change, so it works outwards from the cell a layer at a
+ * time and stops at the first layer that didn't change.
+ */
+void graph_update_clearance(graph* gp, uint32_t id)
+{
+    uint8_t cx, cy, cz;     /* The changed cell's coordinates. */
+    int16_t x;              /* The current x coordinate. */
+    int16_t y;              /* The current y coordinate. */
+    int16_t z;              /* The current z coordinate. */
+    int16_t d;              /* The distance of the current layer. */
+    uint32_t cell;          /* The id of the current cell. */
+    uint8_t c;              /* The current cell's new clearance. */
+    bool changed;           /* Whether the current layer changed. */
+
+    /* Get the coordinates of the changed cell. */
+    graph_get_cell_coords(*gp, id, &cx, &cy, &cz);
+
+    /* Work through the layers of cells at each distance from the cell. A
+     * cell's clearance only depends on cells at the same or higher
+     * coordinates, so each layer is worked out from the highest coordinates
+     * to the lowest, and once a layer is unchanged the ones beyond it are
+     * too. */
+    changed = true;
+    for (d = 0; changed; d++)
+    {
+        changed = false;
+        for (x = cx; x >= 0 && x >= cx - d; x--)
+        {
+            for (y = cy; y >= 0 && y >= cy - d; y--)
+            {
+                for (z = cz; z >= 0 && z >= cz - d; z--)
+                {
+                    /* Skip the cells that aren't in this layer. */
+                    if (cx - x != d && cy - y != d && cz - z != d)
+                    {
+                        continue;
+                    }
+
+                    /* Work out the cell's clearance again. */
+                    cell = graph_get_cell_id(*gp, (uint8_t) x, (uint8_t) y,
+                                             (uint8_t) z);
+                    c = graph_cell_clearance(*gp, x, y, z);
+                    if (c != (*gp)->clearance[cell])
+                    {
+                        (*gp)->clearance[cell] = c;
+                        changed = true;
+                    }
+                }
             }
         }
     }
 }
 
+/**
+ * This function returns what the clearance of the cell at the coordinates
+ * provided to it should be, from the clearance of its neighbours at higher
+ * coordinates.
+ */
+uint8_t graph_cell_clearance(graph g, int16_t x, int16_t y, int16_t z)
+{
+    uint8_t m;      /* The least clearance of the cell's neighbours. */
+    uint8_t off;    /* The offsets of the current neighbour, a bit each. */
+    int16_t nx;     /* The neighbour's x coordinate. */
+    int16_t ny;     /* The neighbour's y coordinate. */
+    int16_t nz;     /* The neighbour's z coordinate. */
+    uint32_t id;    /* The neighbour's id. */
+
+    /* An obstacle has no clearance. */
+    id = graph_get_cell_id(g, (uint8_t) x, (uint8_t) y, (uint8_t) z);
+    if (node_get_type(g->cells[id]) != PASSABLE)
+    {
+        return 0;
+    }
+
+    /* Find the least clearance of the seven neighbours that are one cell
+     * further along one or more of the axes. */
+    m = UINT8_MAX;
+    for (off = 1; off < 8; off++)
+    {
+        nx = x + (off & 1);
+        ny = y + ((off >> 1) & 1);
+        nz = z + ((off >> 2) & 1);
+
+        /* Skip the neighbours along axes that are only one cell long. */
+        if ((nx != x && g->xsize == 1) || (ny != y && g->ysize == 1)
+            || (nz != z && g->zsize == 1))
+        {
+            continue;
+        }
+
+        /* The cells past the end of an axis are obstacles. */
+        if (!graph_valid_coord(g, nx, ny, nz))
+        {
+            return 1;
+        }
+        id = graph_get_cell_id(g, (uint8_t) nx, (uint8_t) ny, (uint8_t) nz);
+        if (g->clearance[id] < m)
+        {
+            m = g->clearance[id];
+        }
+    }
+    return m < UINT8_MAX ? m + 1 : UINT8_MAX;
+}
+
 /**
  * This function prints information about the graph.
  */
@@ -467,7 +1746,7 @@ void graph_print(graph g)
             {
                 // Print the current node.
                 printf("\t\t\t");
-                node_print(g->nodes[x][y][z]);
+                node_print(g->cells[graph_get_cell_id(g, x, y, z)]);
                 if (z < zsize - 1)
                 {
                     printf(",");
@@ -24,12 +24,37 @@
 #include "array.h"
 #include "node.h"
 
+/**
+ * This is the id that stands for no cell at all, e.g. the cell a path's
+ * first cell came from.
+ */
+#define GRAPH_NO_CELL UINT32_MAX
+
+/**
+ * This is the number of directions a cell can have a neighbour in on a grid:
+ * every combination of -1, 0 and 1 on each axis except staying put.
+ */
+#define GRAPH_NUM_DIRECTIONS 26
+
+/**
+ * This is the number of terrain classes a cell can have.
+ */
+#define GRAPH_NUM_TERRAINS 16
+
 /**
  * These are the identities of ways a graph-node will be considered the
  * neighbour of another graph-node.
  */
 enum graph_style { MANHATTAN, DIAGONAL };
 
+/**
+ * These are the identities of the orders a graph's cells can be stored in.
+ * LINEAR stores them x axis first, then y, then z, so only neighbours on the
+ * z axis are next to each other in memory. MORTON interleaves the bits of the
+ * coordinates (Z-order), so cells that are close to each other on any axis
+ * are also close to each other in memory.
+ */
+enum graph_layout { LINEAR, MORTON };
 
 /**
  * This is the data-structure of the graph type.
@@ -42,6 +67,14 @@ typedef struct graph_data* graph;
 void graph_init(graph* gp, uint8_t x_size, uint8_t y_size, 
                            uint8_t z_size, enum graph_style gstyle);
 
+/**
+ * This function initialises the graph provided to it, storing its cells in
+ * the order given by the layout also provided to the function.
+ */
+void graph_init_layout(graph* gp, uint8_t x_size, uint8_t y_size, 
+                       uint8_t z_size, enum graph_style gstyle, 
+                       enum graph_layout layout);
+
 /**
  * This function destroys the graph provided to it.
  */
@@ -58,6 +91,195 @@ node* graph_get_node(graph g, uint8_t x, uint8_t y, uint8_t z);
  */
 enum graph_style graph_get_style(graph g);
 
+/**
+ * This function returns the order the cells of the graph provided to it are
+ * stored in.
+ */
+enum graph_layout graph_get_layout(graph g);
+
+/**
+ * This function returns the number of cell ids of the graph provided to it.
+ * With a MORTON layout some ids are padding and don't belong to a cell.
+ */
+uint32_t graph_get_cell_count(graph g);
+
+/**
+ * This function returns the id of the cell in the graph provided to it
+ * located at the coordinates also provided to the function. The coordinates
+ * must be within the bounds of the graph.
+ */
+uint32_t graph_get_cell_id(graph g, uint8_t x, uint8_t y, uint8_t z);
+
+/**
+ * This function gets the coordinates of the cell with the id provided to it
+ * in the graph also provided to the function.
+ */
+void graph_get_cell_coords(graph g, uint32_t id, 
+                           uint8_t* xp, uint8_t* yp, uint8_t* zp);
+
+/**
+ * This function gets the x and y coordinates of the cell with the id
+ * provided to it in a graph with only one layer on its z axis, without
+ * working out the z coordinate.
+ */
+void graph_get_cell_coords_2d(graph g, uint32_t id, uint8_t* xp, uint8_t* yp);
+
+/**
+ * This function returns true if the id provided to it belongs to a cell of
+ * the graph also provided to the function.
+ */
+bool graph_cell_exists(graph g, uint32_t id);
+
+/**
+ * This function returns the id of the cell that the node provided to it is
+ * at in the graph also provided to the function.
+ */
+uint32_t graph_get_node_id(graph g, node* np);
+
+/**
+ * This function returns the node at the cell with the id provided to it in
+ * the graph also provided to the function.
+ */
+node* graph_get_cell_node(graph g, uint32_t id);
+
+/**
+ * This function brings the graph's index of edges up to date with any edges
+ * that have been added or removed since it was last built. Searches that use
+ * cell ids call it before they start.
+ *
+ * The index is kept as well as the nodes' own arrays of neighbours and
+ * edges, not in place of them, so it adds to the graph's memory rather than
+ * saving any. On a 128x128x16 graph the nodes take about 790 bytes a cell.
+ * The index of edges leaving and entering each cell adds about 66 bytes a
+ * cell with MANHATTAN moves (254 with DIAGONAL ones). The passability mask,
+ * clearance and terrain class add 6 more.
+ */
+void graph_update_index(graph* gp);
+
+/**
+ * This function returns the number of edges in the index of the graph
+ * provided to it.
+ */
+uint32_t graph_get_edge_count(graph g);
+
+/**
+ * This function returns the id of the first edge leaving the cell with the
+ * id provided to it. The edges leaving the cell run up to, but not
+ * including, the first edge of the next cell id.
+ */
+uint32_t graph_get_first_edge(graph g, uint32_t id);
+
+/**
+ * This function returns the id of the cell that the edge with the id
+ * provided to it leads to.
+ */
+uint32_t graph_get_edge_to(graph g, uint32_t e);
+
+/**
+ * This function returns the cost of moving along the edge with the id
+ * provided to it. A cost of 0 means the move isn't possible.
+ */
+uint8_t graph_get_edge_w(graph g, uint32_t e);
+
+/**
+ * This function returns the id of the first edge leading into the cell with
+ * the id provided to it. The edges leading into the cell run up to, but not
+ * including, the first edge leading into the next cell id.
+ */
+uint32_t graph_get_first_in_edge(graph g, uint32_t id);
+
+/**
+ * This function returns the id of the cell that the edge leading in with the
+ * id provided to it leaves.
+ */
+uint32_t graph_get_in_edge_from(graph g, uint32_t e);
+
+/**
+ * This function returns the cost of moving along the edge leading in with
+ * the id provided to it. A cost of 0 means the move isn't possible.
+ */
+uint8_t graph_get_in_edge_w(graph g, uint32_t e);
+
+/**
+ * This function returns true if every edge of the graph provided to it is a
+ * move to a neighbouring cell on the grid with a cost of 0 or 1, as they are
+ * when the graph is initialised. The passability masks then describe all of
+ * the graph's edges.
+ */
+bool graph_is_unit_grid(graph g);
+
+/**
+ * This function returns the passability mask of the cell with the id
+ * provided to it. Bit d of the mask is set if the cell has an edge with a
+ * non-zero cost to its neighbour in direction d.
+ */
+uint32_t graph_get_pass_mask(graph g, uint32_t id);
+
+/**
+ * This function returns the clearance of the cell with the id provided to
+ * it: how many cells wide the largest cube of passable cells with the cell
+ * at its lowest corner is. It's 0 for an obstacle. Along an axis that's only
+ * one cell long the cube is flat, so on a flat graph it's a square. An agent
+ * that fills a cube of cells can stand with its lowest corner on any cell
+ * whose clearance is at least its size. The clearance is worked out when
+ * the graph is initialised and kept up to date by graph_set_cell_type().
+ */
+uint8_t graph_get_clearance(graph g, uint32_t id);
+
+/**
+ * This function returns the id of the neighbour in the direction provided to
+ * it of the cell with the id also provided to the function. The neighbour
+ * must be within the bounds of the graph.
+ */
+uint32_t graph_get_neighbour_id(graph g, uint32_t id, uint8_t dir);
+
+/**
+ * This function gets the coordinate offsets of the direction provided to
+ * it. Directions are numbered in the order of their x, then y, then z
+ * offsets, each going from -1 to 1.
+ */
+void graph_get_dir_offset(uint8_t dir, int8_t* xp, int8_t* yp, int8_t* zp);
+
+/**
+ * This function changes the node-type of the cell with the id provided to
+ * it. Moving into the cell then costs 1 if it's PASSABLE and isn't possible
+ * if it's IMPASSABLE. The graph's index of edges, the passability masks
+ * of the cell's neighbours and the clearance of the cells are updated to
+ * match.
+ */
+void graph_set_cell_type(graph* gp, uint32_t id, enum node_type type);
+
+/**
+ * This function returns the number of changes to the graph provided to it
+ * that may have made moving between some of its cells cheaper: cells made
+ * PASSABLE by graph_set_cell_type(), edges added and terrain classes set.
+ * Searches that keep what they've learned about the graph from one search
+ * to the next can check it to know when what they learned may no longer
+ * hold. Changes that only make moves dearer don't count.
+ */
+uint32_t graph_get_num_decreases(graph g);
+
+/**
+ * This function sets the terrain class of the cell with the id provided to
+ * it, which must be less than GRAPH_NUM_TERRAINS. The graph's own costs
+ * don't change, only the costs movement profiles give moves into the cell.
+ */
+void graph_set_cell_terrain(graph* gp, uint32_t id, uint8_t terrain);
+
+/**
+ * This function returns the terrain class of the cell with the id provided
+ * to it. Every cell's terrain class is 0 when the graph is initialised.
+ */
+uint8_t graph_get_cell_terrain(graph g, uint32_t id);
+
+/**
+ * This function asks the processor to start loading what a search reads to
+ * expand the cell with the id provided to it, so it's in the cache by the
+ * time the cell is expanded: the cell's passability mask on a unit grid,
+ * or otherwise its entry in the edge index.
+ */
+void graph_prefetch_cell(graph g, uint32_t id);
+
 /**
  * This function returns the size of the x axis of the graph provided it.
  */
@@ -90,6 +312,18 @@ void graph_add_edge(node* fromp, node* top, uint8_t weight);
  */
 void graph_remove_edge(node* fromp, node* top);
 
+/**
+ * This function does the same as graph_add_edge() for the cells with the ids
+ * provided to it.
+ */
+void graph_add_edge_id(graph* gp, uint32_t from, uint32_t to, uint8_t weight);
+
+/**
+ * This function does the same as graph_remove_edge() for the cells with the
+ * ids provided to it.
+ */
+void graph_remove_edge_id(graph* gp, uint32_t from, uint32_t to);
+
 /**
  * This function resets the graph to its original state.
  */
@@ -0,0 +1,265 @@
+/**
+ * hash_map.c
+ *
+ * This file contains the internal data-structure and function definitions
+ * for the hash_map type.
+ *
+ * The table's size is a power of two and a key's first slot is picked by
+ * multiplying it by a large odd number and keeping the top bits. Keys that
+ * collide go in the next free slot along. Each slot has the number of the
+ * clearing it was filled after, so clearing the map only has to count up,
+ * and every slot with an older number is free.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#include "hash_map.h"
+
+/**
+ * This is the number keys are multiplied by to spread them over the table.
+ */
+#define HASH_MAP_MULTIPLIER 0x9E3779B97F4A7C15ULL
+
+/**
+ * This is the internal data-structure of the hash_map type.
+ */
+struct hash_map_data {
+    uint64_t* keys;         /* The key in each slot. */
+    uint32_t* values;       /* The value in each slot. */
+    uint32_t* stamps;       /* The clearing each slot was filled after. */
+    uint32_t stamp;         /* The number of the current clearing. */
+    uint32_t capacity;      /* The number of slots, a power of two. */
+    uint8_t shift;          /* The bits to drop to pick a first slot. */
+    uint32_t size;          /* The number of keys in the map. */
+};
+
+/**
+ * This function returns the slot the key provided to it is in, or the free
+ * slot it would go in.
+ */
+uint32_t hash_map_find(hash_map h, uint64_t key);
+
+/**
+ * This function doubles the number of slots of the hash_map provided to it.
+ */
+void hash_map_grow(hash_map* hp);
+
+/**
+ * This function initialises the hash_map provided to it with room for at
+ * least the number of keys also provided before it has to grow.
+ */
+void hash_map_init(hash_map* hp, uint32_t capacity)
+{
+    uint32_t slots;     /* The number of slots. */
+    uint8_t shift;      /* The bits to drop to pick a first slot. */
+
+    /* Keep the table at most half full. */
+    slots = 16;
+    shift = 60;
+    while (slots < capacity * 2)
+    {
+        slots *= 2;
+        shift--;
+    }
+
+    /* Allocate memory to the map. No slot is filled yet. */
+    *hp = (hash_map) malloc(sizeof(struct hash_map_data));
+    (*hp)->keys = (uint64_t*) malloc(sizeof(uint64_t) * slots);
+    (*hp)->values = (uint32_t*) malloc(sizeof(uint32_t) * slots);
+    (*hp)->stamps = (uint32_t*) calloc(slots, sizeof(uint32_t));
+    (*hp)->stamp = 1;
+    (*hp)->capacity = slots;
+    (*hp)->shift = shift;
+    (*hp)->size = 0;
+}
+
+/**
+ * This function destroys the hash_map provided to it.
+ */
+void hash_map_free(hash_map* hp)
+{
+    /* De-allocate memory from the map's slots. */
+    free((*hp)->keys);
+    free((*hp)->values);
+    free((*hp)->stamps);
+
+    /* De-allocate memory from the map. */
+    free(*hp);
+}
+
+/**
+ * This function returns the value of the key provided to it in the
+ * hash_map also provided, or HASH_MAP_ABSENT if it isn't in the map.
+ */
+uint32_t hash_map_get(hash_map h, uint64_t key)
+{
+    uint32_t slot;  /* The slot the key would be in. */
+
+    slot = hash_map_find(h, key);
+    return h->stamps[slot] == h->stamp ? h->values[slot] : HASH_MAP_ABSENT;
+}
+
+/**
+ * This function sets the value of the key provided to it in the hash_map
+ * also provided, adding the key if it isn't in the map.
+ */
+void hash_map_put(hash_map* hp, uint64_t key, uint32_t value)
+{
+    uint32_t slot;  /* The slot the key goes in. */
+
+    /* Change the value if the key is already in the map. */
+    slot = hash_map_find(*hp, key);
+    if ((*hp)->stamps[slot] == (*hp)->stamp)
+    {
+        (*hp)->values[slot] = value;
+        return;
+    }
+
+    /* Make more room first if the map would be more than half full. */
+    if (((*hp)->size + 1) * 2 > (*hp)->capacity)
+    {
+        hash_map_grow(hp);
+        slot = hash_map_find(*hp, key);
+    }
+
+    /* Fill the slot. */
+    (*hp)->keys[slot] = key;
+    (*hp)->values[slot] = value;
+    (*hp)->stamps[slot] = (*hp)->stamp;
+    (*hp)->size++;
+}
+
+/**
+ * This function removes the key provided to it from the hash_map also
+ * provided, if it's in the map.
+ */
+void hash_map_remove(hash_map* hp, uint64_t key)
+{
+    uint32_t mask;      /* The bits of a slot number. */
+    uint32_t hole;      /* The slot being emptied. */
+    uint32_t slot;      /* The current slot after it. */
+    uint32_t home;      /* The first slot of the current slot's key. */
+
+    /* Nothing needs doing if the key isn't in the map. */
+    hole = hash_map_find(*hp, key);
+    if ((*hp)->stamps[hole] != (*hp)->stamp)
+    {
+        return;
+    }
+    (*hp)->size--;
+
+    /* Move back any key further along that would no longer be found past
+     * the hole, until a free slot turns up. */
+    mask = (*hp)->capacity - 1;
+    slot = hole;
+    while (true)
+    {
+        slot = (slot + 1) & mask;
+        if ((*hp)->stamps[slot] != (*hp)->stamp)
+        {
+            break;
+        }
+        home = (uint32_t) (((*hp)->keys[slot] * HASH_MAP_MULTIPLIER)
+                           >> (*hp)->shift);
+        if (((slot - home) & mask) < ((slot - hole) & mask))
+        {
+            continue;
+        }
+        (*hp)->keys[hole] = (*hp)->keys[slot];
+        (*hp)->values[hole] = (*hp)->values[slot];
+        hole = slot;
+    }
+
+    /* Free the last slot moved from. */
+    (*hp)->stamps[hole] = 0;
+}
+
+/**
+ * This function returns the number of keys in the hash_map provided to it.
+ */
+uint32_t hash_map_size(hash_map h)
+{
+    return h->size;
+}
+
+/**
+ * This function removes every key from the hash_map provided to it.
+ */
+void hash_map_clear(hash_map* hp)
+{
+    /* Count the clearing up. If the number wraps around, the old numbers
+     * have to be cleared so they can't be mistaken for new ones. */
+    (*hp)->stamp++;
+    if ((*hp)->stamp == 0)
+    {
+        memset((*hp)->stamps, 0, sizeof(uint32_t) * (*hp)->capacity);
+        (*hp)->stamp = 1;
+    }
+    (*hp)->size = 0;
+}
+
+/**
+ * This function returns the slot the key provided to it is in, or the free
+ * slot it would go in.
+ */
+uint32_t hash_map_find(hash_map h, uint64_t key)
+{
+    uint32_t slot;  /* The current slot. */
+
+    /* Look along from the key's first slot until the key or a free slot
+     * turns up. The table is never full, so one always does. */
+    slot = (uint32_t) ((key * HASH_MAP_MULTIPLIER) >> h->shift);
+    while (h->stamps[slot] == h->stamp && h->keys[slot] != key)
+    {
+        slot = (slot + 1) & (h->capacity - 1);
+    }
+    return slot;
+}
+
+/**
+ * This function doubles the number of slots of the hash_map provided to it.
+ */
+void hash_map_grow(hash_map* hp)
+{
+    uint64_t* keys;     /* The old keys. */
+    uint32_t* values;   /* The old values. */
+    uint32_t* stamps;   /* The old stamps. */
+    uint32_t capacity;  /* The old number of slots. */
+    uint32_t stamp;     /* The old number of the current clearing. */
+    uint32_t slot;      /* The current slot. */
+    uint32_t i;         /* The current old slot. */
+
+    /* Keep the old slots while the new ones are filled. */
+    keys = (*hp)->keys;
+    values = (*hp)->values;
+    stamps = (*hp)->stamps;
+    capacity = (*hp)->capacity;
+    stamp = (*hp)->stamp;
+
+    /* Allocate twice as many slots. */
+    (*hp)->capacity = capacity * 2;
+    (*hp)->shift--;
+    (*hp)->keys = (uint64_t*) malloc(sizeof(uint64_t) * (*hp)->capacity);
+    (*hp)->values = (uint32_t*) malloc(sizeof(uint32_t) * (*hp)->capacity);
+    (*hp)->stamps = (uint32_t*) calloc((*hp)->capacity, sizeof(uint32_t));
+    (*hp)->stamp = 1;
+
+    /* Put the keys in their new slots. */
+    for (i = 0; i < capacity; i++)
+    {
+        if (stamps[i] == stamp)
+        {
+            slot = hash_map_find(*hp, keys[i]);
+            (*hp)->keys[slot] = keys[i];
+            (*hp)->values[slot] = values[i];
+            (*hp)->stamps[slot] = 1;
+        }
+    }
+
+    /* De-allocate memory from the old slots. */
+    free(keys);
+    free(values);
+    free(stamps);
+}
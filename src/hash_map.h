@@ -0,0 +1,75 @@
+/**
+ * hash_map.h
+ *
+ * This file contains the data-structure and function prototype declarations
+ * for the hash_map type.
+ *
+ * The hash_map type maps 64-bit keys to 32-bit values, for when only a few
+ * of a very large number of keys are used, such as pairs of a cell id and a
+ * timestep. It's an open-addressing table that doubles in size when it gets
+ * half full, and it can be cleared without touching every entry.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#ifndef HASH_MAP_H
+#define HASH_MAP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * This is the value returned for a key that isn't in the map.
+ */
+#define HASH_MAP_ABSENT UINT32_MAX
+
+/**
+ * The data-structure of the hash_map type.
+ */
+typedef struct hash_map_data* hash_map;
+
+/**
+ * This function initialises the hash_map provided to it with room for at
+ * least the number of keys also provided before it has to grow.
+ */
+void hash_map_init(hash_map* hp, uint32_t capacity);
+
+/**
+ * This function destroys the hash_map provided to it.
+ */
+void hash_map_free(hash_map* hp);
+
+/**
+ * This function returns the value of the key provided to it in the
+ * hash_map also provided, or HASH_MAP_ABSENT if it isn't in the map.
+ */
+uint32_t hash_map_get(hash_map h, uint64_t key);
+
+/**
+ * This function sets the value of the key provided to it in the hash_map
+ * also provided, adding the key if it isn't in the map.
+ */
+void hash_map_put(hash_map* hp, uint64_t key, uint32_t value);
+
+/**
+ * This function removes the key provided to it from the hash_map also
+ * provided, if it's in the map.
+ */
+void hash_map_remove(hash_map* hp, uint64_t key);
+
+/**
+ * This function returns the number of keys in the hash_map provided to it.
+ */
+uint32_t hash_map_size(hash_map h);
+
+/**
+ * This function removes every key from the hash_map provided to it.
+ */
+void hash_map_clear(hash_map* hp);
+
+#endif // HASH_MAP_H
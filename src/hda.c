@@ -0,0 +1,702 @@
+/**
+ * hda.c
+ *
+ * This file contains the internal data-structure and function definitions
+ * for the hda type.
+ *
+ * Each cell id is hashed to a slot: it's multiplied by an odd constant and
+ * its high bits are folded into its low bits, both modulo the smallest
+ * power of two that covers every id. Both steps can be undone, so no two
+ * cells share a slot and a slot gives its cell back. Slot s belongs to
+ * thread s % n and is stored at index s / n of that thread's arrays, so
+ * each thread's arrays only hold its own cells and no two threads write to
+ * the same memory. Ids that are a fixed distance apart, such as the cells
+ * of a row, land on different threads. Each thread has one queue for every
+ * other thread that can send cells to it. A queue is a list of fixed size
+ * chunks with a single writer and a single reader, so sending and receiving
+ * a cell only needs atomic loads and stores.
+ *
+ * Termination is detected with one shared counter, which counts the threads
+ * that are working plus the cells that have been sent but not handled. A
+ * thread that runs out of work takes itself off the counter and a thread
+ * that is sent a cell is put back on before the cell is taken off, so the
+ * counter only reaches 0 when every thread is out of work and every queue
+ * is empty. Nothing can give a thread more work after that.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#include "hda.h"
+
+/**
+ * This is the number of messages in each chunk of a queue.
+ */
+#define HDA_CHUNK_SIZE 1024
+
+/**
+ * This is the odd constant cell ids are multiplied by when they're hashed,
+ * and its inverse modulo 2^32, which undoes the multiplication.
+ */
+#define HDA_HASH_MUL 0x9E3779B1u
+#define HDA_HASH_INV 0x0E8B2F51u
+
+/**
+ * This is a cell sent from one thread to the thread that owns it, with the
+ * cost of the path to it that was found and the cell the path came from.
+ */
+struct hda_msg {
+    uint32_t id;            /* The cell. */
+    uint32_t g;             /* The cost of the path to the cell. */
+    uint32_t came_from;     /* The cell the path came from. */
+};
+
+/**
+ * This is one chunk of the messages of a queue.
+ */
+struct hda_chunk {
+    struct hda_msg msgs[HDA_CHUNK_SIZE];    /* The messages. */
+    uint32_t count;             /* The number of messages written. */
+    struct hda_chunk* next;     /* The chunk written after this one. */
+};
+
+/**
+ * This is a queue of messages from one thread to another. Only the sending
+ * thread touches the tail and only the receiving thread touches the head.
+ */
+struct hda_queue {
+    struct hda_chunk* head;     /* The chunk being read. */
+    uint32_t head_pos;          /* The next message to read in it. */
+    struct hda_chunk* tail;     /* The chunk being written. */
+};
+
+/**
+ * This is the state of one of the threads of a search.
+ */
+struct hda_worker {
+    hda h;                      /* The hda the thread searches for. */
+    uint32_t index;             /* The number of the thread. */
+    id_heap open;               /* The thread's cells still to expand. */
+    uint32_t* g;                /* The cost of the path to each cell. */
+    uint32_t* came_from;        /* The cell each cell's path came from. */
+    uint32_t* visit;            /* The search each cell was last reached by. */
+    struct hda_queue* inbox;    /* The queue from each other thread. */
+    bool busy;                  /* Whether the thread is on the counter. */
+    pthread_t thread;           /* The thread. */
+};
+
+/**
+ * This is the internal data-structure of the hda type.
+ */
+struct hda_data {
+    graph* gp;                  /* The graph to search. */
+    uint8_t num_threads;        /* The number of threads. */
+    uint32_t local_cells;       /* The number of slots each thread owns. */
+    uint32_t hash_mask;         /* The slots cover ids up to this mask. */
+    uint8_t hash_shift;         /* How far the high bits of a slot are
+                                 * folded down. */
+    struct hda_worker* workers; /* The state of each thread. */
+    uint32_t search;            /* The number of the current search. */
+    uint32_t start;             /* The start cell of the current search. */
+    uint32_t end;               /* The end cell of the current search. */
+    uint32_t best;              /* The cost of the cheapest path so far. */
+    int64_t work;               /* The number of threads and messages at work. */
+    bool done;                  /* Whether the search has finished. */
+    uint32_t* path;             /* The path that was found. */
+    uint32_t path_size;         /* The number of cells in the path. */
+};
+
+/**
+ * This function is run by each thread of a search.
+ */
+void* hda_work(void* arg);
+
+/**
+ * This function expands the cell provided to it, which belongs to the
+ * worker also provided to the function.
+ */
+void hda_expand(struct hda_worker* wp, uint32_t current);
+
+/**
+ * This function records the path to the cell provided to it, which belongs
+ * to the worker also provided, if it's cheaper than any path the search has
+ * found to it before.
+ */
+void hda_relax(struct hda_worker* wp, uint32_t id, uint32_t g,
+               uint32_t came_from);
+
+/**
+ * This function sends a cell to the worker that owns it.
+ */
+void hda_send(struct hda_worker* wp, uint32_t id, uint32_t g,
+              uint32_t came_from);
+
+/**
+ * This function handles every message waiting for the worker provided to
+ * it. It returns true if there were any.
+ */
+bool hda_receive(struct hda_worker* wp);
+
+/**
+ * This function initialises the queue provided to it.
+ */
+void hda_queue_init(struct hda_queue* qp);
+
+/**
+ * This function destroys the queue provided to it.
+ */
+void hda_queue_free(struct hda_queue* qp);
+
+/**
+ * This function reconstructs the path that ends at the end cell of the
+ * search.
+ */
+void hda_reconstruct_path(hda* hp);
+
+/**
+ * This function returns the slot of the cell with the id provided to it.
+ * The slot's owner is the slot modulo the number of threads.
+ */
+uint32_t hda_slot(hda h, uint32_t id);
+
+/**
+ * This function returns the id of the cell in the slot provided to it.
+ */
+uint32_t hda_slot_cell(hda h, uint32_t slot);
+
+/**
+ * This function initialises the hda provided to it to search the graph also
+ * provided to the function with the number of threads also provided.
+ */
+void hda_init(hda* hp, graph* gp, uint8_t num_threads)
+{
+    struct hda_worker* wp;  /* The current worker. */
+    uint32_t i;             /* The index of the current worker. */
+    uint32_t j;             /* The index of the current queue. */
+    uint8_t bits;           /* The number of bits of a slot. */
+
+    /* Check there's at least one thread. */
+    if (num_threads == 0)
+    {
+        fprintf(stdout,
+                "\nERROR: In function hda_init(): an hda needs at least one "
+                "thread!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Allocate memory to the hda. */
+    *hp = (hda) malloc(sizeof(struct hda_data));
+
+    /* Initialise the hda's internal properties. */
+    (*hp)->gp = gp;
+    (*hp)->num_threads = num_threads;
+
+    /* Hash the ids modulo the smallest power of two that covers them, so
+     * there are at most twice as many slots as ids. */
+    for (bits = 1; bits < 32 
+                   && (1u << bits) < graph_get_cell_count(*gp); bits++)
+    {
+    }
+    (*hp)->hash_mask = bits < 32 ? (1u << bits) - 1 : UINT32_MAX;
+    (*hp)->hash_shift = (bits + 1) / 2;
+    (*hp)->local_cells = (*hp)->hash_mask / num_threads + 1;
+    (*hp)->search = 0;
+    (*hp)->best = UINT32_MAX;
+    (*hp)->path = (uint32_t*) malloc(
+            sizeof(uint32_t) * graph_get_cell_count(*gp));
+    (*hp)->path_size = 0;
+
+    /* Initialise the state of each thread. */
+    (*hp)->workers = (struct hda_worker*) malloc(
+            sizeof(struct hda_worker) * num_threads);
+    for (i = 0; i < num_threads; i++)
+    {
+        wp = &(*hp)->workers[i];
+        wp->h = *hp;
+        wp->index = i;
+        id_heap_init(&wp->open, (*hp)->local_cells);
+        wp->g = (uint32_t*) malloc(sizeof(uint32_t) * (*hp)->local_cells);
+        wp->came_from = (uint32_t*) malloc(
+                sizeof(uint32_t) * (*hp)->local_cells);
+        wp->visit = (uint32_t*) calloc((*hp)->local_cells, sizeof(uint32_t));
+        wp->inbox = (struct hda_queue*) malloc(
+                sizeof(struct hda_queue) * num_threads);
+        for (j = 0; j < num_threads; j++)
+        {
+            hda_queue_init(&wp->inbox[j]);
+        }
+    }
+}
+
+/**
+ * This function destroys the hda provided to it.
+ */
+void hda_free(hda* hp)
+{
+    struct hda_worker* wp;  /* The current worker. */
+    uint32_t i;             /* The index of the current worker. */
+    uint32_t j;             /* The index of the current queue. */
+
+    /* Destroy the state of each thread. */
+    for (i = 0; i < (*hp)->num_threads; i++)
+    {
+        wp = &(*hp)->workers[i];
+        id_heap_free(&wp->open);
+        free(wp->g);
+        free(wp->came_from);
+        free(wp->visit);
+        for (j = 0; j < (*hp)->num_threads; j++)
+        {
+            hda_queue_free(&wp->inbox[j]);
+        }
+        free(wp->inbox);
+    }
+    free((*hp)->workers);
+    free((*hp)->path);
+
+    /* De-allocate memory from the hda. */
+    free(*hp);
+}
+
+/**
+ * This function searches for the shortest path from the start cell to the
+ * end cell, using all of the hda's threads.
+ */
+void hda_search(hda* hp, uint32_t start, uint32_t end)
+{
+    struct hda_worker* owner;   /* The worker that owns the start cell. */
+    uint32_t i;                 /* The index of the current worker. */
+
+    /* Make sure the graph's index of edges is up to date. */
+    graph_update_index((*hp)->gp);
+
+    /* Start a new search. If the search number wraps around, the old
+     * numbers have to be cleared so they can't be mistaken for new ones. */
+    (*hp)->search++;
+    if ((*hp)->search == 0)
+    {
+        for (i = 0; i < (*hp)->num_threads; i++)
+        {
+            memset((*hp)->workers[i].visit, 0,
+                   sizeof(uint32_t) * (*hp)->local_cells);
+        }
+        (*hp)->search = 1;
+    }
+    (*hp)->start = start;
+    (*hp)->end = end;
+    (*hp)->best = UINT32_MAX;
+    (*hp)->done = false;
+    (*hp)->path_size = 0;
+
+    /* Every thread starts out working. */
+    (*hp)->work = (*hp)->num_threads;
+    for (i = 0; i < (*hp)->num_threads; i++)
+    {
+        (*hp)->workers[i].busy = true;
+        id_heap_clear(&(*hp)->workers[i].open);
+    }
+
+    /* Give the start cell to the thread that owns it. */
+    owner = &(*hp)->workers[hda_slot(*hp, start) % (*hp)->num_threads];
+    hda_relax(owner, start, 0, GRAPH_NO_CELL);
+
+    /* Run the threads and wait for them to finish. */
+    for (i = 1; i < (*hp)->num_threads; i++)
+    {
+        pthread_create(&(*hp)->workers[i].thread, NULL, hda_work,
+                       &(*hp)->workers[i]);
+    }
+    hda_work(&(*hp)->workers[0]);
+    for (i = 1; i < (*hp)->num_threads; i++)
+    {
+        pthread_join((*hp)->workers[i].thread, NULL);
+    }
+
+    /* Reconstruct the path if one was found. */
+    if ((*hp)->best != UINT32_MAX)
+    {
+        hda_reconstruct_path(hp);
+    }
+}
+
+/**
+ * This function returns the ids of the cells that make up the shortest path
+ * found by hda_search(), from the start cell to the end cell.
+ */
+uint32_t* hda_get_path(hda h)
+{
+    return h->path;
+}
+
+/**
+ * This function returns the number of cells in the path found by
+ * hda_search(). It is 0 if no path was found.
+ */
+uint32_t hda_get_path_size(hda h)
+{
+    return h->path_size;
+}
+
+/**
+ * This function returns the cost of the path found by hda_search(), or
+ * UINT32_MAX if no path was found.
+ */
+uint32_t hda_get_cost(hda h)
+{
+    return h->best;
+}
+
+/**
+ * This function returns the number of threads the hda provided to it
+ * searches with.
+ */
+uint8_t hda_get_num_threads(hda h)
+{
+    return h->num_threads;
+}
+
+/**
+ * This function is run by each thread of a search.
+ */
+void* hda_work(void* arg)
+{
+    struct hda_worker* wp;  /* The thread's worker. */
+    hda h;                  /* The hda. */
+    uint32_t current;       /* The cell being expanded. */
+
+    /* Get the thread's worker. */
+    wp = (struct hda_worker*) arg;
+    h = wp->h;
+
+    /* Work until every thread has run out of work. */
+    while (!__atomic_load_n(&h->done, __ATOMIC_ACQUIRE))
+    {
+        /* Handle the cells other threads have sent. */
+        hda_receive(wp);
+
+        /* Cells whose estimated total cost is no less than the cheapest
+         * path so far can't lead to a cheaper one. */
+        if (!id_heap_is_empty(wp->open)
+            && id_heap_get_key(wp->open, id_heap_peek_min(wp->open))
+               >= __atomic_load_n(&h->best, __ATOMIC_RELAXED))
+        {
+            id_heap_clear(&wp->open);
+        }
+
+        /* Expand the thread's most promising cell. The heap holds the
+         * indices of the cells in the thread's arrays. */
+        if (!id_heap_is_empty(wp->open))
+        {
+            current = hda_slot_cell(h, id_heap_pop_min(&wp->open) 
+                                       * h->num_threads + wp->index);
+            hda_expand(wp, current);
+        }
+        else
+        {
+            /* The thread is out of work, so take it off the counter. */
+            if (wp->busy)
+            {
+                wp->busy = false;
+                __atomic_sub_fetch(&h->work, 1, __ATOMIC_ACQ_REL);
+            }
+
+            /* If nothing is at work, the search is finished. */
+            if (__atomic_load_n(&h->work, __ATOMIC_ACQUIRE) == 0)
+            {
+                __atomic_store_n(&h->done, true, __ATOMIC_RELEASE);
+            }
+            else
+            {
+                sched_yield();
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * This function expands the cell provided to it, which belongs to the
+ * worker also provided to the function.
+ */
+void hda_expand(struct hda_worker* wp, uint32_t current)
+{
+    hda h;              /* The hda. */
+    graph g;            /* The graph. */
+    uint32_t current_g; /* The cost of the path to the current cell. */
+    uint32_t next_g;    /* The cost of the path to the neighbour. */
+    uint32_t neighbour; /* The neighbour. */
+    uint32_t slot;      /* The neighbour's slot. */
+    uint32_t e;         /* The edge leading to the neighbour. */
+    uint32_t last;      /* The end of the current cell's edges. */
+    uint8_t w;          /* The cost of moving to the neighbour. */
+
+    /* Get the hda, the graph and the cost of the path to the cell. */
+    h = wp->h;
+    g = *h->gp;
+    current_g = wp->g[hda_slot(h, current) / h->num_threads];
+
+    /* Assess the edges leaving the current cell. */
+    last = graph_get_first_edge(g, current + 1);
+    for (e = graph_get_first_edge(g, current); e < last; e++)
+    {
+        /* Skip moves that aren't possible or can't beat the cheapest path
+         * so far. */
+        w = graph_get_edge_w(g, e);
+        next_g = current_g + w;
+        if (w == 0 || next_g >= __atomic_load_n(&h->best, __ATOMIC_RELAXED))
+        {
+            continue;
+        }
+
+        /* Relax the neighbour here if the thread owns it, otherwise send it
+         * to the thread that does. */
+        neighbour = graph_get_edge_to(g, e);
+        slot = hda_slot(h, neighbour);
+        if (slot % h->num_threads == wp->index)
+        {
+            hda_relax(wp, neighbour, next_g, current);
+        }
+        else
+        {
+            hda_send(wp, neighbour, next_g, current);
+        }
+    }
+}
+
+/**
+ * This function records the path to the cell provided to it, which belongs
+ * to the worker also provided, if it's cheaper than any path the search has
+ * found to it before.
+ */
+void hda_relax(struct hda_worker* wp, uint32_t id, uint32_t g,
+               uint32_t came_from)
+{
+    hda h;              /* The hda. */
+    uint32_t local;     /* The index of the cell in the worker's arrays. */
+    uint32_t f;         /* The estimated total cost of a path through it. */
+    uint32_t best;      /* The cost of the cheapest path so far. */
+
+    /* Check if the path is cheaper than any found before. */
+    h = wp->h;
+    local = hda_slot(h, id) / h->num_threads;
+    if (wp->visit[local] == h->search && g >= wp->g[local])
+    {
+        return;
+    }
+
+    /* Record the cheaper path. */
+    wp->visit[local] = h->search;
+    wp->g[local] = g;
+    wp->came_from[local] = came_from;
+
+    /* A path to the end cell is a new cheapest path. */
+    if (id == h->end)
+    {
+        best = __atomic_load_n(&h->best, __ATOMIC_RELAXED);
+        while (g < best
+               && !__atomic_compare_exchange_n(&h->best, &best, g, true,
+                                               __ATOMIC_ACQ_REL,
+                                               __ATOMIC_RELAXED))
+        {
+        }
+        return;
+    }
+
+    /* Queue the cell if it could lead to a cheaper path. */
+    f = g + astar_estimate(*h->gp, id, h->end);
+    if (f < __atomic_load_n(&h->best, __ATOMIC_RELAXED))
+    {
+        id_heap_push(&wp->open, local, f);
+    }
+}
+
+/**
+ * This function sends a cell to the worker that owns it.
+ */
+void hda_send(struct hda_worker* wp, uint32_t id, uint32_t g,
+              uint32_t came_from)
+{
+    hda h;                      /* The hda. */
+    struct hda_queue* qp;       /* The queue to the owner. */
+    struct hda_chunk* chunk;    /* The chunk being written. */
+    struct hda_chunk* next;     /* A new chunk. */
+    uint32_t count;             /* The number of messages in the chunk. */
+
+    /* Find the queue from this thread to the owner. */
+    h = wp->h;
+    qp = &h->workers[hda_slot(h, id) % h->num_threads].inbox[wp->index];
+
+    /* The message is at work until the owner has handled it. */
+    __atomic_add_fetch(&h->work, 1, __ATOMIC_ACQ_REL);
+
+    /* Start a new chunk if the current one is full. */
+    chunk = qp->tail;
+    count = chunk->count;
+    if (count == HDA_CHUNK_SIZE)
+    {
+        next = (struct hda_chunk*) malloc(sizeof(struct hda_chunk));
+        next->count = 0;
+        next->next = NULL;
+        __atomic_store_n(&chunk->next, next, __ATOMIC_RELEASE);
+        qp->tail = next;
+        chunk = next;
+        count = 0;
+    }
+
+    /* Write the message, then publish it. */
+    chunk->msgs[count].id = id;
+    chunk->msgs[count].g = g;
+    chunk->msgs[count].came_from = came_from;
+    __atomic_store_n(&chunk->count, count + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * This function handles every message waiting for the worker provided to
+ * it. It returns true if there were any.
+ */
+bool hda_receive(struct hda_worker* wp)
+{
+    hda h;                      /* The hda. */
+    struct hda_queue* qp;       /* The current queue. */
+    struct hda_chunk* next;     /* The chunk after the one being read. */
+    struct hda_msg* msg;        /* The current message. */
+    uint32_t count;             /* The number of messages published. */
+    uint32_t handled;           /* The number of messages handled. */
+    uint32_t i;                 /* The index of the current queue. */
+    bool received;              /* Whether any messages were handled. */
+
+    h = wp->h;
+    received = false;
+    for (i = 0; i < h->num_threads; i++)
+    {
+        qp = &wp->inbox[i];
+        for (;;)
+        {
+            /* Read the messages published in the current chunk. */
+            count = __atomic_load_n(&qp->head->count, __ATOMIC_ACQUIRE);
+            if (qp->head_pos < count)
+            {
+                /* A thread that was out of work is put back on the counter
+                 * before the messages are taken off it. */
+                if (!wp->busy)
+                {
+                    wp->busy = true;
+                    __atomic_add_fetch(&h->work, 1, __ATOMIC_ACQ_REL);
+                }
+
+                /* Handle the messages, then take them off the counter. */
+                handled = count - qp->head_pos;
+                for (; qp->head_pos < count; qp->head_pos++)
+                {
+                    msg = &qp->head->msgs[qp->head_pos];
+                    hda_relax(wp, msg->id, msg->g, msg->came_from);
+                }
+                __atomic_sub_fetch(&h->work, handled, __ATOMIC_ACQ_REL);
+                received = true;
+            }
+
+            /* Move on to the next chunk once the current one is finished. */
+            if (qp->head_pos < HDA_CHUNK_SIZE)
+            {
+                break;
+            }
+            next = __atomic_load_n(&qp->head->next, __ATOMIC_ACQUIRE);
+            if (next == NULL)
+            {
+                break;
+            }
+            free(qp->head);
+            qp->head = next;
+            qp->head_pos = 0;
+        }
+    }
+    return received;
+}
+
+/**
+ * This function initialises the queue provided to it.
+ */
+void hda_queue_init(struct hda_queue* qp)
+{
+    qp->head = (struct hda_chunk*) malloc(sizeof(struct hda_chunk));
+    qp->head->count = 0;
+    qp->head->next = NULL;
+    qp->head_pos = 0;
+    qp->tail = qp->head;
+}
+
+/**
+ * This function destroys the queue provided to it.
+ */
+void hda_queue_free(struct hda_queue* qp)
+{
+    struct hda_chunk* next;     /* The chunk after the current one. */
+
+    while (qp->head != NULL)
+    {
+        next = qp->head->next;
+        free(qp->head);
+        qp->head = next;
+    }
+}
+
+/**
+ * This function reconstructs the path that ends at the end cell of the
+ * search.
+ */
+void hda_reconstruct_path(hda* hp)
+{
+    uint32_t current;   /* The current cell on the path. */
+    uint32_t size;      /* The number of cells in the path. */
+    uint32_t i;         /* The index of the current cell. */
+    uint32_t tmp;       /* A cell being swapped. */
+    uint32_t slot;      /* The slot of the current cell. */
+    uint8_t n;          /* The number of threads. */
+
+    /* Follow the path back from the end cell to the start cell. Each cell
+     * is looked up in the arrays of the thread that owns it. */
+    n = (*hp)->num_threads;
+    size = 0;
+    for (current = (*hp)->end; current != GRAPH_NO_CELL;
+         current = (*hp)->workers[slot % n].came_from[slot / n])
+    {
+        (*hp)->path[size] = current;
+        size++;
+        slot = hda_slot(*hp, current);
+    }
+
+    /* Put the path in order from the start cell to the end cell. */
+    for (i = 0; i < size / 2; i++)
+    {
+        tmp = (*hp)->path[i];
+        (*hp)->path[i] = (*hp)->path[size - 1 - i];
+        (*hp)->path[size - 1 - i] = tmp;
+    }
+    (*hp)->path_size = size;
+}
+
+/**
+ * This function returns the slot of the cell with the id provided to it.
+ * The slot's owner is the slot modulo the number of threads.
+ */
+uint32_t hda_slot(hda h, uint32_t id)
+{
+    uint32_t slot;  /* The slot. */
+
+    /* Multiply, then fold the high bits, which the multiplication mixed
+     * all of the id into, down into the low bits that pick the owner. */
+    slot = (id * HDA_HASH_MUL) & h->hash_mask;
+    return slot ^ (slot >> h->hash_shift);
+}
+
+/**
+ * This function returns the id of the cell in the slot provided to it.
+ */
+uint32_t hda_slot_cell(hda h, uint32_t slot)
+{
+    /* The fold moves bits at least half the width of a slot, so doing it
+     * again undoes it. Then undo the multiplication. */
+    slot ^= slot >> h->hash_shift;
+    return (slot * HDA_HASH_INV) & h->hash_mask;
+}
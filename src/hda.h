@@ -0,0 +1,82 @@
+/**
+ * hda.h
+ *
+ * This file contains the data-structure and function prototype declarations
+ * for the hda type.
+ *
+ * The hda type is an implementation of Hash Distributed A* (HDA*). It
+ * spreads a single search over several threads. Every cell belongs to one
+ * thread, picked by hashing the cell's id, and each thread keeps the open
+ * list and the costs of its own cells. When a thread finds a path to a cell
+ * that belongs to another thread, it sends the cell to that thread through a
+ * lock-free queue. The search ends when every thread has run out of cells
+ * that could lead to a cheaper path and no cells are left in the queues,
+ * which proves the path that was found is the shortest one.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#ifndef HDA_H
+#define HDA_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "graph.h"
+#include "id_heap.h"
+#include "astar.h"
+
+/**
+ * The data-structure of the hda type.
+ */
+typedef struct hda_data* hda;
+
+/**
+ * This function initialises the hda provided to it to search the graph also
+ * provided to the function with the number of threads also provided.
+ */
+void hda_init(hda* hp, graph* gp, uint8_t num_threads);
+
+/**
+ * This function destroys the hda provided to it.
+ */
+void hda_free(hda* hp);
+
+/**
+ * This function searches for the shortest path from the start cell to the
+ * end cell, using all of the hda's threads.
+ */
+void hda_search(hda* hp, uint32_t start, uint32_t end);
+
+/**
+ * This function returns the ids of the cells that make up the shortest path
+ * found by hda_search(), from the start cell to the end cell.
+ */
+uint32_t* hda_get_path(hda h);
+
+/**
+ * This function returns the number of cells in the path found by
+ * hda_search(). It is 0 if no path was found.
+ */
+uint32_t hda_get_path_size(hda h);
+
+/**
+ * This function returns the cost of the path found by hda_search(), or
+ * UINT32_MAX if no path was found.
+ */
+uint32_t hda_get_cost(hda h);
+
+/**
+ * This function returns the number of threads the hda provided to it
+ * searches with.
+ */
+uint8_t hda_get_num_threads(hda h);
+
+#endif // HDA_H
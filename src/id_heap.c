@@ -0,0 +1,328 @@
+/**
+ * id_heap.c
+ *
+ * This file contains the internal data-structure and function definitions
+ * for the id_heap type.
+ *
+ * The id_heap type is a minimum heap of 32-bit ids, such as the cell ids of
+ * a graph. Each id in the heap has a key and the id with the lowest key is
+ * at the top of the heap. An id can be in the heap only once; adding it
+ * again changes its key.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#include "id_heap.h"
+
+/**
+ * This is the position of an id that isn't in the heap.
+ */
+#define ID_HEAP_ABSENT UINT32_MAX
+
+/**
+ * This is the internal data-structure of the id_heap type.
+ */
+struct id_heap_data {
+    uint32_t* heap;         /* The ids, in heap order. */
+    uint32_t* positions;    /* The position of each id in the heap. */
+    uint32_t* keys;         /* The key of each id. */
+    uint32_t num_elems;     /* The number of ids stored in the heap. */
+    uint32_t capacity;      /* The number of ids the heap can hold. */
+};
+
+/**
+ * This function initialises the id_heap provided to it. The heap will be
+ * able to hold the ids from 0 up to, but not including, the capacity also
+ * provided to the function.
+ */
+void id_heap_init(id_heap* hp, uint32_t capacity)
+{
+    uint32_t id;    /* The current id. */
+
+    /* Allocate memory to the heap. */
+    *hp = (id_heap) malloc(sizeof(struct id_heap_data));
+
+    /* Allocate memory to the heap's storage. */
+    (*hp)->heap = (uint32_t*) malloc(sizeof(uint32_t) * capacity);
+    (*hp)->positions = (uint32_t*) malloc(sizeof(uint32_t) * capacity);
+    (*hp)->keys = (uint32_t*) malloc(sizeof(uint32_t) * capacity);
+
+    /* No ids are in the heap yet. */
+    for (id = 0; id < capacity; id++)
+    {
+        (*hp)->positions[id] = ID_HEAP_ABSENT;
+    }
+    (*hp)->num_elems = 0;
+    (*hp)->capacity = capacity;
+}
+
+/**
+ * This function destroys the id_heap provided to it.
+ */
+void id_heap_free(id_heap* hp)
+{
+    /* De-allocate memory from the heap's storage. */
+    free((*hp)->heap);
+    free((*hp)->positions);
+    free((*hp)->keys);
+
+    /* De-allocate memory from the heap. */
+    free(*hp);
+}
+
+/**
+ * This function returns true if the id_heap provided to it is not storing
+ * any ids.
+ */
+bool id_heap_is_empty(id_heap h)
+{
+    return h->num_elems == 0;
+}
+
+/**
+ * This function returns the number of ids stored in the id_heap provided to
+ * it.
+ */
+uint32_t id_heap_size(id_heap h)
+{
+    return h->num_elems;
+}
+
+/**
+ * This function returns true if the id provided to it is in the id_heap
+ * also provided to the function.
+ */
+bool id_heap_contains(id_heap h, uint32_t id)
+{
+    return h->positions[id] != ID_HEAP_ABSENT;
+}
+
+/**
+ * This function returns the key of the id provided to it, which must be in
+ * the id_heap also provided to the function.
+ */
+uint32_t id_heap_get_key(id_heap h, uint32_t id)
+{
+    return h->keys[id];
+}
+
+/**
+ * This function returns the id stored at the position provided to it in the
+ * id_heap also provided to the function. Position 0 is the top of the heap
+ * and the children of position i are at positions 2i + 1 and 2i + 2.
+ */
+uint32_t id_heap_get_at(id_heap h, uint32_t position)
+{
+    return h->heap[position];
+}
+
+/**
+ * This function moves the id at the position provided to it up through the
+ * heap until its parent's key is no greater than its own.
+ */
+void id_heap_float_up(id_heap* hp, uint32_t position)
+{
+    uint32_t id;        /* The id being moved. */
+    uint32_t key;       /* The key of the id being moved. */
+    uint32_t parent;    /* The position of the parent. */
+
+    /* Get the id and its key. */
+    id = (*hp)->heap[position];
+    key = (*hp)->keys[id];
+
+    /* Move parents with greater keys down until the id's place is found. */
+    while (position > 0)
+    {
+        parent = (position - 1) / 2;
+        if ((*hp)->keys[(*hp)->heap[parent]] <= key)
+        {
+            break;
+        }
+        (*hp)->heap[position] = (*hp)->heap[parent];
+        (*hp)->positions[(*hp)->heap[position]] = position;
+        position = parent;
+    }
+
+    /* Put the id in its place. */
+    (*hp)->heap[position] = id;
+    (*hp)->positions[id] = position;
+}
+
+/**
+ * This function moves the id at the position provided to it down through the
+ * heap until neither of its children has a smaller key than its own.
+ */
+void id_heap_sink_down(id_heap* hp, uint32_t position)
+{
+    uint32_t id;        /* The id being moved. */
+    uint32_t key;       /* The key of the id being moved. */
+    uint32_t child;     /* The position of the child with the smaller key. */
+
+    /* Get the id and its key. */
+    id = (*hp)->heap[position];
+    key = (*hp)->keys[id];
+
+    /* Move children with smaller keys up until the id's place is found. */
+    for (child = position * 2 + 1;
+         child < (*hp)->num_elems;
+         child = position * 2 + 1)
+    {
+        /* Pick the child with the smaller key. */
+        if (child + 1 < (*hp)->num_elems
+            && (*hp)->keys[(*hp)->heap[child + 1]]
+             < (*hp)->keys[(*hp)->heap[child]])
+        {
+            child++;
+        }
+
+        /* Stop if the child's key isn't smaller than the id's key. */
+        if ((*hp)->keys[(*hp)->heap[child]] >= key)
+        {
+            break;
+        }
+
+        /* Move the child up. */
+        (*hp)->heap[position] = (*hp)->heap[child];
+        (*hp)->positions[(*hp)->heap[position]] = position;
+        position = child;
+    }
+
+    /* Put the id in its place. */
+    (*hp)->heap[position] = id;
+    (*hp)->positions[id] = position;
+}
+
+/**
+ * This function adds the id provided to it to the id_heap with the key also
+ * provided to the function. If the id is already in the heap, its key is
+ * changed instead.
+ */
+void id_heap_push(id_heap* hp, uint32_t id, uint32_t key)
+{
+    uint32_t old_key;   /* The key the id had before. */
+
+    /* Check the id can be stored in the heap. */
+    if (id >= (*hp)->capacity)
+    {
+        fprintf(stdout,
+                "\nERROR: In function id_heap_push(): id %u is beyond the "
+                "heap's capacity of %u!\n", id, (*hp)->capacity);
+        exit(EXIT_FAILURE);
+    }
+
+    /* Check if the id is already in the heap. */
+    if ((*hp)->positions[id] == ID_HEAP_ABSENT)
+    {
+        /* Add the id to the bottom of the heap and move it up. */
+        (*hp)->keys[id] = key;
+        (*hp)->heap[(*hp)->num_elems] = id;
+        (*hp)->positions[id] = (*hp)->num_elems;
+        (*hp)->num_elems++;
+        id_heap_float_up(hp, (*hp)->positions[id]);
+    }
+    else
+    {
+        /* Change the id's key and move it whichever way it needs to go. */
+        old_key = (*hp)->keys[id];
+        (*hp)->keys[id] = key;
+        if (key < old_key)
+        {
+            id_heap_float_up(hp, (*hp)->positions[id]);
+        }
+        else
+        {
+            id_heap_sink_down(hp, (*hp)->positions[id]);
+        }
+    }
+}
+
+/**
+ * This function returns the id with the lowest key without removing it from
+ * the id_heap.
+ */
+uint32_t id_heap_peek_min(id_heap h)
+{
+    /* Check there's an id to return. */
+    if (h->num_elems == 0)
+    {
+        fprintf(stdout,
+                "\nERROR: In function id_heap_peek_min(): heap is empty!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Return the id at the top of the heap. */
+    return h->heap[0];
+}
+
+/**
+ * This function removes the id with the lowest key from the heap and returns
+ * it.
+ */
+uint32_t id_heap_pop_min(id_heap* hp)
+{
+    uint32_t min;   /* The id with the lowest key. */
+
+    /* Get the id at the top of the heap. */
+    min = id_heap_peek_min(*hp);
+
+    /* Take it out of the heap. */
+    id_heap_remove(hp, min);
+
+    /* Return the id with the lowest key. */
+    return min;
+}
+
+/**
+ * This function removes the id provided to it from the id_heap also
+ * provided to the function, if it's in the heap.
+ */
+void id_heap_remove(id_heap* hp, uint32_t id)
+{
+    uint32_t position;  /* The position of the id. */
+    uint32_t last;      /* The id at the bottom of the heap. */
+
+    /* Check the id is in the heap. */
+    position = (*hp)->positions[id];
+    if (position == ID_HEAP_ABSENT)
+    {
+        return;
+    }
+
+    /* Take the id out of the heap. */
+    (*hp)->positions[id] = ID_HEAP_ABSENT;
+    (*hp)->num_elems--;
+
+    /* Fill its place with the id from the bottom of the heap. */
+    if (position < (*hp)->num_elems)
+    {
+        last = (*hp)->heap[(*hp)->num_elems];
+        (*hp)->heap[position] = last;
+        (*hp)->positions[last] = position;
+        if ((*hp)->keys[last] < (*hp)->keys[id])
+        {
+            id_heap_float_up(hp, position);
+        }
+        else
+        {
+            id_heap_sink_down(hp, position);
+        }
+    }
+}
+
+/**
+ * This function removes every id from the id_heap provided to it. It only
+ * touches the ids that were in the heap.
+ */
+void id_heap_clear(id_heap* hp)
+{
+    uint32_t i; /* The position of the current id. */
+
+    /* Forget the position of every id in the heap. */
+    for (i = 0; i < (*hp)->num_elems; i++)
+    {
+        (*hp)->positions[(*hp)->heap[i]] = ID_HEAP_ABSENT;
+    }
+    (*hp)->num_elems = 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * id_heap.h
+ *
+ * This file contains the data-structure and function prototype declarations
+ * for the id_heap type.
+ *
+ * The id_heap type is a minimum heap of 32-bit ids, such as the cell ids of
+ * a graph. Each id in the heap has a key and the id with the lowest key is
+ * at the top of the heap. An id can be in the heap only once; adding it
+ * again changes its key.
+ *
+ * Unlike the min_heap type, the id_heap stores its ids in one block of
+ * memory and knows where each id is, so finding, adding and changing an id
+ * never searches the heap.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#ifndef ID_HEAP_H
+#define ID_HEAP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * The id_heap data structure.
+ */
+typedef struct id_heap_data* id_heap;
+
+/**
+ * This function initialises the id_heap provided to it. The heap will be
+ * able to hold the ids from 0 up to, but not including, the capacity also
+ * provided to the function.
+ */
+void id_heap_init(id_heap* hp, uint32_t capacity);
+
+/**
+ * This function destroys the id_heap provided to it.
+ */
+void id_heap_free(id_heap* hp);
+
+/**
+ * This function returns true if the id_heap provided to it is not storing
+ * any ids.
+ */
+bool id_heap_is_empty(id_heap h);
+
+/**
+ * This function returns the number of ids stored in the id_heap provided to
+ * it.
+ */
+uint32_t id_heap_size(id_heap h);
+
+/**
+ * This function returns true if the id provided to it is in the id_heap
+ * also provided to the function.
+ */
+bool id_heap_contains(id_heap h, uint32_t id);
+
+/**
+ * This function returns the key of the id provided to it, which must be in
+ * the id_heap also provided to the function.
+ */
+uint32_t id_heap_get_key(id_heap h, uint32_t id);
+
+/**
+ * This function returns the id stored at the position provided to it in the
+ * id_heap also provided to the function. Position 0 is the top of the heap
+ * and the children of position i are at positions 2i + 1 and 2i + 2.
+ */
+uint32_t id_heap_get_at(id_heap h, uint32_t position);
+
+/**
+ * This function adds the id provided to it to the id_heap with the key also
+ * provided to the function. If the id is already in the heap, its key is
+ * changed instead.
+ */
+void id_heap_push(id_heap* hp, uint32_t id, uint32_t key);
+
+/**
+ * This function returns the id with the lowest key without removing it from
+ * the id_heap.
+ */
+uint32_t id_heap_peek_min(id_heap h);
+
+/**
+ * This function removes the id with the lowest key from the heap and returns
+ * it.
+ */
+uint32_t id_heap_pop_min(id_heap* hp);
+
+/**
+ * This function removes the id provided to it from the id_heap also
+ * provided to the function, if it's in the heap.
+ */
+void id_heap_remove(id_heap* hp, uint32_t id);
+
+/**
+ * This function removes every id from the id_heap provided to it. It only
+ * touches the ids that were in the heap.
+ */
+void id_heap_clear(id_heap* hp);
+
+#endif // ID_HEAP_H
@@ -0,0 +1,441 @@
+/**
+ * lrta.c
+ *
+ * This file contains the internal data-structure and function definitions
+ * for the lrta type.
+ *
+ * The local search space is searched with the same search numbers astar
+ * uses, so nothing has to be reset between moves, and the learned estimates
+ * carry a stamp of the goal they were learned for, so they can all be
+ * forgotten at once. Each move only touches the cells of its local search
+ * space and the cells around them.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#include "lrta.h"
+
+/**
+ * This is the estimate of a cell the goal can't be reached from.
+ */
+#define LRTA_INFINITY UINT32_MAX
+
+/**
+ * This is the internal data-structure of the lrta type.
+ */
+struct lrta_data {
+    graph* gp;              /* The graph the agent moves on. */
+    uint32_t lookahead;     /* The most cells expanded for each move. */
+    uint32_t cell;          /* The cell the agent is at. */
+    uint32_t goal;          /* The cell the agent is moving to. */
+    uint8_t goal_x;         /* The coordinates of the goal. */
+    uint8_t goal_y;
+    uint8_t goal_z;
+    uint32_t* h;            /* The learned estimate of each cell. */
+    uint32_t* learned;      /* The stamp each cell's estimate was learned
+                             * with. */
+    uint32_t stamp;         /* The stamp of the estimates that hold. */
+    uint32_t decreases;     /* The graph's number of decreases when the
+                             * estimates started being learned. */
+    uint32_t* g;            /* The cost of the path to each cell. */
+    uint32_t* came_from;    /* The cell each cell's path came from. */
+    uint32_t* visit;        /* The search each cell was last reached by. */
+    uint32_t* closed;       /* The search each cell was last expanded by. */
+    uint32_t search;        /* The number of the current search. */
+    id_heap open;           /* The cells waiting to be expanded. */
+    uint32_t* expanded;     /* The cells expanded by the current search. */
+    uint32_t* frontier;     /* The cells left in the open set. */
+};
+
+/**
+ * This function forgets every estimate the lrta provided to it has
+ * learned.
+ */
+void lrta_forget(lrta* lp);
+
+/**
+ * This function starts a new local search, leaving the state of every
+ * previous search behind.
+ */
+void lrta_begin_search(lrta* lp);
+
+/**
+ * This function expands the cell provided to it during the local search.
+ */
+void lrta_expand(lrta* lp, uint32_t current);
+
+/**
+ * This function learns the estimates of the cells expanded by the local
+ * search, the number of which is provided to it, from the estimates of the
+ * cells left in the open set.
+ */
+void lrta_learn(lrta* lp, uint32_t num_expanded);
+
+/**
+ * This function initialises the lrta provided to it for an agent on the
+ * graph also provided, expanding at most the lookahead number of cells, at
+ * least 1, for each move.
+ */
+void lrta_init(lrta* lp, graph* gp, uint32_t lookahead)
+{
+    uint32_t count;     /* The number of cell ids. */
+
+    /* Check the agent can look ahead at all. */
+    if (lookahead == 0)
+    {
+        fprintf(stdout,
+                "\nERROR: In function lrta_init(): The lookahead must be at "
+                "least 1!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Allocate memory to the lrta. */
+    *lp = (lrta) malloc(sizeof(struct lrta_data));
+    count = graph_get_cell_count(*gp);
+
+    /* Initialise the lrta's internal properties. */
+    (*lp)->gp = gp;
+    (*lp)->lookahead = lookahead;
+    (*lp)->cell = GRAPH_NO_CELL;
+    (*lp)->goal = GRAPH_NO_CELL;
+    (*lp)->goal_x = 0;
+    (*lp)->goal_y = 0;
+    (*lp)->goal_z = 0;
+    (*lp)->h = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*lp)->learned = (uint32_t*) calloc(count, sizeof(uint32_t));
+    (*lp)->stamp = 0;
+    (*lp)->decreases = 0;
+    (*lp)->g = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*lp)->came_from = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*lp)->visit = (uint32_t*) calloc(count, sizeof(uint32_t));
+    (*lp)->closed = (uint32_t*) calloc(count, sizeof(uint32_t));
+    (*lp)->search = 0;
+    id_heap_init(&(*lp)->open, count);
+    (*lp)->expanded = (uint32_t*) malloc(sizeof(uint32_t) * lookahead);
+    (*lp)->frontier = (uint32_t*) malloc(sizeof(uint32_t) * count);
+}
+
+/**
+ * This function destroys the lrta provided to it.
+ */
+void lrta_free(lrta* lp)
+{
+    /* Destroy the lrta's internal properties. */
+    free((*lp)->h);
+    free((*lp)->learned);
+    free((*lp)->g);
+    free((*lp)->came_from);
+    free((*lp)->visit);
+    free((*lp)->closed);
+    id_heap_free(&(*lp)->open);
+    free((*lp)->expanded);
+    free((*lp)->frontier);
+
+    /* De-allocate memory from the lrta. */
+    free(*lp);
+}
+
+/**
+ * This function puts the agent of the lrta provided to it at the start cell
+ * and gives it the goal cell to move to. The estimates learned so far are
+ * kept if the goal is the same as before.
+ */
+void lrta_start(lrta* lp, uint32_t start, uint32_t goal)
+{
+    /* Make sure the graph's index of edges is up to date. */
+    graph_update_index((*lp)->gp);
+
+    /* Forget the estimates if they were learned for another goal. */
+    if (goal != (*lp)->goal)
+    {
+        (*lp)->goal = goal;
+        graph_get_cell_coords(*(*lp)->gp, goal, &(*lp)->goal_x,
+                              &(*lp)->goal_y, &(*lp)->goal_z);
+        lrta_forget(lp);
+    }
+
+    /* Put the agent at the start cell. */
+    (*lp)->cell = start;
+}
+
+/**
+ * This function moves the agent of the lrta provided to it one cell towards
+ * its goal and returns the cell it moved to. It returns the agent's cell if
+ * it's already at the goal, and GRAPH_NO_CELL if the goal can't be reached
+ * from there. It expands at most the lookahead number of cells.
+ */
+uint32_t lrta_step(lrta* lp)
+{
+    uint32_t current;       /* The cell being expanded. */
+    uint32_t best;          /* The most promising cell left in the open
+                             * set. */
+    uint32_t next;          /* The cell the agent moves to. */
+    uint32_t num_expanded;  /* The number of cells expanded. */
+
+    /* Check the agent hasn't already arrived. */
+    if ((*lp)->cell == (*lp)->goal)
+    {
+        return (*lp)->cell;
+    }
+
+    /* Make sure the graph's index of edges is up to date, and forget the
+     * estimates if the graph may have become cheaper to move through, as
+     * they might be too high now. */
+    graph_update_index((*lp)->gp);
+    if ((*lp)->decreases != graph_get_num_decreases(*(*lp)->gp))
+    {
+        lrta_forget(lp);
+    }
+
+    /* Search the local search space with A*, until the goal is the most
+     * promising cell in the open set or the lookahead has been expanded. */
+    lrta_begin_search(lp);
+    (*lp)->visit[(*lp)->cell] = (*lp)->search;
+    (*lp)->g[(*lp)->cell] = 0;
+    (*lp)->came_from[(*lp)->cell] = GRAPH_NO_CELL;
+    id_heap_push(&(*lp)->open, (*lp)->cell,
+                 lrta_get_estimate(*lp, (*lp)->cell));
+    num_expanded = 0;
+    while (!id_heap_is_empty((*lp)->open))
+    {
+        current = id_heap_peek_min((*lp)->open);
+        if (current == (*lp)->goal || num_expanded == (*lp)->lookahead)
+        {
+            break;
+        }
+        id_heap_pop_min(&(*lp)->open);
+        (*lp)->closed[current] = (*lp)->search;
+        (*lp)->expanded[num_expanded] = current;
+        num_expanded++;
+        lrta_expand(lp, current);
+    }
+
+    /* Learn the estimates of the cells that were expanded. */
+    best = id_heap_is_empty((*lp)->open)
+         ? GRAPH_NO_CELL : id_heap_peek_min((*lp)->open);
+    if (best == GRAPH_NO_CELL
+        || id_heap_get_key((*lp)->open, best) == LRTA_INFINITY)
+    {
+        best = GRAPH_NO_CELL;
+    }
+    lrta_learn(lp, num_expanded);
+
+    /* Stay put if there's nowhere left that the goal can be reached
+     * from. */
+    if (best == GRAPH_NO_CELL)
+    {
+        return GRAPH_NO_CELL;
+    }
+
+    /* Move one cell along the path to the most promising cell. */
+    next = best;
+    while ((*lp)->came_from[next] != (*lp)->cell)
+    {
+        next = (*lp)->came_from[next];
+    }
+    (*lp)->cell = next;
+    return next;
+}
+
+/**
+ * This function returns the cell the agent of the lrta provided to it is
+ * at.
+ */
+uint32_t lrta_get_cell(lrta l)
+{
+    return l->cell;
+}
+
+/**
+ * This function returns whether the agent of the lrta provided to it has
+ * reached its goal.
+ */
+bool lrta_at_goal(lrta l)
+{
+    return l->cell == l->goal;
+}
+
+/**
+ * This function returns the estimate the lrta provided to it has of the
+ * cost from the cell with the id also provided to its goal, which is
+ * learned if the cell has been in a local search space.
+ */
+uint32_t lrta_get_estimate(lrta l, uint32_t id)
+{
+    uint8_t x, y, z;    /* The cell's coordinates. */
+
+    /* Use the learned estimate if there is one. */
+    if (l->learned[id] == l->stamp)
+    {
+        return l->h[id];
+    }
+
+    /* Otherwise estimate the cost from the coordinates. */
+    graph_get_cell_coords(*l->gp, id, &x, &y, &z);
+    return astar_estimate_coords(graph_get_style(*l->gp), x, y, z,
+                                 l->goal_x, l->goal_y, l->goal_z);
+}
+
+/**
+ * This function returns the most cells the lrta provided to it expands for
+ * each move.
+ */
+uint32_t lrta_get_lookahead(lrta l)
+{
+    return l->lookahead;
+}
+
+/**
+ * This function forgets every estimate the lrta provided to it has
+ * learned.
+ */
+void lrta_forget(lrta* lp)
+{
+    /* Move on to a new stamp. If the stamps have run out, forget every
+     * cell's stamp and start counting again. */
+    (*lp)->stamp++;
+    if ((*lp)->stamp == 0)
+    {
+        memset((*lp)->learned, 0,
+               sizeof(uint32_t) * graph_get_cell_count(*(*lp)->gp));
+        (*lp)->stamp = 1;
+    }
+    (*lp)->decreases = graph_get_num_decreases(*(*lp)->gp);
+}
+
+/**
+ * This function starts a new local search, leaving the state of every
+ * previous search behind.
+ */
+void lrta_begin_search(lrta* lp)
+{
+    /* Move on to the next search number. If the numbers have run out, forget
+     * every cell's search numbers and start counting again. */
+    (*lp)->search++;
+    if ((*lp)->search == 0)
+    {
+        memset((*lp)->visit, 0,
+               sizeof(uint32_t) * graph_get_cell_count(*(*lp)->gp));
+        memset((*lp)->closed, 0,
+               sizeof(uint32_t) * graph_get_cell_count(*(*lp)->gp));
+        (*lp)->search = 1;
+    }
+
+    /* Empty the open set. */
+    id_heap_clear(&(*lp)->open);
+}
+
+/**
+ * This function expands the cell provided to it during the local search.
+ */
+void lrta_expand(lrta* lp, uint32_t current)
+{
+    graph g;            /* The graph. */
+    uint32_t e;         /* The current edge. */
+    uint32_t last;      /* The end of the current cell's edges. */
+    uint32_t neighbour; /* The cell the edge leads to. */
+    uint32_t next_g;    /* The cost of the path to it through the cell. */
+    uint32_t h;         /* The estimate of the neighbour. */
+    uint8_t w;          /* The cost of the edge. */
+
+    /* Assess the edges leaving the current cell. */
+    g = *(*lp)->gp;
+    last = graph_get_first_edge(g, current + 1);
+    for (e = graph_get_first_edge(g, current); e < last; e++)
+    {
+        /* Skip moves that aren't possible and cells already expanded. */
+        w = graph_get_edge_w(g, e);
+        neighbour = graph_get_edge_to(g, e);
+        if (w == 0 || (*lp)->closed[neighbour] == (*lp)->search)
+        {
+            continue;
+        }
+
+        /* Record the path to the neighbour if it's better than any the
+         * search has found before, and queue it by its estimated total
+         * cost, which stays infinite if the goal can't be reached from it. */
+        next_g = (*lp)->g[current] + w;
+        if ((*lp)->visit[neighbour] != (*lp)->search
+            || next_g < (*lp)->g[neighbour])
+        {
+            (*lp)->visit[neighbour] = (*lp)->search;
+            (*lp)->g[neighbour] = next_g;
+            (*lp)->came_from[neighbour] = current;
+            h = lrta_get_estimate(*lp, neighbour);
+            id_heap_push(&(*lp)->open, neighbour,
+                         h == LRTA_INFINITY ? LRTA_INFINITY : next_g + h);
+        }
+    }
+}
+
+/**
+ * This function learns the estimates of the cells expanded by the local
+ * search, the number of which is provided to it, from the estimates of the
+ * cells left in the open set.
+ */
+void lrta_learn(lrta* lp, uint32_t num_expanded)
+{
+    graph g;            /* The graph. */
+    uint32_t num_open;  /* The number of cells left in the open set. */
+    uint32_t current;   /* The cell whose estimate is final. */
+    uint32_t from;      /* A cell with an edge into the current cell. */
+    uint32_t h;         /* The current cell's estimate. */
+    uint32_t e;         /* The current edge into the cell. */
+    uint32_t last;      /* The end of the edges into the cell. */
+    uint32_t i;         /* The index of the current cell. */
+    uint8_t w;          /* The cost of the edge. */
+
+    /* The expanded cells start with no estimate at all. */
+    g = *(*lp)->gp;
+    for (i = 0; i < num_expanded; i++)
+    {
+        (*lp)->h[(*lp)->expanded[i]] = LRTA_INFINITY;
+        (*lp)->learned[(*lp)->expanded[i]] = (*lp)->stamp;
+    }
+
+    /* Queue the cells left in the open set by their estimates instead. */
+    num_open = id_heap_size((*lp)->open);
+    for (i = 0; i < num_open; i++)
+    {
+        (*lp)->frontier[i] = id_heap_get_at((*lp)->open, i);
+    }
+    for (i = 0; i < num_open; i++)
+    {
+        id_heap_push(&(*lp)->open, (*lp)->frontier[i],
+                     lrta_get_estimate(*lp, (*lp)->frontier[i]));
+    }
+
+    /* Search backwards from the open set, giving each expanded cell the
+     * lowest cost of a move to a cell around it plus that cell's estimate,
+     * until every expanded cell's estimate is final. */
+    while (num_expanded > 0 && !id_heap_is_empty((*lp)->open))
+    {
+        current = id_heap_pop_min(&(*lp)->open);
+        if ((*lp)->closed[current] == (*lp)->search)
+        {
+            num_expanded--;
+        }
+        h = lrta_get_estimate(*lp, current);
+        if (h == LRTA_INFINITY)
+        {
+            break;
+        }
+
+        /* Lower the estimates of the expanded cells that can move into the
+         * current cell. */
+        last = graph_get_first_in_edge(g, current + 1);
+        for (e = graph_get_first_in_edge(g, current); e < last; e++)
+        {
+            w = graph_get_in_edge_w(g, e);
+            from = graph_get_in_edge_from(g, e);
+            if (w != 0 && (*lp)->closed[from] == (*lp)->search
+                && (*lp)->h[from] > h + w)
+            {
+                (*lp)->h[from] = h + w;
+                id_heap_push(&(*lp)->open, from, h + w);
+            }
+        }
+    }
+}
@@ -0,0 +1,97 @@
+/**
+ * lrta.h
+ *
+ * This file contains the data-structure and function prototype declarations
+ * for the lrta type.
+ *
+ * The lrta type moves an agent towards its goal a cell at a time with
+ * LSS-LRTA*, a real-time search whose work for each move is capped however
+ * big the graph or long the path is. For each move it runs an A* search
+ * from the agent's cell that expands at most its lookahead of cells, the
+ * local search space. It then learns better estimates of the cost to the
+ * goal for the cells it expanded, from the estimates of the cells around
+ * them, with a Dijkstra search backwards from the edge of the local search
+ * space. Last, it moves the agent one cell along the path to the most
+ * promising cell on that edge.
+ *
+ * The learned estimates are kept from one move to the next, so an agent
+ * that is caught in a dead end raises the estimates there until it walks
+ * out of it, and always reaches a goal it can reach. They are forgotten when
+ * the goal changes or the graph may have become cheaper to move through.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#ifndef LRTA_H
+#define LRTA_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "graph.h"
+#include "id_heap.h"
+#include "astar.h"
+
+/**
+ * The data-structure of the lrta type.
+ */
+typedef struct lrta_data* lrta;
+
+/**
+ * This function initialises the lrta provided to it for an agent on the
+ * graph also provided, expanding at most the lookahead number of cells, at
+ * least 1, for each move.
+ */
+void lrta_init(lrta* lp, graph* gp, uint32_t lookahead);
+
+/**
+ * This function destroys the lrta provided to it.
+ */
+void lrta_free(lrta* lp);
+
+/**
+ * This function puts the agent of the lrta provided to it at the start cell
+ * and gives it the goal cell to move to. The estimates learned so far are
+ * kept if the goal is the same as before.
+ */
+void lrta_start(lrta* lp, uint32_t start, uint32_t goal);
+
+/**
+ * This function moves the agent of the lrta provided to it one cell towards
+ * its goal and returns the cell it moved to. It returns the agent's cell if
+ * it's already at the goal, and GRAPH_NO_CELL if the goal can't be reached
+ * from there. It expands at most the lookahead number of cells.
+ */
+uint32_t lrta_step(lrta* lp);
+
+/**
+ * This function returns the cell the agent of the lrta provided to it is
+ * at.
+ */
+uint32_t lrta_get_cell(lrta l);
+
+/**
+ * This function returns whether the agent of the lrta provided to it has
+ * reached its goal.
+ */
+bool lrta_at_goal(lrta l);
+
+/**
+ * This function returns the estimate the lrta provided to it has of the
+ * cost from the cell with the id also provided to its goal, which is
+ * learned if the cell has been in a local search space.
+ */
+uint32_t lrta_get_estimate(lrta l, uint32_t id);
+
+/**
+ * This function returns the most cells the lrta provided to it expands for
+ * each move.
+ */
+uint32_t lrta_get_lookahead(lrta l);
+
+#endif // LRTA_H
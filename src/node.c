@@ -45,6 +45,12 @@ struct node_data {
 
     /* The type of node this is e.g PASSABLE, IMPASSABLE. */
     enum node_type type;
+
+    /* Whether the memory the node's data is in was allocated by the node. */
+    bool owns_memory;
+
+    /* This is the structure the node belongs to, e.g. its graph. */
+    void* owner;
 };
 
 /**
@@ -52,8 +58,24 @@ struct node_data {
  */
 void node_init(node* np, uint8_t x, uint8_t y, uint8_t z, enum node_type type)
 {
-    /* Allocate memory to the node. */
-    *np = (node) malloc(sizeof(struct node_data));
+    /* Allocate memory to the node and initialise it there. */
+    node_init_in(np, malloc(sizeof(struct node_data)), x, y, z, type);
+
+    /* Record that the node allocated its own memory. */
+    (*np)->owns_memory = true;
+}
+
+/**
+ * This function initialises the node provided to it in the memory that is
+ * also provided to it, rather than allocating memory of its own. This lets a
+ * graph keep all of its nodes in one block of memory. The memory must be at
+ * least node_get_data_size() bytes and is not de-allocated by node_free().
+ */
+void node_init_in(node* np, void* mem, 
+                  uint8_t x, uint8_t y, uint8_t z, enum node_type type)
+{
+    /* Place the node in the memory provided. */
+    *np = (node) mem;
 
     /* Initialise the node's internal data. */
     array_init(&(*np)->neighbours);
@@ -65,6 +87,17 @@ void node_init(node* np, uint8_t x, uint8_t y, uint8_t z, enum node_type type)
     (*np)->f = UINT64_MAX;
     (*np)->g = UINT64_MAX;
     (*np)->type = type;
+    (*np)->owns_memory = false;
+    (*np)->owner = NULL;
+}
+
+/**
+ * This function returns the number of bytes of memory that a node's data
+ * needs.
+ */
+size_t node_get_data_size(void)
+{
+    return sizeof(struct node_data);
 }
 
 /**
@@ -82,8 +115,11 @@ void node_free(node* np)
     }
     array_free(&(*np)->edges);
     
-    /* De-allocate memory from the node. */
-    free(*np);
+    /* De-allocate memory from the node if it allocated it itself. */
+    if ((*np)->owns_memory)
+    {
+        free(*np);
+    }
 }
 
 /**
@@ -217,6 +253,32 @@ enum node_type node_get_type(node n)
     return n->type;
 }
 
+/**
+ * This function sets the node-type of the node provided to it. It doesn't
+ * change the weights of the node's edges.
+ */
+void node_set_type(node* np, enum node_type type)
+{
+    (*np)->type = type;
+}
+
+/**
+ * This function returns the structure that owns the node provided to it, e.g.
+ * the graph it belongs to, or NULL if it has no owner.
+ */
+void* node_get_owner(node n)
+{
+    return n->owner;
+}
+
+/**
+ * This function sets the structure that owns the node provided to it.
+ */
+void node_set_owner(node* np, void* owner)
+{
+    (*np)->owner = owner;
+}
+
 /**
  * This function sets which node on a path created by the astar algorithm
  * preceeds the node provided to this function on that path.
@@ -329,28 +391,28 @@ void node_add_neighbour(node* np, node* neighbourp)
  */
 void node_remove_neighbour(node* np, node* neighbourp)
 {
-    array neighbours;           /* The array of neighbours. */
     node* neighbour;            /* The current neighbour. */
     uint32_t num_neighbours;    /* The number of neighbours in the array. */
     uint32_t i;                 /* The index of the current neighbour. */
-
-    /* Get the array of neighbours. */
-    neighbours = node_get_neighbours(*np);
+    bool found;                 /* Whether the neighbour was found. */
 
     /* Get the number of neighbours in the array. */
-    num_neighbours = array_size(neighbours);
+    num_neighbours = array_size((*np)->neighbours);
 
     /* Search for the correct neighbour in the array. */
-    for (i = 0; i < num_neighbours; i++)
+    found = false;
+    for (i = 0; i < num_neighbours && !found; i++)
     {
         /* Get the current neighbour. */
-        neighbour = array_get_data(neighbours, i);
+        neighbour = array_get_data((*np)->neighbours, i);
         
         /* Check if it's the correct neighbour. */
         if (neighbour == neighbourp)
         {
-            /* The correct neighbour was found so remove it from the array. */
-            array_pop_data(&neighbours, i);
+            /* The correct neighbour was found so remove it from the node's
+             * own array, which may change the array's first element. */
+            array_pop_data(&(*np)->neighbours, i);
+            found = true;
         }
     }
 }
@@ -41,6 +41,21 @@ typedef struct node_data* node;
  */
 void node_init(node* np, uint8_t x, uint8_t y, uint8_t z, enum node_type type);
 
+/**
+ * This function initialises the node provided to it in the memory that is
+ * also provided to it, rather than allocating memory of its own. This lets a
+ * graph keep all of its nodes in one block of memory. The memory must be at
+ * least node_get_data_size() bytes and is not de-allocated by node_free().
+ */
+void node_init_in(node* np, void* mem, 
+                  uint8_t x, uint8_t y, uint8_t z, enum node_type type);
+
+/**
+ * This function returns the number of bytes of memory that a node's data
+ * needs.
+ */
+size_t node_get_data_size(void);
+
 /**
  * This function destroys the node provided to it.
  */
@@ -108,6 +123,23 @@ uint64_t node_get_g(node n);
  */
 enum node_type node_get_type(node n);
 
+/**
+ * This function sets the node-type of the node provided to it. It doesn't
+ * change the weights of the node's edges.
+ */
+void node_set_type(node* np, enum node_type type);
+
+/**
+ * This function returns the structure that owns the node provided to it, e.g.
+ * the graph it belongs to, or NULL if it has no owner.
+ */
+void* node_get_owner(node n);
+
+/**
+ * This function sets the structure that owns the node provided to it.
+ */
+void node_set_owner(node* np, void* owner);
+
 /**
  * This function sets which node on a path created by the astar algorithm
  * preceeds the node provided to this function on that path.
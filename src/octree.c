@@ -0,0 +1,935 @@
+/**
+ * octree.c
+ *
+ * This file contains the internal data-structure and function definitions
+ * for the octree type.
+ *
+ * The nodes of the octree are kept in arrays, with the eight children of a
+ * node next to each other in a block. Child i of a node is on the high side
+ * of its x axis if bit 0 of i is set, of its y axis if bit 1 is set and of
+ * its z axis if bit 2 is set. The blocks of merged nodes are kept in a list
+ * and reused when a node is split. Cells outside the graph's volume, which
+ * the octree's cube can be bigger than, count as impassable.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#include "octree.h"
+
+/**
+ * This is the child of a leaf and the parent of the root.
+ */
+#define OCTREE_NONE UINT32_MAX
+
+/**
+ * These are the states of a node.
+ */
+#define OCTREE_FREE 0       /* A leaf whose cells are all passable. */
+#define OCTREE_BLOCKED 1    /* A leaf whose cells are all impassable. */
+#define OCTREE_MIXED 2      /* A node that's split into eight children. */
+
+/**
+ * This is the internal data-structure of the octree type.
+ */
+struct octree_data {
+    graph* gp;              /* The graph the octree was built from. */
+
+    /* The nodes. Each node is a cube of cells. */
+    uint8_t* x;             /* The lowest x coordinate of each node. */
+    uint8_t* y;             /* The lowest y coordinate of each node. */
+    uint8_t* z;             /* The lowest z coordinate of each node. */
+    uint8_t* level;         /* Each node is 2 to the level cells wide. */
+    uint8_t* state;         /* Whether each node is free, blocked or split. */
+    uint32_t* child;        /* The first of each node's children. */
+    uint32_t* parent;       /* The node each node is a child of. */
+    uint32_t num_nodes;     /* The number of nodes in the arrays. */
+    uint32_t capacity;      /* The number of nodes there's room for. */
+    uint32_t* spare;        /* The first nodes of blocks that can be reused. */
+    uint32_t num_spare;     /* The number of blocks that can be reused. */
+    uint32_t spare_capacity; /* The number of blocks there's room for. */
+
+    /* The state of the search over the free leaves. */
+    id_heap open;           /* The leaves waiting to be expanded, by f. */
+    uint32_t* g;            /* The cost of the path to each leaf. */
+    uint32_t* came_from;    /* The leaf each leaf's path came from. */
+    uint32_t* entry;        /* The cell each leaf's path enters it at. */
+    uint32_t* visit;        /* The search each leaf was last reached by. */
+    uint32_t search;        /* The number of the current search. */
+    uint32_t search_capacity; /* The number of nodes the state fits. */
+    uint32_t end;           /* The end cell of the current search. */
+
+    /* The path that was found. */
+    uint32_t* path;         /* The cells of the path. */
+    uint32_t path_size;     /* The number of cells in the path. */
+    uint32_t* leaves;       /* The leaves of the path. */
+    uint32_t num_leaves;    /* The number of leaves in the path. */
+};
+
+/**
+ * This function fills in the node provided to it, and every node under it,
+ * from the cells of the graph.
+ */
+void octree_build(octree* op, uint32_t n);
+
+/**
+ * This function returns the first node of a block of eight new nodes.
+ */
+uint32_t octree_alloc_block(octree* op);
+
+/**
+ * This function splits the leaf provided to it into eight leaves in the
+ * same state.
+ */
+void octree_split(octree* op, uint32_t n);
+
+/**
+ * This function merges the node provided to it into a leaf if all of its
+ * children are leaves in the same state. It returns whether it did.
+ */
+bool octree_merge(octree* op, uint32_t n);
+
+/**
+ * This function returns the state of the cell at the coordinates provided
+ * to it.
+ */
+uint8_t octree_cell_state(octree o, uint32_t x, uint32_t y, uint32_t z);
+
+/**
+ * This function returns the deepest node containing the coordinates
+ * provided to it that's a leaf or at the level also provided.
+ */
+uint32_t octree_find(octree o, uint32_t x, uint32_t y, uint32_t z,
+                     uint8_t level);
+
+/**
+ * This function assesses the free leaves sharing a face with the leaf
+ * provided to it, on the side of the axis also provided.
+ */
+void octree_expand_face(octree* op, uint32_t current, uint8_t axis,
+                        bool high);
+
+/**
+ * This function assesses the free leaves of the node provided to it that
+ * touch its side of the axis also provided.
+ */
+void octree_expand_node(octree* op, uint32_t current, uint32_t n,
+                        uint8_t axis, bool high);
+
+/**
+ * This function assesses the free leaves that touch the leaf provided to it
+ * only at the edge or the corner in the direction of the offsets also
+ * provided, two or three of which aren't 0.
+ */
+void octree_expand_corner(octree* op, uint32_t current,
+                          int8_t xoff, int8_t yoff, int8_t zoff);
+
+/**
+ * This function assesses the free leaves under the node provided to it that
+ * overlap the box of cells from lo to hi, which touches the current leaf.
+ */
+void octree_expand_box(octree* op, uint32_t current, uint32_t n,
+                       const uint32_t* lo, const uint32_t* hi);
+
+/**
+ * This function records the path to the free leaf provided to it through
+ * the current leaf, if it's better than any path found to it before.
+ */
+void octree_relax(octree* op, uint32_t current, uint32_t n);
+
+/**
+ * This function moves the coordinates provided to it into the node also
+ * provided.
+ */
+void octree_clamp(octree o, uint32_t n, uint8_t* xp, uint8_t* yp,
+                  uint8_t* zp);
+
+/**
+ * This function makes sure the search's state fits every node.
+ */
+void octree_grow_search(octree* op);
+
+/**
+ * This function refines the path of leaves ending at the leaf provided to
+ * it into a path of cells.
+ */
+void octree_reconstruct_path(octree* op, uint32_t current);
+
+/**
+ * This function adds the cells of a straight walk inside one node from the
+ * last cell of the path to the coordinates provided to it to the path.
+ */
+void octree_walk(octree* op, uint8_t tx, uint8_t ty, uint8_t tz);
+
+/**
+ * This function initialises the octree provided to it by building it from
+ * the cells of the graph also provided.
+ */
+void octree_init(octree* op, graph* gp)
+{
+    uint32_t size;  /* The width of the graph's widest axis. */
+    uint8_t level;  /* The level of the root. */
+
+    /* Allocate memory to the octree. */
+    *op = (octree) malloc(sizeof(struct octree_data));
+    (*op)->gp = gp;
+
+    /* Find the smallest cube the graph fits in. */
+    size = graph_get_x_size(*gp);
+    if (graph_get_y_size(*gp) > size)
+    {
+        size = graph_get_y_size(*gp);
+    }
+    if (graph_get_z_size(*gp) > size)
+    {
+        size = graph_get_z_size(*gp);
+    }
+    for (level = 0; (1U << level) < size; level++)
+    {
+    }
+
+    /* Make the root and build the octree under it. */
+    (*op)->capacity = 64;
+    (*op)->x = (uint8_t*) malloc(sizeof(uint8_t) * (*op)->capacity);
+    (*op)->y = (uint8_t*) malloc(sizeof(uint8_t) * (*op)->capacity);
+    (*op)->z = (uint8_t*) malloc(sizeof(uint8_t) * (*op)->capacity);
+    (*op)->level = (uint8_t*) malloc(sizeof(uint8_t) * (*op)->capacity);
+    (*op)->state = (uint8_t*) malloc(sizeof(uint8_t) * (*op)->capacity);
+    (*op)->child = (uint32_t*) malloc(sizeof(uint32_t) * (*op)->capacity);
+    (*op)->parent = (uint32_t*) malloc(sizeof(uint32_t) * (*op)->capacity);
+    (*op)->spare = NULL;
+    (*op)->num_spare = 0;
+    (*op)->spare_capacity = 0;
+    (*op)->x[0] = 0;
+    (*op)->y[0] = 0;
+    (*op)->z[0] = 0;
+    (*op)->level[0] = level;
+    (*op)->child[0] = OCTREE_NONE;
+    (*op)->parent[0] = OCTREE_NONE;
+    (*op)->num_nodes = 1;
+    octree_build(op, 0);
+
+    /* Initialise the state of the search. It grows with the octree. */
+    id_heap_init(&(*op)->open, 1);
+    (*op)->g = NULL;
+    (*op)->came_from = NULL;
+    (*op)->entry = NULL;
+    (*op)->visit = NULL;
+    (*op)->search = 0;
+    (*op)->search_capacity = 0;
+    octree_grow_search(op);
+
+    /* A path can't have more cells or leaves than the graph has cells. */
+    (*op)->path = (uint32_t*) malloc(
+            sizeof(uint32_t) * graph_get_cell_count(*gp));
+    (*op)->path_size = 0;
+    (*op)->leaves = (uint32_t*) malloc(
+            sizeof(uint32_t) * graph_get_cell_count(*gp));
+    (*op)->num_leaves = 0;
+}
+
+/**
+ * This function destroys the octree provided to it.
+ */
+void octree_free(octree* op)
+{
+    /* De-allocate memory from the nodes. */
+    free((*op)->x);
+    free((*op)->y);
+    free((*op)->z);
+    free((*op)->level);
+    free((*op)->state);
+    free((*op)->child);
+    free((*op)->parent);
+    free((*op)->spare);
+
+    /* De-allocate memory from the search. */
+    id_heap_free(&(*op)->open);
+    free((*op)->g);
+    free((*op)->came_from);
+    free((*op)->entry);
+    free((*op)->visit);
+    free((*op)->path);
+    free((*op)->leaves);
+
+    /* De-allocate memory from the octree. */
+    free(*op);
+}
+
+/**
+ * This function brings the octree provided to it up to date with the type
+ * of the cell with the id also provided, after it has been changed.
+ */
+void octree_update(octree* op, uint32_t id)
+{
+    uint8_t x, y, z;    /* The cell's coordinates. */
+    uint8_t state;      /* The cell's new state. */
+    uint32_t n;         /* The current node. */
+
+    /* Find the leaf the cell is in. Nothing changes if it's already in the
+     * cell's state. */
+    graph_get_cell_coords(*(*op)->gp, id, &x, &y, &z);
+    state = octree_cell_state(*op, x, y, z);
+    n = octree_find(*op, x, y, z, 0);
+    if ((*op)->state[n] == state)
+    {
+        return;
+    }
+
+    /* Split the leaf down to the cell and change the cell's leaf. */
+    while ((*op)->level[n] > 0)
+    {
+        octree_split(op, n);
+        n = octree_find(*op, x, y, z, (*op)->level[n] - 1);
+    }
+    (*op)->state[n] = state;
+
+    /* Merge the nodes above it whose children are now all the same. */
+    n = (*op)->parent[n];
+    while (n != OCTREE_NONE && octree_merge(op, n))
+    {
+        n = (*op)->parent[n];
+    }
+}
+
+/**
+ * This function searches for a path from the start cell to the end cell
+ * across the octree's free leaves. There's no path if either cell is
+ * impassable.
+ */
+void octree_search(octree* op, uint32_t start, uint32_t end)
+{
+    uint8_t sx, sy, sz;     /* The start cell's coordinates. */
+    uint8_t ex, ey, ez;     /* The end cell's coordinates. */
+    uint32_t first;         /* The leaf the start cell is in. */
+    uint32_t last;          /* The leaf the end cell is in. */
+    uint32_t current;       /* The leaf being expanded. */
+    uint8_t axis;           /* The axis of the face being expanded. */
+    uint8_t dir;            /* The direction of the edge or corner. */
+    int8_t xoff;            /* The x offset of the direction. */
+    int8_t yoff;            /* The y offset of the direction. */
+    int8_t zoff;            /* The z offset of the direction. */
+
+    /* Start a new search. */
+    octree_grow_search(op);
+    (*op)->search++;
+    if ((*op)->search == 0)
+    {
+        memset((*op)->visit, 0, sizeof(uint32_t) * (*op)->search_capacity);
+        (*op)->search = 1;
+    }
+    id_heap_clear(&(*op)->open);
+    (*op)->path_size = 0;
+    (*op)->num_leaves = 0;
+    (*op)->end = end;
+
+    /* There's no path unless both ends are in free leaves. */
+    graph_get_cell_coords(*(*op)->gp, start, &sx, &sy, &sz);
+    graph_get_cell_coords(*(*op)->gp, end, &ex, &ey, &ez);
+    first = octree_find(*op, sx, sy, sz, 0);
+    last = octree_find(*op, ex, ey, ez, 0);
+    if ((*op)->state[first] != OCTREE_FREE
+        || (*op)->state[last] != OCTREE_FREE)
+    {
+        return;
+    }
+
+    /* Add the start cell's leaf to the priority queue. */
+    (*op)->visit[first] = (*op)->search;
+    (*op)->g[first] = 0;
+    (*op)->came_from[first] = OCTREE_NONE;
+    (*op)->entry[first] = start;
+    id_heap_push(&(*op)->open, first, astar_estimate(*(*op)->gp, start, end));
+
+    /* Expand the most promising leaf until the end cell's leaf comes up. */
+    while (!id_heap_is_empty((*op)->open))
+    {
+        current = id_heap_pop_min(&(*op)->open);
+        if (current == last)
+        {
+            octree_reconstruct_path(op, current);
+            return;
+        }
+
+        /* Assess the leaves on both sides of each axis. */
+        for (axis = 0; axis < 3; axis++)
+        {
+            octree_expand_face(op, current, axis, false);
+            octree_expand_face(op, current, axis, true);
+        }
+
+        /* On a diagonal graph the leaves that only touch this one at an
+         * edge or a corner can be moved to as well. */
+        if (graph_get_style(*(*op)->gp) != MANHATTAN)
+        {
+            for (dir = 0; dir < GRAPH_NUM_DIRECTIONS; dir++)
+            {
+                graph_get_dir_offset(dir, &xoff, &yoff, &zoff);
+                if ((xoff != 0) + (yoff != 0) + (zoff != 0) >= 2)
+                {
+                    octree_expand_corner(op, current, xoff, yoff, zoff);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * This function returns the ids of the cells that make up the path found by
+ * octree_search(), from the start cell to the end cell.
+ */
+uint32_t* octree_get_path(octree o)
+{
+    return o->path;
+}
+
+/**
+ * This function returns the number of cells in the path found by
+ * octree_search(). It is 0 if no path was found.
+ */
+uint32_t octree_get_path_size(octree o)
+{
+    return o->path_size;
+}
+
+/**
+ * This function returns the number of free leaves on the path found by
+ * octree_search().
+ */
+uint32_t octree_get_num_path_leaves(octree o)
+{
+    return o->num_leaves;
+}
+
+/**
+ * This function returns the number of leaves, free or not, in the octree
+ * provided to it.
+ */
+uint32_t octree_get_num_leaves(octree o)
+{
+    uint32_t used;  /* The number of nodes in use. */
+
+    /* Every split node has eight children, so seven of every eight nodes
+     * after the root are another leaf. */
+    used = o->num_nodes - 8 * o->num_spare;
+    return 1 + (used - 1) / 8 * 7;
+}
+
+/**
+ * This function fills in the node provided to it, and every node under it,
+ * from the cells of the graph.
+ */
+void octree_build(octree* op, uint32_t n)
+{
+    uint32_t i;     /* The index of the current child. */
+
+    /* A single cell is in its own state. */
+    if ((*op)->level[n] == 0)
+    {
+        (*op)->state[n] = octree_cell_state(*op, (*op)->x[n], (*op)->y[n],
+                                            (*op)->z[n]);
+        return;
+    }
+
+    /* Otherwise build the node's children, and merge them back into it if
+     * they turn out to be the same. */
+    octree_split(op, n);
+    for (i = 0; i < 8; i++)
+    {
+        octree_build(op, (*op)->child[n] + i);
+    }
+    octree_merge(op, n);
+}
+
+/**
+ * This function returns the first node of a block of eight new nodes.
+ */
+uint32_t octree_alloc_block(octree* op)
+{
+    /* Reuse a block of merged nodes if there is one. */
+    if ((*op)->num_spare > 0)
+    {
+        (*op)->num_spare--;
+        return (*op)->spare[(*op)->num_spare];
+    }
+
+    /* Otherwise double the room for nodes if it's full. */
+    if ((*op)->num_nodes + 8 > (*op)->capacity)
+    {
+        (*op)->capacity *= 2;
+        (*op)->x = (uint8_t*) realloc((*op)->x,
+                sizeof(uint8_t) * (*op)->capacity);
+        (*op)->y = (uint8_t*) realloc((*op)->y,
+                sizeof(uint8_t) * (*op)->capacity);
+        (*op)->z = (uint8_t*) realloc((*op)->z,
+                sizeof(uint8_t) * (*op)->capacity);
+        (*op)->level = (uint8_t*) realloc((*op)->level,
+                sizeof(uint8_t) * (*op)->capacity);
+        (*op)->state = (uint8_t*) realloc((*op)->state,
+                sizeof(uint8_t) * (*op)->capacity);
+        (*op)->child = (uint32_t*) realloc((*op)->child,
+                sizeof(uint32_t) * (*op)->capacity);
+        (*op)->parent = (uint32_t*) realloc((*op)->parent,
+                sizeof(uint32_t) * (*op)->capacity);
+    }
+    (*op)->num_nodes += 8;
+    return (*op)->num_nodes - 8;
+}
+
+/**
+ * This function splits the leaf provided to it into eight leaves in the
+ * same state.
+ */
+void octree_split(octree* op, uint32_t n)
+{
+    uint32_t first;     /* The first of the node's children. */
+    uint32_t half;      /* The width of a child. */
+    uint32_t c;         /* The current child. */
+    uint32_t i;         /* The index of the current child. */
+
+    /* Fill in each child as a leaf covering its eighth of the node. */
+    first = octree_alloc_block(op);
+    half = 1U << ((*op)->level[n] - 1);
+    for (i = 0; i < 8; i++)
+    {
+        c = first + i;
+        (*op)->x[c] = (uint8_t) ((*op)->x[n] + (i & 1 ? half : 0));
+        (*op)->y[c] = (uint8_t) ((*op)->y[n] + (i & 2 ? half : 0));
+        (*op)->z[c] = (uint8_t) ((*op)->z[n] + (i & 4 ? half : 0));
+        (*op)->level[c] = (*op)->level[n] - 1;
+        (*op)->state[c] = (*op)->state[n];
+        (*op)->child[c] = OCTREE_NONE;
+        (*op)->parent[c] = n;
+    }
+    (*op)->child[n] = first;
+    (*op)->state[n] = OCTREE_MIXED;
+}
+
+/**
+ * This function merges the node provided to it into a leaf if all of its
+ * children are leaves in the same state. It returns whether it did.
+ */
+bool octree_merge(octree* op, uint32_t n)
+{
+    uint32_t first;     /* The first of the node's children. */
+    uint32_t i;         /* The index of the current child. */
+
+    /* Check the children are all leaves in the first one's state. */
+    first = (*op)->child[n];
+    if ((*op)->state[first] == OCTREE_MIXED)
+    {
+        return false;
+    }
+    for (i = 1; i < 8; i++)
+    {
+        if ((*op)->state[first + i] != (*op)->state[first])
+        {
+            return false;
+        }
+    }
+
+    /* Make the node a leaf in their state and keep the block for reuse. */
+    (*op)->state[n] = (*op)->state[first];
+    (*op)->child[n] = OCTREE_NONE;
+    if ((*op)->num_spare == (*op)->spare_capacity)
+    {
+        (*op)->spare_capacity = (*op)->spare_capacity == 0
+                              ? 16 : (*op)->spare_capacity * 2;
+        (*op)->spare = (uint32_t*) realloc((*op)->spare,
+                sizeof(uint32_t) * (*op)->spare_capacity);
+    }
+    (*op)->spare[(*op)->num_spare] = first;
+    (*op)->num_spare++;
+    return true;
+}
+
+/**
+ * This function returns the state of the cell at the coordinates provided
+ * to it.
+ */
+uint8_t octree_cell_state(octree o, uint32_t x, uint32_t y, uint32_t z)
+{
+    uint32_t id;    /* The cell's id. */
+
+    /* Cells outside the graph's volume are impassable. */
+    if (x >= graph_get_x_size(*o->gp) || y >= graph_get_y_size(*o->gp)
+        || z >= graph_get_z_size(*o->gp))
+    {
+        return OCTREE_BLOCKED;
+    }
+
+    /* Otherwise it depends on the cell's type. */
+    id = graph_get_cell_id(*o->gp, (uint8_t) x, (uint8_t) y, (uint8_t) z);
+    if (!graph_cell_exists(*o->gp, id)
+        || node_get_type(*graph_get_cell_node(*o->gp, id)) != PASSABLE)
+    {
+        return OCTREE_BLOCKED;
+    }
+    return OCTREE_FREE;
+}
+
+/**
+ * This function returns the deepest node containing the coordinates
+ * provided to it that's a leaf or at the level also provided.
+ */
+uint32_t octree_find(octree o, uint32_t x, uint32_t y, uint32_t z,
+                     uint8_t level)
+{
+    uint32_t n;     /* The current node. */
+    uint8_t bit;    /* The bit of the coordinates that picks the child. */
+
+    /* Go down into the child containing the coordinates. */
+    n = 0;
+    while (o->state[n] == OCTREE_MIXED && o->level[n] > level)
+    {
+        bit = o->level[n] - 1;
+        n = o->child[n] + ((x >> bit) & 1) + (((y >> bit) & 1) << 1)
+                        + (((z >> bit) & 1) << 2);
+    }
+    return n;
+}
+
+/**
+ * This function assesses the free leaves sharing a face with the leaf
+ * provided to it, on the side of the axis also provided.
+ */
+void octree_expand_face(octree* op, uint32_t current, uint8_t axis,
+                        bool high)
+{
+    uint32_t c[3];      /* A cell just past the face. */
+    uint32_t limit;     /* The width of the graph along the axis. */
+    uint32_t n;         /* The node just past the face. */
+
+    /* Find a cell just past the face, if it's inside the graph. */
+    c[0] = (*op)->x[current];
+    c[1] = (*op)->y[current];
+    c[2] = (*op)->z[current];
+    limit = axis == 0 ? graph_get_x_size(*(*op)->gp)
+          : axis == 1 ? graph_get_y_size(*(*op)->gp)
+          : graph_get_z_size(*(*op)->gp);
+    if (high)
+    {
+        c[axis] += 1U << (*op)->level[current];
+        if (c[axis] >= limit)
+        {
+            return;
+        }
+    }
+    else
+    {
+        if (c[axis] == 0)
+        {
+            return;
+        }
+        c[axis]--;
+    }
+
+    /* The node past the face is either a leaf at least as big as this one
+     * or a node as big as it, whose leaves touching the face are
+     * neighbours. */
+    n = octree_find(*op, c[0], c[1], c[2], (*op)->level[current]);
+    octree_expand_node(op, current, n, axis, !high);
+}
+
+/**
+ * This function assesses the free leaves of the node provided to it that
+ * touch its side of the axis also provided.
+ */
+void octree_expand_node(octree* op, uint32_t current, uint32_t n,
+                        uint8_t axis, bool high)
+{
+    uint32_t i;     /* The index of the current child. */
+
+    /* A free leaf is a neighbour, and a blocked one isn't. */
+    if ((*op)->state[n] == OCTREE_FREE)
+    {
+        octree_relax(op, current, n);
+        return;
+    }
+    if ((*op)->state[n] == OCTREE_BLOCKED)
+    {
+        return;
+    }
+
+    /* Otherwise look in the four children on that side. */
+    for (i = 0; i < 8; i++)
+    {
+        if (((i >> axis) & 1) == (high ? 1U : 0U))
+        {
+            octree_expand_node(op, current, (*op)->child[n] + i, axis, high);
+        }
+    }
+}
+
+/**
+ * This function assesses the free leaves that touch the leaf provided to it
+ * only at the edge or the corner in the direction of the offsets also
+ * provided, two or three of which aren't 0.
+ */
+void octree_expand_corner(octree* op, uint32_t current,
+                          int8_t xoff, int8_t yoff, int8_t zoff)
+{
+    int8_t off[3];      /* The offsets of the direction. */
+    uint32_t c[3];      /* The lowest cell of the leaf. */
+    uint32_t limit[3];  /* The width of the graph along each axis. */
+    uint32_t lo[3];     /* The lowest cell of the box past the corner. */
+    uint32_t hi[3];     /* The highest cell of the box past the corner. */
+    uint32_t size;      /* The width of the leaf. */
+    uint8_t axis;       /* The current axis. */
+
+    off[0] = xoff;
+    off[1] = yoff;
+    off[2] = zoff;
+    c[0] = (*op)->x[current];
+    c[1] = (*op)->y[current];
+    c[2] = (*op)->z[current];
+    limit[0] = graph_get_x_size(*(*op)->gp);
+    limit[1] = graph_get_y_size(*(*op)->gp);
+    limit[2] = graph_get_z_size(*(*op)->gp);
+    size = 1U << (*op)->level[current];
+
+    /* The box is one cell thick just past the leaf along each axis that's
+     * offset, and as wide as the leaf along the others. */
+    for (axis = 0; axis < 3; axis++)
+    {
+        if (off[axis] < 0)
+        {
+            if (c[axis] == 0)
+            {
+                return;
+            }
+            lo[axis] = c[axis] - 1;
+            hi[axis] = lo[axis];
+        }
+        else if (off[axis] > 0)
+        {
+            lo[axis] = c[axis] + size;
+            if (lo[axis] >= limit[axis])
+            {
+                return;
+            }
+            hi[axis] = lo[axis];
+        }
+        else
+        {
+            lo[axis] = c[axis];
+            hi[axis] = c[axis] + size - 1;
+        }
+    }
+
+    /* Look for the free leaves in the box from the root down. */
+    octree_expand_box(op, current, 0, lo, hi);
+}
+
+/**
+ * This function assesses the free leaves under the node provided to it that
+ * overlap the box of cells from lo to hi, which touches the current leaf.
+ */
+void octree_expand_box(octree* op, uint32_t current, uint32_t n,
+                       const uint32_t* lo, const uint32_t* hi)
+{
+    uint32_t top;   /* The offset of the node's highest cell. */
+    uint32_t i;     /* The index of the current child. */
+
+    /* Skip the node if it doesn't overlap the box. */
+    top = (1U << (*op)->level[n]) - 1;
+    if ((*op)->x[n] > hi[0] || (*op)->x[n] + top < lo[0]
+        || (*op)->y[n] > hi[1] || (*op)->y[n] + top < lo[1]
+        || (*op)->z[n] > hi[2] || (*op)->z[n] + top < lo[2])
+    {
+        return;
+    }
+
+    /* A free leaf is a neighbour, a blocked one isn't, and otherwise look
+     * in the children. */
+    if ((*op)->state[n] == OCTREE_FREE)
+    {
+        octree_relax(op, current, n);
+    }
+    else if ((*op)->state[n] == OCTREE_MIXED)
+    {
+        for (i = 0; i < 8; i++)
+        {
+            octree_expand_box(op, current, (*op)->child[n] + i, lo, hi);
+        }
+    }
+}
+
+/**
+ * This function records the path to the free leaf provided to it through
+ * the current leaf, if it's better than any path found to it before.
+ */
+void octree_relax(octree* op, uint32_t current, uint32_t n)
+{
+    graph g;            /* The graph. */
+    uint8_t px, py, pz; /* The cell the current leaf is entered at. */
+    uint8_t qx, qy, qz; /* The cell the leaf would be entered at. */
+    uint8_t rx, ry, rz; /* The cell the current leaf is left from. */
+    uint32_t next_g;    /* The cost of the path through the current leaf. */
+    uint32_t q;         /* The id of the cell the leaf would be entered at. */
+
+    /* The leaf is entered at its closest cell to where the current leaf was
+     * entered, from the current leaf's closest cell to that one. */
+    g = *(*op)->gp;
+    graph_get_cell_coords(g, (*op)->entry[current], &px, &py, &pz);
+    qx = px;
+    qy = py;
+    qz = pz;
+    octree_clamp(*op, n, &qx, &qy, &qz);
+    rx = qx;
+    ry = qy;
+    rz = qz;
+    octree_clamp(*op, current, &rx, &ry, &rz);
+
+    /* The cost is the walk across the current leaf and the step across. */
+    next_g = (*op)->g[current]
+           + astar_estimate_coords(graph_get_style(g), px, py, pz,
+                                   rx, ry, rz) + 1;
+
+    /* Record the path if it's better than any before. */
+    if ((*op)->visit[n] != (*op)->search || next_g < (*op)->g[n])
+    {
+        q = graph_get_cell_id(g, qx, qy, qz);
+        (*op)->visit[n] = (*op)->search;
+        (*op)->g[n] = next_g;
+        (*op)->came_from[n] = current;
+        (*op)->entry[n] = q;
+        id_heap_push(&(*op)->open, n,
+                     next_g + astar_estimate(g, q, (*op)->end));
+    }
+}
+
+/**
+ * This function moves the coordinates provided to it into the node also
+ * provided.
+ */
+void octree_clamp(octree o, uint32_t n, uint8_t* xp, uint8_t* yp,
+                  uint8_t* zp)
+{
+    uint32_t top;   /* The offset of the node's highest cell. */
+
+    top = (1U << o->level[n]) - 1;
+    *xp = *xp < o->x[n] ? o->x[n]
+        : *xp > o->x[n] + top ? (uint8_t) (o->x[n] + top) : *xp;
+    *yp = *yp < o->y[n] ? o->y[n]
+        : *yp > o->y[n] + top ? (uint8_t) (o->y[n] + top) : *yp;
+    *zp = *zp < o->z[n] ? o->z[n]
+        : *zp > o->z[n] + top ? (uint8_t) (o->z[n] + top) : *zp;
+}
+
+/**
+ * This function makes sure the search's state fits every node.
+ */
+void octree_grow_search(octree* op)
+{
+    uint32_t old;   /* The number of nodes the state fitted. */
+
+    if ((*op)->search_capacity >= (*op)->capacity)
+    {
+        return;
+    }
+
+    /* Grow each array to fit every node, and the queue with them. */
+    old = (*op)->search_capacity;
+    (*op)->search_capacity = (*op)->capacity;
+    (*op)->g = (uint32_t*) realloc((*op)->g,
+            sizeof(uint32_t) * (*op)->search_capacity);
+    (*op)->came_from = (uint32_t*) realloc((*op)->came_from,
+            sizeof(uint32_t) * (*op)->search_capacity);
+    (*op)->entry = (uint32_t*) realloc((*op)->entry,
+            sizeof(uint32_t) * (*op)->search_capacity);
+    (*op)->visit = (uint32_t*) realloc((*op)->visit,
+            sizeof(uint32_t) * (*op)->search_capacity);
+    memset(&(*op)->visit[old], 0,
+           sizeof(uint32_t) * ((*op)->search_capacity - old));
+    id_heap_free(&(*op)->open);
+    id_heap_init(&(*op)->open, (*op)->search_capacity);
+}
+
+/**
+ * This function refines the path of leaves ending at the leaf provided to
+ * it into a path of cells.
+ */
+void octree_reconstruct_path(octree* op, uint32_t current)
+{
+    graph g;            /* The graph. */
+    uint32_t i;         /* The index of the current leaf on the path. */
+    uint32_t temp;      /* A leaf being swapped. */
+    uint8_t x, y, z;    /* The cell to walk to. */
+
+    /* Follow the leaves back from the end to the start, then put them in
+     * order. */
+    g = *(*op)->gp;
+    (*op)->num_leaves = 0;
+    for (; current != OCTREE_NONE; current = (*op)->came_from[current])
+    {
+        (*op)->leaves[(*op)->num_leaves] = current;
+        (*op)->num_leaves++;
+    }
+    for (i = 0; i < (*op)->num_leaves / 2; i++)
+    {
+        temp = (*op)->leaves[i];
+        (*op)->leaves[i] = (*op)->leaves[(*op)->num_leaves - 1 - i];
+        (*op)->leaves[(*op)->num_leaves - 1 - i] = temp;
+    }
+
+    /* Walk across each leaf to its closest cell to where the next one is
+     * entered, then step into the next one. */
+    (*op)->path[0] = (*op)->entry[(*op)->leaves[0]];
+    (*op)->path_size = 1;
+    for (i = 0; i + 1 < (*op)->num_leaves; i++)
+    {
+        graph_get_cell_coords(g, (*op)->entry[(*op)->leaves[i + 1]],
+                              &x, &y, &z);
+        octree_clamp(*op, (*op)->leaves[i], &x, &y, &z);
+        octree_walk(op, x, y, z);
+        (*op)->path[(*op)->path_size] = (*op)->entry[(*op)->leaves[i + 1]];
+        (*op)->path_size++;
+    }
+
+    /* Walk across the last leaf to the end cell. */
+    graph_get_cell_coords(g, (*op)->end, &x, &y, &z);
+    octree_walk(op, x, y, z);
+}
+
+/**
+ * This function adds the cells of a straight walk inside one node from the
+ * last cell of the path to the coordinates provided to it to the path.
+ */
+void octree_walk(octree* op, uint8_t tx, uint8_t ty, uint8_t tz)
+{
+    graph g;            /* The graph. */
+    uint8_t x, y, z;    /* The current cell's coordinates. */
+    bool diagonal;      /* Whether the axes can be moved along at once. */
+    bool moved;         /* Whether the current step has moved yet. */
+
+    /* Start from the last cell of the path. */
+    g = *(*op)->gp;
+    graph_get_cell_coords(g, (*op)->path[(*op)->path_size - 1], &x, &y, &z);
+    diagonal = graph_get_style(g) != MANHATTAN;
+
+    /* Step towards the coordinates. A node is a cube, so every cell of the
+     * walk is in it. On a diagonal graph every axis that's off is moved
+     * along at once, and otherwise one axis at a time. */
+    while (x != tx || y != ty || z != tz)
+    {
+        moved = false;
+        if (x != tx)
+        {
+            x = x < tx ? x + 1 : x - 1;
+            moved = true;
+        }
+        if ((diagonal || !moved) && y != ty)
+        {
+            y = y < ty ? y + 1 : y - 1;
+            moved = true;
+        }
+        if ((diagonal || !moved) && z != tz)
+        {
+            z = z < tz ? z + 1 : z - 1;
+        }
+        (*op)->path[(*op)->path_size] = graph_get_cell_id(g, x, y, z);
+        (*op)->path_size++;
+    }
+}
@@ -0,0 +1,96 @@
+/**
+ * octree.h
+ *
+ * This file contains the data-structure and function prototype declarations
+ * for the octree type.
+ *
+ * The octree type is a sparse voxel octree of a graph's cells, for finding
+ * paths across large open volumes. The graph's volume is split into eight
+ * cubes, and each cube that has both passable and impassable cells in it is
+ * split again, down to single cells. Cubes whose cells are all passable are
+ * free leaves, however big they are, so an open region is only a few of
+ * them while the leaves near obstacles are single cells.
+ *
+ * The search is A* over the free leaves, moving between leaves that share a
+ * face, whatever their sizes. On a DIAGONAL graph, leaves that only touch
+ * at an edge or a corner are neighbours as well. Each leaf is entered at the cell closest to
+ * where the path came from, and the cost of a move is the number of cells
+ * walked to get there. The path of leaves is then refined into a path of
+ * cells by walking straight across each leaf to where the next is entered.
+ *
+ * The octree only looks at whether cells are passable, not at edges added
+ * with graph_add_edge(). When a cell's type changes, octree_update() splits
+ * or merges only the cubes around it.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#ifndef OCTREE_H
+#define OCTREE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "graph.h"
+#include "id_heap.h"
+#include "astar.h"
+
+/**
+ * The data-structure of the octree type.
+ */
+typedef struct octree_data* octree;
+
+/**
+ * This function initialises the octree provided to it by building it from
+ * the cells of the graph also provided.
+ */
+void octree_init(octree* op, graph* gp);
+
+/**
+ * This function destroys the octree provided to it.
+ */
+void octree_free(octree* op);
+
+/**
+ * This function brings the octree provided to it up to date with the type
+ * of the cell with the id also provided, after it has been changed.
+ */
+void octree_update(octree* op, uint32_t id);
+
+/**
+ * This function searches for a path from the start cell to the end cell
+ * across the octree's free leaves. There's no path if either cell is
+ * impassable.
+ */
+void octree_search(octree* op, uint32_t start, uint32_t end);
+
+/**
+ * This function returns the ids of the cells that make up the path found by
+ * octree_search(), from the start cell to the end cell.
+ */
+uint32_t* octree_get_path(octree o);
+
+/**
+ * This function returns the number of cells in the path found by
+ * octree_search(). It is 0 if no path was found.
+ */
+uint32_t octree_get_path_size(octree o);
+
+/**
+ * This function returns the number of free leaves on the path found by
+ * octree_search().
+ */
+uint32_t octree_get_num_path_leaves(octree o);
+
+/**
+ * This function returns the number of leaves, free or not, in the octree
+ * provided to it.
+ */
+uint32_t octree_get_num_leaves(octree o);
+
+#endif // OCTREE_H
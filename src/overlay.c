@@ -0,0 +1,257 @@
+/**
+ * overlay.c
+ *
+ * This file contains the internal data-structure and function definitions
+ * for the overlay type.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#include "overlay.h"
+
+/**
+ * This is the extra cost of a blocked cell.
+ */
+#define OVERLAY_BLOCKED UINT32_MAX
+
+/**
+ * This is the most extra cost a cell can have, which keeps the cost of a
+ * path well within 32 bits.
+ */
+#define OVERLAY_MAX_EXTRA 0xFFFF
+
+/**
+ * This is the number of changed cells an overlay has room for when it's
+ * initialised.
+ */
+#define OVERLAY_INITIAL_CAPACITY 16
+
+/**
+ * This is the internal data-structure of the overlay type.
+ */
+struct overlay_data {
+    uint32_t* ids;          /* The ids of the changed cells, in order. */
+    uint32_t* extra;        /* The extra cost of moving into each one. */
+    uint32_t size;          /* The number of changed cells. */
+    uint32_t capacity;      /* The number of cells there's room for. */
+
+    /* The bitmap of the low bits of the changed cells' ids. A cell whose
+     * bit is clear hasn't been changed. */
+    uint64_t filter[OVERLAY_FILTER_WORDS];
+};
+
+/**
+ * This function returns the position in the overlay provided to it of the
+ * cell with the id also provided, or of the first cell with a higher id if
+ * it isn't there.
+ */
+uint32_t overlay_find(overlay o, uint32_t id);
+
+/**
+ * This function returns the position in the overlay provided to it of the
+ * cell with the id also provided, adding it with no extra cost if it isn't
+ * there.
+ */
+uint32_t overlay_add(overlay* op, uint32_t id);
+
+/**
+ * This function initialises the overlay provided to it with no changed
+ * cells.
+ */
+void overlay_init(overlay* op)
+{
+    /* Allocate memory to the overlay. */
+    *op = (overlay) malloc(sizeof(struct overlay_data));
+
+    /* Initialise the overlay's internal properties. */
+    (*op)->ids = (uint32_t*) malloc(
+            sizeof(uint32_t) * OVERLAY_INITIAL_CAPACITY);
+    (*op)->extra = (uint32_t*) malloc(
+            sizeof(uint32_t) * OVERLAY_INITIAL_CAPACITY);
+    (*op)->size = 0;
+    (*op)->capacity = OVERLAY_INITIAL_CAPACITY;
+    memset((*op)->filter, 0, sizeof((*op)->filter));
+}
+
+/**
+ * This function destroys the overlay provided to it.
+ */
+void overlay_free(overlay* op)
+{
+    /* Destroy the overlay's internal properties. */
+    free((*op)->ids);
+    free((*op)->extra);
+
+    /* De-allocate memory from the overlay. */
+    free(*op);
+}
+
+/**
+ * This function blocks the cell with the id provided to it in the overlay
+ * also provided, so searches with the overlay can't move into it.
+ */
+void overlay_block(overlay* op, uint32_t id)
+{
+    uint32_t i; /* The position of the cell. */
+
+    /* Add the cell and block it. */
+    i = overlay_add(op, id);
+    (*op)->extra[i] = OVERLAY_BLOCKED;
+}
+
+/**
+ * This function adds the extra cost provided to it to every move into the
+ * cell with the id also provided, in the overlay also provided. Extra costs
+ * added to the same cell more than once add up, to at most 65535.
+ */
+void overlay_add_cost(overlay* op, uint32_t id, uint32_t extra)
+{
+    uint32_t i; /* The position of the cell. */
+
+    /* Add the extra cost, unless the cell is blocked already, up to the
+     * most a cell can have. */
+    i = overlay_add(op, id);
+    if ((*op)->extra[i] != OVERLAY_BLOCKED)
+    {
+        if (extra >= OVERLAY_MAX_EXTRA - (*op)->extra[i])
+        {
+            (*op)->extra[i] = OVERLAY_MAX_EXTRA;
+        }
+        else
+        {
+            (*op)->extra[i] += extra;
+        }
+    }
+}
+
+/**
+ * This function removes every changed cell from the overlay provided to
+ * it.
+ */
+void overlay_clear(overlay* op)
+{
+    (*op)->size = 0;
+    memset((*op)->filter, 0, sizeof((*op)->filter));
+}
+
+/**
+ * This function returns the cost of moving into the cell with the id
+ * provided to it with the overlay also provided, given the cost of the move
+ * in the graph. It's 0 if the cell is blocked.
+ */
+uint32_t overlay_get_cost(overlay o, uint32_t id, uint32_t w)
+{
+    uint32_t bit;   /* The cell's bit in the bitmap. */
+    uint32_t i;     /* The position of the cell. */
+
+    /* Most cells can be passed over by their bit in the bitmap. */
+    bit = id % (OVERLAY_FILTER_WORDS * 64);
+    if (!(o->filter[bit / 64] & ((uint64_t) 1 << (bit % 64))))
+    {
+        return w;
+    }
+
+    /* Otherwise look the cell up. */
+    i = overlay_find(o, id);
+    if (i == o->size || o->ids[i] != id)
+    {
+        return w;
+    }
+    if (o->extra[i] == OVERLAY_BLOCKED)
+    {
+        return 0;
+    }
+    return w + o->extra[i];
+}
+
+/**
+ * This function returns whether the cell with the id provided to it is
+ * blocked in the overlay also provided.
+ */
+bool overlay_is_blocked(overlay o, uint32_t id)
+{
+    return overlay_get_cost(o, id, 1) == 0;
+}
+
+/**
+ * This function returns the number of changed cells in the overlay provided
+ * to it.
+ */
+uint32_t overlay_get_size(overlay o)
+{
+    return o->size;
+}
+
+/**
+ * This function returns the position in the overlay provided to it of the
+ * cell with the id also provided, or of the first cell with a higher id if
+ * it isn't there.
+ */
+uint32_t overlay_find(overlay o, uint32_t id)
+{
+    uint32_t lo;    /* The first position it could be at. */
+    uint32_t hi;    /* The position after the last it could be at. */
+    uint32_t mid;   /* The position being looked at. */
+
+    /* Halve the range the cell could be in until it's one position. */
+    lo = 0;
+    hi = o->size;
+    while (lo < hi)
+    {
+        mid = lo + (hi - lo) / 2;
+        if (o->ids[mid] < id)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * This function returns the position in the overlay provided to it of the
+ * cell with the id also provided, adding it with no extra cost if it isn't
+ * there.
+ */
+uint32_t overlay_add(overlay* op, uint32_t id)
+{
+    uint32_t i;     /* The position of the cell. */
+    uint32_t bit;   /* The cell's bit in the bitmap. */
+
+    /* Check if the cell has been changed already. */
+    i = overlay_find(*op, id);
+    if (i < (*op)->size && (*op)->ids[i] == id)
+    {
+        return i;
+    }
+
+    /* Make room for another cell if the overlay is full. */
+    if ((*op)->size == (*op)->capacity)
+    {
+        (*op)->capacity *= 2;
+        (*op)->ids = (uint32_t*) realloc((*op)->ids,
+                sizeof(uint32_t) * (*op)->capacity);
+        (*op)->extra = (uint32_t*) realloc((*op)->extra,
+                sizeof(uint32_t) * (*op)->capacity);
+    }
+
+    /* Move the cells with higher ids up by one and put the cell in their
+     * place. */
+    memmove(&(*op)->ids[i + 1], &(*op)->ids[i],
+            sizeof(uint32_t) * ((*op)->size - i));
+    memmove(&(*op)->extra[i + 1], &(*op)->extra[i],
+            sizeof(uint32_t) * ((*op)->size - i));
+    (*op)->ids[i] = id;
+    (*op)->extra[i] = 0;
+    (*op)->size++;
+
+    /* Set the cell's bit in the bitmap. */
+    bit = id % (OVERLAY_FILTER_WORDS * 64);
+    (*op)->filter[bit / 64] |= (uint64_t) 1 << (bit % 64);
+    return i;
+}
@@ -0,0 +1,94 @@
+/**
+ * overlay.h
+ *
+ * This file contains the data-structure and function prototype declarations
+ * for the overlay type.
+ *
+ * The overlay type is a small set of changes to the cost of moving into
+ * some of a graph's cells, such as cells taken by other units or doors an
+ * agent can't open, that one search takes into account without changing
+ * the graph itself. A cell can be blocked, or made dearer to move into by a
+ * number added to the cost of every move into it. Costs can't be lowered,
+ * so astar's estimates still never overestimate.
+ *
+ * The changed cells are kept in order of their ids, so a cell is looked up
+ * with a binary search, and a bitmap of the low bits of their ids lets most
+ * unchanged cells be passed over without searching at all. Searches only
+ * read an overlay, so many threads can search the same graph at once, each
+ * with its own overlay, or all with the same one.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#ifndef OVERLAY_H
+#define OVERLAY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * This is the number of 64 bit words in the bitmap of the low bits of the
+ * changed cells' ids.
+ */
+#define OVERLAY_FILTER_WORDS 8
+
+/**
+ * The data-structure of the overlay type.
+ */
+typedef struct overlay_data* overlay;
+
+/**
+ * This function initialises the overlay provided to it with no changed
+ * cells.
+ */
+void overlay_init(overlay* op);
+
+/**
+ * This function destroys the overlay provided to it.
+ */
+void overlay_free(overlay* op);
+
+/**
+ * This function blocks the cell with the id provided to it in the overlay
+ * also provided, so searches with the overlay can't move into it.
+ */
+void overlay_block(overlay* op, uint32_t id);
+
+/**
+ * This function adds the extra cost provided to it to every move into the
+ * cell with the id also provided, in the overlay also provided. Extra costs
+ * added to the same cell more than once add up, to at most 65535.
+ */
+void overlay_add_cost(overlay* op, uint32_t id, uint32_t extra);
+
+/**
+ * This function removes every changed cell from the overlay provided to
+ * it.
+ */
+void overlay_clear(overlay* op);
+
+/**
+ * This function returns the cost of moving into the cell with the id
+ * provided to it with the overlay also provided, given the cost of the move
+ * in the graph. It's 0 if the cell is blocked.
+ */
+uint32_t overlay_get_cost(overlay o, uint32_t id, uint32_t w);
+
+/**
+ * This function returns whether the cell with the id provided to it is
+ * blocked in the overlay also provided.
+ */
+bool overlay_is_blocked(overlay o, uint32_t id);
+
+/**
+ * This function returns the number of changed cells in the overlay provided
+ * to it.
+ */
+uint32_t overlay_get_size(overlay o);
+
+#endif // OVERLAY_H
@@ -0,0 +1,175 @@
+/**
+ * profile.c
+ *
+ * This file contains the internal data-structure and function definitions
+ * for the profile type.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#include "profile.h"
+
+/**
+ * This is the internal data-structure of the profile type.
+ */
+struct profile_data {
+    /* The multiplier of each kind of move into each terrain class. */
+    uint8_t multipliers[GRAPH_NUM_TERRAINS][PROFILE_NUM_MOVES];
+
+    /* The lowest multiplier that isn't PROFILE_IMPASSABLE. */
+    uint8_t min_multiplier;
+};
+
+/**
+ * This function works out the lowest multiplier of the profile provided to
+ * it again.
+ */
+void profile_update_min(profile* pp);
+
+/**
+ * This function initialises the profile provided to it with a multiplier of
+ * 1 for every terrain class and kind of move.
+ */
+void profile_init(profile* pp)
+{
+    /* Allocate memory to the profile. */
+    *pp = (profile) malloc(sizeof(struct profile_data));
+
+    /* Every move costs what it does in the graph. */
+    memset((*pp)->multipliers, 1, sizeof((*pp)->multipliers));
+    (*pp)->min_multiplier = 1;
+}
+
+/**
+ * This function destroys the profile provided to it.
+ */
+void profile_free(profile* pp)
+{
+    /* De-allocate memory from the profile. */
+    free(*pp);
+}
+
+/**
+ * This function sets the multiplier of moves of the kind provided to it
+ * into cells of the terrain class also provided, in the profile also
+ * provided. PROFILE_IMPASSABLE stops the agent making them.
+ */
+void profile_set_multiplier(profile* pp, uint8_t terrain,
+                            enum profile_move move, uint8_t multiplier)
+{
+    /* Check there's a multiplier for the terrain class. */
+    if (terrain >= GRAPH_NUM_TERRAINS)
+    {
+        fprintf(stdout,
+                "\nERROR: In function profile_set_multiplier(): Terrain "
+                "class %u is beyond the %u classes!\n",
+                (unsigned) terrain, (unsigned) GRAPH_NUM_TERRAINS);
+        exit(EXIT_FAILURE);
+    }
+
+    /* Set the multiplier. */
+    (*pp)->multipliers[terrain][move] = multiplier;
+    profile_update_min(pp);
+}
+
+/**
+ * This function sets the multiplier of every kind of move into cells of the
+ * terrain class provided to it, in the profile also provided.
+ */
+void profile_set_terrain(profile* pp, uint8_t terrain, uint8_t multiplier)
+{
+    profile_set_multiplier(pp, terrain, PROFILE_LEVEL, multiplier);
+    profile_set_multiplier(pp, terrain, PROFILE_UP, multiplier);
+    profile_set_multiplier(pp, terrain, PROFILE_DOWN, multiplier);
+}
+
+/**
+ * This function returns the multiplier of moves of the kind provided to it
+ * into cells of the terrain class also provided, in the profile also
+ * provided.
+ */
+uint8_t profile_get_multiplier(profile p, uint8_t terrain,
+                               enum profile_move move)
+{
+    return p->multipliers[terrain][move];
+}
+
+/**
+ * This function returns the lowest multiplier of the profile provided to
+ * it, leaving out PROFILE_IMPASSABLE, which estimates of the cost of a path
+ * can be multiplied by. It's 1 if every move is impassable.
+ */
+uint8_t profile_get_min_multiplier(profile p)
+{
+    return p->min_multiplier;
+}
+
+/**
+ * This function returns what moving from one cell to another of the graph
+ * provided to it, along an edge with the cost also provided, costs with the
+ * profile also provided. It's 0 if the agent can't make the move.
+ */
+uint32_t profile_get_cost(profile p, graph g, uint32_t from, uint32_t to,
+                          uint32_t w)
+{
+    uint8_t fx, fy, fz;         /* The coordinates of the cell left. */
+    uint8_t tx, ty, tz;         /* The coordinates of the cell entered. */
+    enum profile_move move;     /* The kind of move. */
+
+    /* Every move on a flat graph is level. Otherwise compare the heights
+     * of the cells. */
+    move = PROFILE_LEVEL;
+    if (graph_get_z_size(g) > 1)
+    {
+        graph_get_cell_coords(g, from, &fx, &fy, &fz);
+        graph_get_cell_coords(g, to, &tx, &ty, &tz);
+        if (tz > fz)
+        {
+            move = PROFILE_UP;
+        }
+        else if (tz < fz)
+        {
+            move = PROFILE_DOWN;
+        }
+    }
+
+    /* Multiply the cost of the move by the multiplier of the terrain class
+     * of the cell it enters. */
+    return w * p->multipliers[graph_get_cell_terrain(g, to)][move];
+}
+
+/**
+ * This function works out the lowest multiplier of the profile provided to
+ * it again.
+ */
+void profile_update_min(profile* pp)
+{
+    uint8_t terrain;    /* The current terrain class. */
+    uint8_t move;       /* The current kind of move. */
+    uint8_t m;          /* The current multiplier. */
+
+    /* Find the lowest multiplier that isn't impassable, with
+     * PROFILE_IMPASSABLE standing for none found yet. */
+    (*pp)->min_multiplier = PROFILE_IMPASSABLE;
+    for (terrain = 0; terrain < GRAPH_NUM_TERRAINS; terrain++)
+    {
+        for (move = 0; move < PROFILE_NUM_MOVES; move++)
+        {
+            m = (*pp)->multipliers[terrain][move];
+            if (m != PROFILE_IMPASSABLE
+                && ((*pp)->min_multiplier == PROFILE_IMPASSABLE
+                    || m < (*pp)->min_multiplier))
+            {
+                (*pp)->min_multiplier = m;
+            }
+        }
+    }
+
+    /* Nothing is passable, so there is nothing to estimate. */
+    if ((*pp)->min_multiplier == PROFILE_IMPASSABLE)
+    {
+        (*pp)->min_multiplier = 1;
+    }
+}
@@ -0,0 +1,105 @@
+/**
+ * profile.h
+ *
+ * This file contains the data-structure and function prototype declarations
+ * for the profile type.
+ *
+ * The profile type is a movement profile: what moving over each terrain
+ * class costs one kind of agent, such as wheeled, legged or flying units.
+ * It's a small table of a multiplier for each terrain class and kind of
+ * move, level, up or down, that the cost of a move in the graph is
+ * multiplied by, where a multiplier of PROFILE_IMPASSABLE means the agent
+ * can't make the move at all. Searches look the table up for the terrain
+ * class of the cell each move goes into as they expand it, so one graph
+ * serves every kind of agent.
+ *
+ * No move costs less than the graph's cost times the profile's lowest
+ * multiplier, so an estimate of the graph's cost times that multiplier
+ * still never overestimates.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "graph.h"
+
+/**
+ * This is the multiplier of a move the agent can't make.
+ */
+#define PROFILE_IMPASSABLE 0
+
+/**
+ * These are the kinds of move a profile has a multiplier for: moves that
+ * stay on the same z, and moves that go up or down the z axis.
+ */
+enum profile_move { PROFILE_LEVEL, PROFILE_UP, PROFILE_DOWN };
+
+/**
+ * This is the number of kinds of move.
+ */
+#define PROFILE_NUM_MOVES 3
+
+/**
+ * The data-structure of the profile type.
+ */
+typedef struct profile_data* profile;
+
+/**
+ * This function initialises the profile provided to it with a multiplier of
+ * 1 for every terrain class and kind of move.
+ */
+void profile_init(profile* pp);
+
+/**
+ * This function destroys the profile provided to it.
+ */
+void profile_free(profile* pp);
+
+/**
+ * This function sets the multiplier of moves of the kind provided to it
+ * into cells of the terrain class also provided, in the profile also
+ * provided. PROFILE_IMPASSABLE stops the agent making them.
+ */
+void profile_set_multiplier(profile* pp, uint8_t terrain,
+                            enum profile_move move, uint8_t multiplier);
+
+/**
+ * This function sets the multiplier of every kind of move into cells of the
+ * terrain class provided to it, in the profile also provided.
+ */
+void profile_set_terrain(profile* pp, uint8_t terrain, uint8_t multiplier);
+
+/**
+ * This function returns the multiplier of moves of the kind provided to it
+ * into cells of the terrain class also provided, in the profile also
+ * provided.
+ */
+uint8_t profile_get_multiplier(profile p, uint8_t terrain,
+                               enum profile_move move);
+
+/**
+ * This function returns the lowest multiplier of the profile provided to
+ * it, leaving out PROFILE_IMPASSABLE, which estimates of the cost of a path
+ * can be multiplied by. It's 1 if every move is impassable.
+ */
+uint8_t profile_get_min_multiplier(profile p);
+
+/**
+ * This function returns what moving from one cell to another of the graph
+ * provided to it, along an edge with the cost also provided, costs with the
+ * profile also provided. It's 0 if the agent can't make the move.
+ */
+uint32_t profile_get_cost(profile p, graph g, uint32_t from, uint32_t to,
+                          uint32_t w);
+
+#endif // PROFILE_H
@@ -0,0 +1,520 @@
+/**
+ * ring_grid.c
+ *
+ * This file contains the internal data-structure and function definitions
+ * for the ring_grid type.
+ *
+ * When the window moves less than its size along an axis, the cells that
+ * come into it are split into three boxes that don't overlap: the slab of
+ * new x coordinates across the whole new window, the slab of new y
+ * coordinates across the x coordinates the old and new windows share, and
+ * the slab of new z coordinates across the x and y coordinates they share.
+ * Only those boxes are loaded. Searches use search numbers like astar's, so
+ * nothing has to be reset between them.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#include "ring_grid.h"
+
+/**
+ * This is the internal data-structure of the ring_grid type.
+ */
+struct ring_grid_data {
+    uint8_t x_size;             /* The size of the window on each axis. */
+    uint8_t y_size;
+    uint8_t z_size;
+    uint32_t num_cells;         /* The number of cells in the window. */
+    enum graph_style gstyle;    /* The moves searches can make. */
+    ring_grid_loader load;      /* The function cells are loaded with. */
+    void* context;              /* What the function is given. */
+    int32_t origin_x;           /* The world coordinates of the window's */
+    int32_t origin_y;           /* lowest corner. */
+    int32_t origin_z;
+    uint8_t* types;             /* The type of each cell in the buffer. */
+    uint32_t version;           /* The number of times the window moved. */
+    uint64_t num_loaded;        /* The number of cells loaded. */
+    uint32_t* g;                /* The cost of the path to each cell. */
+    uint32_t* came_from;        /* The cell each cell's path came from. */
+    uint32_t* visit;            /* The search each cell was last reached
+                                 * by. */
+    uint32_t search;            /* The number of the current search. */
+    id_heap open;               /* The cells waiting to be expanded. */
+    uint32_t* path;             /* The cells of the path found. */
+    uint32_t path_size;         /* The number of cells in the path. */
+};
+
+/**
+ * This function returns the coordinate provided to it modulo the size also
+ * provided, which is never negative.
+ */
+uint32_t ring_grid_mod(int32_t a, uint8_t size);
+
+/**
+ * This function returns the place in the ring buffer of the ring_grid
+ * provided to it of the cell at the world coordinates also provided,
+ * without checking the cell is in the window.
+ */
+uint32_t ring_grid_index(ring_grid r, int32_t x, int32_t y, int32_t z);
+
+/**
+ * This function loads the cells of the box of world coordinates provided
+ * to it, given by its lowest corner and its size on each axis, into the
+ * ring_grid also provided.
+ */
+void ring_grid_load(ring_grid* rp, int32_t x, int32_t y, int32_t z,
+                    uint32_t x_count, uint32_t y_count, uint32_t z_count);
+
+/**
+ * This function initialises the ring_grid provided to it with a window of
+ * the sizes provided, whose lowest corner is at the world's origin, and
+ * loads every cell of it with the loader and context also provided.
+ */
+void ring_grid_init(ring_grid* rp, uint8_t x_size, uint8_t y_size,
+                    uint8_t z_size, enum graph_style gstyle,
+                    ring_grid_loader load, void* context)
+{
+    uint32_t count;     /* The number of cells in the window. */
+
+    /* Check the window has cells. */
+    if (x_size == 0 || y_size == 0 || z_size == 0)
+    {
+        fprintf(stdout,
+                "\nERROR: In function ring_grid_init(): The window must be "
+                "at least 1 cell in size on every axis!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Allocate memory to the ring_grid. */
+    *rp = (ring_grid) malloc(sizeof(struct ring_grid_data));
+    count = (uint32_t) x_size * y_size * z_size;
+
+    /* Initialise the ring_grid's internal properties. */
+    (*rp)->x_size = x_size;
+    (*rp)->y_size = y_size;
+    (*rp)->z_size = z_size;
+    (*rp)->num_cells = count;
+    (*rp)->gstyle = gstyle;
+    (*rp)->load = load;
+    (*rp)->context = context;
+    (*rp)->origin_x = 0;
+    (*rp)->origin_y = 0;
+    (*rp)->origin_z = 0;
+    (*rp)->types = (uint8_t*) malloc(sizeof(uint8_t) * count);
+    (*rp)->version = 0;
+    (*rp)->num_loaded = 0;
+    (*rp)->g = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*rp)->came_from = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*rp)->visit = (uint32_t*) calloc(count, sizeof(uint32_t));
+    (*rp)->search = 0;
+    id_heap_init(&(*rp)->open, count);
+    (*rp)->path = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*rp)->path_size = 0;
+
+    /* Load every cell of the window. */
+    ring_grid_load(rp, 0, 0, 0, x_size, y_size, z_size);
+}
+
+/**
+ * This function destroys the ring_grid provided to it.
+ */
+void ring_grid_free(ring_grid* rp)
+{
+    /* Destroy the ring_grid's internal properties. */
+    free((*rp)->types);
+    free((*rp)->g);
+    free((*rp)->came_from);
+    free((*rp)->visit);
+    id_heap_free(&(*rp)->open);
+    free((*rp)->path);
+
+    /* De-allocate memory from the ring_grid. */
+    free(*rp);
+}
+
+/**
+ * This function moves the window of the ring_grid provided to it so that
+ * its lowest corner is at the world coordinates also provided. Only the
+ * cells that come into the window are loaded, into the places of the cells
+ * that leave it. The path found by the last search is emptied if any of its
+ * cells leave the window.
+ */
+void ring_grid_move(ring_grid* rp, int32_t x, int32_t y, int32_t z)
+{
+    int64_t dx, dy, dz;     /* How far the window moves on each axis. */
+    int32_t px, py, pz;     /* The coordinates of a cell of the path. */
+    int32_t nx, ny, nz;     /* The lowest new coordinate on each axis. */
+    int32_t sx, sy;         /* The lowest shared coordinate on the x and y
+                             * axes. */
+    uint32_t kx, ky;        /* The number of shared x and y coordinates. */
+    uint32_t i;             /* The current cell of the path. */
+    ring_grid r;            /* The ring_grid. */
+
+    /* Nothing changes if the window stays put. */
+    r = *rp;
+    dx = (int64_t) x - r->origin_x;
+    dy = (int64_t) y - r->origin_y;
+    dz = (int64_t) z - r->origin_z;
+    if (dx == 0 && dy == 0 && dz == 0)
+    {
+        return;
+    }
+
+    /* Empty the path if any of its cells are leaving the window. */
+    for (i = 0; i < r->path_size; i++)
+    {
+        ring_grid_get_coords(r, r->path[i], &px, &py, &pz);
+        if ((int64_t) px - x < 0 || (int64_t) px - x >= r->x_size
+            || (int64_t) py - y < 0 || (int64_t) py - y >= r->y_size
+            || (int64_t) pz - z < 0 || (int64_t) pz - z >= r->z_size)
+        {
+            r->path_size = 0;
+        }
+    }
+
+    /* Move the window. */
+    r->origin_x = x;
+    r->origin_y = y;
+    r->origin_z = z;
+    r->version++;
+
+    /* If the window moves its size or more on any axis, none of its cells
+     * stay, so load them all. */
+    if (dx <= -r->x_size || dx >= r->x_size
+        || dy <= -r->y_size || dy >= r->y_size
+        || dz <= -r->z_size || dz >= r->z_size)
+    {
+        ring_grid_load(rp, x, y, z, r->x_size, r->y_size, r->z_size);
+        return;
+    }
+
+    /* Work out where the new coordinates start on each axis, and where the
+     * shared ones start on the x and y axes. */
+    nx = dx > 0 ? (int32_t) (x + r->x_size - dx) : x;
+    ny = dy > 0 ? (int32_t) (y + r->y_size - dy) : y;
+    nz = dz > 0 ? (int32_t) (z + r->z_size - dz) : z;
+    sx = dx > 0 ? x : (int32_t) (x - dx);
+    sy = dy > 0 ? y : (int32_t) (y - dy);
+    kx = r->x_size - (uint32_t) (dx > 0 ? dx : -dx);
+    ky = r->y_size - (uint32_t) (dy > 0 ? dy : -dy);
+
+    /* Load the slab of new x coordinates across the whole window, then the
+     * slab of new y coordinates across the shared x coordinates, then the
+     * slab of new z coordinates across the shared x and y coordinates. */
+    ring_grid_load(rp, nx, y, z, (uint32_t) (dx > 0 ? dx : -dx),
+                   r->y_size, r->z_size);
+    ring_grid_load(rp, sx, ny, z, kx, (uint32_t) (dy > 0 ? dy : -dy),
+                   r->z_size);
+    ring_grid_load(rp, sx, sy, nz, kx, ky,
+                   (uint32_t) (dz > 0 ? dz : -dz));
+}
+
+/**
+ * This function moves the window of the ring_grid provided to it so that
+ * the cell at the world coordinates also provided is at its centre.
+ */
+void ring_grid_recentre(ring_grid* rp, int32_t x, int32_t y, int32_t z)
+{
+    ring_grid_move(rp, x - (*rp)->x_size / 2, y - (*rp)->y_size / 2,
+                   z - (*rp)->z_size / 2);
+}
+
+/**
+ * This function returns whether the cell at the world coordinates provided
+ * to it is in the window of the ring_grid also provided.
+ */
+bool ring_grid_contains(ring_grid r, int32_t x, int32_t y, int32_t z)
+{
+    return (int64_t) x - r->origin_x >= 0
+        && (int64_t) x - r->origin_x < r->x_size
+        && (int64_t) y - r->origin_y >= 0
+        && (int64_t) y - r->origin_y < r->y_size
+        && (int64_t) z - r->origin_z >= 0
+        && (int64_t) z - r->origin_z < r->z_size;
+}
+
+/**
+ * This function returns the place in the ring buffer of the ring_grid
+ * provided to it of the cell at the world coordinates also provided, which
+ * must be in the window.
+ */
+uint32_t ring_grid_get_index(ring_grid r, int32_t x, int32_t y, int32_t z)
+{
+    /* Check the cell is in the window. */
+    if (!ring_grid_contains(r, x, y, z))
+    {
+        fprintf(stdout,
+                "\nERROR: In function ring_grid_get_index(): The cell at "
+                "(%d, %d, %d) isn't in the window!\n", x, y, z);
+        exit(EXIT_FAILURE);
+    }
+    return ring_grid_index(r, x, y, z);
+}
+
+/**
+ * This function gets the world coordinates of the cell at the place in the
+ * ring buffer provided to it, in the ring_grid also provided.
+ */
+void ring_grid_get_coords(ring_grid r, uint32_t index,
+                          int32_t* xp, int32_t* yp, int32_t* zp)
+{
+    uint32_t bx, by, bz;    /* The coordinates of the place in the buffer. */
+
+    /* Split the place into its coordinates in the buffer. */
+    bz = index % r->z_size;
+    by = (index / r->z_size) % r->y_size;
+    bx = index / r->z_size / r->y_size;
+
+    /* Each coordinate is the one in the window that wraps around to it. */
+    *xp = r->origin_x + (int32_t) ring_grid_mod(
+            (int32_t) bx - (int32_t) ring_grid_mod(r->origin_x, r->x_size),
+            r->x_size);
+    *yp = r->origin_y + (int32_t) ring_grid_mod(
+            (int32_t) by - (int32_t) ring_grid_mod(r->origin_y, r->y_size),
+            r->y_size);
+    *zp = r->origin_z + (int32_t) ring_grid_mod(
+            (int32_t) bz - (int32_t) ring_grid_mod(r->origin_z, r->z_size),
+            r->z_size);
+}
+
+/**
+ * This function returns the type of the cell at the world coordinates
+ * provided to it, which must be in the window of the ring_grid also
+ * provided.
+ */
+enum node_type ring_grid_get_type(ring_grid r, int32_t x, int32_t y,
+                                  int32_t z)
+{
+    return (enum node_type) r->types[ring_grid_get_index(r, x, y, z)];
+}
+
+/**
+ * This function changes the type of the cell at the world coordinates
+ * provided to it, which must be in the window of the ring_grid also
+ * provided, until it leaves the window.
+ */
+void ring_grid_set_type(ring_grid* rp, int32_t x, int32_t y, int32_t z,
+                        enum node_type type)
+{
+    (*rp)->types[ring_grid_get_index(*rp, x, y, z)] = (uint8_t) type;
+}
+
+/**
+ * This function searches for the shortest path between the cells at the
+ * world coordinates provided to it, both of which must be in the window of
+ * the ring_grid also provided, over the cells in the window.
+ */
+void ring_grid_search(ring_grid* rp, int32_t sx, int32_t sy, int32_t sz,
+                      int32_t ex, int32_t ey, int32_t ez)
+{
+    uint32_t start;         /* The place of the start cell. */
+    uint32_t end;           /* The place of the end cell. */
+    uint32_t current;       /* The cell being expanded. */
+    uint32_t next;          /* The neighbour being looked at. */
+    uint32_t g;             /* The cost of the path to the neighbour. */
+    int32_t x, y, z;        /* The coordinates of the cell expanded. */
+    int32_t nx, ny, nz;     /* The coordinates of the neighbour. */
+    int8_t xoff, yoff, zoff;    /* The offsets of the direction. */
+    uint8_t dir;            /* The current direction. */
+    uint32_t i;             /* The current cell of the path. */
+    ring_grid r;            /* The ring_grid. */
+
+    /* Find the places of the start and end cells. */
+    r = *rp;
+    start = ring_grid_get_index(r, sx, sy, sz);
+    end = ring_grid_get_index(r, ex, ey, ez);
+
+    /* Move on to the next search number. If the numbers have run out,
+     * forget every cell's visit number and start counting again. */
+    r->search++;
+    if (r->search == 0)
+    {
+        memset(r->visit, 0, sizeof(uint32_t) * r->num_cells);
+        r->search = 1;
+    }
+    id_heap_clear(&r->open);
+    r->path_size = 0;
+
+    /* There's no path from or to an impassable cell. */
+    if (r->types[start] != PASSABLE || r->types[end] != PASSABLE)
+    {
+        return;
+    }
+
+    /* Start from the start cell. */
+    r->g[start] = 0;
+    r->came_from[start] = start;
+    r->visit[start] = r->search;
+    id_heap_push(&r->open, start, astar_estimate_coords(r->gstyle,
+            (uint8_t) (sx - r->origin_x), (uint8_t) (sy - r->origin_y),
+            (uint8_t) (sz - r->origin_z), (uint8_t) (ex - r->origin_x),
+            (uint8_t) (ey - r->origin_y), (uint8_t) (ez - r->origin_z)));
+
+    /* Expand the cell with the lowest estimated cost until the end cell is
+     * reached or there's nothing left to expand. */
+    while (!id_heap_is_empty(r->open))
+    {
+        current = id_heap_pop_min(&r->open);
+        if (current == end)
+        {
+            break;
+        }
+        ring_grid_get_coords(r, current, &x, &y, &z);
+
+        /* Look at each neighbour in the window the graph style can move
+         * to. */
+        for (dir = 0; dir < GRAPH_NUM_DIRECTIONS; dir++)
+        {
+            graph_get_dir_offset(dir, &xoff, &yoff, &zoff);
+            if (r->gstyle == MANHATTAN
+                && (xoff != 0) + (yoff != 0) + (zoff != 0) > 1)
+            {
+                continue;
+            }
+            nx = x + xoff;
+            ny = y + yoff;
+            nz = z + zoff;
+            if (!ring_grid_contains(r, nx, ny, nz))
+            {
+                continue;
+            }
+            next = ring_grid_index(r, nx, ny, nz);
+            if (r->types[next] != PASSABLE)
+            {
+                continue;
+            }
+
+            /* Keep the neighbour's path if it's the cheapest found so
+             * far. */
+            g = r->g[current] + 1;
+            if (r->visit[next] == r->search && g >= r->g[next])
+            {
+                continue;
+            }
+            r->g[next] = g;
+            r->came_from[next] = current;
+            r->visit[next] = r->search;
+            id_heap_push(&r->open, next, g + astar_estimate_coords(
+                    r->gstyle, (uint8_t) (nx - r->origin_x),
+                    (uint8_t) (ny - r->origin_y),
+                    (uint8_t) (nz - r->origin_z),
+                    (uint8_t) (ex - r->origin_x),
+                    (uint8_t) (ey - r->origin_y),
+                    (uint8_t) (ez - r->origin_z)));
+        }
+    }
+
+    /* Follow the path back from the end cell, if it was reached, then put
+     * it in order. */
+    if (r->visit[end] != r->search)
+    {
+        return;
+    }
+    current = end;
+    r->path[r->path_size++] = current;
+    while (current != start)
+    {
+        current = r->came_from[current];
+        r->path[r->path_size++] = current;
+    }
+    for (i = 0; i < r->path_size / 2; i++)
+    {
+        current = r->path[i];
+        r->path[i] = r->path[r->path_size - 1 - i];
+        r->path[r->path_size - 1 - i] = current;
+    }
+}
+
+/**
+ * This function returns the places in the ring buffer of the cells that
+ * make up the path found by ring_grid_search(), from the start cell to the
+ * end cell.
+ */
+uint32_t* ring_grid_get_path(ring_grid r)
+{
+    return r->path;
+}
+
+/**
+ * This function returns the number of cells in the path found by
+ * ring_grid_search(). It is 0 if no path was found or the path has left the
+ * window.
+ */
+uint32_t ring_grid_get_path_size(ring_grid r)
+{
+    return r->path_size;
+}
+
+/**
+ * This function returns the number of times the window of the ring_grid
+ * provided to it has moved, so anything that keeps places in the ring
+ * buffer can tell when to check them again.
+ */
+uint32_t ring_grid_get_version(ring_grid r)
+{
+    return r->version;
+}
+
+/**
+ * This function returns the number of cells the ring_grid provided to it
+ * has loaded.
+ */
+uint64_t ring_grid_get_num_loaded(ring_grid r)
+{
+    return r->num_loaded;
+}
+
+/**
+ * This function returns the coordinate provided to it modulo the size also
+ * provided, which is never negative.
+ */
+uint32_t ring_grid_mod(int32_t a, uint8_t size)
+{
+    int32_t m;  /* The remainder. */
+
+    m = a % size;
+    return (uint32_t) (m < 0 ? m + size : m);
+}
+
+/**
+ * This function returns the place in the ring buffer of the ring_grid
+ * provided to it of the cell at the world coordinates also provided,
+ * without checking the cell is in the window.
+ */
+uint32_t ring_grid_index(ring_grid r, int32_t x, int32_t y, int32_t z)
+{
+    return (ring_grid_mod(x, r->x_size) * r->y_size
+            + ring_grid_mod(y, r->y_size)) * r->z_size
+         + ring_grid_mod(z, r->z_size);
+}
+
+/**
+ * This function loads the cells of the box of world coordinates provided
+ * to it, given by its lowest corner and its size on each axis, into the
+ * ring_grid also provided.
+ */
+void ring_grid_load(ring_grid* rp, int32_t x, int32_t y, int32_t z,
+                    uint32_t x_count, uint32_t y_count, uint32_t z_count)
+{
+    uint32_t i, j, k;   /* The current offsets into the box. */
+    ring_grid r;        /* The ring_grid. */
+
+    r = *rp;
+    for (i = 0; i < x_count; i++)
+    {
+        for (j = 0; j < y_count; j++)
+        {
+            for (k = 0; k < z_count; k++)
+            {
+                r->types[ring_grid_index(r, x + (int32_t) i,
+                                         y + (int32_t) j,
+                                         z + (int32_t) k)]
+                    = (uint8_t) r->load(r->context, x + (int32_t) i,
+                                        y + (int32_t) j, z + (int32_t) k);
+            }
+        }
+    }
+    r->num_loaded += (uint64_t) x_count * y_count * z_count;
+}
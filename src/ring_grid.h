@@ -0,0 +1,154 @@
+/**
+ * ring_grid.h
+ *
+ * This file contains the data-structure and function prototype declarations
+ * for the ring_grid type.
+ *
+ * The ring_grid type is a window onto a world too big to hold, which moves
+ * with the player. The window's cells are kept in a ring buffer that wraps
+ * around on every axis: the cell at world coordinates (x, y, z) is always
+ * kept at the place given by x, y and z modulo the window's size. When the
+ * window moves, the cells that leave it make room for exactly the cells that
+ * come into it, so only the newly exposed slabs of cells are loaded, with a
+ * function that gives the type of the cell at any world coordinates, and
+ * the cells that stay in the window don't move.
+ *
+ * Searches run over the cells in the window with A*, with the same moves
+ * and costs as a graph of the same style, and find paths of buffer places.
+ * A cell's place stays the same for as long as it's in the window, so a
+ * path found before the window moves is kept if all of its cells are still
+ * in the window, and is emptied if any of them have left.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#ifndef RING_GRID_H
+#define RING_GRID_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "node.h"
+#include "graph.h"
+#include "id_heap.h"
+#include "astar.h"
+
+/**
+ * This is the type of the function a ring_grid loads cells with. It returns
+ * the type of the cell at the world coordinates provided to it, and is also
+ * given the context the ring_grid was initialised with.
+ */
+typedef enum node_type (*ring_grid_loader)(void* context,
+                                           int32_t x, int32_t y, int32_t z);
+
+/**
+ * The data-structure of the ring_grid type.
+ */
+typedef struct ring_grid_data* ring_grid;
+
+/**
+ * This function initialises the ring_grid provided to it with a window of
+ * the sizes provided, whose lowest corner is at the world's origin, and
+ * loads every cell of it with the loader and context also provided.
+ */
+void ring_grid_init(ring_grid* rp, uint8_t x_size, uint8_t y_size,
+                    uint8_t z_size, enum graph_style gstyle,
+                    ring_grid_loader load, void* context);
+
+/**
+ * This function destroys the ring_grid provided to it.
+ */
+void ring_grid_free(ring_grid* rp);
+
+/**
+ * This function moves the window of the ring_grid provided to it so that
+ * its lowest corner is at the world coordinates also provided. Only the
+ * cells that come into the window are loaded, into the places of the cells
+ * that leave it. The path found by the last search is emptied if any of its
+ * cells leave the window.
+ */
+void ring_grid_move(ring_grid* rp, int32_t x, int32_t y, int32_t z);
+
+/**
+ * This function moves the window of the ring_grid provided to it so that
+ * the cell at the world coordinates also provided is at its centre.
+ */
+void ring_grid_recentre(ring_grid* rp, int32_t x, int32_t y, int32_t z);
+
+/**
+ * This function returns whether the cell at the world coordinates provided
+ * to it is in the window of the ring_grid also provided.
+ */
+bool ring_grid_contains(ring_grid r, int32_t x, int32_t y, int32_t z);
+
+/**
+ * This function returns the place in the ring buffer of the ring_grid
+ * provided to it of the cell at the world coordinates also provided, which
+ * must be in the window.
+ */
+uint32_t ring_grid_get_index(ring_grid r, int32_t x, int32_t y, int32_t z);
+
+/**
+ * This function gets the world coordinates of the cell at the place in the
+ * ring buffer provided to it, in the ring_grid also provided.
+ */
+void ring_grid_get_coords(ring_grid r, uint32_t index,
+                          int32_t* xp, int32_t* yp, int32_t* zp);
+
+/**
+ * This function returns the type of the cell at the world coordinates
+ * provided to it, which must be in the window of the ring_grid also
+ * provided.
+ */
+enum node_type ring_grid_get_type(ring_grid r, int32_t x, int32_t y,
+                                  int32_t z);
+
+/**
+ * This function changes the type of the cell at the world coordinates
+ * provided to it, which must be in the window of the ring_grid also
+ * provided, until it leaves the window.
+ */
+void ring_grid_set_type(ring_grid* rp, int32_t x, int32_t y, int32_t z,
+                        enum node_type type);
+
+/**
+ * This function searches for the shortest path between the cells at the
+ * world coordinates provided to it, both of which must be in the window of
+ * the ring_grid also provided, over the cells in the window.
+ */
+void ring_grid_search(ring_grid* rp, int32_t sx, int32_t sy, int32_t sz,
+                      int32_t ex, int32_t ey, int32_t ez);
+
+/**
+ * This function returns the places in the ring buffer of the cells that
+ * make up the path found by ring_grid_search(), from the start cell to the
+ * end cell.
+ */
+uint32_t* ring_grid_get_path(ring_grid r);
+
+/**
+ * This function returns the number of cells in the path found by
+ * ring_grid_search(). It is 0 if no path was found or the path has left the
+ * window.
+ */
+uint32_t ring_grid_get_path_size(ring_grid r);
+
+/**
+ * This function returns the number of times the window of the ring_grid
+ * provided to it has moved, so anything that keeps places in the ring
+ * buffer can tell when to check them again.
+ */
+uint32_t ring_grid_get_version(ring_grid r);
+
+/**
+ * This function returns the number of cells the ring_grid provided to it
+ * has loaded.
+ */
+uint64_t ring_grid_get_num_loaded(ring_grid r);
+
+#endif // RING_GRID_H
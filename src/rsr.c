@@ -0,0 +1,794 @@
+/**
+ * rsr.c
+ *
+ * This file contains the internal data-structure and function definitions
+ * for the rsr type.
+ *
+ * Each box is kept as its lowest and highest coordinate on each axis, three
+ * to a box, and each cell has the id of the box it's in. A cell is inside
+ * its box if it isn't on the box's lowest or highest coordinate on any axis
+ * the graph has more than one layer on. The ids of boxes that have been
+ * split up are kept in a list and reused.
+ *
+ * A macro edge is only a move from one cell of a box to another. When the
+ * path is put together, the cells between the two are filled in by walking
+ * straight across the box, which has no obstacles in it.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#include "rsr.h"
+
+/**
+ * This is the box of a cell that isn't in one.
+ */
+#define RSR_NO_BOX UINT32_MAX
+
+/**
+ * This is the internal data-structure of the rsr type.
+ */
+struct rsr_data {
+    graph* gp;              /* The graph the boxes split up. */
+    uint8_t size[3];        /* The width of the graph along each axis. */
+    uint8_t max_side;       /* The most cells wide a box can be. */
+
+    /* The boxes. */
+    uint32_t* box;          /* The box each cell is in. */
+    uint8_t* lo;            /* The lowest coordinates of each box. */
+    uint8_t* hi;            /* The highest coordinates of each box. */
+    uint32_t num_boxes;     /* The number of box ids used. */
+    uint32_t boxes_capacity; /* The number of boxes there's room for. */
+    uint32_t* spare;        /* The ids of boxes that can be reused. */
+    uint32_t num_spare;     /* The number of ids that can be reused. */
+    uint32_t* cells;        /* The cells of the boxes being split again. */
+    uint32_t num_cells;     /* The number of those cells. */
+
+    /* The state of the search. */
+    id_heap open;           /* The cells waiting to be expanded, by f. */
+    uint32_t* g;            /* The cost of the path to each cell. */
+    uint32_t* came_from;    /* The cell each cell's path came from. */
+    uint32_t* visit;        /* The search each cell was last reached by. */
+    uint32_t search;        /* The number of the current search. */
+    uint32_t end;           /* The end cell of the current search. */
+    uint32_t end_c[3];      /* The coordinates of the end cell. */
+    bool end_inside;        /* Whether the end cell is inside its box. */
+    uint32_t num_expanded;  /* The number of cells expanded. */
+
+    /* The path that was found. */
+    uint32_t* path;         /* The cells of the path. */
+    uint32_t path_size;     /* The number of cells in the path. */
+    uint32_t cost;          /* The cost of the path. */
+};
+
+/**
+ * This function returns whether the cell at the coordinates provided to it
+ * is passable and not yet in a box.
+ */
+bool rsr_is_free(rsr r, const uint32_t* c);
+
+/**
+ * This function grows a new box from the cell at the coordinates provided
+ * to it, as far as it will go along x, then y, then z.
+ */
+void rsr_grow_box(rsr* rp, const uint32_t* c);
+
+/**
+ * This function splits the cells gathered in the rsr provided to it into
+ * boxes, in order along z, then y, then x.
+ */
+void rsr_split_cells(rsr* rp);
+
+/**
+ * This function splits up the box provided to it, gathering its cells to
+ * be split into boxes again.
+ */
+void rsr_dissolve(rsr* rp, uint32_t b);
+
+/**
+ * This function returns whether the cell provided to it, at the coordinates
+ * also provided, is inside its box.
+ */
+bool rsr_is_inside(rsr r, uint32_t id, const uint32_t* c);
+
+/**
+ * This function assesses every cell the cell provided to it can move to,
+ * by its own edges or by macro edges across its box.
+ */
+void rsr_expand(rsr* rp, uint32_t current);
+
+/**
+ * This function assesses a macro edge with the cost provided to it from
+ * the current cell to the cell at the coordinates also provided.
+ */
+void rsr_relax_coords(rsr* rp, uint32_t current, const uint32_t* c,
+                      uint32_t w);
+
+/**
+ * This function records the path to the cell provided to it, at the
+ * coordinates also provided, through the current cell, if it's better than
+ * any path found to it before.
+ */
+void rsr_relax(rsr* rp, uint32_t current, uint32_t n, const uint32_t* c,
+               uint32_t w);
+
+/**
+ * This function reconstructs the path that ends at the end cell, filling
+ * in the cells each macro edge crosses.
+ */
+void rsr_reconstruct_path(rsr* rp);
+
+/**
+ * This function compares the two cells provided to it by their order along
+ * z, then y, then x, for qsort().
+ */
+int rsr_compare_cells(const void* a, const void* b);
+
+/**
+ * This function initialises the rsr provided to it by splitting the
+ * passable cells of the graph also provided into boxes.
+ */
+void rsr_init(rsr* rp, graph* gp)
+{
+    uint32_t count;     /* The number of cells in the graph. */
+    uint32_t c[3];      /* The coordinates of the current cell. */
+
+    /* Allocate memory to the rsr. */
+    *rp = (rsr) malloc(sizeof(struct rsr_data));
+    (*rp)->gp = gp;
+    (*rp)->size[0] = graph_get_x_size(*gp);
+    (*rp)->size[1] = graph_get_y_size(*gp);
+    (*rp)->size[2] = graph_get_z_size(*gp);
+    (*rp)->max_side = graph_get_style(*gp) == MANHATTAN ? UINT8_MAX
+                    : graph_get_z_size(*gp) == 1 ? RSR_DIAGONAL_MAX_SIDE : 1;
+
+    /* No cell is in a box yet. */
+    count = graph_get_cell_count(*gp);
+    (*rp)->box = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    memset((*rp)->box, 0xFF, sizeof(uint32_t) * count);
+    (*rp)->boxes_capacity = 64;
+    (*rp)->lo = (uint8_t*) malloc(sizeof(uint8_t) * 3 * 64);
+    (*rp)->hi = (uint8_t*) malloc(sizeof(uint8_t) * 3 * 64);
+    (*rp)->num_boxes = 0;
+    (*rp)->spare = (uint32_t*) malloc(sizeof(uint32_t) * 64);
+    (*rp)->num_spare = 0;
+    (*rp)->cells = (uint32_t*) malloc(sizeof(uint32_t) * (count + 1));
+    (*rp)->num_cells = 0;
+
+    /* Grow a box from every passable cell that isn't in one yet, in order
+     * along z, then y, then x. */
+    for (c[2] = 0; c[2] < (*rp)->size[2]; c[2]++)
+    {
+        for (c[1] = 0; c[1] < (*rp)->size[1]; c[1]++)
+        {
+            for (c[0] = 0; c[0] < (*rp)->size[0]; c[0]++)
+            {
+                if (rsr_is_free(*rp, c))
+                {
+                    rsr_grow_box(rp, c);
+                }
+            }
+        }
+    }
+
+    /* Initialise the state of the search. */
+    id_heap_init(&(*rp)->open, count);
+    (*rp)->g = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*rp)->came_from = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*rp)->visit = (uint32_t*) calloc(count, sizeof(uint32_t));
+    (*rp)->search = 0;
+    (*rp)->num_expanded = 0;
+    (*rp)->path = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*rp)->path_size = 0;
+    (*rp)->cost = UINT32_MAX;
+}
+
+/**
+ * This function destroys the rsr provided to it.
+ */
+void rsr_free(rsr* rp)
+{
+    /* De-allocate memory from the boxes. */
+    free((*rp)->box);
+    free((*rp)->lo);
+    free((*rp)->hi);
+    free((*rp)->spare);
+    free((*rp)->cells);
+
+    /* De-allocate memory from the search. */
+    id_heap_free(&(*rp)->open);
+    free((*rp)->g);
+    free((*rp)->came_from);
+    free((*rp)->visit);
+    free((*rp)->path);
+
+    /* De-allocate memory from the rsr. */
+    free(*rp);
+}
+
+/**
+ * This function brings the boxes of the rsr provided to it up to date with
+ * the type of the cell with the id also provided, after it has been
+ * changed.
+ */
+void rsr_update(rsr* rp, uint32_t id)
+{
+    uint8_t x, y, z;    /* The cell's coordinates. */
+    uint32_t c[3];      /* The coordinates of the current cell. */
+    uint32_t n;         /* The current neighbour. */
+    uint8_t axis;       /* The axis the neighbour is along. */
+    uint8_t side;       /* Whether the neighbour is on the high side. */
+
+    /* Split up the cell's box and the boxes next to it, so the cell can
+     * join them or leave them. */
+    (*rp)->num_cells = 0;
+    if ((*rp)->box[id] != RSR_NO_BOX)
+    {
+        rsr_dissolve(rp, (*rp)->box[id]);
+    }
+    graph_get_cell_coords(*(*rp)->gp, id, &x, &y, &z);
+    for (axis = 0; axis < 3; axis++)
+    {
+        for (side = 0; side < 2; side++)
+        {
+            /* Find the neighbour on that side, if there is one. */
+            c[0] = x;
+            c[1] = y;
+            c[2] = z;
+            if (side == 0 ? c[axis] == 0 : c[axis] + 1 >= (*rp)->size[axis])
+            {
+                continue;
+            }
+            c[axis] = side == 0 ? c[axis] - 1 : c[axis] + 1;
+            n = graph_get_cell_id(*(*rp)->gp, (uint8_t) c[0],
+                                  (uint8_t) c[1], (uint8_t) c[2]);
+            if ((*rp)->box[n] != RSR_NO_BOX)
+            {
+                rsr_dissolve(rp, (*rp)->box[n]);
+            }
+        }
+    }
+
+    /* Split the cells into boxes again, with the cell if it's passable. */
+    (*rp)->cells[(*rp)->num_cells] = id;
+    (*rp)->num_cells++;
+    rsr_split_cells(rp);
+}
+
+/**
+ * This function searches for the shortest path from the start cell to the
+ * end cell, only expanding the cells on the faces of the boxes.
+ */
+void rsr_search(rsr* rp, uint32_t start, uint32_t end)
+{
+    graph g;            /* The graph. */
+    uint32_t current;   /* The cell being expanded. */
+    uint8_t x, y, z;    /* The end cell's coordinates. */
+
+    /* Make sure the graph's index of edges is up to date. */
+    graph_update_index((*rp)->gp);
+    g = *(*rp)->gp;
+
+    /* Start a new search. */
+    (*rp)->search++;
+    if ((*rp)->search == 0)
+    {
+        memset((*rp)->visit, 0, sizeof(uint32_t) * graph_get_cell_count(g));
+        (*rp)->search = 1;
+    }
+    id_heap_clear(&(*rp)->open);
+    (*rp)->path_size = 0;
+    (*rp)->cost = UINT32_MAX;
+    (*rp)->num_expanded = 0;
+    (*rp)->end = end;
+    graph_get_cell_coords(g, end, &x, &y, &z);
+    (*rp)->end_c[0] = x;
+    (*rp)->end_c[1] = y;
+    (*rp)->end_c[2] = z;
+    (*rp)->end_inside = rsr_is_inside(*rp, end, (*rp)->end_c);
+
+    /* Add the start cell to the priority queue. */
+    (*rp)->visit[start] = (*rp)->search;
+    (*rp)->g[start] = 0;
+    (*rp)->came_from[start] = GRAPH_NO_CELL;
+    id_heap_push(&(*rp)->open, start, astar_estimate(g, start, end));
+
+    /* Expand the most promising cell until the end cell comes up. */
+    while (!id_heap_is_empty((*rp)->open))
+    {
+        current = id_heap_pop_min(&(*rp)->open);
+        if (current == end)
+        {
+            rsr_reconstruct_path(rp);
+            return;
+        }
+        (*rp)->num_expanded++;
+        rsr_expand(rp, current);
+    }
+}
+
+/**
+ * This function returns the ids of the cells that make up the shortest path
+ * found by rsr_search(), from the start cell to the end cell.
+ */
+uint32_t* rsr_get_path(rsr r)
+{
+    return r->path;
+}
+
+/**
+ * This function returns the number of cells in the path found by
+ * rsr_search(). It is 0 if no path was found.
+ */
+uint32_t rsr_get_path_size(rsr r)
+{
+    return r->path_size;
+}
+
+/**
+ * This function returns the cost of the path found by rsr_search(), or
+ * UINT32_MAX if no path was found.
+ */
+uint32_t rsr_get_cost(rsr r)
+{
+    return r->cost;
+}
+
+/**
+ * This function returns the number of cells rsr_search() expanded.
+ */
+uint32_t rsr_get_num_expanded(rsr r)
+{
+    return r->num_expanded;
+}
+
+/**
+ * This function returns the number of boxes the rsr provided to it has
+ * split the graph's passable cells into.
+ */
+uint32_t rsr_get_num_boxes(rsr r)
+{
+    return r->num_boxes - r->num_spare;
+}
+
+/**
+ * This function returns whether the cell at the coordinates provided to it
+ * is passable and not yet in a box.
+ */
+bool rsr_is_free(rsr r, const uint32_t* c)
+{
+    uint32_t id;    /* The cell's id. */
+
+    id = graph_get_cell_id(*r->gp, (uint8_t) c[0], (uint8_t) c[1],
+                           (uint8_t) c[2]);
+    return graph_cell_exists(*r->gp, id) && r->box[id] == RSR_NO_BOX
+           && node_get_type(*graph_get_cell_node(*r->gp, id)) == PASSABLE;
+}
+
+/**
+ * This function grows a new box from the cell at the coordinates provided
+ * to it, as far as it will go along x, then y, then z.
+ */
+void rsr_grow_box(rsr* rp, const uint32_t* c)
+{
+    uint32_t lo[3];     /* The lowest coordinates of the box. */
+    uint32_t hi[3];     /* The highest coordinates of the box. */
+    uint32_t p[3];      /* The coordinates of the current cell. */
+    uint32_t b;         /* The id of the box. */
+    uint8_t axis;       /* The axis being grown along. */
+    uint8_t a1, a2;     /* The other two axes. */
+    bool grow;          /* Whether the next layer is free. */
+
+    /* Start with the cell on its own. */
+    for (axis = 0; axis < 3; axis++)
+    {
+        lo[axis] = c[axis];
+        hi[axis] = c[axis];
+    }
+
+    /* Add layers along each axis in turn while the whole layer is free. */
+    for (axis = 0; axis < 3; axis++)
+    {
+        a1 = (axis + 1) % 3;
+        a2 = (axis + 2) % 3;
+        grow = true;
+        while (grow && hi[axis] + 1 < (*rp)->size[axis]
+               && hi[axis] - lo[axis] + 1 < (*rp)->max_side)
+        {
+            p[axis] = hi[axis] + 1;
+            for (p[a1] = lo[a1]; grow && p[a1] <= hi[a1]; p[a1]++)
+            {
+                for (p[a2] = lo[a2]; grow && p[a2] <= hi[a2]; p[a2]++)
+                {
+                    grow = rsr_is_free(*rp, p);
+                }
+            }
+            if (grow)
+            {
+                hi[axis]++;
+            }
+        }
+    }
+
+    /* Take a box id, reusing one if there is one. */
+    if ((*rp)->num_spare > 0)
+    {
+        (*rp)->num_spare--;
+        b = (*rp)->spare[(*rp)->num_spare];
+    }
+    else
+    {
+        if ((*rp)->num_boxes == (*rp)->boxes_capacity)
+        {
+            (*rp)->boxes_capacity *= 2;
+            (*rp)->lo = (uint8_t*) realloc((*rp)->lo,
+                    sizeof(uint8_t) * 3 * (*rp)->boxes_capacity);
+            (*rp)->hi = (uint8_t*) realloc((*rp)->hi,
+                    sizeof(uint8_t) * 3 * (*rp)->boxes_capacity);
+            (*rp)->spare = (uint32_t*) realloc((*rp)->spare,
+                    sizeof(uint32_t) * (*rp)->boxes_capacity);
+        }
+        b = (*rp)->num_boxes;
+        (*rp)->num_boxes++;
+    }
+
+    /* Record the box and put its cells in it. */
+    for (axis = 0; axis < 3; axis++)
+    {
+        (*rp)->lo[3 * b + axis] = (uint8_t) lo[axis];
+        (*rp)->hi[3 * b + axis] = (uint8_t) hi[axis];
+    }
+    for (p[2] = lo[2]; p[2] <= hi[2]; p[2]++)
+    {
+        for (p[1] = lo[1]; p[1] <= hi[1]; p[1]++)
+        {
+            for (p[0] = lo[0]; p[0] <= hi[0]; p[0]++)
+            {
+                (*rp)->box[graph_get_cell_id(*(*rp)->gp, (uint8_t) p[0],
+                                             (uint8_t) p[1],
+                                             (uint8_t) p[2])] = b;
+            }
+        }
+    }
+}
+
+/**
+ * This function splits the cells gathered in the rsr provided to it into
+ * boxes, in order along z, then y, then x.
+ */
+void rsr_split_cells(rsr* rp)
+{
+    uint32_t i;         /* The index of the current cell. */
+    uint32_t c[3];      /* The coordinates of the current cell. */
+    uint8_t x, y, z;    /* The coordinates as the graph gives them. */
+
+    /* Put the cells in the same order the boxes were first grown in, as
+     * keys of their coordinates. */
+    for (i = 0; i < (*rp)->num_cells; i++)
+    {
+        graph_get_cell_coords(*(*rp)->gp, (*rp)->cells[i], &x, &y, &z);
+        (*rp)->cells[i] = ((uint32_t) z << 16) | ((uint32_t) y << 8) | x;
+    }
+    qsort((*rp)->cells, (*rp)->num_cells, sizeof(uint32_t),
+          rsr_compare_cells);
+
+    /* Grow a box from each cell that isn't in one yet. */
+    for (i = 0; i < (*rp)->num_cells; i++)
+    {
+        c[0] = (*rp)->cells[i] & 0xFF;
+        c[1] = ((*rp)->cells[i] >> 8) & 0xFF;
+        c[2] = (*rp)->cells[i] >> 16;
+        if (rsr_is_free(*rp, c))
+        {
+            rsr_grow_box(rp, c);
+        }
+    }
+    (*rp)->num_cells = 0;
+}
+
+/**
+ * This function splits up the box provided to it, gathering its cells to
+ * be split into boxes again.
+ */
+void rsr_dissolve(rsr* rp, uint32_t b)
+{
+    uint32_t p[3];  /* The coordinates of the current cell. */
+    uint32_t id;    /* The id of the current cell. */
+
+    /* Take each cell out of the box and gather it. */
+    for (p[2] = (*rp)->lo[3 * b + 2]; p[2] <= (*rp)->hi[3 * b + 2]; p[2]++)
+    {
+        for (p[1] = (*rp)->lo[3 * b + 1]; p[1] <= (*rp)->hi[3 * b + 1];
+             p[1]++)
+        {
+            for (p[0] = (*rp)->lo[3 * b]; p[0] <= (*rp)->hi[3 * b]; p[0]++)
+            {
+                id = graph_get_cell_id(*(*rp)->gp, (uint8_t) p[0],
+                                       (uint8_t) p[1], (uint8_t) p[2]);
+                (*rp)->box[id] = RSR_NO_BOX;
+                (*rp)->cells[(*rp)->num_cells] = id;
+                (*rp)->num_cells++;
+            }
+        }
+    }
+
+    /* Keep the box's id for reuse. */
+    (*rp)->spare[(*rp)->num_spare] = b;
+    (*rp)->num_spare++;
+}
+
+/**
+ * This function returns whether the cell provided to it, at the coordinates
+ * also provided, is inside its box.
+ */
+bool rsr_is_inside(rsr r, uint32_t id, const uint32_t* c)
+{
+    uint32_t b;     /* The cell's box. */
+    uint8_t axis;   /* The current axis. */
+
+    /* A cell that isn't in a box isn't inside one. */
+    b = r->box[id];
+    if (b == RSR_NO_BOX)
+    {
+        return false;
+    }
+
+    /* A cell on the lowest or highest coordinate of any axis that has more
+     * than one layer is on one of the box's faces. */
+    for (axis = 0; axis < 3; axis++)
+    {
+        if (r->size[axis] > 1 && (c[axis] == r->lo[3 * b + axis]
+                                  || c[axis] == r->hi[3 * b + axis]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * This function assesses every cell the cell provided to it can move to,
+ * by its own edges or by macro edges across its box.
+ */
+void rsr_expand(rsr* rp, uint32_t current)
+{
+    graph g;            /* The graph. */
+    uint32_t b;         /* The current cell's box. */
+    uint8_t x, y, z;    /* The coordinates as the graph gives them. */
+    uint32_t c[3];      /* The current cell's coordinates. */
+    uint32_t p[3];      /* The coordinates of another cell. */
+    uint32_t e;         /* The edge leading to the neighbour. */
+    uint32_t last;      /* The end of the cell's edges. */
+    uint32_t n;         /* The neighbour. */
+    uint32_t d;         /* The distance to a face. */
+    uint32_t from[3];   /* The lowest coordinates of the cone on a face. */
+    uint32_t to[3];     /* The highest coordinates of the cone on a face. */
+    bool inside;        /* Whether the current cell is inside its box. */
+    uint8_t axis;       /* The current axis. */
+    uint8_t a1, a2;     /* The other two axes. */
+    uint8_t side;       /* Whether the face is on the high side. */
+    uint8_t w;          /* The cost of moving to the neighbour. */
+
+    /* Assess the cell's own edges, except to cells inside a box. */
+    g = *(*rp)->gp;
+    last = graph_get_first_edge(g, current + 1);
+    for (e = graph_get_first_edge(g, current); e < last; e++)
+    {
+        w = graph_get_edge_w(g, e);
+        if (w == 0)
+        {
+            continue;
+        }
+        n = graph_get_edge_to(g, e);
+        graph_get_cell_coords(g, n, &x, &y, &z);
+        p[0] = x;
+        p[1] = y;
+        p[2] = z;
+        if (n == (*rp)->end || !rsr_is_inside(*rp, n, p))
+        {
+            rsr_relax(rp, current, n, p, w);
+        }
+    }
+
+    /* Cells that aren't in a box have no macro edges. */
+    b = (*rp)->box[current];
+    if (b == RSR_NO_BOX)
+    {
+        return;
+    }
+    graph_get_cell_coords(g, current, &x, &y, &z);
+    c[0] = x;
+    c[1] = y;
+    c[2] = z;
+    inside = rsr_is_inside(*rp, current, c);
+
+    /* Assess the macro edges across the box to each face. */
+    for (axis = 0; axis < 3; axis++)
+    {
+        if ((*rp)->size[axis] == 1)
+        {
+            continue;
+        }
+        a1 = (axis + 1) % 3;
+        a2 = (axis + 2) % 3;
+        for (side = 0; side < 2; side++)
+        {
+            /* Skip the faces the cell is on. It can walk along them. */
+            p[axis] = side == 0 ? (*rp)->lo[3 * b + axis]
+                                : (*rp)->hi[3 * b + axis];
+            if (p[axis] == c[axis])
+            {
+                continue;
+            }
+            d = p[axis] > c[axis] ? p[axis] - c[axis] : c[axis] - p[axis];
+
+            /* On a MANHATTAN graph the edge goes straight across, from the
+             * opposite face or from inside the box. */
+            if (graph_get_style(g) == MANHATTAN)
+            {
+                if (inside || c[axis] == (*rp)->lo[3 * b + axis]
+                           || c[axis] == (*rp)->hi[3 * b + axis])
+                {
+                    p[a1] = c[a1];
+                    p[a2] = c[a2];
+                    rsr_relax_coords(rp, current, p, d);
+                }
+                continue;
+            }
+
+            /* Otherwise there's an edge to every cell of the face no
+             * further along the face than the face is away, all costing
+             * that distance. Any other cell of the face costs as much to
+             * reach through the nearest of them. */
+            from[a1] = c[a1] > (*rp)->lo[3 * b + a1] + d
+                     ? c[a1] - d : (*rp)->lo[3 * b + a1];
+            to[a1] = c[a1] + d < (*rp)->hi[3 * b + a1]
+                   ? c[a1] + d : (*rp)->hi[3 * b + a1];
+            from[a2] = c[a2] > (*rp)->lo[3 * b + a2] + d
+                     ? c[a2] - d : (*rp)->lo[3 * b + a2];
+            to[a2] = c[a2] + d < (*rp)->hi[3 * b + a2]
+                   ? c[a2] + d : (*rp)->hi[3 * b + a2];
+            for (p[a1] = from[a1]; p[a1] <= to[a1]; p[a1]++)
+            {
+                for (p[a2] = from[a2]; p[a2] <= to[a2]; p[a2]++)
+                {
+                    rsr_relax_coords(rp, current, p, d);
+                }
+            }
+        }
+    }
+
+    /* An end cell inside the box is joined to it for this search. */
+    if ((*rp)->end_inside && (*rp)->box[(*rp)->end] == b)
+    {
+        rsr_relax(rp, current, (*rp)->end, (*rp)->end_c,
+                  astar_estimate_coords(graph_get_style(g), x, y, z,
+                                        (uint8_t) (*rp)->end_c[0],
+                                        (uint8_t) (*rp)->end_c[1],
+                                        (uint8_t) (*rp)->end_c[2]));
+    }
+}
+
+/**
+ * This function assesses a macro edge with the cost provided to it from
+ * the current cell to the cell at the coordinates also provided.
+ */
+void rsr_relax_coords(rsr* rp, uint32_t current, const uint32_t* c,
+                      uint32_t w)
+{
+    rsr_relax(rp, current,
+              graph_get_cell_id(*(*rp)->gp, (uint8_t) c[0], (uint8_t) c[1],
+                                (uint8_t) c[2]), c, w);
+}
+
+/**
+ * This function records the path to the cell provided to it, at the
+ * coordinates also provided, through the current cell, if it's better than
+ * any path found to it before.
+ */
+void rsr_relax(rsr* rp, uint32_t current, uint32_t n, const uint32_t* c,
+               uint32_t w)
+{
+    uint32_t next_g;    /* The cost of the path through the current cell. */
+
+    next_g = (*rp)->g[current] + w;
+    if ((*rp)->visit[n] != (*rp)->search || next_g < (*rp)->g[n])
+    {
+        (*rp)->visit[n] = (*rp)->search;
+        (*rp)->g[n] = next_g;
+        (*rp)->came_from[n] = current;
+        id_heap_push(&(*rp)->open, n, next_g
+                     + astar_estimate_coords(graph_get_style(*(*rp)->gp),
+                                             (uint8_t) c[0], (uint8_t) c[1],
+                                             (uint8_t) c[2],
+                                             (uint8_t) (*rp)->end_c[0],
+                                             (uint8_t) (*rp)->end_c[1],
+                                             (uint8_t) (*rp)->end_c[2]));
+    }
+}
+
+/**
+ * This function reconstructs the path that ends at the end cell, filling
+ * in the cells each macro edge crosses.
+ */
+void rsr_reconstruct_path(rsr* rp)
+{
+    graph g;            /* The graph. */
+    uint32_t size;      /* The number of cells the search's path has. */
+    uint32_t current;   /* The current cell of the search's path. */
+    uint32_t from;      /* The cell a move starts from. */
+    uint32_t to;        /* The cell the move ends at. */
+    uint8_t x, y, z;    /* The coordinates of the walk's current cell. */
+    uint8_t tx, ty, tz; /* The coordinates the walk ends at. */
+    bool diagonal;      /* Whether the axes can be moved along at once. */
+    bool moved;         /* Whether the current step has moved yet. */
+    uint32_t i;         /* The index of the current move. */
+
+    /* Follow the search's path back from the end, keeping it at the back
+     * of the path array, which is long enough for the whole path. */
+    g = *(*rp)->gp;
+    size = 0;
+    for (current = (*rp)->end; current != GRAPH_NO_CELL;
+         current = (*rp)->came_from[current])
+    {
+        size++;
+        (*rp)->path[graph_get_cell_count(g) - size] = current;
+    }
+
+    /* Copy each move to the front, walking straight across the box for a
+     * macro edge. A walk can't catch up with the cells still to be read,
+     * as the whole path fits in the array. */
+    diagonal = graph_get_style(g) != MANHATTAN;
+    (*rp)->path[0] = (*rp)->path[graph_get_cell_count(g) - size];
+    (*rp)->path_size = 1;
+    for (i = size - 1; i > 0; i--)
+    {
+        from = (*rp)->path[(*rp)->path_size - 1];
+        to = (*rp)->path[graph_get_cell_count(g) - i];
+        if ((*rp)->box[from] == RSR_NO_BOX
+            || (*rp)->box[from] != (*rp)->box[to])
+        {
+            (*rp)->path[(*rp)->path_size] = to;
+            (*rp)->path_size++;
+            continue;
+        }
+        graph_get_cell_coords(g, from, &x, &y, &z);
+        graph_get_cell_coords(g, to, &tx, &ty, &tz);
+        while (x != tx || y != ty || z != tz)
+        {
+            moved = false;
+            if (x != tx)
+            {
+                x = x < tx ? x + 1 : x - 1;
+                moved = true;
+            }
+            if ((diagonal || !moved) && y != ty)
+            {
+                y = y < ty ? y + 1 : y - 1;
+                moved = true;
+            }
+            if ((diagonal || !moved) && z != tz)
+            {
+                z = z < tz ? z + 1 : z - 1;
+            }
+            (*rp)->path[(*rp)->path_size] = graph_get_cell_id(g, x, y, z);
+            (*rp)->path_size++;
+        }
+    }
+    (*rp)->cost = (*rp)->g[(*rp)->end];
+}
+
+/**
+ * This function compares the two cells provided to it by their order along
+ * z, then y, then x, for qsort().
+ */
+int rsr_compare_cells(const void* a, const void* b)
+{
+    uint32_t ka;    /* The first cell's key. */
+    uint32_t kb;    /* The second cell's key. */
+
+    ka = *(const uint32_t*) a;
+    kb = *(const uint32_t*) b;
+    return ka < kb ? -1 : ka > kb ? 1 : 0;
+}
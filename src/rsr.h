@@ -0,0 +1,108 @@
+/**
+ * rsr.h
+ *
+ * This file contains the data-structure and function prototype declarations
+ * for the rsr type.
+ *
+ * The rsr type is Rectangular Symmetry Reduction. The passable cells of a
+ * graph are split into boxes with no obstacles in them, each grown as far
+ * as it will go along x, then y, then z. The cells inside a box are never
+ * expanded. Only the cells on its faces are, and they get macro edges
+ * straight across the box to the opposite face. On a DIAGONAL graph, where
+ * the cheapest way across a box can be at an angle, a face cell's macro
+ * edges go to every cell of each other face that's no further along it than
+ * the face is away, so the boxes of a flat DIAGONAL graph are kept to at
+ * most RSR_DIAGONAL_MAX_SIDE cells wide. On a DIAGONAL graph with more than
+ * one layer the faces are too big for that to pay off, so every cell is a
+ * box of its own and the search is the same as A*.
+ *
+ * A start or end cell inside a box is joined to the cells of its box's
+ * faces for that search only. The paths found are as short as A*'s, as long
+ * as every move on the grid costs 1, and the macro edges are unpacked back
+ * into single moves.
+ *
+ * When a cell's type changes, rsr_update() splits up only the boxes next to
+ * it and splits their cells into boxes again.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#ifndef RSR_H
+#define RSR_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "graph.h"
+#include "id_heap.h"
+#include "astar.h"
+
+/**
+ * This is the most cells wide a box of a flat DIAGONAL graph can be.
+ */
+#define RSR_DIAGONAL_MAX_SIDE 64
+
+/**
+ * The data-structure of the rsr type.
+ */
+typedef struct rsr_data* rsr;
+
+/**
+ * This function initialises the rsr provided to it by splitting the
+ * passable cells of the graph also provided into boxes.
+ */
+void rsr_init(rsr* rp, graph* gp);
+
+/**
+ * This function destroys the rsr provided to it.
+ */
+void rsr_free(rsr* rp);
+
+/**
+ * This function brings the boxes of the rsr provided to it up to date with
+ * the type of the cell with the id also provided, after it has been
+ * changed.
+ */
+void rsr_update(rsr* rp, uint32_t id);
+
+/**
+ * This function searches for the shortest path from the start cell to the
+ * end cell, only expanding the cells on the faces of the boxes.
+ */
+void rsr_search(rsr* rp, uint32_t start, uint32_t end);
+
+/**
+ * This function returns the ids of the cells that make up the shortest path
+ * found by rsr_search(), from the start cell to the end cell.
+ */
+uint32_t* rsr_get_path(rsr r);
+
+/**
+ * This function returns the number of cells in the path found by
+ * rsr_search(). It is 0 if no path was found.
+ */
+uint32_t rsr_get_path_size(rsr r);
+
+/**
+ * This function returns the cost of the path found by rsr_search(), or
+ * UINT32_MAX if no path was found.
+ */
+uint32_t rsr_get_cost(rsr r);
+
+/**
+ * This function returns the number of cells rsr_search() expanded.
+ */
+uint32_t rsr_get_num_expanded(rsr r);
+
+/**
+ * This function returns the number of boxes the rsr provided to it has
+ * split the graph's passable cells into.
+ */
+uint32_t rsr_get_num_boxes(rsr r);
+
+#endif // RSR_H
@@ -0,0 +1,558 @@
+/**
+ * sma.c
+ *
+ * This file contains the internal data-structure and function definitions
+ * for the sma type.
+ *
+ * Each cell has the cost of the path to it, the cell its path came from,
+ * its estimated total cost and the lowest estimate of the children it has
+ * had pruned. Two heaps are kept over the open set: one lowest estimate
+ * first, to pick the cell to expand, and one highest estimate first, to
+ * pick the entry to prune when the open set is full.
+ *
+ * A pruned entry's estimate is backed up to its parent. If the parent has
+ * been expanded, it goes back in the open set with the lowest estimate of
+ * its pruned children, and expanding it again regenerates the children with
+ * that estimate. If there's no room for the parent either, it's pruned too
+ * and the estimate is backed up to its own parent, and so on. Every part of
+ * the graph that has been pruned is still stood for by an estimate in the
+ * open set, unless it reached the start cell, which is what makes the
+ * first path to the end cell taken from the open set the shortest one.
+ *
+ * An entry is only pruned to make room for one with a lower estimate, and
+ * the estimates taken from the open set never go down, so no entry can be
+ * pruned and regenerated forever and the search always ends.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#include "sma.h"
+
+/**
+ * This is the estimate of a cell that has no pruned children.
+ */
+#define SMA_INFINITY UINT32_MAX
+
+/**
+ * These are the states a cell reached by the search can be in.
+ */
+#define SMA_OPEN 0
+#define SMA_CLOSED 1
+#define SMA_PRUNED 2
+
+/**
+ * This is the internal data-structure of the sma type.
+ */
+struct sma_data {
+    graph* gp;              /* The graph to search. */
+    uint32_t capacity;      /* The most entries in the open set. */
+    uint32_t* g;            /* The cost of the path to each cell. */
+    uint32_t* came_from;    /* The cell each cell's path came from. */
+    uint32_t* f;            /* The estimated total cost of each cell. */
+    uint32_t* forgotten;    /* The lowest estimate of pruned children. */
+    uint32_t* visit;        /* The search each cell was last reached by. */
+    uint8_t* state;         /* The state of each cell. */
+    bool* expanded;         /* Whether each cell has been expanded. */
+    uint32_t search;        /* The number of the current search. */
+    id_heap open;           /* The open set, lowest estimate first. */
+    id_heap worst;          /* The open set, highest estimate first. */
+    uint32_t peak_size;     /* The most entries the open set has held. */
+    uint32_t expanding;     /* The cell being expanded. */
+    uint32_t end;           /* The end cell. */
+    uint32_t cut;           /* The lowest estimate dropped for lack of room. */
+    uint32_t* path;         /* The path that was found. */
+    uint32_t path_size;     /* The number of cells in the path. */
+    uint32_t cost;          /* The cost of the path. */
+};
+
+/**
+ * This function expands the cell provided to it.
+ */
+void sma_expand(sma* sp, uint32_t current);
+
+/**
+ * This function assesses the neighbour of the cell being expanded that the
+ * path provided to it leads to. Pruned neighbours are only regenerated if
+ * their estimate is no higher than the threshold also provided.
+ */
+void sma_generate(sma* sp, uint32_t current, uint32_t neighbour, uint32_t g,
+                  uint32_t threshold);
+
+/**
+ * This function puts the cell provided to it in the open set with the
+ * estimate also provided. If the open set is full, the entry with the
+ * highest estimate is pruned to make room, but only if its estimate is
+ * higher. It returns false if there was no room.
+ */
+bool sma_insert(sma* sp, uint32_t id, uint32_t f);
+
+/**
+ * This function prunes the cell provided to it from the open set.
+ */
+void sma_prune(sma* sp, uint32_t id);
+
+/**
+ * This function backs the estimate provided to it up from the pruned cell
+ * also provided to its parent, and on up the path while there's no room
+ * for the parent in the open set.
+ */
+void sma_back_up(sma* sp, uint32_t id, uint32_t f);
+
+/**
+ * This function reconstructs the path that ends at the cell provided to it.
+ */
+void sma_reconstruct_path(sma* sp, uint32_t current);
+
+/**
+ * This function initialises the sma provided to it to search the graph also
+ * provided to the function, keeping at most the number of entries also
+ * provided in its open set. It needs room for at least one entry.
+ */
+void sma_init(sma* sp, graph* gp, uint32_t capacity)
+{
+    /* Check there's room for an entry. */
+    if (capacity == 0)
+    {
+        fprintf(stdout,
+                "\nERROR: In function sma_init(): an sma needs room for at "
+                "least one entry!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Allocate memory to the sma. */
+    *sp = (sma) malloc(sizeof(struct sma_data));
+
+    /* Initialise the state of each cell. */
+    (*sp)->gp = gp;
+    (*sp)->capacity = capacity;
+    (*sp)->g = (uint32_t*) malloc(sizeof(uint32_t) * graph_get_cell_count(*gp));
+    (*sp)->came_from = (uint32_t*) malloc(
+            sizeof(uint32_t) * graph_get_cell_count(*gp));
+    (*sp)->f = (uint32_t*) malloc(sizeof(uint32_t) * graph_get_cell_count(*gp));
+    (*sp)->forgotten = (uint32_t*) malloc(
+            sizeof(uint32_t) * graph_get_cell_count(*gp));
+    (*sp)->visit = (uint32_t*) calloc(graph_get_cell_count(*gp),
+                                      sizeof(uint32_t));
+    (*sp)->state = (uint8_t*) malloc(
+            sizeof(uint8_t) * graph_get_cell_count(*gp));
+    (*sp)->expanded = (bool*) malloc(sizeof(bool) * graph_get_cell_count(*gp));
+    (*sp)->search = 0;
+
+    /* The heaps can hold any cell, but the open set is never let grow past
+     * the capacity. */
+    id_heap_init(&(*sp)->open, graph_get_cell_count(*gp));
+    id_heap_init(&(*sp)->worst, graph_get_cell_count(*gp));
+    (*sp)->peak_size = 0;
+    (*sp)->expanding = GRAPH_NO_CELL;
+
+    /* No path has been found yet. */
+    (*sp)->path = NULL;
+    (*sp)->path_size = 0;
+    (*sp)->cost = UINT32_MAX;
+    (*sp)->cut = SMA_INFINITY;
+}
+
+/**
+ * This function destroys the sma provided to it.
+ */
+void sma_free(sma* sp)
+{
+    /* De-allocate memory from the sma's internal properties. */
+    free((*sp)->g);
+    free((*sp)->came_from);
+    free((*sp)->f);
+    free((*sp)->forgotten);
+    free((*sp)->visit);
+    free((*sp)->state);
+    free((*sp)->expanded);
+    id_heap_free(&(*sp)->open);
+    id_heap_free(&(*sp)->worst);
+    free((*sp)->path);
+
+    /* De-allocate memory from the sma. */
+    free(*sp);
+}
+
+/**
+ * This function searches for the shortest path from the start cell to the
+ * end cell that can be found within the sma's bound on its open set.
+ */
+void sma_search(sma* sp, uint32_t start, uint32_t end)
+{
+    uint32_t current;   /* The cell being expanded. */
+
+    /* Make sure the graph's index of edges is up to date. */
+    graph_update_index((*sp)->gp);
+
+    /* Start a new search. If the search number wraps around, the old
+     * numbers have to be cleared so they can't be mistaken for new ones. */
+    (*sp)->search++;
+    if ((*sp)->search == 0)
+    {
+        memset((*sp)->visit, 0,
+               sizeof(uint32_t) * graph_get_cell_count(*(*sp)->gp));
+        (*sp)->search = 1;
+    }
+    id_heap_clear(&(*sp)->open);
+    id_heap_clear(&(*sp)->worst);
+    (*sp)->peak_size = 0;
+    (*sp)->end = end;
+    (*sp)->cut = SMA_INFINITY;
+    (*sp)->path_size = 0;
+    (*sp)->cost = UINT32_MAX;
+
+    /* Start with only the start cell in the open set. */
+    (*sp)->visit[start] = (*sp)->search;
+    (*sp)->g[start] = 0;
+    (*sp)->came_from[start] = GRAPH_NO_CELL;
+    (*sp)->f[start] = astar_estimate(*(*sp)->gp, start, end);
+    (*sp)->forgotten[start] = SMA_INFINITY;
+    (*sp)->expanded[start] = false;
+    sma_insert(sp, start, (*sp)->f[start]);
+
+    /* Expand the most promising cell until the end cell comes up. */
+    while (!id_heap_is_empty((*sp)->open))
+    {
+        current = id_heap_pop_min(&(*sp)->open);
+        id_heap_remove(&(*sp)->worst, current);
+        if (current == end)
+        {
+            (*sp)->state[current] = SMA_CLOSED;
+            (*sp)->cost = (*sp)->g[current];
+            sma_reconstruct_path(sp, current);
+            break;
+        }
+        sma_expand(sp, current);
+    }
+}
+
+/**
+ * This function returns the ids of the cells that make up the path found by
+ * sma_search(), from the start cell to the end cell.
+ */
+uint32_t* sma_get_path(sma s)
+{
+    return s->path;
+}
+
+/**
+ * This function returns the number of cells in the path found by
+ * sma_search(). It is 0 if no path was found.
+ */
+uint32_t sma_get_path_size(sma s)
+{
+    return s->path_size;
+}
+
+/**
+ * This function returns the cost of the path found by sma_search(), or
+ * UINT32_MAX if no path was found.
+ */
+uint32_t sma_get_cost(sma s)
+{
+    return s->cost;
+}
+
+/**
+ * This function returns true if the path found by sma_search() is provably
+ * the shortest path. It's false if no path was found, or if entries that
+ * might have led to a shorter path had to be dropped for lack of room.
+ */
+bool sma_is_optimal(sma s)
+{
+    return s->path_size > 0 && s->cost <= s->cut;
+}
+
+/**
+ * This function returns the most entries the sma provided to it keeps in
+ * its open set.
+ */
+uint32_t sma_get_capacity(sma s)
+{
+    return s->capacity;
+}
+
+/**
+ * This function returns the most entries the open set of the sma provided
+ * to it held at once during its last search.
+ */
+uint32_t sma_get_peak_size(sma s)
+{
+    return s->peak_size;
+}
+
+/**
+ * This function expands the cell provided to it.
+ */
+void sma_expand(sma* sp, uint32_t current)
+{
+    graph g;            /* The graph. */
+    uint32_t threshold; /* The highest estimate to regenerate. */
+    uint32_t e;         /* The edge leading to the neighbour. */
+    uint32_t last;      /* The end of the cell's edges. */
+    uint8_t w;          /* The cost of moving to the neighbour. */
+
+    /* The first time a cell is expanded every neighbour is assessed. After
+     * that, it's back in the open set for its pruned children, and only
+     * the ones with the lowest estimate are regenerated. Everything it had
+     * pruned was backed up to at least that estimate, so it's the cell's
+     * estimate from now on. */
+    g = *(*sp)->gp;
+    threshold = (*sp)->expanded[current] ? (*sp)->forgotten[current]
+                                         : SMA_INFINITY;
+    if (threshold != SMA_INFINITY && threshold > (*sp)->f[current])
+    {
+        (*sp)->f[current] = threshold;
+    }
+    (*sp)->forgotten[current] = SMA_INFINITY;
+    (*sp)->expanded[current] = true;
+    (*sp)->state[current] = SMA_CLOSED;
+    (*sp)->expanding = current;
+
+    /* Assess the edges leaving the cell. */
+    last = graph_get_first_edge(g, current + 1);
+    for (e = graph_get_first_edge(g, current); e < last; e++)
+    {
+        w = graph_get_edge_w(g, e);
+        if (w != 0)
+        {
+            sma_generate(sp, current, graph_get_edge_to(g, e),
+                         (*sp)->g[current] + w, threshold);
+        }
+    }
+
+    /* Children that are still pruned have to be regenerated later, so the
+     * cell goes back in the open set, or is pruned itself if there's no
+     * room. */
+    (*sp)->expanding = GRAPH_NO_CELL;
+    if ((*sp)->forgotten[current] != SMA_INFINITY
+        && !sma_insert(sp, current, (*sp)->forgotten[current]))
+    {
+        (*sp)->state[current] = SMA_PRUNED;
+        (*sp)->f[current] = (*sp)->forgotten[current];
+        sma_back_up(sp, current, (*sp)->f[current]);
+    }
+}
+
+/**
+ * This function assesses the neighbour of the cell being expanded that the
+ * path provided to it leads to. Pruned neighbours are only regenerated if
+ * their estimate is no higher than the threshold also provided.
+ */
+void sma_generate(sma* sp, uint32_t current, uint32_t neighbour, uint32_t g,
+                  uint32_t threshold)
+{
+    uint32_t f;     /* The neighbour's estimated total cost. */
+
+    /* Estimate the neighbour's total cost. It's never lower than the
+     * estimate of the cell being expanded. */
+    f = g + astar_estimate(*(*sp)->gp, neighbour, (*sp)->end);
+    if (f < (*sp)->f[current])
+    {
+        f = (*sp)->f[current];
+    }
+
+    /* Check if this is the first or the cheapest path to the neighbour. */
+    if ((*sp)->visit[neighbour] != (*sp)->search || g < (*sp)->g[neighbour])
+    {
+        /* Take the old path to the neighbour out of the open set. */
+        if ((*sp)->visit[neighbour] == (*sp)->search
+            && (*sp)->state[neighbour] == SMA_OPEN)
+        {
+            id_heap_remove(&(*sp)->open, neighbour);
+            id_heap_remove(&(*sp)->worst, neighbour);
+        }
+
+        /* Record the neighbour's path. It has to be expanded again to
+         * move its children onto it. */
+        (*sp)->visit[neighbour] = (*sp)->search;
+        (*sp)->g[neighbour] = g;
+        (*sp)->came_from[neighbour] = current;
+        (*sp)->f[neighbour] = f;
+        (*sp)->forgotten[neighbour] = SMA_INFINITY;
+        (*sp)->expanded[neighbour] = false;
+
+        /* If there's no room for the neighbour, it starts out pruned. */
+        if (!sma_insert(sp, neighbour, f))
+        {
+            (*sp)->state[neighbour] = SMA_PRUNED;
+            if (f < (*sp)->forgotten[current])
+            {
+                (*sp)->forgotten[current] = f;
+            }
+        }
+    }
+    else if ((*sp)->state[neighbour] == SMA_PRUNED
+             && (*sp)->came_from[neighbour] == current
+             && g == (*sp)->g[neighbour])
+    {
+        /* Regenerate the pruned child if it's among the most promising and
+         * there's room, otherwise leave it pruned. */
+        if ((*sp)->f[neighbour] > threshold
+            || !sma_insert(sp, neighbour, (*sp)->f[neighbour]))
+        {
+            if ((*sp)->f[neighbour] < (*sp)->forgotten[current])
+            {
+                (*sp)->forgotten[current] = (*sp)->f[neighbour];
+            }
+        }
+    }
+}
+
+/**
+ * This function puts the cell provided to it in the open set with the
+ * estimate also provided. If the open set is full, the entry with the
+ * highest estimate is pruned to make room, but only if its estimate is
+ * higher. It returns false if there was no room.
+ */
+bool sma_insert(sma* sp, uint32_t id, uint32_t f)
+{
+    uint32_t worst;     /* The entry with the highest estimate. */
+
+    /* Make room if there isn't any. Only pruning entries with a higher
+     * estimate means the same entries can't keep swapping places. Pruning
+     * an entry can put its parent back in the open set, so the room has
+     * to be checked again. */
+    while (id_heap_size((*sp)->open) == (*sp)->capacity)
+    {
+        worst = id_heap_peek_min((*sp)->worst);
+        if (id_heap_get_key((*sp)->open, worst) <= f)
+        {
+            return false;
+        }
+        sma_prune(sp, worst);
+    }
+
+    /* Put the cell in both heaps. */
+    id_heap_push(&(*sp)->open, id, f);
+    id_heap_push(&(*sp)->worst, id, SMA_INFINITY - f);
+    (*sp)->state[id] = SMA_OPEN;
+
+    /* Keep track of the most entries the open set has held. */
+    if (id_heap_size((*sp)->open) > (*sp)->peak_size)
+    {
+        (*sp)->peak_size = id_heap_size((*sp)->open);
+    }
+    return true;
+}
+
+/**
+ * This function prunes the cell provided to it from the open set.
+ */
+void sma_prune(sma* sp, uint32_t id)
+{
+    uint32_t f;     /* The cell's estimate in the open set. */
+
+    /* Take the cell out of the open set, keeping its estimate, so it's
+     * regenerated with it. */
+    f = id_heap_get_key((*sp)->open, id);
+    id_heap_remove(&(*sp)->open, id);
+    id_heap_remove(&(*sp)->worst, id);
+    (*sp)->state[id] = SMA_PRUNED;
+    (*sp)->f[id] = f;
+
+    /* Let its parent know it has to regenerate it. */
+    sma_back_up(sp, id, f);
+}
+
+/**
+ * This function backs the estimate provided to it up from the pruned cell
+ * also provided to its parent, and on up the path while there's no room
+ * for the parent in the open set.
+ */
+void sma_back_up(sma* sp, uint32_t id, uint32_t f)
+{
+    uint32_t parent;    /* The parent of the current cell. */
+
+    while (true)
+    {
+        /* If the start cell is pruned, nothing is left to regenerate it,
+         * so it's dropped for good. */
+        parent = (*sp)->came_from[id];
+        if (parent == GRAPH_NO_CELL)
+        {
+            if (f < (*sp)->cut)
+            {
+                (*sp)->cut = f;
+            }
+            return;
+        }
+
+        /* Nothing more needs doing if the parent already stands for a
+         * pruned child that's at least as promising. */
+        if (f >= (*sp)->forgotten[parent])
+        {
+            return;
+        }
+        (*sp)->forgotten[parent] = f;
+
+        /* The cell being expanded goes back in the open set when it's
+         * done, and a parent in the open set only needs its estimate
+         * lowered. */
+        if (parent == (*sp)->expanding)
+        {
+            return;
+        }
+        if ((*sp)->state[parent] == SMA_OPEN)
+        {
+            if (f < id_heap_get_key((*sp)->open, parent))
+            {
+                id_heap_push(&(*sp)->open, parent, f);
+                id_heap_push(&(*sp)->worst, parent, SMA_INFINITY - f);
+            }
+            return;
+        }
+
+        /* A pruned parent stands for the child in its own parent, and an
+         * expanded parent goes back in the open set if there's room. */
+        if ((*sp)->state[parent] == SMA_PRUNED)
+        {
+            if (f >= (*sp)->f[parent])
+            {
+                return;
+            }
+        }
+        else if (sma_insert(sp, parent, f))
+        {
+            return;
+        }
+        else
+        {
+            (*sp)->state[parent] = SMA_PRUNED;
+        }
+        (*sp)->f[parent] = f;
+        id = parent;
+    }
+}
+
+/**
+ * This function reconstructs the path that ends at the cell provided to it.
+ */
+void sma_reconstruct_path(sma* sp, uint32_t current)
+{
+    uint32_t cell;      /* The current cell on the path. */
+    uint32_t size;      /* The number of cells in the path. */
+    uint32_t i;         /* The index of the current cell. */
+
+    /* Count the cells in the path, so only enough memory for them is
+     * needed. */
+    size = 0;
+    for (cell = current; cell != GRAPH_NO_CELL;
+         cell = (*sp)->came_from[cell])
+    {
+        size++;
+    }
+
+    /* Fill the path in from the end cell back to the start cell. */
+    (*sp)->path = (uint32_t*) realloc((*sp)->path, sizeof(uint32_t) * size);
+    i = size;
+    for (cell = current; cell != GRAPH_NO_CELL;
+         cell = (*sp)->came_from[cell])
+    {
+        i--;
+        (*sp)->path[i] = cell;
+    }
+    (*sp)->path_size = size;
+}
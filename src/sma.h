@@ -0,0 +1,97 @@
+/**
+ * sma.h
+ *
+ * This file contains the data-structure and function prototype declarations
+ * for the sma type.
+ *
+ * The sma type is a memory-bounded A* search in the style of Simplified
+ * Memory-bounded A* (SMA*). It finds a path between two cells of a graph
+ * without ever letting its open set grow past a set number of entries,
+ * whatever the map. When the open set is full, the entry with the highest
+ * estimated total cost is pruned and its estimate is backed up to its
+ * parent, so the parent is expanded again to regenerate it if it's needed.
+ *
+ * If an entry can't be kept anywhere, because every entry in the open set
+ * is at least as promising, it's dropped for good. The path found is then
+ * the best one that could be found within the bound, and the search says
+ * whether it's provably the shortest.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#ifndef SMA_H
+#define SMA_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "graph.h"
+#include "id_heap.h"
+#include "astar.h"
+
+/**
+ * The data-structure of the sma type.
+ */
+typedef struct sma_data* sma;
+
+/**
+ * This function initialises the sma provided to it to search the graph also
+ * provided to the function, keeping at most the number of entries also
+ * provided in its open set. It needs room for at least one entry.
+ */
+void sma_init(sma* sp, graph* gp, uint32_t capacity);
+
+/**
+ * This function destroys the sma provided to it.
+ */
+void sma_free(sma* sp);
+
+/**
+ * This function searches for the shortest path from the start cell to the
+ * end cell that can be found within the sma's bound on its open set.
+ */
+void sma_search(sma* sp, uint32_t start, uint32_t end);
+
+/**
+ * This function returns the ids of the cells that make up the path found by
+ * sma_search(), from the start cell to the end cell.
+ */
+uint32_t* sma_get_path(sma s);
+
+/**
+ * This function returns the number of cells in the path found by
+ * sma_search(). It is 0 if no path was found.
+ */
+uint32_t sma_get_path_size(sma s);
+
+/**
+ * This function returns the cost of the path found by sma_search(), or
+ * UINT32_MAX if no path was found.
+ */
+uint32_t sma_get_cost(sma s);
+
+/**
+ * This function returns true if the path found by sma_search() is provably
+ * the shortest path. It's false if no path was found, or if entries that
+ * might have led to a shorter path had to be dropped for lack of room.
+ */
+bool sma_is_optimal(sma s);
+
+/**
+ * This function returns the most entries the sma provided to it keeps in
+ * its open set.
+ */
+uint32_t sma_get_capacity(sma s);
+
+/**
+ * This function returns the most entries the open set of the sma provided
+ * to it held at once during its last search.
+ */
+uint32_t sma_get_peak_size(sma s);
+
+#endif // SMA_H
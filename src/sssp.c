@@ -0,0 +1,800 @@
+/**
+ * sssp.c
+ *
+ * This file contains the internal data-structure and function definitions
+ * for the sssp type.
+ *
+ * A run is made by a team of threads. Each phase of a run expands the cells
+ * of the current bucket: the threads take chunks of the bucket's cells in
+ * turn and lower the costs of their neighbours with atomic compare and
+ * swaps. A thread that lowers a cost puts the cell in its own list for the
+ * cell's new bucket, so the threads never share lists. Between phases the
+ * lowest non-empty bucket is found and every thread's list for it is
+ * copied into the next bucket to expand.
+ *
+ * sssp_run() uses one team of every thread. sssp_run_many() and
+ * sssp_run_matrix() give each thread a team of its own, so the threads
+ * never wait for each other. A team can be given cells to stop at: once
+ * the lowest non-empty bucket is above all of their costs, every bucket
+ * below it has been expanded, so their costs are final and the rest of the
+ * buckets are emptied without being expanded.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#include "sssp.h"
+
+/**
+ * This is the range of costs each bucket covers unless it's changed.
+ */
+#define SSSP_DEFAULT_DELTA 8
+
+/**
+ * This is the number of cells a thread takes from the bucket at a time.
+ */
+#define SSSP_CHUNK_SIZE 64
+
+/**
+ * This is a growable list of cell ids.
+ */
+struct sssp_list {
+    uint32_t* ids;          /* The cell ids. */
+    uint32_t size;          /* The number of cell ids in the list. */
+    uint32_t capacity;      /* The number of cell ids the list can hold. */
+};
+
+/**
+ * This is one thread's list of cells for each bucket.
+ */
+struct sssp_bins {
+    struct sssp_list* lists;    /* The list of each bucket. */
+    uint32_t num_lists;         /* The number of buckets with a list. */
+};
+
+/**
+ * This is a team of threads making one run.
+ */
+struct sssp_team {
+    sssp s;                     /* The sssp the team runs for. */
+    uint8_t num_threads;        /* The number of threads in the team. */
+    bool reverse;               /* Whether the run goes backwards. */
+    uint32_t* dist;             /* The cost of each cell. */
+    struct sssp_list frontier;  /* The cells of the bucket being expanded. */
+    uint32_t next_index;        /* The next cell of the bucket to take. */
+    uint32_t bin;               /* The bucket being expanded. */
+    bool done;                  /* Whether every bucket is empty. */
+    struct sssp_bins* bins;     /* Each thread's lists of cells. */
+    uint32_t* offsets;          /* Where each thread copies its list to. */
+    pthread_barrier_t barrier;  /* The point the threads wait for each other. */
+    const uint32_t* stops;      /* The cells the run can stop at, or NULL. */
+    uint32_t num_stops;         /* The number of those cells. */
+    uint32_t num_final;         /* The number of them whose costs are final. */
+    uint32_t* scratch;          /* The costs of sssp_run_matrix()'s runs. */
+};
+
+/**
+ * This is what a thread of a team is given to run.
+ */
+struct sssp_member {
+    struct sssp_team* team;     /* The thread's team. */
+    uint8_t index;              /* The thread's place in the team. */
+};
+
+/**
+ * This is the internal data-structure of the sssp type.
+ */
+struct sssp_data {
+    graph* gp;                  /* The graph to run over. */
+    uint8_t num_threads;        /* The number of threads. */
+    uint32_t delta;             /* The range of costs each bucket covers. */
+    struct sssp_team team;      /* The team of every thread. */
+    struct sssp_team* solos;    /* A team of one for each thread. */
+    const uint32_t* sources;    /* The sources of sssp_run_many(). */
+    uint32_t num_sources;       /* The number of those sources. */
+    uint32_t** dists;           /* The costs from each of those sources. */
+    uint32_t next_source;       /* The next of those sources to run. */
+    const uint32_t* targets;    /* The targets of sssp_run_matrix(). */
+    uint32_t num_targets;       /* The number of those targets. */
+    uint32_t* matrix;           /* The costs between the sources and them. */
+    bool by_target;             /* Whether it runs back from the targets. */
+};
+
+/**
+ * This function initialises the team provided to it.
+ */
+void sssp_team_init(struct sssp_team* tp, sssp s, uint8_t num_threads);
+
+/**
+ * This function destroys the team provided to it.
+ */
+void sssp_team_free(struct sssp_team* tp);
+
+/**
+ * This function makes the team provided to it run from the source cell,
+ * using all of its threads. The calling thread is one of them.
+ */
+void sssp_team_run(struct sssp_team* tp, uint32_t source, uint32_t* dist,
+                   bool reverse);
+
+/**
+ * This function is run by each thread of a team.
+ */
+void* sssp_team_work(void* arg);
+
+/**
+ * This function makes the threads of a team wait for each other.
+ */
+void sssp_team_sync(struct sssp_team* tp);
+
+/**
+ * This function expands the cell provided to it for the thread of the team
+ * also provided.
+ */
+void sssp_expand(struct sssp_team* tp, uint8_t index, uint32_t u);
+
+/**
+ * This function finds the next bucket to expand and works out where each
+ * thread copies its list for it to. It's run by one thread of the team.
+ */
+void sssp_next_bin(struct sssp_team* tp);
+
+/**
+ * This function is run by each thread of sssp_run_many().
+ */
+void* sssp_many_work(void* arg);
+
+/**
+ * This function is run by each thread of sssp_run_matrix().
+ */
+void* sssp_matrix_work(void* arg);
+
+/**
+ * This function adds the cell id provided to it to the list also provided.
+ */
+void sssp_list_push(struct sssp_list* lp, uint32_t id);
+
+/**
+ * This function makes sure the list provided to it can hold the number of
+ * cell ids also provided.
+ */
+void sssp_list_reserve(struct sssp_list* lp, uint32_t capacity);
+
+/**
+ * This function initialises the sssp provided to it to run over the graph
+ * also provided to the function with the number of threads also provided.
+ */
+void sssp_init(sssp* sp, graph* gp, uint8_t num_threads)
+{
+    uint8_t i;  /* The index of the current thread. */
+
+    /* Check there's at least one thread. */
+    if (num_threads == 0)
+    {
+        fprintf(stdout,
+                "\nERROR: In function sssp_init(): an sssp needs at least one "
+                "thread!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Allocate memory to the sssp. */
+    *sp = (sssp) malloc(sizeof(struct sssp_data));
+
+    /* Initialise the sssp's internal properties. */
+    (*sp)->gp = gp;
+    (*sp)->num_threads = num_threads;
+    (*sp)->delta = SSSP_DEFAULT_DELTA;
+
+    /* Initialise the team of every thread and a team for each thread. */
+    sssp_team_init(&(*sp)->team, *sp, num_threads);
+    (*sp)->solos = (struct sssp_team*) malloc(
+            sizeof(struct sssp_team) * num_threads);
+    for (i = 0; i < num_threads; i++)
+    {
+        sssp_team_init(&(*sp)->solos[i], *sp, 1);
+    }
+}
+
+/**
+ * This function destroys the sssp provided to it.
+ */
+void sssp_free(sssp* sp)
+{
+    uint8_t i;  /* The index of the current thread. */
+
+    /* Destroy the teams. */
+    sssp_team_free(&(*sp)->team);
+    for (i = 0; i < (*sp)->num_threads; i++)
+    {
+        sssp_team_free(&(*sp)->solos[i]);
+    }
+    free((*sp)->solos);
+
+    /* De-allocate memory from the sssp. */
+    free(*sp);
+}
+
+/**
+ * This function sets the range of costs each bucket of the sssp provided to
+ * it covers. Larger buckets give the threads more cells to share out at a
+ * time, but some cells are expanded more than once.
+ */
+void sssp_set_delta(sssp* sp, uint32_t delta)
+{
+    /* Check the buckets cover at least one cost. */
+    if (delta == 0)
+    {
+        fprintf(stdout,
+                "\nERROR: In function sssp_set_delta(): delta must be at "
+                "least 1!\n");
+        exit(EXIT_FAILURE);
+    }
+    (*sp)->delta = delta;
+}
+
+/**
+ * This function returns the number of threads the sssp provided to it runs
+ * with.
+ */
+uint8_t sssp_get_num_threads(sssp s)
+{
+    return s->num_threads;
+}
+
+/**
+ * This function fills the array provided to it with the cost of the
+ * cheapest path from the source cell to every cell of the graph, indexed by
+ * cell id. The array must hold graph_get_cell_count() costs. Cells that
+ * can't be reached get SSSP_UNREACHABLE.
+ */
+void sssp_run(sssp* sp, uint32_t source, uint32_t* dist)
+{
+    graph_update_index((*sp)->gp);
+    sssp_team_run(&(*sp)->team, source, dist, false);
+}
+
+/**
+ * This function fills the array provided to it with the cost of the
+ * cheapest path from every cell of the graph to the target cell, by running
+ * backwards along the graph's edges.
+ */
+void sssp_run_reverse(sssp* sp, uint32_t target, uint32_t* dist)
+{
+    graph_update_index((*sp)->gp);
+    sssp_team_run(&(*sp)->team, target, dist, true);
+}
+
+/**
+ * This function runs from many sources at once, each thread running from
+ * its own sources. dists holds one array of costs for each source. If
+ * reverse is true, the costs are to each source rather than from it.
+ */
+void sssp_run_many(sssp* sp, const uint32_t* sources, uint32_t num_sources,
+                   uint32_t** dists, bool reverse)
+{
+    pthread_t* threads;     /* The threads other than this one. */
+    uint8_t i;              /* The index of the current thread. */
+
+    /* Make sure the graph's index of edges is up to date. */
+    graph_update_index((*sp)->gp);
+
+    /* Hand out the sources. */
+    (*sp)->sources = sources;
+    (*sp)->num_sources = num_sources;
+    (*sp)->dists = dists;
+    (*sp)->next_source = 0;
+    for (i = 0; i < (*sp)->num_threads; i++)
+    {
+        (*sp)->solos[i].reverse = reverse;
+    }
+
+    /* Run the threads and wait for them to finish. */
+    threads = (pthread_t*) malloc(sizeof(pthread_t) * (*sp)->num_threads);
+    for (i = 1; i < (*sp)->num_threads; i++)
+    {
+        pthread_create(&threads[i], NULL, sssp_many_work, &(*sp)->solos[i]);
+    }
+    sssp_many_work(&(*sp)->solos[0]);
+    for (i = 1; i < (*sp)->num_threads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+}
+
+/**
+ * This function fills the matrix provided to it with the cost of the
+ * cheapest path from each source cell to each target cell. The matrix holds
+ * num_sources rows of num_targets costs, so the cost from source i to
+ * target j is at matrix[i * num_targets + j]. Only costs are worked out,
+ * not paths. The threads each run from their own cells, from the sources
+ * or backwards from the targets, whichever there are fewer of, and each
+ * run stops as soon as the costs it needs are final.
+ */
+void sssp_run_matrix(sssp* sp, const uint32_t* sources, uint32_t num_sources,
+                     const uint32_t* targets, uint32_t num_targets,
+                     uint32_t* matrix)
+{
+    pthread_t* threads;     /* The threads other than this one. */
+    uint8_t i;              /* The index of the current thread. */
+
+    /* Make sure the graph's index of edges is up to date. */
+    graph_update_index((*sp)->gp);
+
+    /* Hand out the rows, or the columns if there are fewer of them, each
+     * run stopping at the cells of the other side. */
+    (*sp)->sources = sources;
+    (*sp)->num_sources = num_sources;
+    (*sp)->targets = targets;
+    (*sp)->num_targets = num_targets;
+    (*sp)->matrix = matrix;
+    (*sp)->by_target = num_targets < num_sources;
+    (*sp)->next_source = 0;
+    for (i = 0; i < (*sp)->num_threads; i++)
+    {
+        (*sp)->solos[i].reverse = (*sp)->by_target;
+        (*sp)->solos[i].stops = (*sp)->by_target ? sources : targets;
+        (*sp)->solos[i].num_stops = (*sp)->by_target ? num_sources
+                                                     : num_targets;
+    }
+
+    /* Run the threads and wait for them to finish. */
+    threads = (pthread_t*) malloc(sizeof(pthread_t) * (*sp)->num_threads);
+    for (i = 1; i < (*sp)->num_threads; i++)
+    {
+        pthread_create(&threads[i], NULL, sssp_matrix_work,
+                       &(*sp)->solos[i]);
+    }
+    sssp_matrix_work(&(*sp)->solos[0]);
+    for (i = 1; i < (*sp)->num_threads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+
+    /* The teams run to the end again from now on. */
+    for (i = 0; i < (*sp)->num_threads; i++)
+    {
+        (*sp)->solos[i].stops = NULL;
+        (*sp)->solos[i].num_stops = 0;
+    }
+}
+
+/**
+ * This function initialises the team provided to it.
+ */
+void sssp_team_init(struct sssp_team* tp, sssp s, uint8_t num_threads)
+{
+    uint8_t i;  /* The index of the current thread. */
+
+    tp->s = s;
+    tp->num_threads = num_threads;
+    tp->reverse = false;
+    tp->frontier.ids = NULL;
+    tp->frontier.size = 0;
+    tp->frontier.capacity = 0;
+    tp->bins = (struct sssp_bins*) malloc(
+            sizeof(struct sssp_bins) * num_threads);
+    for (i = 0; i < num_threads; i++)
+    {
+        tp->bins[i].lists = NULL;
+        tp->bins[i].num_lists = 0;
+    }
+    tp->offsets = (uint32_t*) malloc(sizeof(uint32_t) * num_threads);
+    pthread_barrier_init(&tp->barrier, NULL, num_threads);
+    tp->stops = NULL;
+    tp->num_stops = 0;
+    tp->num_final = 0;
+    tp->scratch = NULL;
+}
+
+/**
+ * This function destroys the team provided to it.
+ */
+void sssp_team_free(struct sssp_team* tp)
+{
+    uint32_t b;     /* The index of the current bucket. */
+    uint8_t i;      /* The index of the current thread. */
+
+    for (i = 0; i < tp->num_threads; i++)
+    {
+        for (b = 0; b < tp->bins[i].num_lists; b++)
+        {
+            free(tp->bins[i].lists[b].ids);
+        }
+        free(tp->bins[i].lists);
+    }
+    free(tp->bins);
+    free(tp->offsets);
+    free(tp->frontier.ids);
+    free(tp->scratch);
+    pthread_barrier_destroy(&tp->barrier);
+}
+
+/**
+ * This function makes the team provided to it run from the source cell,
+ * using all of its threads. The calling thread is one of them.
+ */
+void sssp_team_run(struct sssp_team* tp, uint32_t source, uint32_t* dist,
+                   bool reverse)
+{
+    struct sssp_member* members;    /* What each thread is given to run. */
+    pthread_t* threads;             /* The threads other than this one. */
+    uint32_t id;                    /* The current cell id. */
+    uint8_t i;                      /* The index of the current thread. */
+
+    /* No cell has been reached yet, apart from the source. */
+    for (id = 0; id < graph_get_cell_count(*tp->s->gp); id++)
+    {
+        dist[id] = SSSP_UNREACHABLE;
+    }
+    dist[source] = 0;
+
+    /* The first bucket to expand holds only the source. */
+    tp->dist = dist;
+    tp->reverse = reverse;
+    tp->frontier.size = 0;
+    sssp_list_push(&tp->frontier, source);
+    tp->next_index = 0;
+    tp->bin = 0;
+    tp->done = false;
+    tp->num_final = 0;
+
+    /* Run the threads and wait for them to finish. */
+    members = (struct sssp_member*) malloc(
+            sizeof(struct sssp_member) * tp->num_threads);
+    threads = (pthread_t*) malloc(sizeof(pthread_t) * tp->num_threads);
+    for (i = 0; i < tp->num_threads; i++)
+    {
+        members[i].team = tp;
+        members[i].index = i;
+    }
+    for (i = 1; i < tp->num_threads; i++)
+    {
+        pthread_create(&threads[i], NULL, sssp_team_work, &members[i]);
+    }
+    sssp_team_work(&members[0]);
+    for (i = 1; i < tp->num_threads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+    free(members);
+}
+
+/**
+ * This function is run by each thread of a team.
+ */
+void* sssp_team_work(void* arg)
+{
+    struct sssp_member* mp;     /* The thread's place in its team. */
+    struct sssp_team* tp;       /* The thread's team. */
+    struct sssp_list* lp;       /* The thread's list for the next bucket. */
+    uint32_t start;             /* The first cell of the chunk taken. */
+    uint32_t end;               /* The end of the chunk taken. */
+    uint32_t i;                 /* The index of the current cell. */
+
+    mp = (struct sssp_member*) arg;
+    tp = mp->team;
+    for (;;)
+    {
+        /* Expand the cells of the current bucket a chunk at a time. */
+        for (start = __atomic_fetch_add(&tp->next_index, SSSP_CHUNK_SIZE,
+                                        __ATOMIC_RELAXED);
+             start < tp->frontier.size;
+             start = __atomic_fetch_add(&tp->next_index, SSSP_CHUNK_SIZE,
+                                        __ATOMIC_RELAXED))
+        {
+            end = start + SSSP_CHUNK_SIZE < tp->frontier.size
+                ? start + SSSP_CHUNK_SIZE : tp->frontier.size;
+            for (i = start; i < end; i++)
+            {
+                sssp_expand(tp, mp->index, tp->frontier.ids[i]);
+            }
+        }
+        sssp_team_sync(tp);
+
+        /* Find the next bucket, stopping if they're all empty. */
+        if (mp->index == 0)
+        {
+            sssp_next_bin(tp);
+        }
+        sssp_team_sync(tp);
+        if (tp->done)
+        {
+            break;
+        }
+
+        /* Copy this thread's list for the bucket into the cells to
+         * expand. */
+        if (tp->bin < tp->bins[mp->index].num_lists)
+        {
+            lp = &tp->bins[mp->index].lists[tp->bin];
+            for (i = 0; i < lp->size; i++)
+            {
+                tp->frontier.ids[tp->offsets[mp->index] + i] = lp->ids[i];
+            }
+            lp->size = 0;
+        }
+        sssp_team_sync(tp);
+    }
+    return NULL;
+}
+
+/**
+ * This function makes the threads of a team wait for each other.
+ */
+void sssp_team_sync(struct sssp_team* tp)
+{
+    /* A thread on its own has nobody to wait for. */
+    if (tp->num_threads > 1)
+    {
+        pthread_barrier_wait(&tp->barrier);
+    }
+}
+
+/**
+ * This function expands the cell provided to it for the thread of the team
+ * also provided.
+ */
+void sssp_expand(struct sssp_team* tp, uint8_t index, uint32_t u)
+{
+    graph g;                /* The graph. */
+    struct sssp_bins* bp;   /* The thread's lists. */
+    uint32_t du;            /* The cost of the cell. */
+    uint32_t nd;            /* The cost of the neighbour through the cell. */
+    uint32_t old;           /* The neighbour's cost before. */
+    uint32_t v;             /* The neighbour. */
+    uint32_t e;             /* The edge to the neighbour. */
+    uint32_t last;          /* The end of the cell's edges. */
+    uint32_t bin;           /* The neighbour's new bucket. */
+    uint32_t b;             /* The index of a new bucket list. */
+    uint8_t w;              /* The cost of the edge. */
+
+    /* Skip cells whose cost has dropped below the current bucket since they
+     * were added to it, they were expanded in an earlier bucket. */
+    g = *tp->s->gp;
+    du = __atomic_load_n(&tp->dist[u], __ATOMIC_RELAXED);
+    if (du / tp->s->delta < tp->bin)
+    {
+        return;
+    }
+
+    /* Assess each edge of the cell, leading out of it on a forward run and
+     * into it on a backward one. */
+    if (tp->reverse)
+    {
+        e = graph_get_first_in_edge(g, u);
+        last = graph_get_first_in_edge(g, u + 1);
+    }
+    else
+    {
+        e = graph_get_first_edge(g, u);
+        last = graph_get_first_edge(g, u + 1);
+    }
+    for (; e < last; e++)
+    {
+        if (tp->reverse)
+        {
+            v = graph_get_in_edge_from(g, e);
+            w = graph_get_in_edge_w(g, e);
+        }
+        else
+        {
+            v = graph_get_edge_to(g, e);
+            w = graph_get_edge_w(g, e);
+        }
+
+        /* Skip moves that aren't possible. */
+        if (w == 0)
+        {
+            continue;
+        }
+
+        /* Lower the neighbour's cost if the path through the cell is
+         * cheaper, retrying if another thread changes it first. */
+        nd = du + w;
+        old = __atomic_load_n(&tp->dist[v], __ATOMIC_RELAXED);
+        while (nd < old)
+        {
+            if (__atomic_compare_exchange_n(&tp->dist[v], &old, nd, true,
+                                            __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED))
+            {
+                /* Add the neighbour to this thread's list for its new
+                 * bucket. */
+                bp = &tp->bins[index];
+                bin = nd / tp->s->delta;
+                if (bin >= bp->num_lists)
+                {
+                    bp->lists = (struct sssp_list*) realloc(bp->lists,
+                            sizeof(struct sssp_list) * (bin + 1));
+                    for (b = bp->num_lists; b <= bin; b++)
+                    {
+                        bp->lists[b].ids = NULL;
+                        bp->lists[b].size = 0;
+                        bp->lists[b].capacity = 0;
+                    }
+                    bp->num_lists = bin + 1;
+                }
+                sssp_list_push(&bp->lists[bin], v);
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * This function finds the next bucket to expand and works out where each
+ * thread copies its list for it to. It's run by one thread of the team.
+ */
+void sssp_next_bin(struct sssp_team* tp)
+{
+    uint32_t bin;       /* The current bucket. */
+    uint32_t max_lists; /* The most buckets any thread has a list for. */
+    uint32_t size;      /* The number of cells in the next bucket. */
+    uint32_t b;         /* The index of a bucket being emptied. */
+    uint8_t i;          /* The index of the current thread. */
+
+    /* Find the lowest bucket any thread has cells for. Expanding a bucket
+     * only adds cells to it or to higher buckets. */
+    max_lists = 0;
+    for (i = 0; i < tp->num_threads; i++)
+    {
+        if (tp->bins[i].num_lists > max_lists)
+        {
+            max_lists = tp->bins[i].num_lists;
+        }
+    }
+    for (bin = tp->bin; bin < max_lists; bin++)
+    {
+        size = 0;
+        for (i = 0; i < tp->num_threads; i++)
+        {
+            tp->offsets[i] = size;
+            if (bin < tp->bins[i].num_lists)
+            {
+                size += tp->bins[i].lists[bin].size;
+            }
+        }
+        if (size > 0)
+        {
+            break;
+        }
+    }
+
+    /* Stop if every bucket is empty. */
+    if (bin == max_lists)
+    {
+        tp->done = true;
+        return;
+    }
+
+    /* Stop if the costs of all of the cells to stop at are below the
+     * bucket, emptying the buckets left for the next run. A cost that's
+     * final stays final, so the cells are checked in order. */
+    if (tp->stops != NULL)
+    {
+        while (tp->num_final < tp->num_stops
+               && tp->dist[tp->stops[tp->num_final]] / tp->s->delta < bin)
+        {
+            tp->num_final++;
+        }
+        if (tp->num_final == tp->num_stops)
+        {
+            for (i = 0; i < tp->num_threads; i++)
+            {
+                for (b = 0; b < tp->bins[i].num_lists; b++)
+                {
+                    tp->bins[i].lists[b].size = 0;
+                }
+            }
+            tp->done = true;
+            return;
+        }
+    }
+
+    /* Make room for the bucket's cells. */
+    tp->bin = bin;
+    sssp_list_reserve(&tp->frontier, size);
+    tp->frontier.size = size;
+    tp->next_index = 0;
+}
+
+/**
+ * This function is run by each thread of sssp_run_many().
+ */
+void* sssp_many_work(void* arg)
+{
+    struct sssp_team* tp;   /* The thread's team. */
+    sssp s;                 /* The sssp. */
+    uint32_t k;             /* The index of the current source. */
+
+    /* Run from sources until there are none left. */
+    tp = (struct sssp_team*) arg;
+    s = tp->s;
+    for (k = __atomic_fetch_add(&s->next_source, 1, __ATOMIC_RELAXED);
+         k < s->num_sources;
+         k = __atomic_fetch_add(&s->next_source, 1, __ATOMIC_RELAXED))
+    {
+        sssp_team_run(tp, s->sources[k], s->dists[k], tp->reverse);
+    }
+    return NULL;
+}
+
+/**
+ * This function is run by each thread of sssp_run_matrix().
+ */
+void* sssp_matrix_work(void* arg)
+{
+    struct sssp_team* tp;   /* The thread's team. */
+    sssp s;                 /* The sssp. */
+    uint32_t k;             /* The index of the current run. */
+    uint32_t num_runs;      /* The number of runs. */
+    uint32_t j;             /* The index of the current cell stopped at. */
+
+    /* Make room for the costs of a run. */
+    tp = (struct sssp_team*) arg;
+    s = tp->s;
+    if (tp->scratch == NULL)
+    {
+        tp->scratch = (uint32_t*) malloc(
+                sizeof(uint32_t) * graph_get_cell_count(*s->gp));
+    }
+
+    /* Run from rows, or back from columns, until there are none left,
+     * copying the costs of the cells stopped at into the matrix. */
+    num_runs = s->by_target ? s->num_targets : s->num_sources;
+    for (k = __atomic_fetch_add(&s->next_source, 1, __ATOMIC_RELAXED);
+         k < num_runs;
+         k = __atomic_fetch_add(&s->next_source, 1, __ATOMIC_RELAXED))
+    {
+        if (s->by_target)
+        {
+            sssp_team_run(tp, s->targets[k], tp->scratch, true);
+            for (j = 0; j < s->num_sources; j++)
+            {
+                s->matrix[(size_t) j * s->num_targets + k]
+                        = tp->scratch[s->sources[j]];
+            }
+        }
+        else
+        {
+            sssp_team_run(tp, s->sources[k], tp->scratch, false);
+            for (j = 0; j < s->num_targets; j++)
+            {
+                s->matrix[(size_t) k * s->num_targets + j]
+                        = tp->scratch[s->targets[j]];
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * This function adds the cell id provided to it to the list also provided.
+ */
+void sssp_list_push(struct sssp_list* lp, uint32_t id)
+{
+    /* Double the list's capacity if it's full. */
+    if (lp->size == lp->capacity)
+    {
+        sssp_list_reserve(lp, lp->capacity == 0 ? 16 : lp->capacity * 2);
+    }
+    lp->ids[lp->size] = id;
+    lp->size++;
+}
+
+/**
+ * This function makes sure the list provided to it can hold the number of
+ * cell ids also provided.
+ */
+void sssp_list_reserve(struct sssp_list* lp, uint32_t capacity)
+{
+    if (capacity > lp->capacity)
+    {
+        lp->ids = (uint32_t*) realloc(lp->ids, sizeof(uint32_t) * capacity);
+        lp->capacity = capacity;
+    }
+}
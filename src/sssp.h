@@ -0,0 +1,101 @@
+/**
+ * sssp.h
+ *
+ * This file contains the data-structure and function prototype declarations
+ * for the sssp type.
+ *
+ * The sssp type measures the cost of the cheapest path from one cell to
+ * every other cell of a graph (single source shortest paths), which tables
+ * of landmark distances, flow fields and matrices of costs are built from.
+ * It uses delta-stepping: the cells are put in buckets by their cost, each
+ * bucket covering a range of delta costs, and the cells of the lowest
+ * bucket are expanded by all of the threads at once. The costs between
+ * many sources and many targets can be worked out at once as a matrix.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#ifndef SSSP_H
+#define SSSP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "graph.h"
+
+/**
+ * This is the cost of a cell that can't be reached.
+ */
+#define SSSP_UNREACHABLE UINT32_MAX
+
+/**
+ * The data-structure of the sssp type.
+ */
+typedef struct sssp_data* sssp;
+
+/**
+ * This function initialises the sssp provided to it to run over the graph
+ * also provided to the function with the number of threads also provided.
+ */
+void sssp_init(sssp* sp, graph* gp, uint8_t num_threads);
+
+/**
+ * This function destroys the sssp provided to it.
+ */
+void sssp_free(sssp* sp);
+
+/**
+ * This function sets the range of costs each bucket of the sssp provided to
+ * it covers. Larger buckets give the threads more cells to share out at a
+ * time, but some cells are expanded more than once.
+ */
+void sssp_set_delta(sssp* sp, uint32_t delta);
+
+/**
+ * This function returns the number of threads the sssp provided to it runs
+ * with.
+ */
+uint8_t sssp_get_num_threads(sssp s);
+
+/**
+ * This function fills the array provided to it with the cost of the
+ * cheapest path from the source cell to every cell of the graph, indexed by
+ * cell id. The array must hold graph_get_cell_count() costs. Cells that
+ * can't be reached get SSSP_UNREACHABLE.
+ */
+void sssp_run(sssp* sp, uint32_t source, uint32_t* dist);
+
+/**
+ * This function fills the array provided to it with the cost of the
+ * cheapest path from every cell of the graph to the target cell, by running
+ * backwards along the graph's edges.
+ */
+void sssp_run_reverse(sssp* sp, uint32_t target, uint32_t* dist);
+
+/**
+ * This function runs from many sources at once, each thread running from
+ * its own sources. dists holds one array of costs for each source. If
+ * reverse is true, the costs are to each source rather than from it.
+ */
+void sssp_run_many(sssp* sp, const uint32_t* sources, uint32_t num_sources,
+                   uint32_t** dists, bool reverse);
+
+/**
+ * This function fills the matrix provided to it with the cost of the
+ * cheapest path from each source cell to each target cell. The matrix holds
+ * num_sources rows of num_targets costs, so the cost from source i to
+ * target j is at matrix[i * num_targets + j]. Only costs are worked out,
+ * not paths. The threads each run from their own cells, from the sources
+ * or backwards from the targets, whichever there are fewer of, and each
+ * run stops as soon as the costs it needs are final.
+ */
+void sssp_run_matrix(sssp* sp, const uint32_t* sources, uint32_t num_sources,
+                     const uint32_t* targets, uint32_t num_targets,
+                     uint32_t* matrix);
+
+#endif // SSSP_H
@@ -0,0 +1,1031 @@
+/**
+ * subgoal.c
+ *
+ * This file contains the internal data-structure and function definitions
+ * for the subgoal type.
+ *
+ * On a MANHATTAN graph a cell is next to a corner if a cell diagonally next
+ * to it is an obstacle but every cell between the two is passable. On a
+ * DIAGONAL graph, where moves can cut past obstacles, it's next to a corner
+ * if an obstacle next to one of its faces has a passable cell beside it.
+ * The subgoals a cell reaches directly are found with a scan that only
+ * moves to cells whose cost from the cell is its estimate, and doesn't go
+ * past a subgoal. On a unit grid the moves that can do that are worked out
+ * from where the cell is, so the scan only looks at those. The edges of the
+ * subgoal graph are kept in the same compressed form as the graph's index,
+ * with the subgoals numbered in the order of their cells.
+ *
+ * The search over the subgoal graph has two more nodes, one past the last
+ * subgoal for the start cell and one after it for the end cell, so it only
+ * needs one priority queue and one set of arrays.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#include "subgoal.h"
+
+/**
+ * This is the subgoal of a cell that isn't one.
+ */
+#define SUBGOAL_NONE UINT32_MAX
+
+/**
+ * This is the internal data-structure of the subgoal type.
+ */
+struct subgoal_data {
+    graph* gp;              /* The graph the subgoal graph was built from. */
+
+    /* The subgoal graph. */
+    uint32_t* subgoal_of;   /* The subgoal at each cell. */
+    uint32_t* cells;        /* The cell of each subgoal. */
+    uint32_t num_subgoals;  /* The number of subgoals. */
+    uint32_t* first_edge;   /* The first edge of each subgoal. */
+    uint32_t* edge_to;      /* The subgoal each edge leads to. */
+    uint32_t* edge_w;       /* The cost of each edge. */
+    uint32_t num_edges;     /* The number of edges. */
+
+    /* The state of the scans over cells. */
+    uint32_t* cell_g;       /* The cost of each cell from the scan's cell. */
+    uint32_t* cell_from;    /* The cell each cell was reached from. */
+    uint32_t* cell_visit;   /* The scan each cell was last reached by. */
+    uint32_t cell_scan;     /* The number of the current scan. */
+    uint8_t* coords;        /* The coordinates of each cell. */
+    int8_t offsets[3 * GRAPH_NUM_DIRECTIONS]; /* Each direction's offsets. */
+    uint32_t away[6];       /* The directions going down and up each axis. */
+    uint32_t* queue;        /* The cells waiting to be scanned from. */
+    uint32_t tail;          /* The end of the queue. */
+    uint32_t* found;        /* The subgoals the last scan reached. */
+    uint32_t* found_w;      /* The cost of reaching each of them. */
+    uint32_t num_found;     /* The number of subgoals the scan reached. */
+    uint32_t found_capacity; /* The number of subgoals there's room for. */
+
+    /* The state of the search over the subgoal graph. */
+    id_heap open;           /* The nodes waiting to be expanded, by f. */
+    uint32_t* g;            /* The cost of the path to each node. */
+    uint32_t* came_from;    /* The node each node's path came from. */
+    uint32_t* visit;        /* The search each node was last reached by. */
+    uint32_t* end_w;        /* The cost from each subgoal to the end. */
+    uint32_t* end_visit;    /* The search each subgoal reached the end in. */
+    uint32_t search;        /* The number of the current search. */
+    uint32_t* start_to;     /* The subgoals the start cell reaches. */
+    uint32_t* start_w;      /* The cost of reaching each of them. */
+    uint32_t num_start;     /* The number of subgoals the start reaches. */
+    uint32_t start;         /* The start cell of the current search. */
+    uint32_t end;           /* The end cell of the current search. */
+
+    /* The path that was found. */
+    uint32_t* path;         /* The cells of the path. */
+    uint32_t path_size;     /* The number of cells in the path. */
+    uint32_t cost;          /* The cost of the path. */
+};
+
+/**
+ * This function returns whether the cell at the coordinates provided to it
+ * is in the graph and passable.
+ */
+bool subgoal_is_open(subgoal s, int32_t x, int32_t y, int32_t z);
+
+/**
+ * This function returns whether the cell at the coordinates provided to it
+ * is in the graph's volume and isn't passable.
+ */
+bool subgoal_is_blocked(subgoal s, int32_t x, int32_t y, int32_t z);
+
+/**
+ * This function returns whether the cell provided to it is next to the
+ * corner of an obstacle.
+ */
+bool subgoal_is_corner(subgoal s, uint32_t id);
+
+/**
+ * This function scans the cells reachable from the cell provided to it for
+ * their estimated cost, finding the subgoals reached without passing
+ * another. It scans the cells the cell can be reached from instead if
+ * reverse is true, and only the cells on the way to the target cell if
+ * bounded is true. It returns whether it reached the target cell.
+ */
+bool subgoal_scan(subgoal* sp, uint32_t from, uint32_t target,
+                  bool reverse, bool bounded);
+
+/**
+ * This function queues the neighbour provided to it, reached from the
+ * current cell by a move with the cost also provided, if the scan from the
+ * cell provided first hasn't reached it and its cost is its estimate.
+ */
+void subgoal_reach(subgoal* sp, uint32_t from, uint32_t current,
+                   uint32_t n, uint8_t w);
+
+/**
+ * This function returns the directions a move from the current cell
+ * provided to it can take to add 1 to its estimated cost from the cell
+ * scanned from, also provided.
+ */
+uint32_t subgoal_away_mask(subgoal s, uint32_t from, uint32_t current);
+
+/**
+ * This function returns the directions a move from the current cell
+ * provided to it can take to take 1 from its estimated cost to the target
+ * cell, also provided.
+ */
+uint32_t subgoal_toward_mask(subgoal s, uint32_t target, uint32_t current);
+
+/**
+ * This function returns the position of the lowest set bit of the mask
+ * provided to it, which must not be 0.
+ */
+uint8_t subgoal_lowest_bit(uint32_t mask);
+
+/**
+ * This function returns the cell of the node of the search over the
+ * subgoal graph provided to it.
+ */
+uint32_t subgoal_node_cell(subgoal s, uint32_t node);
+
+/**
+ * This function records the path to the node provided to it through the
+ * current node, if it's better than any path found to it before.
+ */
+void subgoal_relax(subgoal* sp, uint32_t current, uint32_t node,
+                   uint32_t w);
+
+/**
+ * This function reconstructs the path that ends at the end cell, refining
+ * each edge into single moves.
+ */
+void subgoal_reconstruct_path(subgoal* sp);
+
+/**
+ * This function adds the single moves of a path from the last cell of the
+ * path to the cell provided to it, which can be reached for its estimated
+ * cost, to the path.
+ */
+void subgoal_refine(subgoal* sp, uint32_t to);
+
+/**
+ * This function returns the cost of the move from the first cell provided
+ * to it to the second, or 0 if the move isn't possible.
+ */
+uint8_t subgoal_move_w(subgoal s, uint32_t from, uint32_t to);
+
+/**
+ * This function initialises the subgoal provided to it by building the
+ * subgoal graph of the graph also provided.
+ */
+void subgoal_init(subgoal* sp, graph* gp)
+{
+    uint32_t count;     /* The number of cells in the graph. */
+    uint32_t capacity;  /* The number of edges there's room for. */
+    uint32_t id;        /* The current cell. */
+    uint32_t s;         /* The current subgoal. */
+    uint32_t i;         /* The index of the current subgoal found. */
+    int8_t* off;        /* The offsets of the current direction. */
+    uint8_t dir;        /* The current direction. */
+
+    /* Allocate memory to the subgoal. */
+    *sp = (subgoal) malloc(sizeof(struct subgoal_data));
+    (*sp)->gp = gp;
+    graph_update_index(gp);
+    count = graph_get_cell_count(*gp);
+
+    /* Initialise the state of the scans. */
+    (*sp)->cell_g = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*sp)->cell_from = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*sp)->cell_visit = (uint32_t*) calloc(count, sizeof(uint32_t));
+    (*sp)->cell_scan = 0;
+    (*sp)->queue = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*sp)->tail = 0;
+    (*sp)->coords = (uint8_t*) malloc(sizeof(uint8_t) * 3 * count);
+    for (id = 0; id < count; id++)
+    {
+        graph_get_cell_coords(*gp, id, &(*sp)->coords[3 * id],
+                              &(*sp)->coords[3 * id + 1],
+                              &(*sp)->coords[3 * id + 2]);
+    }
+    memset((*sp)->away, 0, sizeof((*sp)->away));
+    for (dir = 0; dir < GRAPH_NUM_DIRECTIONS; dir++)
+    {
+        off = &(*sp)->offsets[3 * dir];
+        graph_get_dir_offset(dir, &off[0], &off[1], &off[2]);
+        for (i = 0; i < 3; i++)
+        {
+            if (off[i] != 0)
+            {
+                (*sp)->away[2 * i + (off[i] > 0 ? 1 : 0)] |= 1u << dir;
+            }
+        }
+    }
+    (*sp)->found_capacity = 64;
+    (*sp)->found = (uint32_t*) malloc(sizeof(uint32_t) * 64);
+    (*sp)->found_w = (uint32_t*) malloc(sizeof(uint32_t) * 64);
+    (*sp)->num_found = 0;
+
+    /* Place a subgoal at every passable cell next to a corner. */
+    (*sp)->subgoal_of = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*sp)->cells = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*sp)->num_subgoals = 0;
+    for (id = 0; id < count; id++)
+    {
+        (*sp)->subgoal_of[id] = SUBGOAL_NONE;
+        if (subgoal_is_corner(*sp, id))
+        {
+            (*sp)->subgoal_of[id] = (*sp)->num_subgoals;
+            (*sp)->cells[(*sp)->num_subgoals] = id;
+            (*sp)->num_subgoals++;
+        }
+    }
+
+    /* Join each subgoal to the subgoals it reaches directly. */
+    (*sp)->first_edge = (uint32_t*) malloc(
+            sizeof(uint32_t) * ((*sp)->num_subgoals + 1));
+    capacity = 64;
+    (*sp)->edge_to = (uint32_t*) malloc(sizeof(uint32_t) * capacity);
+    (*sp)->edge_w = (uint32_t*) malloc(sizeof(uint32_t) * capacity);
+    (*sp)->num_edges = 0;
+    for (s = 0; s < (*sp)->num_subgoals; s++)
+    {
+        (*sp)->first_edge[s] = (*sp)->num_edges;
+        subgoal_scan(sp, (*sp)->cells[s], GRAPH_NO_CELL, false, false);
+        for (i = 0; i < (*sp)->num_found; i++)
+        {
+            if ((*sp)->num_edges == capacity)
+            {
+                capacity *= 2;
+                (*sp)->edge_to = (uint32_t*) realloc((*sp)->edge_to,
+                        sizeof(uint32_t) * capacity);
+                (*sp)->edge_w = (uint32_t*) realloc((*sp)->edge_w,
+                        sizeof(uint32_t) * capacity);
+            }
+            (*sp)->edge_to[(*sp)->num_edges] = (*sp)->found[i];
+            (*sp)->edge_w[(*sp)->num_edges] = (*sp)->found_w[i];
+            (*sp)->num_edges++;
+        }
+    }
+    (*sp)->first_edge[(*sp)->num_subgoals] = (*sp)->num_edges;
+
+    /* Initialise the state of the search, with the start and end nodes
+     * after the subgoals. */
+    id_heap_init(&(*sp)->open, (*sp)->num_subgoals + 2);
+    (*sp)->g = (uint32_t*) malloc(
+            sizeof(uint32_t) * ((*sp)->num_subgoals + 2));
+    (*sp)->came_from = (uint32_t*) malloc(
+            sizeof(uint32_t) * ((*sp)->num_subgoals + 2));
+    (*sp)->visit = (uint32_t*) calloc((*sp)->num_subgoals + 2,
+                                      sizeof(uint32_t));
+    (*sp)->end_w = (uint32_t*) malloc(
+            sizeof(uint32_t) * ((*sp)->num_subgoals + 1));
+    (*sp)->end_visit = (uint32_t*) calloc((*sp)->num_subgoals + 1,
+                                          sizeof(uint32_t));
+    (*sp)->search = 0;
+    (*sp)->start_to = (uint32_t*) malloc(
+            sizeof(uint32_t) * ((*sp)->num_subgoals + 1));
+    (*sp)->start_w = (uint32_t*) malloc(
+            sizeof(uint32_t) * ((*sp)->num_subgoals + 1));
+    (*sp)->num_start = 0;
+    (*sp)->path = (uint32_t*) malloc(sizeof(uint32_t) * count);
+    (*sp)->path_size = 0;
+    (*sp)->cost = UINT32_MAX;
+}
+
+/**
+ * This function destroys the subgoal provided to it.
+ */
+void subgoal_free(subgoal* sp)
+{
+    /* De-allocate memory from the subgoal graph. */
+    free((*sp)->subgoal_of);
+    free((*sp)->cells);
+    free((*sp)->first_edge);
+    free((*sp)->edge_to);
+    free((*sp)->edge_w);
+
+    /* De-allocate memory from the scans. */
+    free((*sp)->cell_g);
+    free((*sp)->cell_from);
+    free((*sp)->cell_visit);
+    free((*sp)->queue);
+    free((*sp)->coords);
+    free((*sp)->found);
+    free((*sp)->found_w);
+
+    /* De-allocate memory from the search. */
+    id_heap_free(&(*sp)->open);
+    free((*sp)->g);
+    free((*sp)->came_from);
+    free((*sp)->visit);
+    free((*sp)->end_w);
+    free((*sp)->end_visit);
+    free((*sp)->start_to);
+    free((*sp)->start_w);
+    free((*sp)->path);
+
+    /* De-allocate memory from the subgoal. */
+    free(*sp);
+}
+
+/**
+ * This function searches for the shortest path from the start cell to the
+ * end cell over the subgoal graph.
+ */
+void subgoal_search(subgoal* sp, uint32_t start, uint32_t end)
+{
+    graph g;            /* The graph. */
+    uint32_t start_node; /* The node of the start cell. */
+    uint32_t end_node;  /* The node of the end cell. */
+    uint32_t current;   /* The node being expanded. */
+    uint32_t e;         /* The current edge. */
+    uint32_t i;         /* The index of the current subgoal found. */
+
+    /* Start a new search. */
+    g = *(*sp)->gp;
+    (*sp)->search++;
+    if ((*sp)->search == 0)
+    {
+        memset((*sp)->visit, 0,
+               sizeof(uint32_t) * ((*sp)->num_subgoals + 2));
+        memset((*sp)->end_visit, 0,
+               sizeof(uint32_t) * ((*sp)->num_subgoals + 1));
+        (*sp)->search = 1;
+    }
+    id_heap_clear(&(*sp)->open);
+    (*sp)->path_size = 0;
+    (*sp)->cost = UINT32_MAX;
+    (*sp)->start = start;
+    (*sp)->end = end;
+    start_node = (*sp)->num_subgoals;
+    end_node = start_node + 1;
+
+    /* Find the subgoals the start cell reaches directly. If it reaches the
+     * end cell as well, no path can be shorter than going straight. */
+    (*sp)->visit[start_node] = (*sp)->search;
+    (*sp)->g[start_node] = 0;
+    (*sp)->came_from[start_node] = SUBGOAL_NONE;
+    if (subgoal_scan(sp, start, end, false, false))
+    {
+        (*sp)->visit[end_node] = (*sp)->search;
+        (*sp)->g[end_node] = (*sp)->cell_g[end];
+        (*sp)->came_from[end_node] = start_node;
+        subgoal_reconstruct_path(sp);
+        return;
+    }
+    memcpy((*sp)->start_to, (*sp)->found, sizeof(uint32_t)
+                                          * (*sp)->num_found);
+    memcpy((*sp)->start_w, (*sp)->found_w, sizeof(uint32_t)
+                                           * (*sp)->num_found);
+    (*sp)->num_start = (*sp)->num_found;
+
+    /* Find the subgoals that reach the end cell directly. */
+    subgoal_scan(sp, end, GRAPH_NO_CELL, true, false);
+    for (i = 0; i < (*sp)->num_found; i++)
+    {
+        (*sp)->end_visit[(*sp)->found[i]] = (*sp)->search;
+        (*sp)->end_w[(*sp)->found[i]] = (*sp)->found_w[i];
+    }
+
+    /* Search the subgoal graph until the end node comes up. */
+    id_heap_push(&(*sp)->open, start_node, astar_estimate(g, start, end));
+    while (!id_heap_is_empty((*sp)->open))
+    {
+        current = id_heap_pop_min(&(*sp)->open);
+        if (current == end_node)
+        {
+            subgoal_reconstruct_path(sp);
+            return;
+        }
+
+        /* The start node's edges are the ones found for it. */
+        if (current == start_node)
+        {
+            for (i = 0; i < (*sp)->num_start; i++)
+            {
+                subgoal_relax(sp, current, (*sp)->start_to[i],
+                              (*sp)->start_w[i]);
+            }
+            continue;
+        }
+
+        /* Otherwise follow the subgoal's edges, and its edge to the end
+         * cell if it has one. */
+        for (e = (*sp)->first_edge[current];
+             e < (*sp)->first_edge[current + 1]; e++)
+        {
+            subgoal_relax(sp, current, (*sp)->edge_to[e], (*sp)->edge_w[e]);
+        }
+        if ((*sp)->end_visit[current] == (*sp)->search)
+        {
+            subgoal_relax(sp, current, end_node, (*sp)->end_w[current]);
+        }
+    }
+}
+
+/**
+ * This function returns the ids of the cells that make up the shortest path
+ * found by subgoal_search(), from the start cell to the end cell.
+ */
+uint32_t* subgoal_get_path(subgoal s)
+{
+    return s->path;
+}
+
+/**
+ * This function returns the number of cells in the path found by
+ * subgoal_search(). It is 0 if no path was found.
+ */
+uint32_t subgoal_get_path_size(subgoal s)
+{
+    return s->path_size;
+}
+
+/**
+ * This function returns the cost of the path found by subgoal_search(), or
+ * UINT32_MAX if no path was found.
+ */
+uint32_t subgoal_get_cost(subgoal s)
+{
+    return s->cost;
+}
+
+/**
+ * This function returns the number of subgoals in the subgoal graph of the
+ * subgoal provided to it.
+ */
+uint32_t subgoal_get_num_subgoals(subgoal s)
+{
+    return s->num_subgoals;
+}
+
+/**
+ * This function returns the number of edges in the subgoal graph of the
+ * subgoal provided to it.
+ */
+uint32_t subgoal_get_num_edges(subgoal s)
+{
+    return s->num_edges;
+}
+
+/**
+ * This function returns whether the cell at the coordinates provided to it
+ * is in the graph and passable.
+ */
+bool subgoal_is_open(subgoal s, int32_t x, int32_t y, int32_t z)
+{
+    uint32_t id;    /* The cell's id. */
+
+    if (x < 0 || y < 0 || z < 0 || x >= graph_get_x_size(*s->gp)
+        || y >= graph_get_y_size(*s->gp) || z >= graph_get_z_size(*s->gp))
+    {
+        return false;
+    }
+    id = graph_get_cell_id(*s->gp, (uint8_t) x, (uint8_t) y, (uint8_t) z);
+    return graph_cell_exists(*s->gp, id)
+           && node_get_type(*graph_get_cell_node(*s->gp, id)) == PASSABLE;
+}
+
+/**
+ * This function returns whether the cell at the coordinates provided to it
+ * is in the graph's volume and isn't passable.
+ */
+bool subgoal_is_blocked(subgoal s, int32_t x, int32_t y, int32_t z)
+{
+    if (x < 0 || y < 0 || z < 0 || x >= graph_get_x_size(*s->gp)
+        || y >= graph_get_y_size(*s->gp) || z >= graph_get_z_size(*s->gp))
+    {
+        return false;
+    }
+    return !subgoal_is_open(s, x, y, z);
+}
+
+/**
+ * This function returns whether the cell provided to it is next to the
+ * corner of an obstacle.
+ */
+bool subgoal_is_corner(subgoal s, uint32_t id)
+{
+    uint8_t x, y, z;        /* The cell's coordinates. */
+    int8_t d[3];            /* The offset of the obstacle. */
+    int8_t e[3];            /* The offset of a cell beside the obstacle. */
+    uint8_t axes;           /* The axes the offset moves along. */
+    uint8_t part;           /* Some of those axes, or the offset beside. */
+    bool diagonal;          /* Whether the graph is DIAGONAL. */
+    bool open;              /* Whether the cells in between are passable. */
+
+    /* Only passable cells can be subgoals. */
+    graph_get_cell_coords(*s->gp, id, &x, &y, &z);
+    if (!subgoal_is_open(s, x, y, z))
+    {
+        return false;
+    }
+
+    /* Look at each obstacle next to it. */
+    diagonal = graph_get_style(*s->gp) != MANHATTAN;
+    for (d[2] = -1; d[2] <= 1; d[2]++)
+    {
+        for (d[1] = -1; d[1] <= 1; d[1]++)
+        {
+            for (d[0] = -1; d[0] <= 1; d[0]++)
+            {
+                axes = (d[0] != 0 ? 1 : 0) | (d[1] != 0 ? 2 : 0)
+                     | (d[2] != 0 ? 4 : 0);
+                if (axes == 0
+                    || !subgoal_is_blocked(s, x + d[0], y + d[1], z + d[2]))
+                {
+                    continue;
+                }
+
+                /* On a DIAGONAL graph, where moves can cut past obstacles,
+                 * paths bend around an obstacle next to a face of the cell
+                 * that doesn't go on sideways, so it's a corner if a cell
+                 * beside the obstacle is passable. */
+                if (diagonal)
+                {
+                    if ((axes & (axes - 1)) != 0)
+                    {
+                        continue;
+                    }
+                    for (part = 1; part < 27; part++)
+                    {
+                        e[0] = (int8_t) (part % 3) - 1;
+                        e[1] = (int8_t) (part / 3 % 3) - 1;
+                        e[2] = (int8_t) (part / 9) - 1;
+                        if ((e[0] == 0 && e[1] == 0 && e[2] == 0)
+                            || (axes & 1 && e[0] != 0)
+                            || (axes & 2 && e[1] != 0)
+                            || (axes & 4 && e[2] != 0))
+                        {
+                            continue;
+                        }
+                        if (subgoal_is_open(s, x + d[0] + e[0],
+                                            y + d[1] + e[1],
+                                            z + d[2] + e[2]))
+                        {
+                            return true;
+                        }
+                    }
+                    continue;
+                }
+
+                /* Otherwise only an obstacle diagonally next to the cell
+                 * makes it a corner, if every cell between them is
+                 * passable. */
+                if ((axes & (axes - 1)) == 0)
+                {
+                    continue;
+                }
+                open = true;
+                for (part = (axes - 1) & axes; open && part != 0;
+                     part = (part - 1) & axes)
+                {
+                    open = subgoal_is_open(s, x + (part & 1 ? d[0] : 0),
+                                           y + (part & 2 ? d[1] : 0),
+                                           z + (part & 4 ? d[2] : 0));
+                }
+                if (open)
+                {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * This function scans the cells reachable from the cell provided to it for
+ * their estimated cost, finding the subgoals reached without passing
+ * another. It scans the cells the cell can be reached from instead if
+ * reverse is true, and only the cells on the way to the target cell if
+ * bounded is true. It returns whether it reached the target cell.
+ */
+bool subgoal_scan(subgoal* sp, uint32_t from, uint32_t target,
+                  bool reverse, bool bounded)
+{
+    graph g;            /* The graph. */
+    uint32_t head;      /* The next cell in the queue. */
+    uint32_t current;   /* The cell being scanned from. */
+    uint32_t e;         /* The edge leading to the neighbour. */
+    uint32_t last;      /* The end of the cell's edges. */
+    uint32_t mask;      /* The directions of the passable neighbours. */
+    uint32_t n;         /* The neighbour. */
+    uint8_t* c;         /* The coordinates of the current cell. */
+    int8_t* o;          /* The offsets of the neighbour's direction. */
+    uint8_t dir;        /* The direction of the neighbour. */
+    bool unit;          /* Whether the graph is a unit grid. */
+    bool reached;       /* Whether the target cell was reached. */
+
+    /* Start a new scan. */
+    g = *(*sp)->gp;
+    (*sp)->cell_scan++;
+    if ((*sp)->cell_scan == 0)
+    {
+        memset((*sp)->cell_visit, 0,
+               sizeof(uint32_t) * graph_get_cell_count(g));
+        (*sp)->cell_scan = 1;
+    }
+    (*sp)->num_found = 0;
+    reached = false;
+    (*sp)->cell_visit[from] = (*sp)->cell_scan;
+    (*sp)->cell_g[from] = 0;
+    (*sp)->cell_from[from] = GRAPH_NO_CELL;
+    (*sp)->queue[0] = from;
+    (*sp)->tail = 1;
+    head = 0;
+
+    /* Nothing can be reached from an impassable cell backwards. */
+    unit = graph_is_unit_grid(g);
+    if (unit && reverse && !subgoal_is_open(*sp, (*sp)->coords[3 * from],
+                                            (*sp)->coords[3 * from + 1],
+                                            (*sp)->coords[3 * from + 2]))
+    {
+        return false;
+    }
+
+    /* Each cell is reached at its estimated cost or not at all, so the
+     * order the cells are scanned in doesn't matter. */
+    while (head < (*sp)->tail)
+    {
+        current = (*sp)->queue[head];
+        head++;
+
+        /* Note the target, and subgoals, which the scan doesn't go past. */
+        if (current == target)
+        {
+            reached = true;
+        }
+        if (current != from && (*sp)->subgoal_of[current] != SUBGOAL_NONE)
+        {
+            if ((*sp)->num_found == (*sp)->found_capacity)
+            {
+                (*sp)->found_capacity *= 2;
+                (*sp)->found = (uint32_t*) realloc((*sp)->found,
+                        sizeof(uint32_t) * (*sp)->found_capacity);
+                (*sp)->found_w = (uint32_t*) realloc((*sp)->found_w,
+                        sizeof(uint32_t) * (*sp)->found_capacity);
+            }
+            (*sp)->found[(*sp)->num_found] = (*sp)->subgoal_of[current];
+            (*sp)->found_w[(*sp)->num_found] = (*sp)->cell_g[current];
+            (*sp)->num_found++;
+            continue;
+        }
+
+        /* Move to the neighbours whose cost is their estimate. When the
+         * passability mask describes all of the cell's edges, which are
+         * the same both ways, the neighbours are found from it. */
+        if (unit)
+        {
+            mask = graph_get_pass_mask(g, current)
+                 & subgoal_away_mask(*sp, from, current);
+            if (bounded)
+            {
+                mask &= subgoal_toward_mask(*sp, target, current);
+            }
+            while (mask != 0)
+            {
+                dir = subgoal_lowest_bit(mask);
+                mask &= mask - 1;
+                c = &(*sp)->coords[3 * current];
+                o = &(*sp)->offsets[3 * dir];
+                n = graph_get_cell_id(g, c[0] + o[0], c[1] + o[1],
+                                      c[2] + o[2]);
+                if ((*sp)->cell_visit[n] != (*sp)->cell_scan)
+                {
+                    (*sp)->cell_visit[n] = (*sp)->cell_scan;
+                    (*sp)->cell_g[n] = (*sp)->cell_g[current] + 1;
+                    (*sp)->cell_from[n] = current;
+                    (*sp)->queue[(*sp)->tail] = n;
+                    (*sp)->tail++;
+                }
+            }
+            continue;
+        }
+        last = reverse ? graph_get_first_in_edge(g, current + 1)
+                       : graph_get_first_edge(g, current + 1);
+        for (e = reverse ? graph_get_first_in_edge(g, current)
+                         : graph_get_first_edge(g, current); e < last; e++)
+        {
+            subgoal_reach(sp, from, current,
+                          reverse ? graph_get_in_edge_from(g, e)
+                                  : graph_get_edge_to(g, e),
+                          reverse ? graph_get_in_edge_w(g, e)
+                                  : graph_get_edge_w(g, e));
+        }
+    }
+    return reached;
+}
+
+/**
+ * This function queues the neighbour provided to it, reached from the
+ * current cell by a move with the cost also provided, if the scan from the
+ * cell provided first hasn't reached it and its cost is its estimate.
+ */
+void subgoal_reach(subgoal* sp, uint32_t from, uint32_t current,
+                   uint32_t n, uint8_t w)
+{
+    uint32_t next_g;    /* The cost of the neighbour through the cell. */
+    uint8_t* f;         /* The coordinates of the cell scanned from. */
+    uint8_t* c;         /* The coordinates of the neighbour. */
+
+    next_g = (*sp)->cell_g[current] + w;
+    if (w == 0 || (*sp)->cell_visit[n] == (*sp)->cell_scan)
+    {
+        return;
+    }
+    f = &(*sp)->coords[3 * from];
+    c = &(*sp)->coords[3 * n];
+    if (astar_estimate_coords(graph_get_style(*(*sp)->gp), f[0], f[1], f[2],
+                              c[0], c[1], c[2]) != next_g)
+    {
+        return;
+    }
+    (*sp)->cell_visit[n] = (*sp)->cell_scan;
+    (*sp)->cell_g[n] = next_g;
+    (*sp)->cell_from[n] = current;
+    (*sp)->queue[(*sp)->tail] = n;
+    (*sp)->tail++;
+}
+
+/**
+ * This function returns the directions a move from the current cell
+ * provided to it can take to add 1 to its estimated cost from the cell
+ * scanned from, also provided.
+ */
+uint32_t subgoal_away_mask(subgoal s, uint32_t from, uint32_t current)
+{
+    int32_t d;          /* The offset along the current axis. */
+    uint32_t h;         /* The estimated cost of the current cell. */
+    uint32_t mask;      /* The directions found so far. */
+    uint8_t axis;       /* The current axis. */
+
+    /* A move adds 1 to the Manhattan distance if it moves away along its
+     * axis, and to the Chebyshev distance if it moves away along an axis
+     * the cell is furthest along. */
+    h = s->cell_g[current];
+    mask = 0;
+    for (axis = 0; axis < 3; axis++)
+    {
+        d = (int32_t) s->coords[3 * current + axis]
+          - (int32_t) s->coords[3 * from + axis];
+        if (graph_get_style(*s->gp) != MANHATTAN
+            && (uint32_t) (d < 0 ? -d : d) != h)
+        {
+            continue;
+        }
+        if (d >= 0)
+        {
+            mask |= s->away[2 * axis + 1];
+        }
+        if (d <= 0)
+        {
+            mask |= s->away[2 * axis];
+        }
+    }
+    return mask;
+}
+
+/**
+ * This function returns the directions a move from the current cell
+ * provided to it can take to take 1 from its estimated cost to the target
+ * cell, also provided.
+ */
+uint32_t subgoal_toward_mask(subgoal s, uint32_t target, uint32_t current)
+{
+    int32_t d[3];       /* The offsets along each axis. */
+    uint32_t a;         /* The distance along the current axis. */
+    uint32_t h;         /* The estimated cost to the target cell. */
+    uint32_t mask;      /* The directions found so far. */
+    uint8_t axis;       /* The current axis. */
+
+    /* A move takes 1 from the Manhattan distance if it moves toward the
+     * target along its axis, and from the Chebyshev distance if it moves
+     * toward it along every axis the cell is furthest along. */
+    h = 0;
+    for (axis = 0; axis < 3; axis++)
+    {
+        d[axis] = (int32_t) s->coords[3 * target + axis]
+                - (int32_t) s->coords[3 * current + axis];
+        if ((uint32_t) (d[axis] < 0 ? -d[axis] : d[axis]) > h)
+        {
+            h = (uint32_t) (d[axis] < 0 ? -d[axis] : d[axis]);
+        }
+    }
+    mask = graph_get_style(*s->gp) == MANHATTAN ? 0 : UINT32_MAX;
+    for (axis = 0; axis < 3; axis++)
+    {
+        a = (uint32_t) (d[axis] < 0 ? -d[axis] : d[axis]);
+        if (graph_get_style(*s->gp) == MANHATTAN)
+        {
+            if (a != 0)
+            {
+                mask |= s->away[2 * axis + (d[axis] > 0 ? 1 : 0)];
+            }
+        }
+        else if (a == h)
+        {
+            mask &= s->away[2 * axis + (d[axis] > 0 ? 1 : 0)];
+        }
+        else if (a + 1 == h)
+        {
+            /* The other axes mustn't become the furthest. */
+            if (d[axis] >= 0)
+            {
+                mask &= ~s->away[2 * axis];
+            }
+            if (d[axis] <= 0)
+            {
+                mask &= ~s->away[2 * axis + 1];
+            }
+        }
+    }
+    return mask;
+}
+
+/**
+ * This function returns the position of the lowest set bit of the mask
+ * provided to it, which must not be 0.
+ */
+uint8_t subgoal_lowest_bit(uint32_t mask)
+{
+#if defined(__GNUC__)
+    return (uint8_t) __builtin_ctz(mask);
+#else
+    uint8_t bit;    /* The position of the current bit. */
+
+    /* Find the first set bit. */
+    for (bit = 0; !(mask & 1); bit++)
+    {
+        mask >>= 1;
+    }
+    return bit;
+#endif
+}
+
+/**
+ * This function returns the cell of the node of the search over the
+ * subgoal graph provided to it.
+ */
+uint32_t subgoal_node_cell(subgoal s, uint32_t node)
+{
+    if (node == s->num_subgoals)
+    {
+        return s->start;
+    }
+    if (node == s->num_subgoals + 1)
+    {
+        return s->end;
+    }
+    return s->cells[node];
+}
+
+/**
+ * This function records the path to the node provided to it through the
+ * current node, if it's better than any path found to it before.
+ */
+void subgoal_relax(subgoal* sp, uint32_t current, uint32_t node,
+                   uint32_t w)
+{
+    uint32_t next_g;    /* The cost of the path through the current node. */
+
+    next_g = (*sp)->g[current] + w;
+    if ((*sp)->visit[node] != (*sp)->search || next_g < (*sp)->g[node])
+    {
+        (*sp)->visit[node] = (*sp)->search;
+        (*sp)->g[node] = next_g;
+        (*sp)->came_from[node] = current;
+        id_heap_push(&(*sp)->open, node, next_g
+                     + astar_estimate(*(*sp)->gp, subgoal_node_cell(*sp, node),
+                                      (*sp)->end));
+    }
+}
+
+/**
+ * This function reconstructs the path that ends at the end cell, refining
+ * each edge into single moves.
+ */
+void subgoal_reconstruct_path(subgoal* sp)
+{
+    uint32_t node;      /* The current node. */
+    uint32_t size;      /* The number of nodes on the path. */
+    uint32_t count;     /* The number of cells in the graph. */
+    uint32_t i;         /* The index of the current node. */
+
+    /* Follow the nodes back from the end, keeping their cells at the back
+     * of the path array. The refined path can't catch up with them, as the
+     * whole path fits in the array. */
+    count = graph_get_cell_count(*(*sp)->gp);
+    size = 0;
+    for (node = (*sp)->num_subgoals + 1; node != SUBGOAL_NONE;
+         node = (*sp)->came_from[node])
+    {
+        size++;
+        (*sp)->path[count - size] = subgoal_node_cell(*sp, node);
+    }
+
+    /* Refine each edge into single moves. */
+    (*sp)->path[0] = (*sp)->path[count - size];
+    (*sp)->path_size = 1;
+    for (i = size - 1; i > 0; i--)
+    {
+        subgoal_refine(sp, (*sp)->path[count - i]);
+    }
+    (*sp)->cost = (*sp)->g[(*sp)->num_subgoals + 1];
+}
+
+/**
+ * This function adds the single moves of a path from the last cell of the
+ * path to the cell provided to it, which can be reached for its estimated
+ * cost, to the path.
+ */
+void subgoal_refine(subgoal* sp, uint32_t to)
+{
+    graph g;            /* The graph. */
+    uint32_t from;      /* The cell the path is refined from. */
+    uint32_t current;   /* The current cell of the straight path. */
+    uint32_t next;      /* The next cell of the straight path. */
+    uint32_t size;      /* The number of cells in the path so far. */
+    uint32_t i;         /* The index of the current cell to turn around. */
+    uint8_t x, y, z;    /* The current cell's coordinates. */
+    uint8_t tx, ty, tz; /* The coordinates of the cell to reach. */
+    bool diagonal;      /* Whether the axes can be moved along at once. */
+    bool moved;         /* Whether the current step has moved yet. */
+
+    /* Try going straight first, moving along every axis that's off at
+     * once on a DIAGONAL graph and one axis at a time otherwise. */
+    g = *(*sp)->gp;
+    from = (*sp)->path[(*sp)->path_size - 1];
+    size = (*sp)->path_size;
+    diagonal = graph_get_style(g) != MANHATTAN;
+    graph_get_cell_coords(g, from, &x, &y, &z);
+    graph_get_cell_coords(g, to, &tx, &ty, &tz);
+    current = from;
+    while (current != to)
+    {
+        moved = false;
+        if (x != tx)
+        {
+            x = x < tx ? x + 1 : x - 1;
+            moved = true;
+        }
+        if ((diagonal || !moved) && y != ty)
+        {
+            y = y < ty ? y + 1 : y - 1;
+            moved = true;
+        }
+        if ((diagonal || !moved) && z != tz)
+        {
+            z = z < tz ? z + 1 : z - 1;
+        }
+        next = graph_get_cell_id(g, x, y, z);
+        if (subgoal_move_w(*sp, current, next) != 1)
+        {
+            break;
+        }
+        (*sp)->path[size] = next;
+        size++;
+        current = next;
+    }
+    if (current == to)
+    {
+        (*sp)->path_size = size;
+        return;
+    }
+
+    /* Otherwise scan from the cell and follow the scan's path back from
+     * the cell to reach, keeping it in the order it's found and then
+     * turning it around. */
+    subgoal_scan(sp, from, to, false, true);
+    size = (*sp)->path_size;
+    for (current = to; current != from;
+         current = (*sp)->cell_from[current])
+    {
+        (*sp)->path[size] = current;
+        size++;
+    }
+    for (i = 0; i < (size - (*sp)->path_size) / 2; i++)
+    {
+        next = (*sp)->path[(*sp)->path_size + i];
+        (*sp)->path[(*sp)->path_size + i] = (*sp)->path[size - 1 - i];
+        (*sp)->path[size - 1 - i] = next;
+    }
+    (*sp)->path_size = size;
+}
+
+/**
+ * This function returns the cost of the move from the first cell provided
+ * to it to the second, or 0 if the move isn't possible.
+ */
+uint8_t subgoal_move_w(subgoal s, uint32_t from, uint32_t to)
+{
+    uint32_t e;     /* The current edge. */
+    uint32_t last;  /* The end of the cell's edges. */
+
+    last = graph_get_first_edge(*s->gp, from + 1);
+    for (e = graph_get_first_edge(*s->gp, from); e < last; e++)
+    {
+        if (graph_get_edge_to(*s->gp, e) == to
+            && graph_get_edge_w(*s->gp, e) != 0)
+        {
+            return graph_get_edge_w(*s->gp, e);
+        }
+    }
+    return 0;
+}
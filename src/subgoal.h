@@ -0,0 +1,91 @@
+/**
+ * subgoal.h
+ *
+ * This file contains the data-structure and function prototype declarations
+ * for the subgoal type.
+ *
+ * The subgoal type is a simple subgoal graph. Subgoals are placed at the
+ * passable cells next to the corners of obstacles, where the shortest paths
+ * around them bend. Two subgoals are joined by an edge if one can be reached
+ * from the other by a path that costs no more than astar's estimate between
+ * them, without passing another subgoal on the way. Only those edges are
+ * searched. Between two subgoals the path goes straight, so a path of cells
+ * is only worked out for the edges of the path that's found.
+ *
+ * A search joins the start and end cells to the subgoals they can reach the
+ * same way, searches the subgoal graph with A*, and then refines each edge
+ * of the path into single moves, going straight where the cells are free.
+ * The paths are as short as A*'s. The subgoal graph is built from the graph
+ * as it is when subgoal_init() is called, for maps that don't change.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#ifndef SUBGOAL_H
+#define SUBGOAL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "graph.h"
+#include "id_heap.h"
+#include "astar.h"
+
+/**
+ * The data-structure of the subgoal type.
+ */
+typedef struct subgoal_data* subgoal;
+
+/**
+ * This function initialises the subgoal provided to it by building the
+ * subgoal graph of the graph also provided.
+ */
+void subgoal_init(subgoal* sp, graph* gp);
+
+/**
+ * This function destroys the subgoal provided to it.
+ */
+void subgoal_free(subgoal* sp);
+
+/**
+ * This function searches for the shortest path from the start cell to the
+ * end cell over the subgoal graph.
+ */
+void subgoal_search(subgoal* sp, uint32_t start, uint32_t end);
+
+/**
+ * This function returns the ids of the cells that make up the shortest path
+ * found by subgoal_search(), from the start cell to the end cell.
+ */
+uint32_t* subgoal_get_path(subgoal s);
+
+/**
+ * This function returns the number of cells in the path found by
+ * subgoal_search(). It is 0 if no path was found.
+ */
+uint32_t subgoal_get_path_size(subgoal s);
+
+/**
+ * This function returns the cost of the path found by subgoal_search(), or
+ * UINT32_MAX if no path was found.
+ */
+uint32_t subgoal_get_cost(subgoal s);
+
+/**
+ * This function returns the number of subgoals in the subgoal graph of the
+ * subgoal provided to it.
+ */
+uint32_t subgoal_get_num_subgoals(subgoal s);
+
+/**
+ * This function returns the number of edges in the subgoal graph of the
+ * subgoal provided to it.
+ */
+uint32_t subgoal_get_num_edges(subgoal s);
+
+#endif // SUBGOAL_H
@@ -0,0 +1,564 @@
+/**
+ * wavefront.c
+ *
+ * This file contains the internal data-structure and function definitions
+ * for the wavefront type.
+ *
+ * The wavefront type runs breadth first searches over a graph whose moves
+ * all cost 1. The cells are stored as bitmaps in rows along the x axis, with
+ * one row of 64 bit words for every y and z coordinate. Moving the frontier
+ * one step along the x axis shifts the words of a row, and moving it along
+ * the y or z axes ORs neighbouring rows together.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#include "wavefront.h"
+
+/**
+ * This is the number of cells stored in each word of a bitmap.
+ */
+#define WAVEFRONT_WORD_BITS 64
+
+/**
+ * This is the internal data-structure of the wavefront type.
+ */
+struct wavefront_data {
+    graph* gp;              /* The graph the wavefront searches. */
+    enum graph_style gstyle; /* The moves the graph allows. */
+    uint8_t ysize;          /* The size of the graph's y axis. */
+    uint8_t zsize;          /* The size of the graph's z axis. */
+    uint32_t row_words;     /* The number of words in each row of a bitmap. */
+    uint32_t num_rows;      /* The number of rows in each bitmap. */
+    uint32_t num_words;     /* The number of words in each bitmap. */
+    uint64_t* passable;     /* The cells that can be moved into. */
+    uint64_t* reached;      /* The cells the last run reached. */
+    uint64_t* seen;         /* The cells a reachability check has reached. */
+    uint64_t* frontier;     /* The cells reached by the last step. */
+    uint64_t* next;         /* The cells reached by the current step. */
+    uint64_t* tmp;          /* Scratch space for diagonal steps. */
+    uint32_t* distance;     /* The distance of each cell id to the goal. */
+    uint32_t goal;          /* The goal cell of the last run. */
+    uint32_t decreases;     /* The graph's number of decreases at the
+                             * last run. */
+};
+
+/**
+ * This function finds the word and the bit of the cell with the coordinates
+ * provided to it in the bitmaps of the wavefront also provided.
+ */
+void wavefront_locate(wavefront w, uint8_t x, uint8_t y, uint8_t z,
+                      uint32_t* wordp, uint64_t* bitp);
+
+/**
+ * This function finds the word and the bit of the cell with the id provided
+ * to it in the bitmaps of the wavefront also provided.
+ */
+void wavefront_locate_id(wavefront w, uint32_t id,
+                         uint32_t* wordp, uint64_t* bitp);
+
+/**
+ * This function returns the position of the lowest set bit of the word
+ * provided to it, which must not be 0.
+ */
+uint8_t wavefront_lowest_bit(uint64_t bits);
+
+/**
+ * This function sets out to the cells that are at most one MANHATTAN move
+ * from the cells in the bitmap in.
+ */
+void wavefront_dilate_manhattan(wavefront w, uint64_t* in, uint64_t* out);
+
+/**
+ * This function sets out to the cells that are at most one DIAGONAL move
+ * from the cells in the bitmap in. It uses the wavefront's scratch space.
+ */
+void wavefront_dilate_diagonal(wavefront w, uint64_t* in, uint64_t* out);
+
+/**
+ * This function sets out to the cells in the bitmap in and the cells next to
+ * them along the x axis.
+ */
+void wavefront_dilate_x(wavefront w, uint64_t* in, uint64_t* out);
+
+/**
+ * This function sets out to the cells in the bitmap in and the cells next to
+ * them along the axis whose neighbouring rows are stride rows apart. The
+ * axis has size coordinates.
+ */
+void wavefront_dilate_rows(wavefront w, uint64_t* in, uint64_t* out,
+                           uint32_t stride, uint32_t size);
+
+/**
+ * This function moves the frontier of the wavefront provided to it one step.
+ * The cells the step reaches that aren't in the bitmap reached are added to
+ * it and become the new frontier. It returns false if no cells were added.
+ */
+bool wavefront_step(wavefront* wp, uint64_t* reached);
+
+/**
+ * This function sets the distance of every cell in the frontier of the
+ * wavefront provided to it to the distance also provided.
+ */
+void wavefront_record_frontier(wavefront* wp, uint32_t distance);
+
+/**
+ * This function initialises the wavefront provided to it from the types of
+ * the cells of the graph also provided to the function.
+ */
+void wavefront_init(wavefront* wp, graph* gp)
+{
+    uint32_t id;    /* The id of the current cell. */
+
+    /* Allocate memory to the wavefront. */
+    *wp = (wavefront) malloc(sizeof(struct wavefront_data));
+
+    /* Work out the shape of the bitmaps. */
+    (*wp)->gp = gp;
+    (*wp)->gstyle = graph_get_style(*gp);
+    (*wp)->ysize = graph_get_y_size(*gp);
+    (*wp)->zsize = graph_get_z_size(*gp);
+    (*wp)->row_words = (graph_get_x_size(*gp) + WAVEFRONT_WORD_BITS - 1)
+                     / WAVEFRONT_WORD_BITS;
+    (*wp)->num_rows = (uint32_t) (*wp)->ysize * (*wp)->zsize;
+    (*wp)->num_words = (*wp)->num_rows * (*wp)->row_words;
+
+    /* Allocate memory to the bitmaps and the distances. */
+    (*wp)->passable = (uint64_t*) calloc((*wp)->num_words, sizeof(uint64_t));
+    (*wp)->reached = (uint64_t*) calloc((*wp)->num_words, sizeof(uint64_t));
+    (*wp)->seen = (uint64_t*) calloc((*wp)->num_words, sizeof(uint64_t));
+    (*wp)->frontier = (uint64_t*) calloc((*wp)->num_words, sizeof(uint64_t));
+    (*wp)->next = (uint64_t*) calloc((*wp)->num_words, sizeof(uint64_t));
+    (*wp)->tmp = (uint64_t*) calloc((*wp)->num_words, sizeof(uint64_t));
+    (*wp)->distance = (uint32_t*) malloc(
+            sizeof(uint32_t) * graph_get_cell_count(*gp));
+    (*wp)->goal = GRAPH_NO_CELL;
+
+    /* Read the type of every cell. */
+    for (id = 0; id < graph_get_cell_count(*gp); id++)
+    {
+        if (graph_cell_exists(*gp, id))
+        {
+            wavefront_update_cell(wp, id);
+        }
+    }
+}
+
+/**
+ * This function destroys the wavefront provided to it.
+ */
+void wavefront_free(wavefront* wp)
+{
+    /* De-allocate memory from the bitmaps and the distances. */
+    free((*wp)->passable);
+    free((*wp)->reached);
+    free((*wp)->seen);
+    free((*wp)->frontier);
+    free((*wp)->next);
+    free((*wp)->tmp);
+    free((*wp)->distance);
+
+    /* De-allocate memory from the wavefront. */
+    free(*wp);
+}
+
+/**
+ * This function reads the type of the cell with the id provided to it from
+ * the graph again. It must be called after graph_set_cell_type() changes a
+ * cell, before the wavefront is run.
+ */
+void wavefront_update_cell(wavefront* wp, uint32_t id)
+{
+    uint32_t word;  /* The word holding the cell's bit. */
+    uint64_t bit;   /* The cell's bit. */
+
+    /* Set or clear the cell's bit in the passable bitmap. */
+    wavefront_locate_id(*wp, id, &word, &bit);
+    if (node_get_type(*graph_get_cell_node(*(*wp)->gp, id)) == PASSABLE)
+    {
+        (*wp)->passable[word] |= bit;
+    }
+    else
+    {
+        (*wp)->passable[word] &= ~bit;
+    }
+}
+
+/**
+ * This function measures the number of moves from every passable cell to
+ * the goal cell provided to it. The distances are read with
+ * wavefront_get_distance() until the wavefront is run again.
+ */
+void wavefront_run(wavefront* wp, uint32_t goal)
+{
+    uint32_t word;      /* The word holding the goal's bit. */
+    uint64_t bit;       /* The goal's bit. */
+    uint32_t distance;  /* The distance of the current frontier. */
+
+    /* Start the frontier at the goal. */
+    memset((*wp)->reached, 0, sizeof(uint64_t) * (*wp)->num_words);
+    memset((*wp)->frontier, 0, sizeof(uint64_t) * (*wp)->num_words);
+    wavefront_locate_id(*wp, goal, &word, &bit);
+    (*wp)->reached[word] = bit;
+    (*wp)->frontier[word] = bit;
+    (*wp)->distance[goal] = 0;
+    (*wp)->goal = goal;
+    (*wp)->decreases = graph_get_num_decreases(*(*wp)->gp);
+
+    /* Grow the frontier one move at a time until it stops growing. Every
+     * cell it reaches is one move further from the goal than the last. */
+    for (distance = 1; wavefront_step(wp, (*wp)->reached); distance++)
+    {
+        wavefront_record_frontier(wp, distance);
+    }
+}
+
+/**
+ * This function returns the goal cell of the last run of the wavefront
+ * provided to it, or GRAPH_NO_CELL if it hasn't been run.
+ */
+uint32_t wavefront_get_goal(wavefront w)
+{
+    return w->goal;
+}
+
+/**
+ * This function returns true if the distances of the last run of the
+ * wavefront provided to it still can't be more than the real costs on its
+ * graph: it has been run and, as counted by graph_get_num_decreases(),
+ * nothing has made moving through the graph cheaper since. Cells made
+ * IMPASSABLE since only make the distances lower bounds.
+ */
+bool wavefront_is_current(wavefront w)
+{
+    return w->goal != GRAPH_NO_CELL 
+        && w->decreases == graph_get_num_decreases(*w->gp);
+}
+
+/**
+ * This function returns the number of moves from the cell provided to it to
+ * the goal cell of the last run, or WAVEFRONT_UNREACHABLE if the cell can't
+ * reach the goal.
+ */
+uint32_t wavefront_get_distance(wavefront w, uint32_t id)
+{
+    uint32_t word;  /* The word holding the cell's bit. */
+    uint64_t bit;   /* The cell's bit. */
+
+    /* Only the cells the last run reached have a distance. */
+    wavefront_locate_id(w, id, &word, &bit);
+    if (w->goal == GRAPH_NO_CELL || !(w->reached[word] & bit))
+    {
+        return WAVEFRONT_UNREACHABLE;
+    }
+    return w->distance[id];
+}
+
+/**
+ * This function returns the neighbour the cell provided to it should move to
+ * next to reach the goal cell of the last run in the fewest moves. It
+ * returns GRAPH_NO_CELL if the cell is the goal or can't reach it.
+ */
+uint32_t wavefront_get_next(wavefront w, uint32_t id)
+{
+    uint32_t mask;      /* The directions the cell can move in. */
+    uint32_t neighbour; /* The neighbour in the current direction. */
+    uint32_t distance;  /* The neighbour's distance to the goal. */
+    uint32_t best;      /* The closest neighbour to the goal so far. */
+    uint32_t best_distance; /* Its distance to the goal. */
+    uint8_t dir;        /* The current direction. */
+
+    /* Make sure the graph's passability masks are up to date. */
+    graph_update_index(w->gp);
+
+    /* Find the neighbour closest to the goal. */
+    best = GRAPH_NO_CELL;
+    best_distance = wavefront_get_distance(w, id);
+    mask = graph_get_pass_mask(*w->gp, id);
+    for (dir = 0; dir < GRAPH_NUM_DIRECTIONS; dir++)
+    {
+        if (mask & ((uint32_t) 1 << dir))
+        {
+            neighbour = graph_get_neighbour_id(*w->gp, id, dir);
+            distance = wavefront_get_distance(w, neighbour);
+            if (distance < best_distance)
+            {
+                best = neighbour;
+                best_distance = distance;
+            }
+        }
+    }
+
+    /* Return the closest neighbour, if it's closer than the cell. */
+    return best;
+}
+
+/**
+ * This function returns true if the cell with the id b can be reached from
+ * the cell with the id a. It stops as soon as b is reached and doesn't
+ * change the distances of the last run.
+ */
+bool wavefront_is_reachable(wavefront* wp, uint32_t a, uint32_t b)
+{
+    uint32_t word;      /* The word holding a cell's bit. */
+    uint64_t bit;       /* A cell's bit. */
+    uint32_t b_word;    /* The word holding b's bit. */
+    uint64_t b_bit;     /* b's bit. */
+
+    /* Start the frontier at a. */
+    memset((*wp)->seen, 0, sizeof(uint64_t) * (*wp)->num_words);
+    memset((*wp)->frontier, 0, sizeof(uint64_t) * (*wp)->num_words);
+    wavefront_locate_id(*wp, a, &word, &bit);
+    (*wp)->seen[word] = bit;
+    (*wp)->frontier[word] = bit;
+
+    /* Grow the frontier until it reaches b or stops growing. */
+    wavefront_locate_id(*wp, b, &b_word, &b_bit);
+    while (!((*wp)->seen[b_word] & b_bit))
+    {
+        if (!wavefront_step(wp, (*wp)->seen))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * This function finds the word and the bit of the cell with the coordinates
+ * provided to it in the bitmaps of the wavefront also provided.
+ */
+void wavefront_locate(wavefront w, uint8_t x, uint8_t y, uint8_t z,
+                      uint32_t* wordp, uint64_t* bitp)
+{
+    *wordp = ((uint32_t) z * w->ysize + y) * w->row_words
+           + x / WAVEFRONT_WORD_BITS;
+    *bitp = (uint64_t) 1 << (x % WAVEFRONT_WORD_BITS);
+}
+
+/**
+ * This function finds the word and the bit of the cell with the id provided
+ * to it in the bitmaps of the wavefront also provided.
+ */
+void wavefront_locate_id(wavefront w, uint32_t id,
+                         uint32_t* wordp, uint64_t* bitp)
+{
+    uint8_t x, y, z;    /* The cell's coordinates. */
+
+    graph_get_cell_coords(*w->gp, id, &x, &y, &z);
+    wavefront_locate(w, x, y, z, wordp, bitp);
+}
+
+/**
+ * This function moves the frontier of the wavefront provided to it one step.
+ * The cells the step reaches that aren't in the bitmap reached are added to
+ * it and become the new frontier. It returns false if no cells were added.
+ */
+bool wavefront_step(wavefront* wp, uint64_t* reached)
+{
+    uint64_t* swap;     /* The old frontier, while it's swapped. */
+    uint64_t added;     /* Whether any cells were added. */
+    uint32_t i;         /* The index of the current word. */
+
+    /* Find the cells one move from the frontier. */
+    if ((*wp)->gstyle == MANHATTAN)
+    {
+        wavefront_dilate_manhattan(*wp, (*wp)->frontier, (*wp)->next);
+    }
+    else
+    {
+        wavefront_dilate_diagonal(*wp, (*wp)->frontier, (*wp)->next);
+    }
+
+    /* Keep the ones that can be moved into and haven't been reached. */
+    added = 0;
+    for (i = 0; i < (*wp)->num_words; i++)
+    {
+        (*wp)->next[i] &= (*wp)->passable[i] & ~reached[i];
+        reached[i] |= (*wp)->next[i];
+        added |= (*wp)->next[i];
+    }
+
+    /* The new cells are the next frontier. */
+    swap = (*wp)->frontier;
+    (*wp)->frontier = (*wp)->next;
+    (*wp)->next = swap;
+    return added != 0;
+}
+
+/**
+ * This function sets the distance of every cell in the frontier of the
+ * wavefront provided to it to the distance also provided.
+ */
+void wavefront_record_frontier(wavefront* wp, uint32_t distance)
+{
+    uint64_t bits;      /* The frontier's bits left in the current word. */
+    uint32_t i;         /* The index of the current word. */
+    uint32_t row;       /* The row of the current word. */
+    uint8_t x;          /* The x coordinate of the current cell. */
+
+    /* Visit every set bit of the frontier. */
+    for (i = 0; i < (*wp)->num_words; i++)
+    {
+        row = i / (*wp)->row_words;
+        for (bits = (*wp)->frontier[i]; bits != 0; bits &= bits - 1)
+        {
+            /* Find the cell of the lowest set bit and record its distance. */
+            x = (uint8_t) ((i % (*wp)->row_words) * WAVEFRONT_WORD_BITS
+                         + wavefront_lowest_bit(bits));
+            (*wp)->distance[graph_get_cell_id(*(*wp)->gp, x,
+                                              row % (*wp)->ysize,
+                                              row / (*wp)->ysize)] = distance;
+        }
+    }
+}
+
+/**
+ * This function returns the position of the lowest set bit of the word
+ * provided to it, which must not be 0.
+ */
+uint8_t wavefront_lowest_bit(uint64_t bits)
+{
+#if defined(__GNUC__)
+    return (uint8_t) __builtin_ctzll(bits);
+#else
+    uint8_t bit;    /* The position of the current bit. */
+
+    /* Find the first set bit. */
+    for (bit = 0; !(bits & 1); bit++)
+    {
+        bits >>= 1;
+    }
+    return bit;
+#endif
+}
+
+/**
+ * This function sets out to the cells that are at most one MANHATTAN move
+ * from the cells in the bitmap in.
+ */
+void wavefront_dilate_manhattan(wavefront w, uint64_t* in, uint64_t* out)
+{
+    uint32_t row;       /* The current row. */
+    uint32_t y;         /* The y coordinate of the current row. */
+    uint32_t z;         /* The z coordinate of the current row. */
+    uint32_t i;         /* The index of the current word. */
+    uint32_t words;     /* The number of words in a row. */
+    uint32_t ystride;   /* The number of words between y neighbours. */
+    uint32_t zstride;   /* The number of words between z neighbours. */
+
+    /* Moves along the x axis shift within each row. */
+    wavefront_dilate_x(w, in, out);
+
+    /* Moves along the y and z axes take the rows next to each row. */
+    words = w->row_words;
+    ystride = words;
+    zstride = words * w->ysize;
+    for (row = 0; row < w->num_rows; row++)
+    {
+        y = row % w->ysize;
+        z = row / w->ysize;
+        for (i = row * words; i < (row + 1) * words; i++)
+        {
+            if (y > 0)
+            {
+                out[i] |= in[i - ystride];
+            }
+            if (y + 1 < w->ysize)
+            {
+                out[i] |= in[i + ystride];
+            }
+            if (z > 0)
+            {
+                out[i] |= in[i - zstride];
+            }
+            if (z + 1 < w->zsize)
+            {
+                out[i] |= in[i + zstride];
+            }
+        }
+    }
+}
+
+/**
+ * This function sets out to the cells that are at most one DIAGONAL move
+ * from the cells in the bitmap in. It uses the wavefront's scratch space.
+ */
+void wavefront_dilate_diagonal(wavefront w, uint64_t* in, uint64_t* out)
+{
+    /* A DIAGONAL move changes each axis by at most 1, so the cells it
+     * reaches are found by moving along each axis in turn. */
+    wavefront_dilate_x(w, in, w->tmp);
+    wavefront_dilate_rows(w, w->tmp, out, 1, w->ysize);
+    if (w->zsize > 1)
+    {
+        memcpy(w->tmp, out, sizeof(uint64_t) * w->num_words);
+        wavefront_dilate_rows(w, w->tmp, out, w->ysize, w->zsize);
+    }
+}
+
+/**
+ * This function sets out to the cells in the bitmap in and the cells next to
+ * them along the x axis.
+ */
+void wavefront_dilate_x(wavefront w, uint64_t* in, uint64_t* out)
+{
+    uint32_t row;       /* The current row. */
+    uint32_t first;     /* The index of the row's first word. */
+    uint32_t last;      /* The index of the row's last word. */
+    uint32_t i;         /* The index of the current word. */
+
+    for (row = 0; row < w->num_rows; row++)
+    {
+        first = row * w->row_words;
+        last = first + w->row_words - 1;
+        for (i = first; i <= last; i++)
+        {
+            /* Shift the word both ways, carrying the bits that cross into
+             * the neighbouring words of the row. */
+            out[i] = in[i] | (in[i] << 1) | (in[i] >> 1);
+            if (i > first)
+            {
+                out[i] |= in[i - 1] >> (WAVEFRONT_WORD_BITS - 1);
+            }
+            if (i < last)
+            {
+                out[i] |= in[i + 1] << (WAVEFRONT_WORD_BITS - 1);
+            }
+        }
+    }
+}
+
+/**
+ * This function sets out to the cells in the bitmap in and the cells next to
+ * them along the axis whose neighbouring rows are stride rows apart. The
+ * axis has size coordinates.
+ */
+void wavefront_dilate_rows(wavefront w, uint64_t* in, uint64_t* out,
+                           uint32_t stride, uint32_t size)
+{
+    uint32_t row;       /* The current row. */
+    uint32_t coord;     /* The row's coordinate along the axis. */
+    uint32_t i;         /* The index of the current word. */
+    uint32_t words;     /* The number of words between neighbours. */
+
+    words = stride * w->row_words;
+    for (row = 0; row < w->num_rows; row++)
+    {
+        coord = (row / stride) % size;
+        for (i = row * w->row_words; i < (row + 1) * w->row_words; i++)
+        {
+            out[i] = in[i];
+            if (coord > 0)
+            {
+                out[i] |= in[i - words];
+            }
+            if (coord + 1 < size)
+            {
+                out[i] |= in[i + words];
+            }
+        }
+    }
+}
@@ -0,0 +1,109 @@
+/**
+ * wavefront.h
+ *
+ * This file contains the data-structure and function prototype declarations
+ * for the wavefront type.
+ *
+ * The wavefront type runs breadth first searches over a graph whose moves
+ * all cost 1, such as a graph made by graph_init(). The passable cells are
+ * stored as a bitmap with one bit per cell and the search grows its frontier
+ * with shifts, ORs and ANDs on 64 cells at a time, instead of visiting the
+ * cells one by one.
+ *
+ * A wavefront can measure the distance from every cell to a goal cell, which
+ * gives a flow field towards the goal and an exact heuristic for the astar
+ * type, and can check if two cells can reach each other.
+ *
+ * The wavefront only knows about the types of the cells. Edges that have
+ * been removed from the graph are still treated as moves, so on such graphs
+ * its distances are lower bounds rather than exact distances.
+ *
+ * Version: 1.0.0
+ * File version: 1.0.0
+ * Author: Richard Gale
+ */
+
+#ifndef WAVEFRONT_H
+#define WAVEFRONT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "node.h"
+#include "graph.h"
+
+/**
+ * This is the distance of a cell that can't reach the goal cell.
+ */
+#define WAVEFRONT_UNREACHABLE UINT32_MAX
+
+/**
+ * The data-structure of the wavefront type.
+ */
+typedef struct wavefront_data* wavefront;
+
+/**
+ * This function initialises the wavefront provided to it from the types of
+ * the cells of the graph also provided to the function.
+ */
+void wavefront_init(wavefront* wp, graph* gp);
+
+/**
+ * This function destroys the wavefront provided to it.
+ */
+void wavefront_free(wavefront* wp);
+
+/**
+ * This function reads the type of the cell with the id provided to it from
+ * the graph again. It must be called after graph_set_cell_type() changes a
+ * cell, before the wavefront is run.
+ */
+void wavefront_update_cell(wavefront* wp, uint32_t id);
+
+/**
+ * This function measures the number of moves from every passable cell to
+ * the goal cell provided to it. The distances are read with
+ * wavefront_get_distance() until the wavefront is run again.
+ */
+void wavefront_run(wavefront* wp, uint32_t goal);
+
+/**
+ * This function returns the goal cell of the last run of the wavefront
+ * provided to it, or GRAPH_NO_CELL if it hasn't been run.
+ */
+uint32_t wavefront_get_goal(wavefront w);
+
+/**
+ * This function returns true if the distances of the last run of the
+ * wavefront provided to it still can't be more than the real costs on its
+ * graph: it has been run and, as counted by graph_get_num_decreases(),
+ * nothing has made moving through the graph cheaper since. Cells made
+ * IMPASSABLE since only make the distances lower bounds.
+ */
+bool wavefront_is_current(wavefront w);
+
+/**
+ * This function returns the number of moves from the cell provided to it to
+ * the goal cell of the last run, or WAVEFRONT_UNREACHABLE if the cell can't
+ * reach the goal.
+ */
+uint32_t wavefront_get_distance(wavefront w, uint32_t id);
+
+/**
+ * This function returns the neighbour the cell provided to it should move to
+ * next to reach the goal cell of the last run in the fewest moves. It
+ * returns GRAPH_NO_CELL if the cell is the goal or can't reach it.
+ */
+uint32_t wavefront_get_next(wavefront w, uint32_t id);
+
+/**
+ * This function returns true if the cell with the id b can be reached from
+ * the cell with the id a. It stops as soon as b is reached and doesn't
+ * change the distances of the last run.
+ */
+bool wavefront_is_reachable(wavefront* wp, uint32_t a, uint32_t b);
+
+#endif // WAVEFRONT_H